@@ -37,15 +37,12 @@ EOF
     cp firmware/test_app.hex firmware/firmware.hex
 fi
 
-# Step 3: Update synthesis script to use dual ROM
-echo ""  
-echo "Step 3: Updating synthesis configuration..."
-
-# Update synthesis script to include dual_rom.v
-if ! grep -q "dual_rom.v" synthesize_soc.sh; then
-    sed -i 's/read_verilog.*rom_32kb.v/read_verilog -sv rtl\/memory\/dual_rom.v/' synthesize_soc.sh
-    echo "Updated synthesize_soc.sh to use dual_rom.v"
-fi
+# Step 3: synthesize_soc.sh already builds soc_simple with dual_rom.v; the
+# incremental flow keys the ROM on both hex images, so after a firmware
+# change only the ROM block is re-synthesized
+echo ""
+echo "Step 3: Synthesis configuration..."
+echo "Using dual_rom.v (bootloader.hex + firmware.hex)"
 
 # Step 4: Test compile
 echo ""
@@ -85,7 +82,7 @@ echo "  0x00004000-0x00007FFF: Your CHB App (16KB)"
 echo "  0x00008000-0x00017FFF: RAM (64KB)"
 echo ""
 echo "Next steps:"
-echo "1. Synthesize: ./synthesize_soc.sh"
+echo "1. Synthesize: ./synthesize_soc.sh --incremental"
 echo "2. Program FPGA with bootloader"
 echo "3. Upload your CHB controller via UART!"
 echo ""
@@ -0,0 +1,86 @@
+/**
+ * @file benchmark.h
+ * @brief Cycles-per-Call Measurement of Firmware Kernels on the Simulated Core
+ *
+ * A benchmark build (make bench, see examples/Makefile) replaces the
+ * application main() with a list of kernels to time:
+ *
+ *   bench_run("control_isr", control_isr, 1000);
+ *   bench_exit(0);
+ *
+ * Each kernel is called once to warm the cache and its state, then @p calls
+ * times back to back with interrupts masked. The empty-call loop is timed
+ * the same way and subtracted, so the result is the cost of the kernel
+ * alone. Results go to the console as one line per kernel:
+ *
+ *   BENCH control_isr calls=1000 cycles=412 instret=301
+ *
+ * tools/run_benchmarks.py runs the image on the Verilator model
+ * (sim/verilator, --soc), collects these lines and tracks them over time.
+ * bench_exit() ends the simulation through the riscv-tests tohost
+ * convention; the benchmark application defines tohost.
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <stdint.h>
+#include "perf_counters.h"
+#include "irq.h"
+#include "uart.h"
+
+/** Written by bench_exit(): 1 = pass, (code << 1) | 1 = fail */
+extern volatile uint32_t tohost;
+
+typedef void (*bench_fn_t)(void);
+
+static void __attribute__((noinline, unused)) bench_empty(void) {
+    asm volatile("");
+}
+
+/**
+ * @brief Cycles and instructions of @p calls back-to-back calls to @p fn
+ */
+static inline void bench_measure(bench_fn_t fn, uint32_t calls,
+                                 uint32_t* cycles, uint32_t* instret) {
+    uint32_t mstatus = irq_save();
+    uint32_t c0 = perf_cycles();
+    uint32_t i0 = perf_instret();
+    for (uint32_t n = 0; n < calls; n++) {
+        fn();
+    }
+    *cycles = perf_cycles() - c0;
+    *instret = perf_instret() - i0;
+    irq_restore(mstatus);
+}
+
+/**
+ * @brief Time @p fn and print its BENCH line (per-call averages)
+ */
+static inline void bench_run(const char* name, bench_fn_t fn, uint32_t calls) {
+    uint32_t cycles, instret, base_cycles, base_instret;
+
+    // Console output from the previous kernel must not interrupt this one
+    uart_flush();
+
+    fn();
+    bench_measure(bench_empty, calls, &base_cycles, &base_instret);
+    bench_measure(fn, calls, &cycles, &instret);
+
+    uart_printf("BENCH %s calls=%u cycles=%u instret=%u\r\n", name, calls,
+                (cycles - base_cycles) / calls, (instret - base_instret) / calls);
+}
+
+/**
+ * @brief Drain the console and stop the simulation
+ */
+static inline void __attribute__((noreturn)) bench_exit(uint32_t code) {
+    uart_flush();
+    tohost = (code << 1) | 1;
+    while (1);
+}
+
+#endif // BENCHMARK_H
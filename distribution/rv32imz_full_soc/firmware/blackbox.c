@@ -0,0 +1,58 @@
+/**
+ * @file blackbox.c
+ * @brief Black-Box Recorder Readout
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#include <stdint.h>
+#include "blackbox.h"
+#include "irq.h"
+#include "uart.h"
+
+blackbox_t blackbox;
+
+void blackbox_rearm(void) {
+    uint32_t mstatus = irq_save();
+    blackbox.index = 0;
+    blackbox.post_left = 0;
+    blackbox.trigger_index = 0;
+    blackbox.cause = 0;
+    blackbox.state = BLACKBOX_ARMED;
+    irq_restore(mstatus);
+}
+
+void blackbox_dump(blackbox_print_t print) {
+    if (blackbox.state != BLACKBOX_FROZEN) {
+        uart_puts(blackbox.state == BLACKBOX_ARMED ? "blackbox: armed, no capture\r\n"
+                                                   : "blackbox: capturing post-trigger\r\n");
+        return;
+    }
+
+    // Frozen: the ISR no longer writes, the ring can be read directly
+    uint32_t end = blackbox.index;
+    uint32_t count = (end < BLACKBOX_DEPTH) ? end : BLACKBOX_DEPTH;
+    uint32_t start = end - count;
+
+    uart_flush();
+    uart_printf("blackbox: cause=0x%08x entries=%u pre=%u post=%u\r\n",
+                blackbox.cause, count, blackbox.trigger_index - start,
+                end - 1 - blackbox.trigger_index);
+
+    for (uint32_t i = start; i != end; i++) {
+        const blackbox_entry_t* e = &blackbox.buf[i & (BLACKBOX_DEPTH - 1)];
+        int32_t rel = (int32_t)(i - blackbox.trigger_index);
+
+        // Each line is small; drain when the ring runs low instead of dropping
+        if (uart_tx_free() < UART_PRINTF_MAX) {
+            uart_flush();
+        }
+        if (print != 0) {
+            print(rel, e);
+        } else {
+            uart_printf("%d,%08x,%08x,%08x,%08x\r\n", rel, e->w[0], e->w[1], e->w[2], e->w[3]);
+        }
+    }
+    uart_flush();
+}
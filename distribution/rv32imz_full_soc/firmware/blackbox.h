@@ -0,0 +1,111 @@
+/**
+ * @file blackbox.h
+ * @brief Fault-Triggered Black-Box Recorder of the Last Control Cycles
+ *
+ * A RAM ring keeps the last BLACKBOX_DEPTH control cycles, four 32-bit
+ * words each (the caller packs ADC codes and controller state). On a fault
+ * the ISR calls blackbox_trigger(); BLACKBOX_POST_TRIGGER more cycles are
+ * recorded to show the response to the trip, then the ring freezes until
+ * blackbox_rearm(). The first fault wins: later trips do not overwrite an
+ * existing capture.
+ *
+ *   ISR:   blackbox_record(w0, w1, w2, w3);      // 4 stores + index update
+ *          if (faults) blackbox_trigger(faults);
+ *   loop:  blackbox_dump(print_entry);           // after the fault
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#ifndef BLACKBOX_H
+#define BLACKBOX_H
+
+#include <stdint.h>
+
+#ifndef BLACKBOX_DEPTH
+#define BLACKBOX_DEPTH          256     // cycles, power of two (4 KB)
+#endif
+
+#ifndef BLACKBOX_POST_TRIGGER
+#define BLACKBOX_POST_TRIGGER   16      // cycles kept after the trigger
+#endif
+
+#define BLACKBOX_ARMED          0
+#define BLACKBOX_TRIGGERED      1
+#define BLACKBOX_FROZEN         2
+
+//==========================================================================
+// Data
+//==========================================================================
+
+typedef struct {
+    uint32_t w[4];
+} blackbox_entry_t;
+
+typedef struct {
+    blackbox_entry_t buf[BLACKBOX_DEPTH];
+    uint32_t index;                     // entries written (free-running)
+    volatile uint32_t state;
+    uint32_t post_left;                 // cycles still to record after the trigger
+    uint32_t trigger_index;             // index of the entry that tripped
+    uint32_t cause;                     // value passed to blackbox_trigger()
+} blackbox_t;
+
+extern blackbox_t blackbox;
+
+/**
+ * @brief Dump callback: @p rel is the cycle relative to the trigger
+ */
+typedef void (*blackbox_print_t)(int32_t rel, const blackbox_entry_t* e);
+
+//==========================================================================
+// Control and Readout (background context)
+//==========================================================================
+
+/**
+ * @brief Clear the capture and start recording again
+ */
+void blackbox_rearm(void);
+
+/**
+ * @brief Print the frozen capture oldest-first over UART
+ *
+ * @param print Per-entry formatter, or NULL for raw hex words
+ */
+void blackbox_dump(blackbox_print_t print);
+
+//==========================================================================
+// Recording (ISR)
+//==========================================================================
+
+static inline void blackbox_record(uint32_t w0, uint32_t w1, uint32_t w2, uint32_t w3) {
+    if (blackbox.state == BLACKBOX_FROZEN) return;
+
+    uint32_t i = blackbox.index;
+    blackbox_entry_t* e = &blackbox.buf[i & (BLACKBOX_DEPTH - 1)];
+    e->w[0] = w0;
+    e->w[1] = w1;
+    e->w[2] = w2;
+    e->w[3] = w3;
+    blackbox.index = i + 1;
+
+    if (blackbox.state == BLACKBOX_TRIGGERED && --blackbox.post_left == 0) {
+        blackbox.state = BLACKBOX_FROZEN;
+    }
+}
+
+/**
+ * @brief Freeze after BLACKBOX_POST_TRIGGER more cycles (first call only)
+ *
+ * Call after blackbox_record() of the tripping cycle.
+ */
+static inline void blackbox_trigger(uint32_t cause) {
+    if (blackbox.state != BLACKBOX_ARMED) return;
+
+    blackbox.cause = cause;
+    blackbox.trigger_index = blackbox.index - 1;
+    blackbox.post_left = BLACKBOX_POST_TRIGGER;
+    blackbox.state = (BLACKBOX_POST_TRIGGER > 0) ? BLACKBOX_TRIGGERED : BLACKBOX_FROZEN;
+}
+
+#endif // BLACKBOX_H
@@ -0,0 +1,91 @@
+/**
+ * @file boot_protocol.h
+ * @brief Framed Binary Upload Protocol (bootloader <-> tools/upload_tool.py)
+ *
+ * Every frame, in both directions:
+ *
+ *   +------+------+-----+---------+-----------------+-----------+
+ *   | SYNC | TYPE | SEQ | LEN(16) | PAYLOAD[LEN]    | CRC32(32) |
+ *   +------+------+-----+---------+-----------------+-----------+
+ *
+ * Multi-byte fields are little-endian. CRC32 (crc32.h) covers TYPE..PAYLOAD.
+ * Bytes outside a valid frame (console text, line noise) are skipped while
+ * hunting for SYNC, so the host can start the session right after 'U'.
+ *
+ * Flow control is go-back-N: the host keeps up to PROTO_WINDOW frames in
+ * flight; the bootloader accepts frames strictly in sequence and answers
+ * every accepted frame with ACK(seq = next expected). A corrupt or
+ * out-of-order frame earns one NAK(next expected) and the host rewinds.
+ * A retransmitted frame that was already accepted is simply re-acked.
+ *
+ * Packed images (version 2, tools/pack_image.py): firmware_header_t.reserved
+ * holds the format and the packed length; size and crc32 still describe the
+ * unpacked image. The bootloader unpacks while it programs. A delta image
+ * copies from the installed image and is refused with PROTO_ERR_BASE unless
+ * the installed body has the CRC given in HEADER.
+ *
+ * Session:
+ *   HELLO  [baud u32]        -> ACK [version u8, window u8, max_payload u16,
+ *                                    max_image u32]
+ *          baud != 0 asks for a rate change; the bootloader switches after
+ *          the ACK has left the shifter and falls back to the boot rate if
+ *          no valid frame arrives within PROTO_BAUD_PROBE_MS.
+ *   HEADER [firmware_header_t, base CRC32 u32 for a delta image]
+ *   DATA   [offset u32, bytes...]    offset counts from the end of the header,
+ *                                    in packed bytes for a packed image
+ *   END    []                -> ACK if size and image CRC match, else NAK
+ *   ABORT  []
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#ifndef BOOT_PROTOCOL_H
+#define BOOT_PROTOCOL_H
+
+#define PROTO_VERSION           2       // 2: packed images
+#define PROTO_SYNC              0xA5
+
+#define PROTO_HDR_SIZE          4       // TYPE, SEQ, LEN
+#define PROTO_CRC_SIZE          4
+#define PROTO_MAX_DATA          256     // image bytes per DATA frame
+#define PROTO_MAX_PAYLOAD       (4 + PROTO_MAX_DATA)
+#define PROTO_WINDOW            8       // frames in flight, < 128
+
+#define PROTO_IDLE_TIMEOUT_MS   30000   // no valid frame: give up
+#define PROTO_FRAME_TIMEOUT_MS  1000    // SYNC to last CRC byte
+#define PROTO_BAUD_PROBE_MS     1000    // first frame after a baud change
+#define PROTO_MIN_BAUD_DIV      16      // clocks per bit
+
+// firmware_header_t.reserved of a packed image
+#define PROTO_FORMAT_RAW        0
+#define PROTO_FORMAT_LZ         1
+#define PROTO_FORMAT_DELTA      2
+#define PROTO_FORMAT(reserved)      ((reserved) >> 24)
+#define PROTO_PACKED_SIZE(reserved) ((reserved) & 0xFFFFFFu)
+
+// Host -> bootloader
+#define PROTO_HELLO             0x01
+#define PROTO_HEADER            0x02
+#define PROTO_DATA              0x03
+#define PROTO_END               0x04
+#define PROTO_ABORT             0x05
+
+// Bootloader -> host
+#define PROTO_ACK               0x80
+#define PROTO_NAK               0x81
+
+// NAK reason (one payload byte)
+#define PROTO_ERR_CRC           0x01    // frame CRC mismatch
+#define PROTO_ERR_SEQ           0x02    // gap in the sequence
+#define PROTO_ERR_LENGTH        0x03    // bad LEN for the frame type
+#define PROTO_ERR_STATE         0x04    // DATA/END before HEADER
+#define PROTO_ERR_HEADER        0x05    // bad magic or size
+#define PROTO_ERR_OFFSET        0x06    // DATA offset or overrun
+#define PROTO_ERR_VERIFY        0x07    // image CRC mismatch at END
+#define PROTO_ERR_BAUD          0x08    // requested rate not reachable
+#define PROTO_ERR_TYPE          0x09    // unknown frame type
+#define PROTO_ERR_FORMAT        0x0A    // unknown format or bad packed stream
+#define PROTO_ERR_BASE          0x0B    // delta base is not the installed image
+
+#endif // BOOT_PROTOCOL_H
@@ -3,16 +3,17 @@
  * @brief UART Bootloader for RV32IMZ 5-Level CHB Inverter SoC
  * 
  * Features:
- * - UART-based firmware updates
+ * - UART firmware updates (framed, windowed protocol - boot_protocol.h)
+ * - LZ and delta packed images, unpacked while programming
  * - CRC32 verification  
  * - Application verification
  * - Safe boot with timeout
  * - Recovery mode
  *
- * Memory Layout:
+ * Memory Layout (soc_regs.json):
  * - 0x00000000-0x00003FFF: This bootloader (16KB)
  * - 0x00004000-0x00007FFF: Application space (16KB)
- * - 0x00008000-0x00017FFF: RAM (64KB)
+ * - 0x00010000-0x0001FFFF: RAM (64KB, bootloader uses the first 8KB)
  */
 
 #include <stdint.h>
@@ -22,26 +23,21 @@
 // Hardware Register Definitions
 //=============================================================================
 
-// UART Base Address
-#define UART_BASE       0x80000000
-#define UART_TX_DATA    (*(volatile uint32_t*)(UART_BASE + 0x00))
-#define UART_STATUS     (*(volatile uint32_t*)(UART_BASE + 0x04))
-#define UART_CONTROL    (*(volatile uint32_t*)(UART_BASE + 0x08))
+// UART, TIMER and memory regions come from the generated SoC register map
+#include "soc_regs.h"
+#include "crc32.h"
+#include "boot_protocol.h"
 
-// UART Status Bits
-#define UART_TX_EMPTY   (1 << 1)
-#define UART_RX_READY   (1 << 0)
-
-// Timer Base Address  
-#define TIMER_BASE      0x80000010
-#define TIMER_VALUE     (*(volatile uint32_t*)(TIMER_BASE + 0x00))
+#define CPU_FREQ_HZ     50000000
+#define UART_BAUD       115200
+#define MIE_MTIE        (1u << 7)   // mie: machine timer interrupt (TIMER)
 
 //=============================================================================
 // Bootloader Constants
 //=============================================================================
 
 #define BOOT_MAGIC      0xB007ABCD
-#define APP_START_ADDR  0x00004000
+#define APP_START_ADDR  APP_BASE
 #define TIMEOUT_MS      3000
 #define MAX_APP_SIZE    (16 * 1024)  // 16KB application space
 
@@ -54,48 +50,18 @@ typedef struct __attribute__((packed)) {
 } firmware_header_t;
 
 //=============================================================================
-// CRC32 Implementation
+// Basic I/O Functions
 //=============================================================================
 
-static uint32_t crc32_table[256];
-static bool crc32_table_initialized = false;
-
-static void crc32_init_table(void) {
-    if (crc32_table_initialized) return;
-    
-    for (uint32_t i = 0; i < 256; i++) {
-        uint32_t crc = i;
-        for (int j = 0; j < 8; j++) {
-            if (crc & 1) {
-                crc = (crc >> 1) ^ 0xEDB88320;
-            } else {
-                crc >>= 1;
-            }
-        }
-        crc32_table[i] = crc;
-    }
-    crc32_table_initialized = true;
-}
-
-static uint32_t crc32_calculate(const uint8_t* data, uint32_t length) {
-    crc32_init_table();
-    
-    uint32_t crc = 0xFFFFFFFF;
-    for (uint32_t i = 0; i < length; i++) {
-        uint8_t byte = data[i];
-        crc = crc32_table[(crc ^ byte) & 0xFF] ^ (crc >> 8);
-    }
-    return ~crc;
+static void uart_init(void) {
+    UART->BAUD_DIV = CPU_FREQ_HZ / UART_BAUD;
+    UART->CTRL = UART_CTRL_TX_EN | UART_CTRL_RX_EN;
 }
 
-//=============================================================================
-// Basic I/O Functions
-//=============================================================================
-
 static void uart_putc(char c) {
     // Wait for TX empty
-    while (!(UART_STATUS & UART_TX_EMPTY));
-    UART_TX_DATA = c;
+    while (!(UART->STATUS & UART_STATUS_TX_EMPTY));
+    UART->DATA = c;
 }
 
 static void uart_puts(const char* str) {
@@ -117,44 +83,508 @@ static void uart_put_hex(uint32_t value) {
 }
 
 static bool uart_rx_ready(void) {
-    return (UART_STATUS & UART_RX_READY) != 0;
+    return (UART->STATUS & UART_STATUS_RX_AVAIL) != 0;
 }
 
 static char uart_getc(void) {
     while (!uart_rx_ready());
-    return UART_TX_DATA;  // Same register for RX in simple implementations
+    return (char)(UART->DATA & UART_DATA_BYTE);  // Same register for TX and RX
+}
+
+static void timer_init(void) {
+    // Free-running millisecond counter: the prescaler does the division
+    TIMER->CTRL = 0;
+    TIMER->PRESCALER = CPU_FREQ_HZ / 1000 - 1;
+    TIMER->COUNT = 0;
+    TIMER->CTRL = TIMER_CTRL_ENABLE;
 }
 
 static uint32_t get_time_ms(void) {
-    // Simple timer (assumes 50MHz clock, adjust divider as needed)
-    return TIMER_VALUE / 50000;  // Convert to milliseconds
+    return TIMER->COUNT;
 }
 
+// Sleeps in wfi until the compare match instead of spinning on COUNT.
+// Only the mie bit is set: with mstatus.MIE clear, wfi wakes on the
+// pending interrupt without taking a trap. Match fires when COUNT passes
+// COMPARE, and the time is re-checked before every wfi, so a deadline
+// already past when COMPARE is written never sleeps.
 static void delay_ms(uint32_t ms) {
     uint32_t start = get_time_ms();
-    while ((get_time_ms() - start) < ms);
+    
+    TIMER->COMPARE = start + ms - 1;
+    TIMER->STATUS = TIMER_STATUS_MATCH;
+    TIMER->IRQ_EN = TIMER_IRQ_EN_MATCH;
+    TIMER->CTRL = TIMER_CTRL_ENABLE | TIMER_CTRL_IRQ_EN;
+    __asm__ volatile("csrs mie, %0" : : "r"(MIE_MTIE));
+    
+    while ((get_time_ms() - start) < ms) {
+        __asm__ volatile("wfi");
+    }
+    
+    __asm__ volatile("csrc mie, %0" : : "r"(MIE_MTIE));
+    TIMER->CTRL = TIMER_CTRL_ENABLE;
+    TIMER->IRQ_EN = 0;
+    TIMER->STATUS = TIMER_STATUS_MATCH;
 }
 
 //=============================================================================
-// UART Protocol Functions
+// UART Protocol Functions (boot_protocol.h)
 //=============================================================================
 
-static bool uart_receive_bytes(uint8_t* buffer, uint32_t length, uint32_t timeout_ms) {
-    uint32_t start_time = get_time_ms();
-    uint32_t received = 0;
-    
-    while (received < length) {
-        if ((get_time_ms() - start_time) > timeout_ms) {
-            return false;  // Timeout
+// Transmit queue: ACKs are queued and drained between received bytes so the
+// receive path never stalls on a full TX FIFO while the host keeps sending.
+#define TXQ_SIZE        64      // power of two
+
+static uint8_t txq[TXQ_SIZE];
+static uint32_t txq_head;
+static uint32_t txq_tail;
+
+static void tx_pump(void) {
+    while (txq_tail != txq_head && !(UART->STATUS & UART_STATUS_TX_FULL)) {
+        UART->DATA = txq[txq_tail];
+        txq_tail = (txq_tail + 1) & (TXQ_SIZE - 1);
+    }
+}
+
+static void tx_queue(uint8_t byte) {
+    while (((txq_head + 1) & (TXQ_SIZE - 1)) == txq_tail) {
+        tx_pump();
+    }
+    txq[txq_head] = byte;
+    txq_head = (txq_head + 1) & (TXQ_SIZE - 1);
+}
+
+static void tx_flush(void) {
+    while (txq_tail != txq_head) {
+        tx_pump();
+    }
+    while (!(UART->STATUS & UART_STATUS_TX_EMPTY));
+}
+
+static uint32_t get_le16(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+static uint32_t get_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void prog_pump(void);
+
+/**
+ * @brief Next received byte, or -1 once the deadline (ms tick) has passed
+ *
+ * Idle polls drain the TX queue and the pending block write.
+ */
+static int uart_rx_byte(uint32_t deadline) {
+    while (!uart_rx_ready()) {
+        tx_pump();
+        prog_pump();
+        if ((int32_t)(get_time_ms() - deadline) >= 0) {
+            return -1;
         }
-        
-        if (uart_rx_ready()) {
-            buffer[received++] = uart_getc();
+    }
+    return (int)(UART->DATA & UART_DATA_BYTE);
+}
+
+typedef struct {
+    uint8_t hdr[PROTO_HDR_SIZE];            // TYPE, SEQ, LEN
+    uint8_t payload[PROTO_MAX_PAYLOAD + PROTO_CRC_SIZE];
+} proto_frame_t;
+
+#define PROTO_OK        0
+#define PROTO_TIMEOUT   (-1)
+
+/**
+ * @brief Receive one frame
+ *
+ * @return PROTO_OK, PROTO_TIMEOUT or a PROTO_ERR_* reason for the NAK
+ */
+static int proto_recv_frame(proto_frame_t* f, uint32_t timeout_ms) {
+    uint32_t deadline = get_time_ms() + timeout_ms;
+    int c;
+
+    // Hunt for SYNC, skipping console echo and noise
+    do {
+        c = uart_rx_byte(deadline);
+        if (c < 0) return PROTO_TIMEOUT;
+    } while (c != PROTO_SYNC);
+
+    // The rest of the frame must follow promptly
+    deadline = get_time_ms() + PROTO_FRAME_TIMEOUT_MS;
+
+    for (uint32_t i = 0; i < PROTO_HDR_SIZE; i++) {
+        if ((c = uart_rx_byte(deadline)) < 0) return PROTO_TIMEOUT;
+        f->hdr[i] = (uint8_t)c;
+    }
+
+    uint32_t len = get_le16(&f->hdr[2]);
+    if (len > PROTO_MAX_PAYLOAD) {
+        return PROTO_ERR_LENGTH;
+    }
+
+    for (uint32_t i = 0; i < len + PROTO_CRC_SIZE; i++) {
+        if ((c = uart_rx_byte(deadline)) < 0) return PROTO_TIMEOUT;
+        f->payload[i] = (uint8_t)c;
+    }
+
+    uint32_t crc = crc32_update(CRC32_INIT, f->hdr, PROTO_HDR_SIZE);
+    crc = crc32_final(crc32_update(crc, f->payload, len));
+    if (crc != get_le32(&f->payload[len])) {
+        return PROTO_ERR_CRC;
+    }
+    return PROTO_OK;
+}
+
+static void proto_send(uint8_t type, uint8_t seq, const uint8_t* payload, uint32_t len) {
+    uint8_t hdr[PROTO_HDR_SIZE] = { type, seq, (uint8_t)len, (uint8_t)(len >> 8) };
+
+    uint32_t crc = crc32_update(CRC32_INIT, hdr, PROTO_HDR_SIZE);
+    crc = crc32_final(crc32_update(crc, payload, len));
+
+    tx_queue(PROTO_SYNC);
+    for (uint32_t i = 0; i < PROTO_HDR_SIZE; i++) tx_queue(hdr[i]);
+    for (uint32_t i = 0; i < len; i++) tx_queue(payload[i]);
+    for (int i = 0; i < 32; i += 8) tx_queue((uint8_t)(crc >> i));
+}
+
+static void proto_ack(uint8_t next_seq) {
+    proto_send(PROTO_ACK, next_seq, 0, 0);
+}
+
+static void proto_nak(uint8_t next_seq, uint8_t reason) {
+    proto_send(PROTO_NAK, next_seq, &reason, 1);
+}
+
+/**
+ * @brief BAUD_DIV for a requested rate, 0 if out of range or > 2% off
+ */
+static uint32_t proto_baud_div(uint32_t baud) {
+    if (baud == 0 || baud > CPU_FREQ_HZ / PROTO_MIN_BAUD_DIV) {
+        return 0;
+    }
+    uint32_t div = (CPU_FREQ_HZ + baud / 2) / baud;
+    uint32_t actual = CPU_FREQ_HZ / div;
+    uint32_t error = (actual > baud) ? actual - baud : baud - actual;
+    return (error * 50 <= baud) ? div : 0;
+}
+
+//=============================================================================
+// Application Programming
+//=============================================================================
+
+// Double buffering: DATA frames fill one RAM block while the other is being
+// written to the application region. The write is paced from the UART poll
+// loop (prog_pump), so it overlaps with the reception of the next frames and
+// the host never waits for a block to land.
+//
+// The application region is the upper half of the instruction ROM block
+// RAM; every word is read back after the store, so a read-only ROM makes
+// the upload fail cleanly instead of committing a bad image.
+#define PROG_BLOCK_WORDS    256     // 1KB per buffer
+#define PROG_BLOCK_BYTES    (PROG_BLOCK_WORDS * 4)
+#define PROG_WORDS_PER_POLL 8       // words stored per idle UART poll
+
+static uint32_t prog_buf[2][PROG_BLOCK_WORDS];
+static uint32_t prog_fill;              // bytes in the receive buffer
+static uint32_t prog_rx;                // index of the receive buffer
+
+// Pending block write
+static const uint32_t* prog_src;
+static volatile uint32_t* prog_dst;
+static uint32_t prog_left;              // words
+static volatile uint32_t* prog_next;    // destination of the next block
+static bool prog_error;
+
+static void prog_pump(void) {
+    for (uint32_t n = 0; prog_left != 0 && n < PROG_WORDS_PER_POLL; n++) {
+        uint32_t word = *prog_src++;
+        *prog_dst = word;
+        if (*prog_dst != word) {
+            prog_error = true;
+        }
+        prog_dst++;
+        prog_left--;
+    }
+}
+
+static void prog_wait(void) {
+    while (prog_left != 0) {
+        prog_pump();
+        tx_pump();
+    }
+}
+
+/**
+ * @brief Hand the receive buffer to the writer and switch to the other one
+ */
+static void prog_submit(void) {
+    uint32_t words = (prog_fill + 3) >> 2;
+
+    prog_wait();
+    prog_src = prog_buf[prog_rx];
+    prog_dst = prog_next;
+    prog_left = words;
+    prog_next += words;
+
+    prog_rx ^= 1;
+    prog_fill = 0;
+}
+
+/**
+ * @brief Invalidate the current application and start a new image
+ *
+ * The magic word goes first: an interrupted update leaves no bootable
+ * header behind, and the next boot lands in recovery mode.
+ */
+static void prog_begin(void) {
+    prog_wait();
+    *(volatile uint32_t*)APP_START_ADDR = 0;
+
+    prog_next = (volatile uint32_t*)(APP_START_ADDR + sizeof(firmware_header_t));
+    prog_rx = 0;
+    prog_fill = 0;
+    prog_error = false;
+}
+
+static void prog_write(const uint8_t* data, uint32_t len) {
+    while (len > 0) {
+        uint8_t* buf = (uint8_t*)prog_buf[prog_rx];
+        uint32_t n = PROG_BLOCK_WORDS * 4 - prog_fill;
+        if (n > len) n = len;
+
+        for (uint32_t i = 0; i < n; i++) {
+            buf[prog_fill + i] = data[i];
+        }
+        prog_fill += n;
+        data += n;
+        len -= n;
+
+        if (prog_fill == PROG_BLOCK_WORDS * 4) {
+            prog_submit();
+        }
+    }
+}
+
+/**
+ * @brief Write the last partial block and wait for the writer to drain
+ *
+ * @return false if any word failed to read back
+ */
+static bool prog_finish(void) {
+    if (prog_fill != 0) {
+        // Zero the tail of the last word, it is not covered by the CRC
+        uint8_t* buf = (uint8_t*)prog_buf[prog_rx];
+        while (prog_fill & 3) {
+            buf[prog_fill++] = 0;
+        }
+        prog_submit();
+    }
+    prog_wait();
+    return !prog_error;
+}
+
+/**
+ * @brief Make the image bootable: header words last, magic word last of all
+ */
+static bool prog_commit(const firmware_header_t* header) {
+    volatile uint32_t* dst = (volatile uint32_t*)APP_START_ADDR;
+
+    dst[4] = header->reserved;
+    dst[3] = header->crc32;
+    dst[2] = header->size;
+    dst[1] = header->version;
+    dst[0] = header->magic;
+
+    return dst[0] == header->magic && dst[1] == header->version &&
+           dst[2] == header->size && dst[3] == header->crc32;
+}
+
+//=============================================================================
+// Packed Images (tools/pack_image.py)
+//=============================================================================
+
+// The stream is unpacked straight into the programming buffers, one DATA
+// frame at a time; a token may span frames. There is no window buffer:
+//
+//   COPY  reads earlier output. The current 1KB block is still in the
+//         receive buffer, the previous one in the other buffer (pending or
+//         written, its contents stay put until the next submit), and
+//         everything before that is already in the application region.
+//   BASE  reads the installed image at or after the output position. The
+//         region is only written below the current block, so those bytes
+//         still hold the old image.
+//
+// Every bound is checked against the sizes from HEADER, so a bad stream
+// fails the upload instead of writing outside the image.
+
+enum { UNPACK_TOKEN, UNPACK_LITERAL, UNPACK_LENGTH, UNPACK_ARG_LO, UNPACK_ARG_HI };
+
+#define UNPACK_MIN_MATCH    3
+#define UNPACK_LEN_EXT      0x3F        // length field: extension bytes follow
+
+static struct {
+    uint32_t format;
+    uint32_t state;
+    uint32_t token;
+    uint32_t count;             // literal bytes left or copy length
+    uint32_t arg;               // COPY distance / BASE offset
+    uint32_t out;               // bytes unpacked
+    uint32_t size;              // unpacked body size
+    uint32_t base_size;         // installed body size (delta)
+} unpack;
+
+static const uint8_t* const app_body = (const uint8_t*)(APP_START_ADDR + sizeof(firmware_header_t));
+
+/**
+ * @brief Check that the installed image is the base of a delta image
+ *
+ * Must run before prog_begin() invalidates the installed header.
+ */
+static bool unpack_base_valid(uint32_t base_crc) {
+    const firmware_header_t* installed = (const firmware_header_t*)APP_START_ADDR;
+
+    if (installed->magic != BOOT_MAGIC || installed->crc32 != base_crc ||
+        installed->size < sizeof(firmware_header_t) || installed->size > MAX_APP_SIZE) {
+        return false;
+    }
+    uint32_t size = installed->size - sizeof(firmware_header_t);
+    if (crc32(app_body, size) != base_crc) {
+        return false;
+    }
+    unpack.base_size = size;
+    return true;
+}
+
+static void unpack_begin(uint32_t format, uint32_t size) {
+    unpack.format = format;
+    unpack.state = UNPACK_TOKEN;
+    unpack.out = 0;
+    unpack.size = size;
+}
+
+static void unpack_put(uint8_t byte) {
+    ((uint8_t*)prog_buf[prog_rx])[prog_fill++] = byte;
+    unpack.out++;
+    if (prog_fill == PROG_BLOCK_BYTES) {
+        prog_submit();
+    }
+}
+
+// Byte of earlier output, see above for where it lives
+static uint8_t unpack_peek(uint32_t offset) {
+    uint32_t block = offset / PROG_BLOCK_BYTES;
+    uint32_t current = unpack.out / PROG_BLOCK_BYTES;
+
+    if (block == current) {
+        return ((const uint8_t*)prog_buf[prog_rx])[offset % PROG_BLOCK_BYTES];
+    }
+    if (block + 1 == current) {
+        return ((const uint8_t*)prog_buf[prog_rx ^ 1])[offset % PROG_BLOCK_BYTES];
+    }
+    return app_body[offset];
+}
+
+static bool unpack_copy(void) {
+    uint32_t len = unpack.count;
+    if (len > unpack.size - unpack.out) {
+        return false;
+    }
+
+    if (unpack.token & 0x40) {
+        uint32_t src = unpack.out + unpack.arg;
+        if (unpack.format != PROTO_FORMAT_DELTA || src + len > unpack.base_size) {
+            return false;
+        }
+        while (len-- > 0) {
+            unpack_put(app_body[src++]);
+        }
+    } else {
+        uint32_t dist = unpack.arg;
+        if (dist == 0 || dist > unpack.out) {
+            return false;
+        }
+        while (len-- > 0) {
+            unpack_put(unpack_peek(unpack.out - dist));
         }
     }
     return true;
 }
 
+/**
+ * @brief Unpack the next piece of the stream
+ *
+ * @return false on a token that would leave the image or the base
+ */
+static bool unpack_feed(const uint8_t* data, uint32_t len) {
+    while (len > 0) {
+        if (unpack.state == UNPACK_LITERAL) {
+            uint32_t n = (unpack.count < len) ? unpack.count : len;
+            prog_write(data, n);
+            unpack.out += n;
+            unpack.count -= n;
+            data += n;
+            len -= n;
+            if (unpack.count == 0) unpack.state = UNPACK_TOKEN;
+            continue;
+        }
+
+        uint8_t b = *data++;
+        len--;
+
+        switch (unpack.state) {
+        case UNPACK_TOKEN:
+            if (b < 0x80) {
+                unpack.count = b + 1u;
+                if (unpack.count > unpack.size - unpack.out) return false;
+                unpack.state = UNPACK_LITERAL;
+            } else {
+                unpack.token = b;
+                unpack.count = (b & UNPACK_LEN_EXT) + UNPACK_MIN_MATCH;
+                unpack.state = ((b & UNPACK_LEN_EXT) == UNPACK_LEN_EXT) ? UNPACK_LENGTH
+                                                                         : UNPACK_ARG_LO;
+            }
+            break;
+        case UNPACK_LENGTH:
+            unpack.count += b;
+            if (unpack.count > unpack.size) return false;
+            if (b != 255) unpack.state = UNPACK_ARG_LO;
+            break;
+        case UNPACK_ARG_LO:
+            unpack.arg = b;
+            unpack.state = UNPACK_ARG_HI;
+            break;
+        default:    // UNPACK_ARG_HI
+            unpack.arg |= (uint32_t)b << 8;
+            if (!unpack_copy()) return false;
+            unpack.state = UNPACK_TOKEN;
+            break;
+        }
+    }
+    return true;
+}
+
+static bool unpack_done(void) {
+    return unpack.state == UNPACK_TOKEN && unpack.out == unpack.size;
+}
+
+static void system_reset(void) {
+    uart_puts("Resetting...\r\n");
+    while (!(UART->STATUS & UART_STATUS_TX_EMPTY));
+
+    // The register map has no reset controller: quiesce what the bootloader
+    // started and re-enter the reset vector, which rebuilds .data/.bss/sp.
+    __asm__ volatile("csrci mstatus, 0x8");
+    __asm__ volatile("csrw mie, zero");
+    TIMER->CTRL = 0;
+    UART->CTRL = 0;
+    ICACHE->CTRL = ICACHE_CTRL_FLUSH;   // run the bootloader uncached again
+
+    __asm__ volatile("jr %0" : : "r"(BOOT_BASE));
+    while (1);
+}
+
 //=============================================================================
 // Application Management
 //=============================================================================
@@ -176,7 +606,7 @@ static bool verify_application(uint32_t addr) {
     
     // Calculate CRC of application data (after header)
     uint8_t* app_data = (uint8_t*)(addr + sizeof(firmware_header_t));
-    uint32_t calc_crc = crc32_calculate(app_data, header->size - sizeof(firmware_header_t));
+    uint32_t calc_crc = crc32(app_data, header->size - sizeof(firmware_header_t));
     
     if (calc_crc != header->crc32) {
         uart_puts("CRC check failed - Expected: ");
@@ -212,81 +642,228 @@ static void jump_to_application(uint32_t addr) {
 // Firmware Update Functions
 //=============================================================================
 
+/**
+ * @brief Run one upload session (boot_protocol.h)
+ *
+ * DATA frames must arrive in order, so they stream straight into the
+ * double-buffered programmer. The image is CRC-checked on the fly and again
+ * from the application region before the header is committed.
+ */
 static bool receive_firmware(void) {
-    firmware_header_t header;
-    
-    uart_puts("Waiting for firmware header (30s timeout)...\r\n");
-    
-    // Receive header
-    if (!uart_receive_bytes((uint8_t*)&header, sizeof(header), 30000)) {
-        uart_puts("ERROR: Header timeout\r\n");
-        return false;
-    }
-    
-    // Verify header
-    if (header.magic != BOOT_MAGIC) {
-        uart_puts("ERROR: Invalid magic - ");
-        uart_put_hex(header.magic);
-        uart_puts("\r\n");
-        return false;
-    }
-    
-    if (header.size > MAX_APP_SIZE) {
-        uart_puts("ERROR: Firmware too large\r\n");
-        return false;
-    }
-    
-    uart_puts("Firmware version: ");
-    uart_put_hex(header.version);
-    uart_puts("\r\nSize: ");
-    uart_put_hex(header.size);
-    uart_puts(" bytes\r\n");
-    
-    // For this simple implementation, we'll simulate flash programming
-    // In a real system, this would erase and program flash memory
-    uart_puts("Simulating flash programming...\r\n");
-    
-    // Receive and verify firmware data
-    uint8_t buffer[128];
-    uint32_t remaining = header.size;
-    uint32_t addr = APP_START_ADDR + sizeof(firmware_header_t);
-    uint32_t crc = 0xFFFFFFFF;
-    
-    uart_puts("Programming");
-    
-    // Write header first (simulate)
-    crc32_init_table();
-    
-    while (remaining > 0) {
-        uint32_t chunk = (remaining > sizeof(buffer)) ? sizeof(buffer) : remaining;
-        
-        if (!uart_receive_bytes(buffer, chunk, 5000)) {
-            uart_puts("\r\nERROR: Data timeout\r\n");
-            return false;
+    static proto_frame_t frame;
+    firmware_header_t header = { 0 };
+    bool have_header = false;
+    uint32_t format = PROTO_FORMAT_RAW;
+    uint32_t stream_size = 0;           // bytes of DATA: body or packed stream
+    uint32_t received = 0;
+    uint32_t crc = CRC32_INIT;
+
+    uint8_t expect_seq = 0;
+    bool nak_pending = false;       // one NAK per error burst
+    bool baud_probe = false;
+    uint32_t boot_div = UART->BAUD_DIV;
+    bool ok = false;
+
+    uart_puts("Waiting for upload session (30s timeout)...\r\n");
+
+    while (1) {
+        int status = proto_recv_frame(&frame, baud_probe ? PROTO_BAUD_PROBE_MS
+                                                         : PROTO_IDLE_TIMEOUT_MS);
+        if (baud_probe) {
+            baud_probe = false;
+            if (status != PROTO_OK) {
+                // Host never came up at the new rate: back to the boot rate
+                UART->BAUD_DIV = boot_div;
+                continue;
+            }
         }
-        
-        // Update CRC
-        for (uint32_t i = 0; i < chunk; i++) {
-            crc = crc32_table[(crc ^ buffer[i]) & 0xFF] ^ (crc >> 8);
+        if (status == PROTO_TIMEOUT) {
+            break;
         }
-        
-        remaining -= chunk;
-        uart_putc('.');
+
+        if (status != PROTO_OK) {
+            if (!nak_pending) proto_nak(expect_seq, (uint8_t)status);
+            nak_pending = true;
+            continue;
+        }
+
+        uint8_t type = frame.hdr[0];
+        uint8_t seq = frame.hdr[1];
+        uint32_t len = get_le16(&frame.hdr[2]);
+        const uint8_t* p = frame.payload;
+
+        // HELLO (re)starts the session at its own sequence number
+        if (type == PROTO_HELLO) {
+            if (len != 4) {
+                proto_nak(seq, PROTO_ERR_LENGTH);
+                continue;
+            }
+            uint32_t baud = get_le32(p);
+            uint32_t div = proto_baud_div(baud);
+            if (baud != 0 && div == 0) {
+                proto_nak(seq, PROTO_ERR_BAUD);
+                continue;
+            }
+
+            UART->BAUD_DIV = boot_div;
+            have_header = false;
+            expect_seq = seq + 1;
+            nak_pending = false;
+
+            uint8_t info[8] = {
+                PROTO_VERSION, PROTO_WINDOW,
+                (uint8_t)PROTO_MAX_DATA, (uint8_t)(PROTO_MAX_DATA >> 8),
+                (uint8_t)MAX_APP_SIZE, (uint8_t)(MAX_APP_SIZE >> 8),
+                (uint8_t)(MAX_APP_SIZE >> 16), (uint8_t)(MAX_APP_SIZE >> 24),
+            };
+            proto_send(PROTO_ACK, expect_seq, info, sizeof(info));
+
+            if (div != 0) {
+                tx_flush();
+                UART->BAUD_DIV = div;
+                baud_probe = true;
+            }
+            continue;
+        }
+
+        if (seq != expect_seq) {
+            if ((uint8_t)(expect_seq - seq) <= PROTO_WINDOW) {
+                proto_ack(expect_seq);      // Already accepted, ACK was lost
+            } else if (!nak_pending) {
+                proto_nak(expect_seq, PROTO_ERR_SEQ);
+                nak_pending = true;
+            }
+            continue;
+        }
+
+        uint8_t error = 0;
+        bool done = false;
+
+        switch (type) {
+        case PROTO_HEADER:
+            if (len != sizeof(firmware_header_t) && len != sizeof(firmware_header_t) + 4) {
+                error = PROTO_ERR_LENGTH;
+                break;
+            }
+            header.magic = get_le32(p);
+            header.version = get_le32(p + 4);
+            header.size = get_le32(p + 8);
+            header.crc32 = get_le32(p + 12);
+            header.reserved = get_le32(p + 16);
+            format = PROTO_FORMAT(header.reserved);
+            stream_size = PROTO_PACKED_SIZE(header.reserved);
+
+            // size counts the header, see verify_application()
+            if (header.magic != BOOT_MAGIC || header.size < sizeof(firmware_header_t) ||
+                header.size > MAX_APP_SIZE) {
+                error = PROTO_ERR_HEADER;
+                break;
+            }
+            if (format > PROTO_FORMAT_DELTA ||
+                (format != PROTO_FORMAT_RAW && (stream_size == 0 || stream_size > MAX_APP_SIZE))) {
+                error = PROTO_ERR_FORMAT;
+                break;
+            }
+            if ((format == PROTO_FORMAT_DELTA) != (len == sizeof(firmware_header_t) + 4)) {
+                error = PROTO_ERR_LENGTH;
+                break;
+            }
+            if (format == PROTO_FORMAT_DELTA && !unpack_base_valid(get_le32(p + 20))) {
+                error = PROTO_ERR_BASE;
+                break;
+            }
+            if (format == PROTO_FORMAT_RAW) {
+                stream_size = header.size - sizeof(firmware_header_t);
+            }
+            have_header = true;
+            received = 0;
+            crc = CRC32_INIT;
+            unpack_begin(format, header.size - sizeof(firmware_header_t));
+            prog_begin();
+            break;
+
+        case PROTO_DATA:
+            if (!have_header) {
+                error = PROTO_ERR_STATE;
+            } else if (len < 4) {
+                error = PROTO_ERR_LENGTH;
+            } else if (get_le32(p) != received || len - 4 > stream_size - received) {
+                error = PROTO_ERR_OFFSET;
+            } else if (format == PROTO_FORMAT_RAW) {
+                crc = crc32_update(crc, p + 4, len - 4);
+                prog_write(p + 4, len - 4);
+                received += len - 4;
+            } else if (!unpack_feed(p + 4, len - 4)) {
+                error = PROTO_ERR_FORMAT;
+            } else {
+                received += len - 4;
+            }
+            break;
+
+        case PROTO_END:
+            // A packed stream has no stream CRC: the frame CRCs cover the
+            // transfer and the region CRC below covers the unpacking
+            if (!have_header) {
+                error = PROTO_ERR_STATE;
+            } else if (received != stream_size ||
+                       (format == PROTO_FORMAT_RAW ? crc32_final(crc) != header.crc32 : !unpack_done()) ||
+                       !prog_finish()) {
+                error = PROTO_ERR_VERIFY;
+            } else {
+                // Stream CRC matched and every word read back: check what
+                // actually landed in the region, then commit the header,
+                // which describes the unpacked image from now on
+                header.reserved = 0;
+                ok = crc32(app_body, header.size - sizeof(firmware_header_t)) == header.crc32 &&
+                     prog_commit(&header);
+                if (!ok) error = PROTO_ERR_VERIFY;
+            }
+            done = true;
+            break;
+
+        case PROTO_ABORT:
+            done = true;
+            break;
+
+        default:
+            error = PROTO_ERR_TYPE;
+            break;
+        }
+
+        if (error != 0 && !done) {
+            // The host rewinds to this frame; it cannot succeed, so it aborts
+            proto_nak(expect_seq, error);
+            continue;
+        }
+
+        expect_seq++;
+        nak_pending = false;
+        if (error != 0) {
+            proto_nak(expect_seq, error);
+        } else {
+            proto_ack(expect_seq);
+        }
+
+        if (done) break;
     }
-    
-    crc = ~crc;
-    uart_puts(" done\r\n");
-    
-    // Verify CRC
-    if (crc != header.crc32) {
-        uart_puts("ERROR: CRC mismatch!\r\n");
-        return false;
+
+    // Console output continues at the boot rate
+    tx_flush();
+    UART->BAUD_DIV = boot_div;
+
+    if (ok) {
+        uart_puts("Firmware version: ");
+        uart_put_hex(header.version);
+        uart_puts("\r\nSize: ");
+        uart_put_hex(header.size);
+        uart_puts(" bytes\r\n");
+        uart_puts("Programmed and verified at ");
+        uart_put_hex(APP_START_ADDR);
+        uart_puts("\r\n");
+    } else {
+        uart_puts("ERROR: Upload failed\r\n");
     }
-    
-    uart_puts("Firmware update successful!\r\n");
-    uart_puts("Note: This is a simulation - actual flash programming would occur here\r\n");
-    
-    return true;
+    return ok;
 }
 
 static bool check_for_update_request(void) {
@@ -321,7 +898,9 @@ static bool check_for_update_request(void) {
 //=============================================================================
 
 void bootloader_main(void) {
-    // Initialize UART (simple setup - assume already configured)
+    // Initialize UART and millisecond timer
+    uart_init();
+    timer_init();
     
     // Print banner
     uart_puts("\r\n");
@@ -339,12 +918,7 @@ void bootloader_main(void) {
         
         if (receive_firmware()) {
             uart_puts("Update completed successfully!\r\n");
-            uart_puts("Rebooting in 2 seconds...\r\n");
-            delay_ms(2000);
-            
-            // Simulate reboot (in real system would trigger reset)
-            uart_puts("Reboot simulation - please reset manually\r\n");
-            while(1);
+            system_reset();
         } else {
             uart_puts("Update failed! Attempting to boot existing app...\r\n");
         }
@@ -360,7 +934,8 @@ void bootloader_main(void) {
         // Recovery mode: wait for firmware upload indefinitely
         while (1) {
             if (receive_firmware()) {
-                uart_puts("Recovery successful! Please reset to boot.\r\n");
+                uart_puts("Recovery successful!\r\n");
+                system_reset();
             }
             delay_ms(1000);
         }
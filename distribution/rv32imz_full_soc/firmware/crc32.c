@@ -0,0 +1,44 @@
+/**
+ * @file crc32.c
+ * @brief Slicing-by-4 CRC32
+ *
+ * RV32 is little-endian, so after XOR-ing a whole word into the CRC its
+ * lowest byte is the first byte of the stream and takes the table with the
+ * most bytes still to follow (T[3]).
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#include "crc32.h"
+
+static inline uint32_t crc32_byte(uint32_t crc, uint8_t byte) {
+    return crc32_table[0][(crc ^ byte) & 0xFF] ^ (crc >> 8);
+}
+
+uint32_t crc32_update(uint32_t crc, const uint8_t* data, uint32_t len) {
+    // Head: bytes up to the first word boundary
+    while (len > 0 && ((uintptr_t)data & 3u) != 0) {
+        crc = crc32_byte(crc, *data++);
+        len--;
+    }
+
+    // Body: one aligned word per iteration
+    const uint32_t* word = (const uint32_t*)data;
+    while (len >= 4) {
+        crc ^= *word++;
+        crc = crc32_table[3][crc & 0xFF] ^
+              crc32_table[2][(crc >> 8) & 0xFF] ^
+              crc32_table[1][(crc >> 16) & 0xFF] ^
+              crc32_table[0][crc >> 24];
+        len -= 4;
+    }
+
+    // Tail
+    data = (const uint8_t*)word;
+    while (len > 0) {
+        crc = crc32_byte(crc, *data++);
+        len--;
+    }
+    return crc;
+}
@@ -0,0 +1,48 @@
+/**
+ * @file crc32.h
+ * @brief Streaming CRC32 (IEEE 802.3, reflected 0xEDB88320)
+ *
+ * Slicing-by-4: one 32-bit load and four table lookups per word instead of
+ * one lookup per byte. The tables are generated at build time into
+ * crc32_table.c (tools/gen_crc32_table.py) and live in .rodata, so no RAM
+ * and no boot-time initialisation are needed.
+ *
+ * Usage:
+ *   uint32_t crc = CRC32_INIT;
+ *   crc = crc32_update(crc, chunk, len);   // any number of calls
+ *   crc = crc32_final(crc);                // == zlib.crc32(data)
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stdint.h>
+
+#define CRC32_SLICES    4
+#define CRC32_INIT      0xFFFFFFFFu
+
+/** Slicing tables, crc32_table[0] is the classic byte table */
+extern const uint32_t crc32_table[CRC32_SLICES][256];
+
+/**
+ * @brief Fold len bytes into a running (non-inverted) CRC
+ *
+ * Any alignment and length; chunks may be split arbitrarily between calls.
+ */
+uint32_t crc32_update(uint32_t crc, const uint8_t* data, uint32_t len);
+
+static inline uint32_t crc32_final(uint32_t crc) {
+    return ~crc;
+}
+
+/**
+ * @brief One-shot CRC32 of a buffer
+ */
+static inline uint32_t crc32(const uint8_t* data, uint32_t len) {
+    return crc32_final(crc32_update(CRC32_INIT, data, len));
+}
+
+#endif // CRC32_H
@@ -0,0 +1,132 @@
+/**
+ * @file dma.h
+ * @brief Two-Channel DMA Driver (soc_regs.h DMA, IRQ_DMA)
+ *
+ * rtl/peripherals/wb_dma.v runs chains of descriptors from RAM. Each
+ * descriptor moves COUNT elements of one size, optionally incrementing the
+ * source and/or destination, paced by a peripheral request line:
+ *
+ *   static dma_desc_t d = {
+ *       .src = (uint32_t)buf, .dst = (uint32_t)&UART->DATA,
+ *       .cfg = DMA_CFG_COUNT(len) | DMA_CFG_SIZE_BYTE | DMA_CFG_SRC_INC |
+ *              DMA_CFG_REQ_UART_TX | DMA_CFG_IRQ,
+ *       .next = 0,
+ *   };
+ *   dma_start(DMA_CH_UART, &d, done_fn);
+ *
+ * The engine reads descriptors when it reaches them, so a descriptor must
+ * stay valid (static or otherwise long-lived) until the channel has moved
+ * past it. NEXT may point back into the chain for endless ping-pong
+ * buffers; DMA_CFG_IRQ marks the descriptors that should raise DONE.
+ *
+ * Channel assignment used by the drivers (any channel can use any request
+ * line): channel 0 ADC FIFO -> RAM (adc_fifo.c), channel 1 RAM -> UART TX
+ * (uart.c). Build with `make DMA=1` (defines USE_DMA) to switch them over.
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#ifndef DMA_H
+#define DMA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "soc_regs.h"
+
+#define DMA_NUM_CHANNELS    2
+#define DMA_CH_ADC          0
+#define DMA_CH_UART         1
+
+//==========================================================================
+// Descriptors
+//==========================================================================
+
+typedef struct {
+    uint32_t src;
+    uint32_t dst;
+    uint32_t cfg;                       // DMA_CFG_*
+    uint32_t next;                      // next descriptor, 0 = end of chain
+} dma_desc_t;
+
+#define DMA_CFG_COUNT(n)        ((uint32_t)(n) & 0xFFFFu)   // elements
+#define DMA_CFG_SIZE_BYTE       (0u << 16)
+#define DMA_CFG_SIZE_HALF       (1u << 16)
+#define DMA_CFG_SIZE_WORD       (2u << 16)
+#define DMA_CFG_SRC_INC         (1u << 18)
+#define DMA_CFG_DST_INC         (1u << 19)
+#define DMA_CFG_REQ_NONE        (0u << 20)  // memory to memory, free-running
+#define DMA_CFG_REQ_ADC         (1u << 20)  // ADC FIFO not empty
+#define DMA_CFG_REQ_UART_TX     (2u << 20)  // UART TX FIFO not full
+#define DMA_CFG_IRQ             (1u << 22)  // set DONE when this descriptor ends
+
+#define DMA_MAX_COUNT           0xFFFFu
+
+//==========================================================================
+// Channel Registers
+//==========================================================================
+
+// One channel's view of the register block (identical layout per channel)
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t STATUS;
+    volatile uint32_t DESC;
+    const volatile uint32_t SRC;
+    const volatile uint32_t DST;
+    const volatile uint32_t COUNT;
+    uint32_t reserved[2];
+} dma_channel_t;
+
+_Static_assert(offsetof(dma_regs_t, CH1_CTRL) == sizeof(dma_channel_t), "DMA channel stride");
+
+#define DMA_CH(n)           ((dma_channel_t*)(DMA_BASE + (n) * sizeof(dma_channel_t)))
+
+// Field masks are the same for both channels
+#define DMA_CTRL_START      DMA_CH0_CTRL_START
+#define DMA_CTRL_ABORT      DMA_CH0_CTRL_ABORT
+#define DMA_CTRL_IRQ_EN     DMA_CH0_CTRL_IRQ_EN
+#define DMA_STATUS_BUSY     DMA_CH0_STATUS_BUSY
+#define DMA_STATUS_DONE     DMA_CH0_STATUS_DONE
+#define DMA_STATUS_ERROR    DMA_CH0_STATUS_ERROR
+
+//==========================================================================
+// API
+//==========================================================================
+
+/**
+ * @brief Completion callback (IRQ context): @p status has DONE and/or ERROR
+ */
+typedef void (*dma_callback_t)(unsigned ch, uint32_t status);
+
+/**
+ * @brief Stop both channels and hook IRQ_DMA
+ *
+ * Every driver that uses a channel calls this; only the first call has an
+ * effect, so one driver cannot stop another's channel.
+ */
+void dma_init(void);
+
+/**
+ * @brief Run the chain starting at @p desc on an idle channel
+ *
+ * @param done Called on DONE/ERROR, or NULL to poll with dma_busy()
+ */
+void dma_start(unsigned ch, const dma_desc_t* desc, dma_callback_t done);
+
+/**
+ * @brief Stop a channel after the element in flight and wait until idle
+ */
+void dma_abort(unsigned ch);
+
+static inline int dma_busy(unsigned ch) {
+    return (DMA_CH(ch)->STATUS & DMA_STATUS_BUSY) != 0;
+}
+
+/**
+ * @brief Descriptor the channel will fetch next (0 when the chain ends)
+ */
+static inline uint32_t dma_next_desc(unsigned ch) {
+    return DMA_CH(ch)->DESC;
+}
+
+#endif // DMA_H
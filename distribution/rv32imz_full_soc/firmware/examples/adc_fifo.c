@@ -0,0 +1,210 @@
+/**
+ * @file adc_fifo.c
+ * @brief Sigma-Delta ADC FIFO Burst Driver (interrupt driven)
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "memory_map.h"
+#include "adc_fifo.h"
+#include "irq.h"
+#ifdef USE_DMA
+#include "dma.h"
+#endif
+
+volatile adc_frame_t adc_fifo_frame;
+volatile adc_fifo_stats_t adc_fifo_stats;
+
+/**
+ * @brief Realign on the frame boundary after @p word, the last word popped
+ *
+ * FIFO_DATA cannot be peeked, so the boundary comes from the tags of the
+ * words already popped: a channel-3 word ends a frame, a channel-0 word
+ * starts one. Only the words before the boundary are discarded; a frame
+ * starting at @p word (or after it) whose other samples are already in the
+ * FIFO is read into @p raw instead.
+ *
+ * @return 1 if @p raw holds a complete frame
+ */
+static int adc_fifo_resync(uint32_t word, uint16_t raw[ADC_NUM_CHANNELS]) {
+    for (;;) {
+        uint32_t ch = adc_fifo_data_ch_get(word);
+
+        if (ch == 0 && ADC->FIFO_LEVEL >= ADC_NUM_CHANNELS - 1) {
+            raw[0] = (uint16_t)adc_fifo_data_sample_get(word);
+            for (ch = 1; ch < ADC_NUM_CHANNELS; ch++) {
+                word = ADC->FIFO_DATA;
+                if (adc_fifo_data_ch_get(word) != ch) break;
+                raw[ch] = (uint16_t)adc_fifo_data_sample_get(word);
+            }
+            if (ch == ADC_NUM_CHANNELS) return 1;
+            continue;                           // realign on the new word
+        }
+
+        // Next word starts a frame, or the rest has not arrived yet
+        if (ch == ADC_NUM_CHANNELS - 1 || ADC->FIFO_LEVEL == 0) return 0;
+        word = ADC->FIFO_DATA;
+    }
+}
+
+/**
+ * @brief Make @p raw the newest frame, @p frames after the previous one
+ */
+static void adc_fifo_publish(const uint16_t raw[ADC_NUM_CHANNELS], uint32_t frames) {
+    for (uint32_t ch = 0; ch < ADC_NUM_CHANNELS; ch++) {
+        adc_fifo_frame.raw[ch] = raw[ch];
+    }
+    adc_fifo_frame.seq += frames;
+}
+
+#ifdef USE_DMA
+
+//==========================================================================
+// DMA Mode: channel 0 fills two frame buffers alternately
+//==========================================================================
+
+#define DMA_FRAME_BYTES (ADC_NUM_CHANNELS * sizeof(uint32_t))
+
+static uint32_t dma_frames[2][ADC_NUM_CHANNELS];    // contiguous
+static dma_desc_t dma_descs[2];
+
+/**
+ * @brief Byte offset of the engine's destination pointer from buffer @p buf
+ */
+static uint32_t adc_fifo_dma_offset(uint32_t buf) {
+    return DMA_CH(DMA_CH_ADC)->DST - (uint32_t)dma_frames[buf];
+}
+
+/**
+ * @brief Buffer the engine completed last, from its destination pointer
+ *
+ * DST runs through both buffers back to back (0..2 frames past buffer 0).
+ * Exactly one frame is the end of buffer 0, or the start of buffer 1 once
+ * the next descriptor is fetched: buffer 0 is done either way. Anywhere in
+ * buffer 0, or the end of buffer 1, means buffer 1 is the newest.
+ */
+static uint32_t adc_fifo_dma_newest(void) {
+    uint32_t off = adc_fifo_dma_offset(0);
+    return (off >= DMA_FRAME_BYTES && off < 2 * DMA_FRAME_BYTES) ? 0 : 1;
+}
+
+static void adc_fifo_dma_done(unsigned ch, uint32_t status);
+
+static void adc_fifo_dma_start(void) {
+    for (uint32_t i = 0; i < 2; i++) {
+        dma_descs[i].src = (uint32_t)&ADC->FIFO_DATA;
+        dma_descs[i].dst = (uint32_t)dma_frames[i];
+        dma_descs[i].cfg = DMA_CFG_COUNT(ADC_NUM_CHANNELS) | DMA_CFG_SIZE_WORD |
+                           DMA_CFG_DST_INC | DMA_CFG_REQ_ADC | DMA_CFG_IRQ;
+        dma_descs[i].next = (uint32_t)&dma_descs[i ^ 1];
+    }
+    dma_start(DMA_CH_ADC, &dma_descs[0], adc_fifo_dma_done);
+}
+
+static void adc_fifo_dma_done(unsigned ch, uint32_t status) {
+    (void)ch;
+
+    if (ADC->STATUS & ADC_STATUS_FIFO_FULL) {
+        adc_fifo_stats.overruns++;
+    }
+
+    // DONE is one sticky bit, so a late callback may stand for several
+    // completions: take the newest buffer from where the engine is writing,
+    // not from a count of callbacks. DESC is no help either, it changes with
+    // the descriptor fetch.
+    uint32_t done = adc_fifo_dma_newest();
+    const volatile uint32_t* words = dma_frames[done];
+    uint16_t raw[ADC_NUM_CHANNELS];
+
+    for (uint32_t i = 0; i < ADC_NUM_CHANNELS; i++) {
+        if ((status & DMA_STATUS_ERROR) || adc_fifo_data_ch_get(words[i]) != i) {
+            // Out of step with the FIFO: realign on a frame boundary, restart
+            dma_abort(DMA_CH_ADC);
+            adc_fifo_stats.resyncs++;
+            if (ADC->FIFO_LEVEL != 0 && adc_fifo_resync(ADC->FIFO_DATA, raw)) {
+                adc_fifo_publish(raw, 1);
+            }
+            adc_fifo_dma_start();
+            return;
+        }
+        raw[i] = (uint16_t)adc_fifo_data_sample_get(words[i]);
+    }
+
+    // Serviced a whole frame late: the engine is refilling what was just
+    // read, the samples may span two frames
+    uint32_t off = adc_fifo_dma_offset(done);
+    if (off > 0 && off < DMA_FRAME_BYTES) {
+        adc_fifo_stats.dropped++;
+        return;
+    }
+
+    adc_fifo_publish(raw, 1);
+}
+
+#else
+
+static void adc_fifo_isr(void) {
+    uint16_t raw[ADC_NUM_CHANNELS];
+    uint16_t newest[ADC_NUM_CHANNELS];
+    uint32_t frames = 0;
+    uint32_t bad;
+
+    if (ADC->STATUS & ADC_STATUS_FIFO_FULL) {
+        adc_fifo_stats.overruns++;
+    }
+
+    // Drain every complete frame; level drops below one frame clears the IRQ
+    while (ADC->FIFO_LEVEL >= ADC_NUM_CHANNELS) {
+        if (!adc_fifo_read_frame(raw, &bad)) {
+            adc_fifo_stats.resyncs++;
+            if (!adc_fifo_resync(bad, raw)) continue;
+        }
+        for (uint32_t ch = 0; ch < ADC_NUM_CHANNELS; ch++) {
+            newest[ch] = raw[ch];
+        }
+        frames++;
+    }
+
+    if (frames == 0) return;
+
+    adc_fifo_publish(newest, frames);
+    adc_fifo_stats.dropped += frames - 1;
+}
+
+#endif // USE_DMA
+
+void adc_fifo_init(void) {
+    ADC->IRQ_EN = 0;
+    ADC->CTRL = 0;
+
+    adc_fifo_frame.seq = 0;
+    adc_fifo_stats.overruns = 0;
+    adc_fifo_stats.resyncs = 0;
+    adc_fifo_stats.dropped = 0;
+
+#ifdef USE_DMA
+    // Frames arrive through DMA channel 0; the ADC interrupt stays off
+    dma_init();
+    dma_abort(DMA_CH_ADC);
+    ADC->CTRL = ADC_CTRL_ENABLE | ADC_CTRL_FIFO_EN | ADC_CTRL_CONT;
+    adc_fifo_dma_start();
+#else
+    irq_register(IRQ_ADC, adc_fifo_isr, NULL);
+    irq_enable(IRQ_ADC);
+
+    ADC->CTRL = ADC_CTRL_ENABLE | ADC_CTRL_FIFO_EN | ADC_CTRL_CONT;
+    ADC->IRQ_EN = ADC_IRQ_EN_FRAME;
+#endif
+}
+
+void adc_fifo_disable(void) {
+    ADC->IRQ_EN = 0;
+    irq_disable(IRQ_ADC);
+#ifdef USE_DMA
+    dma_abort(DMA_CH_ADC);
+#endif
+    ADC->CTRL = 0;
+}
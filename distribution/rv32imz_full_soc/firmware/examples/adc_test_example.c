@@ -20,18 +20,21 @@
 
 #include <stdint.h>
 #include "sigma_delta_adc.h"
+#include "irq.h"
+#include "uart.h"
+#include "perf_counters.h"
 
-// Assume these are defined elsewhere (uart, timing, etc.)
-extern void uart_putc(char c);
-extern void uart_puts(const char* s);
-extern void uart_put_hex(uint32_t val);
-extern void uart_put_float(float val);
-extern void delay_ms(uint32_t ms);
+#define CPU_FREQ_HZ     50000000
+#define UART_BAUD       115200
 
 //==========================================================================
 // UART Helper Functions
 //==========================================================================
 
+static void uart_put_float(float val) {
+    uart_printf("%.2k", (int32_t)(val * 65536.0f));  // 16.16, no float printf
+}
+
 void print_voltage(const char* label, float voltage) {
     uart_puts(label);
     uart_puts(": ");
@@ -118,10 +121,10 @@ void test_adc_basic(void) {
         }
     }
 
-    // Sample counter
-    uint32_t samples = adc_get_sample_count();
-    uart_puts("\nSample count: ");
-    uart_put_hex(samples);
+    // FIFO level
+    uint32_t level = adc_get_fifo_level();
+    uart_puts("\nFIFO level: ");
+    uart_put_hex(level);
     uart_putc('\n');
 }
 
@@ -221,7 +224,7 @@ void test_adc_validity(void) {
 
     // Check status immediately (should be invalid)
     uart_puts("Initial status (should be 0): 0x");
-    uart_put_hex(*ADC_STATUS);
+    uart_put_hex(ADC->STATUS);
     uart_putc('\n');
 
     // Wait for new sample
@@ -229,7 +232,7 @@ void test_adc_validity(void) {
 
     // Check status again (should have some valid bits)
     uart_puts("After 1ms (should be non-zero): 0x");
-    uart_put_hex(*ADC_STATUS);
+    uart_put_hex(ADC->STATUS);
     uart_putc('\n');
 
     // Check individual channels
@@ -247,7 +250,9 @@ void test_adc_validity(void) {
 //==========================================================================
 
 int main(void) {
-    // Initialize UART (assume this is done elsewhere)
+    uart_init(CPU_FREQ_HZ, UART_BAUD);
+    irq_global_enable();
+
     uart_puts("\n\n");
     uart_puts("=====================================\n");
     uart_puts(" Sigma-Delta ADC Test Program\n");
@@ -12,6 +12,18 @@
  * - Control frequency: 10 kHz (100 μs ISR)
  * - ADC: 4 channels (I_out, V_out, V_dc1, V_dc2)
  *
+ * Build with -DUSE_FIXED_POINT (make FIXED_POINT=1) to run the control ISR
+ * on Q15/Q31 integer arithmetic instead of soft-float. Add ZPEC=1 to run
+ * the fixed-point kernels on the Zpec custom instructions (zpec.h).
+ * -DUSE_MANUAL_PWM (make MANUAL_PWM=1) drives the two H-bridges from
+ * per-bridge CPU references that compensate unequal DC links.
+ * -DBENCHMARK (make bench) swaps main() for a cycles-per-call benchmark of
+ * the control kernels on the simulated core (benchmark.h).
+ *
+ * Everything outside the control ISR (soft-start ramp, fault monitor,
+ * status, console, telemetry) runs as task_sched.h tasks on the control
+ * timer tick, and the core sleeps in wfi between interrupts.
+ *
  * @author RV32IMZ Team
  * @date 2025-12-16
  */
@@ -19,6 +31,23 @@
 #include <stdint.h>
 #include <math.h>
 #include "memory_map.h"
+#include "pir_controller.h"
+#include "sine_nco.h"
+#include "zpec.h"
+#include "irq.h"
+#include "adc_fifo.h"
+#include "profile.h"
+#include "uart.h"
+#include "telemetry.h"
+#include "blackbox.h"
+#include "icache.h"
+#include "tcm.h"
+#include "perf_counters.h"
+#include "task_sched.h"
+#ifdef BENCHMARK
+#include "benchmark.h"
+#include "crc32.h"
+#endif
 // #include "pwm_registers.h"      // Using memory_map.h definitions
 // #include "adc_registers.h"      // Using memory_map.h definitions  
 // #include "protection_registers.h" // Using memory_map.h definitions
@@ -33,6 +62,7 @@
 #define OUTPUT_FREQ_HZ      50          // 50 Hz output frequency
 
 #define CONTROL_PERIOD_US   100         // 100 μs control period
+#define UART_BAUD           115200      // Console baud rate
 #define DEADTIME_US         2.0         // 2 μs dead-time
 #define DEADTIME_CYCLES     ((int)(DEADTIME_US * CPU_FREQ_HZ / 1000000))
 
@@ -54,11 +84,76 @@
 #define VOLTAGE_SCALE       50.0f       // Voltage divider ratio
 #define CURRENT_OFFSET      32768       // Bipolar current offset
 
+// Engineering units -> raw ADC codes, saturated to 16 bits. Constant
+// arguments fold at compile time, so the fixed-point build stays float-free.
+#define ADC_CODE_SAT(x)     ((x) <= 0 ? 0u : (x) >= 65535 ? 65535u : (uint32_t)(x))
+#define ADC_CODE_AMPS(a)    ADC_CODE_SAT(CURRENT_OFFSET + (a) * ADC_COUNTS / (ADC_VREF * CURRENT_SCALE))
+
+// Protection limits
+#define OCP_LIMIT_A         15.0f       // Overcurrent trip, either polarity
+
+// Per-unit bases for the fixed-point build (the value represented by 1.0)
+#define V_BASE              (ADC_VREF * VOLTAGE_SCALE)          // 165 V = full-scale voltage code
+#define I_BASE              (ADC_VREF * CURRENT_SCALE / 2.0f)   // 33 A = half-scale current code
+
+// Console logging: values go to uart_printf("%k") as 16.16 fixed point
+#ifdef BENCHMARK
+#define ISR_LOG_EVERY       0           // keep the console out of the timed path
+#else
+#define ISR_LOG_EVERY       1000        // control cycles per ISR log line (0 = off)
+#endif
+
+#ifdef USE_FIXED_POINT
+#define LOG_VOLTS(x)        ((int32_t)(x) * (int32_t)(2 * V_BASE))  // Q15 pu -> 16.16 V
+#define LOG_AMPS(x)         ((int32_t)(x) * (int32_t)(2 * I_BASE))  // Q15 pu -> 16.16 A
+#define LOG_MI(x)           ((int32_t)((x) >> 15))                  // Q31 -> 16.16
+#else
+#define LOG_VOLTS(x)        ((int32_t)((x) * 65536.0f))
+#define LOG_AMPS(x)         LOG_VOLTS(x)
+#define LOG_MI(x)           LOG_VOLTS(x)
+#endif
+
+// Waveform telemetry ('t' toggles): Q15 samples of V_ref, V_fb, I_fb, MI
+#define TELEMETRY_DECIMATION 8          // 10 kHz / 8 = 1.25 kS/s, fits 115200 baud
+
+#ifdef USE_FIXED_POINT
+#define TLM_VOLTS(x)        (x)
+#define TLM_AMPS(x)         (x)
+#define TLM_MI(x)           q31_to_q15(x)
+#else
+#define TLM_VOLTS(x)        q15_sat((int32_t)((x) * (32768.0f / V_BASE)))
+#define TLM_AMPS(x)         q15_sat((int32_t)((x) * (32768.0f / I_BASE)))
+#define TLM_MI(x)           q15_sat((int32_t)((x) * 32768.0f))
+#endif
+
 //=============================================================================
 // Global Variables
 //=============================================================================
 
 // Control System State
+#ifdef USE_FIXED_POINT
+typedef struct {
+    q15_t voltage_ref;          // Voltage reference (per-unit of V_BASE)
+    q15_t voltage_fb;           // Voltage feedback (per-unit of V_BASE)
+    q15_t current_fb;           // Current feedback (per-unit of I_BASE)
+    q15_t dc_voltage1;          // H-bridge 1 DC voltage (per-unit of V_BASE)
+    q15_t dc_voltage2;          // H-bridge 2 DC voltage (per-unit of V_BASE)
+    
+    // PI+R Controller State
+    pir_q_state_t pir;
+    
+    // Reference Generation
+    nco_t ref_nco;              // Output phase oscillator (2^32 = 2π)
+    q15_t amplitude;            // Output amplitude (per-unit of V_BASE)
+    
+    // Protection
+    uint32_t fault_flags;       // Fault status
+    
+    // Statistics
+    uint32_t control_count;     // Control loop counter
+    q15_t max_current;          // Peak current tracking (per-unit of I_BASE)
+} control_state_t;
+#else
 typedef struct {
     float voltage_ref;          // Voltage reference (V)
     float voltage_fb;           // Voltage feedback (V)
@@ -67,11 +162,10 @@ typedef struct {
     float dc_voltage2;          // H-bridge 2 DC voltage (V)
     
     // PI+R Controller State (Proportional-Integral + Resonant)
-    float integral;             // Integral accumulator
-    float resonant_x1, resonant_x2;  // Resonant filter states
+    pir_state_t pir;
     
     // Reference Generation
-    float phase;                // Output phase (radians)
+    nco_t ref_nco;              // Output phase oscillator (2^32 = 2π)
     float amplitude;            // Output amplitude (V)
     
     // Protection
@@ -81,11 +175,11 @@ typedef struct {
     uint32_t control_count;     // Control loop counter
     float max_current;          // Peak current tracking
 } control_state_t;
+#endif
 
-static control_state_t ctrl;
+FAST_DATA static control_state_t ctrl;
 
 // Pre-computed Look-up Tables
-// static float sin_table[256];           // Sine lookup table (unused in current impl)
 // static uint16_t level5_table[512];     // 5-level modulation table (unused)
 
 //=============================================================================
@@ -114,23 +208,19 @@ static control_state_t ctrl;
  * +0x18: STATUS    - Hardware status (read-only)
  * +0x1C: PWM_OUT   - Current PWM state (read-only)
  * +0x20: CPU_REF   - Manual reference (when in CPU mode)
+ * +0x24: BRIDGE1_REF - H-bridge 1 reference (CPU mode + BRIDGE_REF)
+ * +0x28: BRIDGE2_REF - H-bridge 2 reference (latched by CTRL.UPDATE)
  */
 
-// PWM Control Register Definitions
-#define PWM_CTRL_ENABLE     (1 << 0)   // Enable PWM generation
-#define PWM_CTRL_CPU_MODE   (1 << 1)   // 0=auto sine, 1=CPU reference
-
-// PWM register access macros
-#define PWM_REG(offset)     (*(volatile uint32_t*)(PWM_BASE + (offset)))
-#define PWM_CTRL            PWM_REG(0x00)
-#define PWM_FREQ_DIV        PWM_REG(0x04)  
-#define PWM_MOD_INDEX       PWM_REG(0x08)
-#define PWM_SINE_PHASE      PWM_REG(0x0C)
-#define PWM_SINE_FREQ       PWM_REG(0x10)
-#define PWM_DEADTIME        PWM_REG(0x14)
-#define PWM_STATUS          PWM_REG(0x18)
-#define PWM_OUT_STATE       PWM_REG(0x1C)
-#define PWM_CPU_REF         PWM_REG(0x20)
+// Registers and CTRL bits (PWM_CTRL_ENABLE, PWM_CTRL_CPU_MODE) come from
+// the generated register map in memory_map.h
+
+#ifdef USE_MANUAL_PWM
+#define DC_VOLTAGE_MIN      20.0f       // Below this a link is not compensated (V)
+
+// CTRL with the mode bits, so arming UPDATE is one store
+#define PWM_CTRL_BRIDGE_MODE (PWM_CTRL_ENABLE | PWM_CTRL_CPU_MODE | PWM_CTRL_BRIDGE_REF)
+#endif
 
 /**
  * @brief Initialize PWM Accelerator
@@ -145,20 +235,30 @@ void pwm_init(void) {
     
     // Calculate sine frequency increment for 50 Hz output
     // Formula: freq_increment = (f_out * 2^32) / f_clk
-    uint32_t sine_freq = (uint64_t)OUTPUT_FREQ_HZ * 65536 / CPU_FREQ_HZ;
+    uint32_t sine_freq = nco_freq_word(OUTPUT_FREQ_HZ, CPU_FREQ_HZ);
     
     // Configure PWM hardware
-    PWM_CTRL = 0;                           // Disable during setup
-    PWM_FREQ_DIV = freq_div;                // Set carrier frequency  
-    PWM_SINE_FREQ = sine_freq;              // Set output frequency
-    PWM_DEADTIME = DEADTIME_CYCLES;         // Configure dead-time
-    PWM_MOD_INDEX = 0;                      // Start with zero modulation
+    PWM->CTRL = 0;                          // Disable during setup
+    PWM->FREQ_DIV = freq_div;               // Set carrier frequency  
+    PWM->SINE_FREQ = sine_freq;             // Set output frequency
+    PWM->DEADTIME = DEADTIME_CYCLES;        // Configure dead-time
+    PWM->MOD_INDEX = 0;                     // Start with zero modulation
     
+#ifdef USE_MANUAL_PWM
+    // Per-bridge CPU references; the sine generator keeps running for the NCO
+    PWM->BRIDGE1_REF = 0;
+    PWM->BRIDGE2_REF = 0;
+    PWM->CTRL = PWM_CTRL_BRIDGE_MODE | PWM_CTRL_UPDATE;
+#else
     // Enable PWM in automatic sine mode
-    PWM_CTRL = PWM_CTRL_ENABLE;             // Hardware generates sine automatically
+    PWM->CTRL = PWM_CTRL_ENABLE;            // Hardware generates sine automatically
+#endif
     
-    // // printf("[PWM] Initialized: PWM=%d Hz, Output=%d Hz, Dead-time=%d cycles\\n", 
-    //        PWM_FREQ_HZ, OUTPUT_FREQ_HZ, DEADTIME_CYCLES);
+    // Lock the firmware reference to the hardware sine
+    nco_sync(&ctrl.ref_nco, PWM->SINE_PHASE, 0);
+    
+    uart_printf("[PWM] Initialized: PWM=%d Hz, Output=%d Hz, Dead-time=%d cycles\r\n",
+                PWM_FREQ_HZ, OUTPUT_FREQ_HZ, DEADTIME_CYCLES);
 }
 
 /**
@@ -179,43 +279,71 @@ void pwm_set_modulation(float modulation_index) {
     uint16_t mod_int = (uint16_t)(modulation_index * 65535.0f);
     
     // Write to hardware register - this immediately updates PWM generation
-    PWM_MOD_INDEX = mod_int;
+    PWM->MOD_INDEX = mod_int;
 }
 
+#ifdef USE_FIXED_POINT
+/**
+ * @brief Update PWM Modulation Index (fixed-point)
+ * 
+ * @param modulation_index: Q31, 0 to MAX_MODULATION (negative clamps to 0)
+ */
+FAST_TEXT void pwm_set_modulation_q31(q31_t modulation_index) {
+    if (modulation_index > Q31(MAX_MODULATION)) modulation_index = Q31(MAX_MODULATION);
+    
+    PWM->MOD_INDEX = q31_to_u16(modulation_index);
+}
+#endif
+
+#ifdef USE_MANUAL_PWM
+/**
+ * @brief Set the per-bridge references
+ * 
+ * Writes the BRIDGE1_REF/BRIDGE2_REF shadows and arms CTRL.UPDATE; the
+ * accelerator moves both to its comparators together at the next carrier
+ * sync, so a bridge never runs on a half-written pair.
+ * 
+ * @param ref1: H-bridge 1 (S1-S4) reference, Q15 (-1.0 to 1.0)
+ * @param ref2: H-bridge 2 (S5-S8) reference, Q15
+ */
+FAST_TEXT void pwm_set_bridge_refs(q15_t ref1, q15_t ref2) {
+    PWM->BRIDGE1_REF = (uint16_t)ref1;
+    PWM->BRIDGE2_REF = (uint16_t)ref2;
+    PWM->CTRL = PWM_CTRL_BRIDGE_MODE | PWM_CTRL_UPDATE;
+}
+#endif
+
 /**
  * @brief Read PWM Status
  * 
  * Monitor hardware PWM generation status and output states.
  */
 uint32_t pwm_get_status(void) {
-    return PWM_STATUS;  // Read carrier sync pulse and other status
+    return PWM->STATUS;  // Read carrier sync pulse and other status
 }
 
 uint8_t pwm_get_output_states(void) {
-    return (uint8_t)PWM_OUT_STATE;  // Current PWM output states
+    return (uint8_t)pwm_pwm_out_state_get(PWM->PWM_OUT);  // Current PWM output states
 }
 
 //=============================================================================
 // ADC Interface  
 //=============================================================================
 
-// ADC register definitions
-#define ADC_REG(offset)     (*(volatile uint32_t*)(ADC_BASE + (offset)))
-#define ADC_CTRL            ADC_REG(0x00)
-#define ADC_STATUS          ADC_REG(0x04)
-#define ADC_CH0_DATA        ADC_REG(0x08)   // Current
-#define ADC_CH1_DATA        ADC_REG(0x0C)   // Output voltage
-#define ADC_CH2_DATA        ADC_REG(0x10)   // DC voltage 1
-#define ADC_CH3_DATA        ADC_REG(0x14)   // DC voltage 2
+// ADC channel assignment
+#define ADC_CH_CURRENT      0   // Current sensor
+#define ADC_CH_VOLTAGE      1   // Output voltage
+#define ADC_CH_DC1          2   // DC voltage 1
+#define ADC_CH_DC2          3   // DC voltage 2
 
 void adc_init(void) {
-    // Enable all 4 ADC channels with sigma-delta filtering
-    ADC_CTRL = 0x0F;  // Enable channels 0-3
+    // Continuous FIFO mode; the ADC interrupt drains each frame in a burst
+    adc_fifo_init();
     
     // Wait for ADC to stabilize (sigma-delta needs time)
-    for (volatile int i = 0; i < 10000; i++);
+    delay_us(200);
     
-    ;
+    uart_puts("[ADC] Initialized: 4-channel FIFO burst mode\r\n");
 }
 
 /**
@@ -223,59 +351,218 @@ void adc_init(void) {
  * 
  * Reads current, voltage, and DC bus measurements simultaneously.
  * Uses sigma-delta ADC for excellent noise immunity in power electronics.
+ * The samples come from the newest FIFO frame captured by the ADC
+ * interrupt, so this never touches the ADC registers.
  */
-void adc_read_all(void) {
+FAST_TEXT void adc_read_all(void) {
     uint16_t raw[4];
     
-    // Read raw ADC values
-    raw[0] = (uint16_t)ADC_CH0_DATA;  // Current sensor
-    raw[1] = (uint16_t)ADC_CH1_DATA;  // Voltage sensor  
-    raw[2] = (uint16_t)ADC_CH2_DATA;  // DC bus 1
-    raw[3] = (uint16_t)ADC_CH3_DATA;  // DC bus 2
+    // Latest frame (no ISR nesting, so the four samples belong together)
+    raw[0] = adc_fifo_frame.raw[ADC_CH_CURRENT];
+    raw[1] = adc_fifo_frame.raw[ADC_CH_VOLTAGE];
+    raw[2] = adc_fifo_frame.raw[ADC_CH_DC1];
+    raw[3] = adc_fifo_frame.raw[ADC_CH_DC2];
     
+#ifdef USE_FIXED_POINT
+    // Convert to per-unit values (shifts and one subtract, no multiplies)
+    ctrl.current_fb = zpec_adc_bipolar(raw[0], CURRENT_OFFSET);
+    ctrl.voltage_fb = q15_from_adc_unipolar(raw[1]);
+    ctrl.dc_voltage1 = q15_from_adc_unipolar(raw[2]);
+    ctrl.dc_voltage2 = q15_from_adc_unipolar(raw[3]);
+#else
     // Convert to engineering units
     ctrl.current_fb = ((float)raw[0] - CURRENT_OFFSET) * ADC_VREF / ADC_COUNTS * CURRENT_SCALE;
     ctrl.voltage_fb = (float)raw[1] * ADC_VREF / ADC_COUNTS * VOLTAGE_SCALE;
     ctrl.dc_voltage1 = (float)raw[2] * ADC_VREF / ADC_COUNTS * VOLTAGE_SCALE;
     ctrl.dc_voltage2 = (float)raw[3] * ADC_VREF / ADC_COUNTS * VOLTAGE_SCALE;
+#endif
 }
 
 //=============================================================================
 // Protection System
 //=============================================================================
 
-// Protection register definitions  
-#define PROT_REG(offset)    (*(volatile uint32_t*)(PROT_BASE + (offset)))
-#define PROT_CTRL           PROT_REG(0x00)
-#define PROT_STATUS         PROT_REG(0x04)
-#define PROT_OC_LIMIT       PROT_REG(0x08)  // Overcurrent limit
-#define PROT_OV_LIMIT       PROT_REG(0x0C)  // Overvoltage limit
+/**
+ * @brief Window of raw ADC codes for one fast comparator
+ */
+static inline uint32_t prot_window(uint32_t low, uint32_t high) {
+    return prot_cmp0_window_high_set(prot_cmp0_window_low_set(0, low), high);
+}
+
+/**
+ * @brief Protection fault interrupt
+ * 
+ * The comparators have already gated the PWM in hardware; this only
+ * latches the status for control_isr() and the main loop. The status stays
+ * set until cleared, so the interrupt is re-armed by protection_rearm().
+ */
+FAST_TEXT static void protection_fault_isr(void) {
+    ctrl.fault_flags = PROT->STATUS;
+    PWM->CTRL = 0;
+    PROT->IRQ_EN = 0;
+}
 
-#define PROT_FLAG_OC        (1 << 0)        // Overcurrent fault
-#define PROT_FLAG_OV        (1 << 1)        // Overvoltage fault  
-#define PROT_FLAG_UV        (1 << 2)        // Undervoltage fault
-#define PROT_FLAG_OT        (1 << 3)        // Overtemperature fault
+/**
+ * @brief Re-enable the fault interrupt once STATUS is clear
+ */
+static void protection_rearm(void) {
+    PROT->IRQ_EN = PROT_STATUS_ANY;
+}
 
 void protection_init(void) {
-    // Set protection limits
-    PROT_OC_LIMIT = 15;     // 15A overcurrent limit
-    PROT_OV_LIMIT = 400;    // 400V overvoltage limit
+    // OCP_THRESHOLD/OVP_THRESHOLD stay 0 (off): every limit is a raw-code
+    // comparator window, in the ADC scaling above.
+    //
+    // Fast path: every decimated current sample against a raw-code window,
+    // PWM gated within two clocks of a trip. CMP1-3 (V_out, V_dc1, V_dc2)
+    // stay disabled: the voltage channels reach full scale at V_BASE
+    // (165 V), below the 170 V nominal DC link, so no code window tells an
+    // overvoltage from normal operation. There is no OVP until the voltage
+    // divider covers the DC link.
+    PROT->CMP0_WINDOW = prot_window(ADC_CODE_AMPS(-OCP_LIMIT_A), ADC_CODE_AMPS(OCP_LIMIT_A));
+    PROT->CMP_CTRL = prot_cmp_ctrl_en_set(0, 1u << ADC_CH_CURRENT);
     
     // Enable all protection functions
-    PROT_CTRL = 0x0F;       // Enable OC, OV, UV, OT protection
+    PROT->FAULT_MASK = PROT_STATUS_ANY;     // OCP, OVP, E-stop, watchdog
+    PROT->CTRL = PROT_CTRL_ENABLE;
+    
+    irq_register(IRQ_PROT, protection_fault_isr, NULL);
+    protection_rearm();
+    irq_enable(IRQ_PROT);
     
-    ;
+    uart_printf("[PROT] Initialized: OCP=15A (fast, codes %u-%u), no OVP (voltage full scale < DC link)\r\n",
+                ADC_CODE_AMPS(-OCP_LIMIT_A), ADC_CODE_AMPS(OCP_LIMIT_A));
 }
 
-uint32_t protection_check(void) {
-    ctrl.fault_flags = PROT_STATUS;
+FAST_TEXT uint32_t protection_check(void) {
+    ctrl.fault_flags = PROT->STATUS;
     return ctrl.fault_flags;
 }
 
+/**
+ * @brief Clear the latched faults and comparator trips
+ * 
+ * Conditions still present (E-stop, watchdog) latch again at once,
+ * so the returned STATUS is what is left after the clear.
+ */
+static inline uint32_t protection_clear(void) {
+    PROT->FAULT_CLEAR = PROT_STATUS_ANY | PROT_STATUS_CMP;
+    return protection_check();
+}
+
+/**
+ * @brief Latest current sample back inside the CMP0 window
+ * 
+ * A comparator only re-trips on the next ADC sample, so this is checked
+ * before the clear instead of relying on STATUS right after it.
+ */
+static inline int protection_current_ok(void) {
+    uint32_t code = adc_fifo_frame.raw[ADC_CH_CURRENT];
+    return code >= ADC_CODE_AMPS(-OCP_LIMIT_A) && code <= ADC_CODE_AMPS(OCP_LIMIT_A);
+}
+
 //=============================================================================
 // Control Algorithms
 //=============================================================================
 
+// Controller coefficients: computed by control_set_output_frequency(), never
+// in the ISR. In the fixed-point build the gains absorb V_BASE so a Q15
+// voltage error maps straight to a Q31 modulation index.
+#ifdef USE_FIXED_POINT
+FAST_DATA static pir_q_coeffs_t pir_coeffs;
+#else
+FAST_DATA static pir_coeffs_t pir_coeffs;
+#endif
+
+/**
+ * @brief Set Output Frequency
+ * 
+ * Recomputes the reference phase increment and retunes the resonant
+ * controller. Call at init and whenever the output frequency changes.
+ */
+void control_set_output_frequency(uint32_t freq_hz) {
+    nco_set_step(&ctrl.ref_nco, nco_freq_word(freq_hz, CONTROL_FREQ_HZ));
+#ifdef USE_FIXED_POINT
+    pir_q_set_frequency(&pir_coeffs, freq_hz, CONTROL_FREQ_HZ);
+#else
+    pir_set_frequency(&pir_coeffs, (float)freq_hz, CONTROL_FREQ_HZ);
+#endif
+}
+
+/**
+ * @brief Initialize Controller Coefficients
+ */
+void control_design(void) {
+#ifdef USE_FIXED_POINT
+    pir_q_design(&pir_coeffs, QGAIN(KP_VOLTAGE * V_BASE), QGAIN(KI_VOLTAGE * V_BASE),
+                 QGAIN(KR_VOLTAGE * V_BASE), Q31(MAX_MODULATION),
+                 OUTPUT_FREQ_HZ, CONTROL_FREQ_HZ);
+#else
+    pir_design(&pir_coeffs, KP_VOLTAGE, KI_VOLTAGE, KR_VOLTAGE, MAX_MODULATION,
+               OUTPUT_FREQ_HZ, CONTROL_FREQ_HZ);
+#endif
+    control_set_output_frequency(OUTPUT_FREQ_HZ);
+}
+
+/**
+ * @brief Advance the Reference Phase
+ * 
+ * Steps the firmware oscillator and, once per fundamental period, re-locks
+ * it to the PWM accelerator's SINE_PHASE so rounding differences between
+ * the two phase increments cannot accumulate into drift.
+ */
+static inline void reference_advance_phase(void) {
+    uint32_t prev = ctrl.ref_nco.phase;
+    if (nco_advance(&ctrl.ref_nco) < prev) {
+        nco_sync(&ctrl.ref_nco, PWM->SINE_PHASE, 0);
+    }
+}
+
+#ifdef USE_FIXED_POINT
+/**
+ * @brief 5-Level Modulation Strategy (fixed-point)
+ * 
+ * Same strategy as the float version: both H-bridges share one modulation
+ * index and the PWM accelerator generates the phase-shifted carriers.
+ */
+FAST_TEXT void calculate_5level_modulation_q31(q31_t mi_ref) {
+#ifdef USE_MANUAL_PWM
+    // Each bridge delivers half of mi * sin * (V_dc1 + V_dc2); the bridge on
+    // the lower link gets the larger reference
+    q31_t mi = q31_abs(mi_ref);
+    if (mi > Q31(MAX_MODULATION)) mi = Q31(MAX_MODULATION);
+    q15_t ref = zpec_mulq15(q31_to_q15(mi), zpec_sin(ctrl.ref_nco.phase));
+    
+    int32_t half_sum = ((int32_t)ctrl.dc_voltage1 + ctrl.dc_voltage2) >> 1;
+    q15_t ref1 = ref, ref2 = ref;
+    if (ctrl.dc_voltage1 > Q15(DC_VOLTAGE_MIN / V_BASE)) {
+        ref1 = q15_sat((int32_t)ref * half_sum / ctrl.dc_voltage1);
+    }
+    if (ctrl.dc_voltage2 > Q15(DC_VOLTAGE_MIN / V_BASE)) {
+        ref2 = q15_sat((int32_t)ref * half_sum / ctrl.dc_voltage2);
+    }
+    pwm_set_bridge_refs(ref1, ref2);
+#else
+    pwm_set_modulation_q31(q31_abs(mi_ref));
+#endif
+}
+
+/**
+ * @brief Generate Reference Signal (fixed-point)
+ * 
+ * 32-bit phase accumulator; wraps at 2π for free.
+ */
+FAST_TEXT void generate_reference_q15(void) {
+    reference_advance_phase();
+    
+    // 70% of the average DC bus for safety margin
+    q15_t avg_dc = (q15_t)(((int32_t)ctrl.dc_voltage1 + ctrl.dc_voltage2) >> 1);
+    ctrl.amplitude = zpec_mulq15(avg_dc, Q15(0.7));
+    
+    ctrl.voltage_ref = zpec_mulq15(ctrl.amplitude, zpec_sin(ctrl.ref_nco.phase));
+}
+#else
+
 /**
  * @brief PI + Resonant Controller
  * 
@@ -284,40 +571,12 @@ uint32_t protection_check(void) {
  * error at the fundamental frequency (50 Hz).
  * 
  * Transfer function: G(s) = Kp + Ki/s + Kr*s/(s² + ωr²)
+ * 
+ * Coefficients (Ki·T, 2·cos(ωr·T)) come from control_design(); the state
+ * lives in ctrl.pir so the controller can be reset and inspected.
  */
-float pi_resonant_controller(float reference, float feedback, float dt) {
-    static float integral = 0.0f;
-    static float resonant_x1 = 0.0f, resonant_x2 = 0.0f;
-    
-    // Error calculation
-    float error = reference - feedback;
-    
-    // Proportional term
-    float proportional = KP_VOLTAGE * error;
-    
-    // Integral term with anti-windup
-    integral += KI_VOLTAGE * error * dt;
-    if (integral > MAX_MODULATION) integral = MAX_MODULATION;
-    if (integral < -MAX_MODULATION) integral = -MAX_MODULATION;
-    
-    // Resonant term (digital implementation of resonator)
-    // Discretized using Tustin's method: s = 2/T * (1-z^-1)/(1+z^-1)
-    float omega_dt = OMEGA_R * dt;
-    float cos_omega_dt = cosf(omega_dt);
-    // float sin_omega_dt = sinf(omega_dt);  // Unused in current implementation
-    
-    float resonant_new = 2.0f * cos_omega_dt * resonant_x1 - resonant_x2 + KR_VOLTAGE * error;
-    resonant_x2 = resonant_x1;
-    resonant_x1 = resonant_new;
-    
-    // Combine all terms
-    float output = proportional + integral + resonant_new;
-    
-    // Clamp output
-    if (output > MAX_MODULATION) output = MAX_MODULATION;
-    if (output < -MAX_MODULATION) output = -MAX_MODULATION;
-    
-    return output;
+float pi_resonant_controller(float reference, float feedback) {
+    return pir_step(&pir_coeffs, &ctrl.pir, reference - feedback);
 }
 
 /**
@@ -333,37 +592,25 @@ void calculate_5level_modulation(float mi_ref) {
     float mi = fabsf(mi_ref);
     if (mi > MAX_MODULATION) mi = MAX_MODULATION;
     
+#ifdef USE_MANUAL_PWM
+    // DC-link imbalance compensation: each bridge delivers half of
+    // mi * sin * (V_dc1 + V_dc2), so the bridge on the lower link gets the
+    // larger reference and the output stays symmetric. Carrier comparison
+    // and dead-time stay in the accelerator.
+    float ref = mi * (sine_lut_q15(ctrl.ref_nco.phase) * (1.0f / 32768.0f));
+    float half_sum = 0.5f * (ctrl.dc_voltage1 + ctrl.dc_voltage2);
+    float ref1 = ref, ref2 = ref;
+    if (ctrl.dc_voltage1 > DC_VOLTAGE_MIN) ref1 = ref * half_sum / ctrl.dc_voltage1;
+    if (ctrl.dc_voltage2 > DC_VOLTAGE_MIN) ref2 = ref * half_sum / ctrl.dc_voltage2;
+    
+    pwm_set_bridge_refs(q15_sat((int32_t)(ref1 * 32768.0f)), q15_sat((int32_t)(ref2 * 32768.0f)));
+#else
     // For 5-level CHB with 2 H-bridges, use simple strategy:
     // Both H-bridges use the same modulation index
     // Hardware PWM accelerator handles the phase-shifted carriers
     
     pwm_set_modulation(mi);
-    
-    // Optional: Manual PWM mode for advanced algorithms
-    #ifdef USE_MANUAL_PWM
-    // Calculate individual duty cycles if needed
-    float duties[8];
-    
-    // Sine reference for current time
-    float sine_ref = sinf(ctrl.phase);
-    
-    // Compare with 4 phase-shifted carriers (done in hardware normally)
-    for (int i = 0; i < 4; i++) {
-        float carrier_offset = (float)i / 4.0f - 0.5f;  // -0.5 to +0.5
-        float carrier_level = carrier_offset * 2.0f;     // -1 to +1
-        
-        if (mi * sine_ref > carrier_level) {
-            duties[2*i] = 1.0f;     // High-side switch ON
-            duties[2*i+1] = 0.0f;   // Low-side switch OFF  
-        } else {
-            duties[2*i] = 0.0f;     // High-side switch OFF
-            duties[2*i+1] = 1.0f;   // Low-side switch ON
-        }
-    }
-    
-    // Apply dead-time (done in hardware normally)
-    // ... dead-time logic would go here
-    #endif
+#endif
 }
 
 /**
@@ -373,59 +620,123 @@ void calculate_5level_modulation(float mi_ref) {
  */
 void generate_reference(void) {
     // Update phase
-    ctrl.phase += 2.0f * M_PI * OUTPUT_FREQ_HZ / CONTROL_FREQ_HZ;
-    if (ctrl.phase >= 2.0f * M_PI) ctrl.phase -= 2.0f * M_PI;
+    reference_advance_phase();
     
     // Calculate reference voltage amplitude based on DC bus
     float avg_dc = (ctrl.dc_voltage1 + ctrl.dc_voltage2) / 2.0f;
     ctrl.amplitude = avg_dc * 0.7f;  // 70% of DC bus for safety margin
     
     // Generate sinusoidal reference
-    ctrl.voltage_ref = ctrl.amplitude * sinf(ctrl.phase);
+    ctrl.voltage_ref = ctrl.amplitude * (sine_lut_q15(ctrl.ref_nco.phase) * (1.0f / 32768.0f));
 }
+#endif // USE_FIXED_POINT
 
 //=============================================================================
 // Main Control Loop (Interrupt Service Routine)
 //=============================================================================
 
+// Profiler stages of control_isr(), in execution order
+enum {
+    STAGE_ADC,
+    STAGE_PROTECTION,
+    STAGE_REFERENCE,
+    STAGE_FILTER,
+    STAGE_CONTROLLER,
+    STAGE_MODULATION,
+    STAGE_STATISTICS,
+    STAGE_COUNT
+};
+
+static const char* const stage_names[STAGE_COUNT] = {
+    "adc", "protection", "reference", "filter",
+    "controller", "modulation", "statistics"
+};
+
 /**
  * @brief Main Control ISR - Called Every 100 μs (10 kHz)
  * 
  * This is the heart of the control system. It must complete within 50 μs
  * to maintain real-time performance (50% CPU usage limit).
  * 
- * Execution Time Breakdown (with M-extension):
- * 1. ADC reading:          0.4 μs
- * 2. Engineering units:    4.0 μs  
- * 3. Digital filtering:    8.0 μs
- * 4. Safety checks:        3.0 μs
- * 5. Reference generation: 4.2 μs
- * 6. PI+R controller:      12.0 μs
- * 7. 5-level modulation:   8.0 μs
- * 8. PWM update:           0.6 μs
- * 9. Logging:              2.0 μs
- * TOTAL:                   42.2 μs (84% of budget) ✅
+ * Stage timing is measured, not estimated: build with PROFILE=1 and send
+ * 'p' on the console for per-stage min/max/mean cycles and histograms,
+ * plus the timer IRQ entry latency, duration and deadline misses
+ * ('r' clears the statistics).
+ * 
+ * 't' toggles binary waveform streaming (telemetry.h); capture it with
+ * tools/telemetry_decode.py --scale 165,165,33,1.
+ * 
+ * The black box (blackbox.h) keeps the last BLACKBOX_DEPTH cycles and
+ * freezes shortly after a protection trip: 'b' dumps it, 'c' re-arms.
  */
-void control_isr(void) {
+FAST_TEXT void control_isr(void) {
+#if ISR_LOG_EVERY != 0
     static uint32_t isr_count = 0;
-    static float dt = 1.0f / CONTROL_FREQ_HZ;  // 100 μs
+#endif
+    static int16_t last_mi = 0;         // Previous cycle's MI for the black box
+    
+    profile_start();
     
-    // 1. Read feedback sensors (0.4 μs)
+    // 1. Read feedback sensors
     adc_read_all();
+    profile_mark(STAGE_ADC);
     
-    // 2. Check protection system (0.2 μs)
-    uint32_t faults = protection_check();
+    // 2. Check protection system: the comparators trip the PWM in hardware
+    // and protection_fault_isr() latches the status, so no MMIO read here
+    uint32_t faults = ctrl.fault_flags;
+    
+    // Black box: raw ADC codes, reference, last MI, faults and cycle stamp
+    blackbox_record(adc_fifo_frame.raw[0] | ((uint32_t)adc_fifo_frame.raw[1] << 16),
+                    adc_fifo_frame.raw[2] | ((uint32_t)adc_fifo_frame.raw[3] << 16),
+                    (uint16_t)TLM_VOLTS(ctrl.voltage_ref) | ((uint32_t)(uint16_t)last_mi << 16),
+                    (faults & 0xFFFF) | (ctrl.control_count << 16));
+    profile_mark(STAGE_PROTECTION);
     if (faults != 0) {
         // Emergency shutdown - disable PWM immediately
-        PWM_CTRL = 0;  // Hardware disables all PWM outputs
-        ctrl.fault_flags = faults;
+        PWM->CTRL = 0;  // Hardware disables all PWM outputs
+        blackbox_trigger(faults);
         return;  // Exit ISR immediately
     }
     
-    // 3. Generate reference signal (4.2 μs)
+#ifdef USE_FIXED_POINT
+    // 3. Generate reference signal
+    generate_reference_q15();
+    profile_mark(STAGE_REFERENCE);
+    
+    // 4. Digital filtering (optional, alpha = 1/8 as a shift)
+    #ifdef USE_DIGITAL_FILTERS
+    static q15_t voltage_filt = 0;
+    static q15_t current_filt = 0;
+    
+    voltage_filt += (q15_t)(((int32_t)ctrl.voltage_fb - voltage_filt) >> 3);
+    current_filt += (q15_t)(((int32_t)ctrl.current_fb - current_filt) >> 3);
+    
+    ctrl.voltage_fb = voltage_filt;
+    ctrl.current_fb = current_filt;
+    #endif
+    profile_mark(STAGE_FILTER);
+    
+    // 5. Run voltage controller
+    q31_t modulation_index = pir_q_step(&pir_coeffs, &ctrl.pir,
+                                        q15_sub(ctrl.voltage_ref, ctrl.voltage_fb));
+    profile_mark(STAGE_CONTROLLER);
+    
+    // 6. Apply 5-level modulation
+    calculate_5level_modulation_q31(modulation_index);
+    profile_mark(STAGE_MODULATION);
+    
+    // 7. Update statistics
+    ctrl.control_count++;
+    if (q15_abs(ctrl.current_fb) > ctrl.max_current) {
+        ctrl.max_current = q15_abs(ctrl.current_fb);
+    }
+    profile_mark(STAGE_STATISTICS);
+#else
+    // 3. Generate reference signal
     generate_reference();
+    profile_mark(STAGE_REFERENCE);
     
-    // 4. Digital filtering (optional - adds 8 μs)
+    // 4. Digital filtering (optional)
     #ifdef USE_DIGITAL_FILTERS
     // Low-pass filter for noise reduction
     static float voltage_filt = 0.0f;
@@ -438,26 +749,59 @@ void control_isr(void) {
     ctrl.voltage_fb = voltage_filt;
     ctrl.current_fb = current_filt;
     #endif
+    profile_mark(STAGE_FILTER);
     
-    // 5. Run voltage controller (12.0 μs)
-    float modulation_index = pi_resonant_controller(ctrl.voltage_ref, ctrl.voltage_fb, dt);
+    // 5. Run voltage controller
+    float modulation_index = pi_resonant_controller(ctrl.voltage_ref, ctrl.voltage_fb);
+    profile_mark(STAGE_CONTROLLER);
     
-    // 6. Apply 5-level modulation (8.0 μs)  
+    // 6. Apply 5-level modulation
     calculate_5level_modulation(modulation_index);
+    profile_mark(STAGE_MODULATION);
     
-    // 7. Update statistics (1.0 μs)
+    // 7. Update statistics
     ctrl.control_count++;
     if (fabsf(ctrl.current_fb) > ctrl.max_current) {
         ctrl.max_current = fabsf(ctrl.current_fb);
     }
+    profile_mark(STAGE_STATISTICS);
+#endif
     
-    // 8. Periodic logging (2.0 μs average, every 10th cycle)
-    if ((isr_count % 10) == 0) {
-        // printf("V_ref=%.1f V_fb=%.1f I_fb=%.2f MI=%.3f\\n", 
-               ctrl.voltage_ref, ctrl.voltage_fb, ctrl.current_fb, modulation_index);
-    }
+    // 8. Waveform telemetry: a few stores, the main loop does the framing
+    last_mi = TLM_MI(modulation_index);
+    telemetry_push(TLM_VOLTS(ctrl.voltage_ref), TLM_VOLTS(ctrl.voltage_fb),
+                   TLM_AMPS(ctrl.current_fb), last_mi);
     
-    isr_count++;
+    // 9. Periodic logging: queued for the UART IRQ, dropped if the ring is full
+#if ISR_LOG_EVERY != 0
+    if (++isr_count >= ISR_LOG_EVERY) {
+        isr_count = 0;
+        uart_printf("V_ref=%.1k V_fb=%.1k I_fb=%.2k MI=%.3k\r\n",
+                    LOG_VOLTS(ctrl.voltage_ref), LOG_VOLTS(ctrl.voltage_fb),
+                    LOG_AMPS(ctrl.current_fb), LOG_MI(modulation_index));
+    }
+#endif
+}
+
+/**
+ * @brief Control Timer Interrupt
+ * 
+ * Dispatched from trap.S/irq.c on the machine timer interrupt.
+ */
+FAST_TEXT static void control_timer_isr(void) {
+    TIMER->STATUS = TIMER_STATUS_MATCH;     // Clear compare match (write 1 to clear)
+    control_isr();
+    sched_tick();                           // Background task time base
+}
+
+/**
+ * @brief Cycles Since the Last Compare Match
+ * 
+ * COUNT restarts from zero at every match and the prescaler is 1,
+ * so it is a timestamp of the interrupt event.
+ */
+FAST_TEXT static uint32_t control_timer_latency(void) {
+    return TIMER->COUNT;
 }
 
 /**
@@ -466,138 +810,273 @@ void control_isr(void) {
  * Configures timer to generate interrupts every 100 μs for the control loop.
  */
 void timer_init(void) {
-    // Timer register definitions
-    #define TIMER_REG(offset)   (*(volatile uint32_t*)(TIMER_BASE + (offset)))
-    #define TIMER_CTRL          TIMER_REG(0x00)
-    #define TIMER_RELOAD        TIMER_REG(0x04)
-    #define TIMER_VALUE         TIMER_REG(0x08)
-    #define TIMER_STATUS        TIMER_REG(0x0C)
-    
-    // Calculate timer reload value for 10 kHz (100 μs period)
-    uint32_t reload_val = CPU_FREQ_HZ / CONTROL_FREQ_HZ - 1;
+    // Calculate compare value for 10 kHz (100 μs period)
+    uint32_t period = CPU_FREQ_HZ / CONTROL_FREQ_HZ - 1;
     
     // Configure timer
-    TIMER_CTRL = 0;             // Disable during setup
-    TIMER_RELOAD = reload_val;  // Set period
-    TIMER_VALUE = reload_val;   // Initial value
+    TIMER->CTRL = 0;            // Disable during setup
+    TIMER->PRESCALER = 0;       // Count CPU clocks
+    TIMER->COUNT = 0;
+    TIMER->COMPARE = period;    // Set period
+    TIMER->IRQ_EN = TIMER_IRQ_EN_MATCH;
     
-    // Enable timer with interrupt
-    TIMER_CTRL = 0x03;          // Enable timer and interrupt
+    // Route the interrupt to the control loop, budget = one control period
+    irq_register(IRQ_TIMER, control_timer_isr, control_timer_latency);
+    irq_set_deadline(IRQ_TIMER, CPU_FREQ_HZ / CONTROL_FREQ_HZ);
+    irq_enable(IRQ_TIMER);
     
-    ;
+    // Enable timer with auto-reload and interrupt
+    TIMER->CTRL = TIMER_CTRL_ENABLE | TIMER_CTRL_IRQ_EN | TIMER_CTRL_AUTO;
 }
 
 //=============================================================================
 // System Initialization
 //=============================================================================
 
-void system_init(void) {
-    ;
-    // printf("CPU: %d MHz, PWM: %d Hz, Control: %d Hz\\n", 
-           CPU_FREQ_HZ/1000000, PWM_FREQ_HZ, CONTROL_FREQ_HZ);
-    
-    // Initialize control state
+static void control_state_init(void) {
+#ifdef USE_FIXED_POINT
+    ctrl.voltage_ref = 0;
+    ctrl.voltage_fb = 0;
+    ctrl.current_fb = 0;
+    ctrl.dc_voltage1 = Q15(DC_VOLTAGE_NOMINAL / V_BASE);
+    ctrl.dc_voltage2 = Q15(DC_VOLTAGE_NOMINAL / V_BASE);
+    pir_q_reset(&ctrl.pir);
+    nco_init(&ctrl.ref_nco, 0);
+    ctrl.amplitude = Q15(120.0 / V_BASE);  // 120V RMS target
+    ctrl.fault_flags = 0;
+    ctrl.control_count = 0;
+    ctrl.max_current = 0;
+#else
     ctrl.voltage_ref = 0.0f;
     ctrl.voltage_fb = 0.0f; 
     ctrl.current_fb = 0.0f;
     ctrl.dc_voltage1 = DC_VOLTAGE_NOMINAL;
     ctrl.dc_voltage2 = DC_VOLTAGE_NOMINAL;
-    ctrl.integral = 0.0f;
-    ctrl.resonant_x1 = 0.0f;
-    ctrl.resonant_x2 = 0.0f;
-    ctrl.phase = 0.0f;
+    pir_reset(&ctrl.pir);
+    nco_init(&ctrl.ref_nco, 0);
     ctrl.amplitude = 120.0f;  // 120V RMS target
     ctrl.fault_flags = 0;
     ctrl.control_count = 0;
     ctrl.max_current = 0.0f;
+#endif
+}
+
+void system_init(void) {
+    // Initialize control state
+    control_state_init();
+    
+    // Cache ROM fetches before anything is timed (reset leaves it disabled)
+    icache_enable();
+    control_design();
+    profile_init(stage_names, STAGE_COUNT);
+    telemetry_init(TELEMETRY_DECIMATION);
     
     // Initialize hardware peripherals
+    uart_init(CPU_FREQ_HZ, UART_BAUD);
+    uart_printf("CPU: %d MHz, PWM: %d Hz, Control: %d Hz\r\n",
+                CPU_FREQ_HZ / 1000000, PWM_FREQ_HZ, CONTROL_FREQ_HZ);
     protection_init();      // Must be first for safety
     adc_init();            // Initialize sensors
     pwm_init();            // Initialize PWM generation
+    sched_init_tick(CONTROL_FREQ_HZ);   // Tasks count control periods
     timer_init();          // Start control loop timer
     
-    // Enable global interrupts (RISC-V CSR)
-    asm volatile("csrsi mstatus, 0x8");  // Set MIE bit
-    asm volatile("csrwi mie, 0x80");     // Enable timer interrupt
-    
-    ;
+    // Enable global interrupts (mtvec is installed by startup.S)
+    irq_global_enable();
 }
 
 /**
  * @brief Soft-Start Sequence
  * 
- * Gradually increases output voltage to prevent inrush current.
+ * Gradually increases output voltage to prevent inrush current. The ramp
+ * is a task that raises the amplitude one step every 10 ms; a fault stops
+ * it from fault_monitor_task().
  */
-void soft_start(void) {
-    // printf("[SOFT-START] Ramping output from 0V to %.0fV over 2 seconds\\n", 
-           ctrl.amplitude);
-    
-    float target_amplitude = ctrl.amplitude;
+#define SOFT_START_STEPS    200         // 200 x 10 ms = 2 s
+
+static struct {
+#ifdef USE_FIXED_POINT
+    q15_t target;
+#else
+    float target;
+#endif
+    int step;
+    sched_task_id_t task;
+} ramp = { .task = -1 };
+
+static uint32_t soft_start_task(void* arg) {
+    (void)arg;
     
-    // Ramp from 0 to full amplitude over 2 seconds
-    for (int i = 0; i <= 200; i++) {
-        ctrl.amplitude = target_amplitude * (float)i / 200.0f;
-        
-        // Wait 10ms
-        for (volatile int j = 0; j < 500000; j++);
-        
-        // Check for faults during soft-start
-        if (protection_check() != 0) {
-            // printf("[FAULT] Soft-start aborted due to protection fault: 0x%08x\\n", 
-                   ctrl.fault_flags);
-            PWM_CTRL = 0;  // Disable PWM
-            return;
-        }
+    if (ramp.step >= SOFT_START_STEPS) {
+        ctrl.amplitude = ramp.target;
+        uart_puts("[SOFT-START] Complete\r\n");
+        return SCHED_STOP;
     }
     
-    ctrl.amplitude = target_amplitude;
-    ;
+    ramp.step++;
+#ifdef USE_FIXED_POINT
+    ctrl.amplitude = (q15_t)((int32_t)ramp.target * ramp.step / SOFT_START_STEPS);
+#else
+    ctrl.amplitude = ramp.target * (float)ramp.step / (float)SOFT_START_STEPS;
+#endif
+    return sched_ms(10);
+}
+
+void soft_start(void) {
+    uart_printf("[SOFT-START] Ramping output from 0V to %.0kV over 2 seconds\r\n",
+                LOG_VOLTS(ctrl.amplitude));
+    
+    ramp.target = ctrl.amplitude;
+    ramp.step = 0;
+#ifdef USE_FIXED_POINT
+    ctrl.amplitude = 0;
+#else
+    ctrl.amplitude = 0.0f;
+#endif
+    ramp.task = sched_add(soft_start_task, NULL, 0);
 }
 
+/**
+ * @brief Black-box entry as CSV: cycle,i,v,dc1,dc2 (ADC codes),v_ref,mi (Q15),faults,count
+ */
+static void blackbox_print(int32_t rel, const blackbox_entry_t* e) {
+    uart_printf("%d,%u,%u,%u,%u,%d,%d,%x,%u\r\n", rel,
+                e->w[0] & 0xFFFF, e->w[0] >> 16, e->w[1] & 0xFFFF, e->w[1] >> 16,
+                (int16_t)e->w[2], (int16_t)(e->w[2] >> 16), e->w[3] & 0xFFFF, e->w[3] >> 16);
+}
+
+#ifdef BENCHMARK
 //=============================================================================
-// Main Application
+// Benchmark (make bench)
 //=============================================================================
 
+#define BENCH_CALLS         1000        // calls per kernel
+
+volatile uint32_t tohost;
+static volatile uint32_t bench_crc_sink;
+
+// One bootloader image check: CRC32 over the whole 16 KB application region
+static void bench_crc32_app(void) {
+    bench_crc_sink = crc32((const uint8_t*)APP_BASE, APP_SIZE);
+}
+
+/**
+ * @brief Time the control kernels instead of running the inverter
+ *
+ * Only the state and the console are initialised: no peripheral is
+ * started, so the ISR runs on a fixed mid-scale ADC frame with no faults.
+ */
 int main(void) {
-    // Initialize system
-    system_init();
+    control_state_init();
+    icache_enable();
+    control_design();
+    telemetry_init(TELEMETRY_DECIMATION);
+    uart_init(CPU_FREQ_HZ, UART_BAUD);
+    irq_global_enable();
     
-    // Run soft-start sequence
-    soft_start();
+    adc_fifo_frame.raw[ADC_CH_CURRENT] = CURRENT_OFFSET;
+    adc_fifo_frame.raw[ADC_CH_VOLTAGE] = ADC_COUNTS / 2;
+    adc_fifo_frame.raw[ADC_CH_DC1] = ADC_COUNTS / 2;
+    adc_fifo_frame.raw[ADC_CH_DC2] = ADC_COUNTS / 2;
     
-    // Main loop - monitor system and handle faults
-    while (1) {
-        // Check for faults every 1ms
+#ifdef USE_FIXED_POINT
+    uart_puts("BENCH variant=fixed\r\n");
+#else
+    uart_puts("BENCH variant=float\r\n");
+#endif
+    bench_run("adc_read_all", adc_read_all, BENCH_CALLS);
+    bench_run("control_isr", control_isr, BENCH_CALLS);
+    bench_run("crc32_16k", bench_crc32_app, 4);
+    bench_exit(0);
+}
+
+#else
+//=============================================================================
+// Main Application
+//=============================================================================
+
+/**
+ * @brief Fault monitor (1 ms)
+ * 
+ * The comparators and protection_fault_isr() have already stopped the
+ * PWM; this reports the fault, clears the latches once the measurements
+ * are back in range and restarts when nothing latches again.
+ */
+static uint32_t fault_monitor_task(void* arg) {
+    (void)arg;
+    static int faulted = 0;
+    
+    if (!faulted) {
         if (protection_check() != 0) {
-            ;
-            
-            // Disable PWM
-            PWM_CTRL = 0;
-            
-            // Wait for fault to clear
-            while (protection_check() != 0) {
-                for (volatile int i = 0; i < 50000; i++);  // 1ms delay
+            if (sched_active(ramp.task)) {
+                sched_cancel(ramp.task);
+                uart_printf("[FAULT] Soft-start aborted due to protection fault: 0x%08x\r\n",
+                            ctrl.fault_flags);
             }
+            uart_printf("[FAULT] Protection fault 0x%08x, PWM disabled ('b' dumps the black box)\r\n",
+                        ctrl.fault_flags);
             
-            ;
-            
-            // Restart system
-            soft_start();
-        }
-        
-        // Print status every 1 second
-        static uint32_t status_count = 0;
-        if ((status_count % 1000) == 0) {
-            // printf("[STATUS] Count=%u Vout=%.1f Iout=%.2f MaxI=%.2f PWM=0x%02x\\n",
-                   ctrl.control_count, ctrl.voltage_fb, ctrl.current_fb, 
-                   ctrl.max_current, pwm_get_output_states());
+            // Disable PWM
+            PWM->CTRL = 0;
+            faulted = 1;
         }
-        status_count++;
+    } else if (protection_current_ok() && protection_clear() == 0) {
+        uart_puts("[FAULT] Cleared, restarting\r\n");
+        protection_rearm();
+        faulted = 0;
         
-        // Main loop delay (1ms)
-        for (volatile int i = 0; i < 50000; i++);
+        // Restart system
+        soft_start();
+    }
+    return sched_ms(1);
+}
+
+/**
+ * @brief Status line (1 s)
+ */
+static uint32_t status_task(void* arg) {
+    (void)arg;
+    uart_printf("[STATUS] Count=%u Vout=%.1k Iout=%.2k MaxI=%.2k PWM=0x%02x Idle=%u%%\r\n",
+                ctrl.control_count, LOG_VOLTS(ctrl.voltage_fb), LOG_AMPS(ctrl.current_fb),
+                LOG_AMPS(ctrl.max_current), pwm_get_output_states(), sched_idle_percent());
+    return sched_ms(1000);
+}
+
+/**
+ * @brief Console commands and telemetry streaming (1 ms)
+ */
+static uint32_t console_task(void* arg) {
+    (void)arg;
+    
+    int cmd = uart_getc_nonblock();
+    if (cmd == 'p') {
+        profile_dump();
+    } else if (cmd == 'r') {
+        profile_reset();
+    } else if (cmd == 't') {
+        telemetry_enable(!telemetry.enabled);
+    } else if (cmd == 'b') {
+        blackbox_dump(blackbox_print);
+    } else if (cmd == 'c') {
+        blackbox_rearm();
     }
     
-    return 0;
-}
\ No newline at end of file
+    // Stream queued waveform samples
+    telemetry_poll();
+    return sched_ms(1);
+}
+
+int main(void) {
+    // Initialize system
+    system_init();
+    
+    // Run soft-start sequence
+    soft_start();
+    
+    // Background tasks; the core sleeps between control ticks
+    sched_add(fault_monitor_task, NULL, 0);
+    sched_add(status_task, NULL, 0);
+    sched_add(console_task, NULL, 0);
+    sched_run();
+}
+#endif // BENCHMARK
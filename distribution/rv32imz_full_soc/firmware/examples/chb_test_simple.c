@@ -11,30 +11,19 @@
 
 #include <stdint.h>
 #include "memory_map.h"
+#include "irq.h"
+#include "uart.h"
+#include "perf_counters.h"
+
+#define CPU_FREQ_HZ     50000000
+#define UART_BAUD       115200
 
 //=============================================================================
 // Simple Hardware Control Functions  
 //=============================================================================
 
-static void delay(uint32_t cycles) {
-    for (volatile uint32_t i = 0; i < cycles; i++) {
-        __asm__ volatile("nop");
-    }
-}
-
-static void uart_putc(char c) {
-    while (!(*(volatile uint32_t*)(UART_BASE + 4) & 0x02));  // Wait for TX empty
-    *(volatile uint32_t*)(UART_BASE + 0) = c;
-}
-
-static void uart_puts(const char* str) {
-    while (*str) {
-        uart_putc(*str++);
-    }
-}
-
 static void gpio_set_led(uint8_t led_mask) {
-    *(volatile uint32_t*)(GPIO_BASE + 0x04) = led_mask;  // GPIO OUTPUT register
+    GPIO->DATA_OUT = led_mask;
 }
 
 //=============================================================================
@@ -42,6 +31,10 @@ static void gpio_set_led(uint8_t led_mask) {
 //=============================================================================
 
 int main(void) {
+    // Console: interrupt-driven, same settings as the bootloader
+    uart_init(CPU_FREQ_HZ, UART_BAUD);
+    irq_global_enable();
+    
     // System banner
     uart_puts("\r\n");
     uart_puts("===========================================\r\n"); 
@@ -53,7 +46,7 @@ int main(void) {
     uart_puts("\r\n");
     
     // Initialize GPIO for LED control
-    *(volatile uint32_t*)(GPIO_BASE + 0x00) = 0x0F;  // GPIO DIRECTION - First 4 bits as outputs
+    GPIO->DIR = 0x0F;               // First 4 bits as outputs
     
     // Initialize PWM (simple setup)  
     PWM->CTRL = PWM_CTRL_ENABLE;    // Enable PWM
@@ -79,39 +72,21 @@ int main(void) {
         
         // Status message every ~1000 loops
         if ((loop_count % 1000) == 0) {
-            uart_puts("Loop: ");
-            // Simple hex output
-            for (int i = 28; i >= 0; i -= 4) {
-                uint8_t nibble = (loop_count >> i) & 0xF;
-                uart_putc((nibble < 10) ? ('0' + nibble) : ('A' + nibble - 10));
-            }
-            uart_puts(" PWM: ");
-            for (int i = 12; i >= 0; i -= 4) {
-                uint8_t nibble = (pwm_value >> i) & 0xF;
-                uart_putc((nibble < 10) ? ('0' + nibble) : ('A' + nibble - 10));
-            }
-            uart_puts(" LED: ");
-            uart_putc('0' + (led_pattern & 0xF));
-            uart_puts("\r\n");
+            uart_printf("Loop: %08X PWM: %04X LED: %u\r\n",
+                        loop_count, pwm_value, led_pattern & 0xF);
         }
         
         // Delay for visible LED changes
-        delay(50000);  // ~1ms at 50MHz
+        delay_ms(1);
         loop_count++;
         
         // Test protection system every 10000 loops
         if ((loop_count % 10000) == 0) {
-            uart_puts("Protection check: ");
-            uint32_t prot_status = *(volatile uint32_t*)(PROT_BASE + 0x00);
+            uint32_t prot_status = PROT->STATUS;
             if (prot_status == 0) {
-                uart_puts("OK\r\n");
+                uart_puts("Protection check: OK\r\n");
             } else {
-                uart_puts("FAULT: ");
-                for (int i = 28; i >= 0; i -= 4) {
-                    uint8_t nibble = (prot_status >> i) & 0xF;
-                    uart_putc((nibble < 10) ? ('0' + nibble) : ('A' + nibble - 10));
-                }
-                uart_puts("\r\n");
+                uart_printf("Protection check: FAULT: %08X\r\n", prot_status);
             }
         }
     }
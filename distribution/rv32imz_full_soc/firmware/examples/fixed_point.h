@@ -0,0 +1,193 @@
+/**
+ * @file fixed_point.h
+ * @brief Q15/Q31 Fixed-Point Arithmetic for the RV32IM Control Path
+ *
+ * The SoC has no F extension (-march=rv32im_zicsr), so every float
+ * operation in the control ISR is a libgcc soft-float call. This header
+ * provides saturating integer replacements that map onto plain RV32IM
+ * instructions (mul/mulh, add, shifts, compares) and never call libgcc.
+ *
+ * Formats:
+ * - q15_t   : signed 1.15, range [-1.0, +1.0)    - sensor values, references
+ * - q31_t   : signed 1.31, range [-1.0, +1.0)    - accumulators, controller output
+ * - qgain_t : signed 16.16, range [-32768, +32768) - gains applied to Q15 signals
+ *
+ * Signals are per-unit values: 1.0 corresponds to the full-scale value of
+ * the quantity (see the *_BASE constants of the application).
+ *
+ * Constants should be built with the Q15()/Q31()/QGAIN() macros, which
+ * fold to integers at compile time and cost nothing at run time.
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <stdint.h>
+
+//==========================================================================
+// Types
+//==========================================================================
+
+typedef int16_t q15_t;      // Signed 1.15 fraction
+typedef int32_t q31_t;      // Signed 1.31 fraction
+typedef int32_t qgain_t;    // Signed 16.16 gain
+
+#define Q15_MAX         ((q15_t)0x7FFF)
+#define Q15_MIN         ((q15_t)-0x8000)
+#define Q31_MAX         ((q31_t)0x7FFFFFFF)
+#define Q31_MIN         ((q31_t)(-0x7FFFFFFF - 1))
+
+//==========================================================================
+// Compile-Time Conversion (constants only - these expand to float math)
+//==========================================================================
+
+#define Q15(x)          ((q15_t)((x) >= 0.99996948 ? 32767 : \
+                                 (x) <= -1.0 ? -32768 : (x) * 32768.0))
+#define Q31(x)          ((q31_t)((x) >= 0.9999999995 ? 2147483647.0 : \
+                                 (x) <= -1.0 ? -2147483648.0 : (x) * 2147483648.0))
+#define QGAIN(x)        ((qgain_t)((x) * 65536.0))
+#define Q29(x)          ((q31_t)((x) * 536870912.0))    // Signed 3.29 coefficient
+
+//==========================================================================
+// Saturation
+//==========================================================================
+
+/**
+ * @brief Saturate a 32-bit intermediate to Q15
+ */
+static inline q15_t q15_sat(int32_t x) {
+    if (x > Q15_MAX) return Q15_MAX;
+    if (x < Q15_MIN) return Q15_MIN;
+    return (q15_t)x;
+}
+
+/**
+ * @brief Saturate a 64-bit intermediate to Q31
+ */
+static inline q31_t q31_sat(int64_t x) {
+    if (x > (int64_t)Q31_MAX) return Q31_MAX;
+    if (x < (int64_t)Q31_MIN) return Q31_MIN;
+    return (q31_t)x;
+}
+
+//==========================================================================
+// Q15 Arithmetic
+//==========================================================================
+
+static inline q15_t q15_add(q15_t a, q15_t b) {
+    return q15_sat((int32_t)a + b);
+}
+
+static inline q15_t q15_sub(q15_t a, q15_t b) {
+    return q15_sat((int32_t)a - b);
+}
+
+/**
+ * @brief Q15 × Q15 → Q15 with rounding (saturates -1.0 × -1.0)
+ */
+static inline q15_t q15_mul(q15_t a, q15_t b) {
+    return q15_sat(((int32_t)a * b + (1 << 14)) >> 15);
+}
+
+static inline q15_t q15_abs(q15_t x) {
+    return (x == Q15_MIN) ? Q15_MAX : (q15_t)(x < 0 ? -x : x);
+}
+
+static inline q15_t q15_clamp(q15_t x, q15_t limit) {
+    if (x > limit) return limit;
+    if (x < -limit) return (q15_t)-limit;
+    return x;
+}
+
+//==========================================================================
+// Q31 Arithmetic
+//==========================================================================
+
+static inline q31_t q31_add(q31_t a, q31_t b) {
+    return q31_sat((int64_t)a + b);
+}
+
+static inline q31_t q31_sub(q31_t a, q31_t b) {
+    return q31_sat((int64_t)a - b);
+}
+
+/**
+ * @brief Q31 × Q31 → Q31 (mul + mulh, truncating)
+ */
+static inline q31_t q31_mul(q31_t a, q31_t b) {
+    return q31_sat(((int64_t)a * b) >> 31);
+}
+
+/**
+ * @brief Q3.29 coefficient × Q31 → Q31 (for coefficients with |c| < 4)
+ */
+static inline q31_t q31_mul_q29(q31_t coeff, q31_t x) {
+    return q31_sat(((int64_t)coeff * x) >> 29);
+}
+
+static inline q31_t q31_abs(q31_t x) {
+    return (x == Q31_MIN) ? Q31_MAX : (x < 0 ? -x : x);
+}
+
+static inline q31_t q31_clamp(q31_t x, q31_t limit) {
+    if (x > limit) return limit;
+    if (x < -limit) return -limit;
+    return x;
+}
+
+//==========================================================================
+// Mixed-Format Helpers
+//==========================================================================
+
+/**
+ * @brief Apply a 16.16 gain to a Q15 signal, producing a Q31 result
+ *
+ * Q15 × Q16.16 is exactly Q31, so no shift is needed - only saturation.
+ */
+static inline q31_t q15_mul_gain(q15_t x, qgain_t gain) {
+    return q31_sat((int64_t)x * gain);
+}
+
+static inline q31_t q15_to_q31(q15_t x) {
+    return (q31_t)x << 16;
+}
+
+/**
+ * @brief Q31 → Q15 with rounding
+ */
+static inline q15_t q31_to_q15(q31_t x) {
+    return q15_sat((x >> 16) + ((x >> 15) & 1));
+}
+
+//==========================================================================
+// ADC / PWM Scaling Helpers
+//==========================================================================
+
+/**
+ * @brief Unipolar 16-bit ADC code (0..65535) → Q15 (0..1.0)
+ */
+static inline q15_t q15_from_adc_unipolar(uint16_t raw) {
+    return (q15_t)(raw >> 1);
+}
+
+/**
+ * @brief Bipolar 16-bit ADC code around @p offset → Q15 (-1.0..1.0)
+ */
+static inline q15_t q15_from_adc_bipolar(uint16_t raw, uint16_t offset) {
+    return q15_sat((int32_t)raw - offset);
+}
+
+/**
+ * @brief Non-negative Q31 magnitude → 16-bit register value (0..65535)
+ *
+ * Matches the PWM MOD_INDEX scale (0-65535 = 0-1.0).
+ */
+static inline uint16_t q31_to_u16(q31_t x) {
+    if (x <= 0) return 0;
+    return (uint16_t)((uint32_t)x >> 15);
+}
+
+#endif // FIXED_POINT_H
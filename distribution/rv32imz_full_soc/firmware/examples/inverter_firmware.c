@@ -10,80 +10,23 @@
  * - Soft-start sequence
  * - UART logging @ 115200 baud
  * - Multiple test modes
+ *
+ * The test modes, soft-start ramp, watchdog kicks and status LED are
+ * task_sched.h tasks on a 1 kHz TIMER; the core sleeps in wfi until the
+ * next one is due.
  */
 
 #include <stdint.h>
 
 //==============================================================================
-// Memory-Mapped Peripheral Addresses
+// Memory-Mapped Peripherals (generated register map, see soc_regs.json)
 //==============================================================================
 
-// PWM Accelerator (Base: 0x00020000)
-#define PWM_BASE        0x00020000
-#define PWM_CTRL        (*(volatile uint32_t*)(PWM_BASE + 0x00))
-#define PWM_FREQ_DIV    (*(volatile uint32_t*)(PWM_BASE + 0x04))
-#define PWM_MOD_INDEX   (*(volatile uint32_t*)(PWM_BASE + 0x08))
-#define PWM_SINE_PHASE  (*(volatile uint32_t*)(PWM_BASE + 0x0C))
-#define PWM_SINE_FREQ   (*(volatile uint32_t*)(PWM_BASE + 0x10))
-#define PWM_DEADTIME    (*(volatile uint32_t*)(PWM_BASE + 0x14))
-#define PWM_STATUS      (*(volatile uint32_t*)(PWM_BASE + 0x18))
-#define PWM_OUT         (*(volatile uint32_t*)(PWM_BASE + 0x1C))
-
-// PWM Control Register Bits
-#define PWM_CTRL_ENABLE     (1 << 0)
-#define PWM_CTRL_AUTO_MODE  (1 << 1)
-
-// ADC Interface (Base: 0x00020100)
-#define ADC_BASE        0x00020100
-#define ADC_CTRL        (*(volatile uint32_t*)(ADC_BASE + 0x00))
-#define ADC_STATUS      (*(volatile uint32_t*)(ADC_BASE + 0x04))
-#define ADC_DATA_CH0    (*(volatile uint32_t*)(ADC_BASE + 0x08))
-#define ADC_DATA_CH1    (*(volatile uint32_t*)(ADC_BASE + 0x0C))
-#define ADC_DATA_CH2    (*(volatile uint32_t*)(ADC_BASE + 0x10))
-#define ADC_DATA_CH3    (*(volatile uint32_t*)(ADC_BASE + 0x14))
-
-// ADC Control Register Bits
-#define ADC_CTRL_START      (1 << 0)
-#define ADC_CTRL_CONTINUOUS (1 << 1)
-#define ADC_STATUS_BUSY     (1 << 0)
-#define ADC_STATUS_DONE     (1 << 1)
-
-// Protection (Base: 0x00020200)
-#define PROT_BASE       0x00020200
-#define PROT_STATUS     (*(volatile uint32_t*)(PROT_BASE + 0x00))
-#define PROT_ENABLE     (*(volatile uint32_t*)(PROT_BASE + 0x04))
-#define PROT_WATCHDOG   (*(volatile uint32_t*)(PROT_BASE + 0x08))
-#define PROT_WD_KICK    (*(volatile uint32_t*)(PROT_BASE + 0x0C))
-
-// Protection Status Bits
-#define PROT_FAULT_OCP      (1 << 0)
-#define PROT_FAULT_OVP      (1 << 1)
-#define PROT_FAULT_ESTOP    (1 << 2)
-#define PROT_FAULT_WATCHDOG (1 << 3)
-
-// Timer (Base: 0x00020300)
-#define TIMER_BASE      0x00020300
-#define TIMER_CTRL      (*(volatile uint32_t*)(TIMER_BASE + 0x00))
-#define TIMER_COUNT     (*(volatile uint32_t*)(TIMER_BASE + 0x04))
-#define TIMER_COMPARE   (*(volatile uint32_t*)(TIMER_BASE + 0x08))
-#define TIMER_PRESCALE  (*(volatile uint32_t*)(TIMER_BASE + 0x0C))
-
-// GPIO (Base: 0x00020400)
-#define GPIO_BASE       0x00020400
-#define GPIO_OUT        (*(volatile uint32_t*)(GPIO_BASE + 0x00))
-#define GPIO_IN         (*(volatile uint32_t*)(GPIO_BASE + 0x04))
-#define GPIO_DIR        (*(volatile uint32_t*)(GPIO_BASE + 0x08))
-
-// UART (Base: 0x00020500)
-#define UART_BASE       0x00020500
-#define UART_TX_DATA    (*(volatile uint32_t*)(UART_BASE + 0x00))
-#define UART_RX_DATA    (*(volatile uint32_t*)(UART_BASE + 0x04))
-#define UART_STATUS     (*(volatile uint32_t*)(UART_BASE + 0x08))
-#define UART_CTRL       (*(volatile uint32_t*)(UART_BASE + 0x0C))
-
-// UART Status Bits
-#define UART_STATUS_TX_READY (1 << 0)
-#define UART_STATUS_RX_READY (1 << 1)
+#include "memory_map.h"
+#include "irq.h"
+#include "uart.h"
+#include "perf_counters.h"
+#include "task_sched.h"
 
 //==============================================================================
 // System Configuration
@@ -94,6 +37,10 @@
 #define OUTPUT_FREQ     50          // 50 Hz output frequency
 #define DEADTIME_NS     1000        // 1 μs dead-time
 #define WATCHDOG_MS     1000        // 1 second watchdog
+#define KICK_MS         (WATCHDOG_MS / 4)
+#define UART_BAUD       115200
+
+#define WATCHDOG_CYCLES (CLK_FREQ / 1000 * WATCHDOG_MS)
 
 //==============================================================================
 // Control Variables
@@ -104,33 +51,7 @@ volatile uint16_t modulation_index = 0;
 volatile uint32_t fault_status = 0;
 uint8_t test_mode = 0;
 
-//==============================================================================
-// UART Functions
-//==============================================================================
-
-void uart_init(void) {
-    UART_CTRL = 0x01;  // Enable UART
-}
-
-void uart_putc(char c) {
-    while (!(UART_STATUS & UART_STATUS_TX_READY));
-    UART_TX_DATA = c;
-}
-
-void uart_puts(const char* str) {
-    while (*str) {
-        uart_putc(*str++);
-    }
-}
-
-void uart_put_hex(uint32_t value) {
-    const char hex[] = "0123456789ABCDEF";
-    uart_putc('0');
-    uart_putc('x');
-    for (int i = 28; i >= 0; i -= 4) {
-        uart_putc(hex[(value >> i) & 0xF]);
-    }
-}
+static sched_task_id_t watchdog_task_id = -1;
 
 //==============================================================================
 // Protection Functions
@@ -138,28 +59,35 @@ void uart_put_hex(uint32_t value) {
 
 void protection_init(void) {
     // Enable all protection features
-    PROT_ENABLE = PROT_FAULT_OCP | PROT_FAULT_OVP | PROT_FAULT_ESTOP;
+    PROT->FAULT_MASK = PROT_STATUS_OCP | PROT_STATUS_OVP | PROT_STATUS_ESTOP | PROT_STATUS_WD;
+    PROT->CTRL = PROT_CTRL_ENABLE;
 
     // Set watchdog timeout (1 second @ 50 MHz)
-    PROT_WATCHDOG = CLK_FREQ * (WATCHDOG_MS / 1000);
+    PROT->WATCHDOG = WATCHDOG_CYCLES;
 
     uart_puts("  [PROT] Protection system initialized\r\n");
 }
 
 void watchdog_kick(void) {
-    PROT_WD_KICK = 0xDEADBEEF;  // Kick watchdog
+    PROT->WATCHDOG = WATCHDOG_CYCLES;  // Any write reloads the watchdog
+}
+
+static uint32_t watchdog_task(void* arg) {
+    (void)arg;
+    watchdog_kick();
+    return sched_ms(KICK_MS);
 }
 
 uint8_t check_faults(void) {
-    fault_status = PROT_STATUS;
+    fault_status = PROT->STATUS;
 
     if (fault_status) {
-        uart_puts("  [FAULT] ");
-        if (fault_status & PROT_FAULT_OCP) uart_puts("OCP ");
-        if (fault_status & PROT_FAULT_OVP) uart_puts("OVP ");
-        if (fault_status & PROT_FAULT_ESTOP) uart_puts("ESTOP ");
-        if (fault_status & PROT_FAULT_WATCHDOG) uart_puts("WATCHDOG ");
-        uart_puts("\r\n");
+        // One queued message: never waits on the UART in the control path
+        uart_printf("  [FAULT] %s%s%s%s\r\n",
+                    (fault_status & PROT_STATUS_OCP) ? "OCP " : "",
+                    (fault_status & PROT_STATUS_OVP) ? "OVP " : "",
+                    (fault_status & PROT_STATUS_ESTOP) ? "ESTOP " : "",
+                    (fault_status & PROT_STATUS_WD) ? "WATCHDOG " : "");
         return 1;
     }
     return 0;
@@ -170,23 +98,18 @@ uint8_t check_faults(void) {
 //==============================================================================
 
 void adc_init(void) {
-    ADC_CTRL = 0;  // Reset ADC
+    // Continuous conversion: the data registers always hold the latest sample
+    ADC->CTRL = ADC_CTRL_ENABLE | ADC_CTRL_CONT;
     uart_puts("  [ADC] ADC interface initialized\r\n");
 }
 
 uint16_t adc_read(uint8_t channel) {
-    // Start conversion
-    ADC_CTRL = ADC_CTRL_START | (channel << 4);
-
-    // Wait for completion
-    while (ADC_STATUS & ADC_STATUS_BUSY);
-
-    // Read data based on channel
+    // Read data based on channel (no conversion start, no busy wait)
     switch(channel) {
-        case 0: return ADC_DATA_CH0 & 0xFFFF;
-        case 1: return ADC_DATA_CH1 & 0xFFFF;
-        case 2: return ADC_DATA_CH2 & 0xFFFF;
-        case 3: return ADC_DATA_CH3 & 0xFFFF;
+        case 0: return ADC->DATA_CH0 & 0xFFFF;
+        case 1: return ADC->DATA_CH1 & 0xFFFF;
+        case 2: return ADC->DATA_CH2 & 0xFFFF;
+        case 3: return ADC->DATA_CH3 & 0xFFFF;
         default: return 0;
     }
 }
@@ -197,69 +120,103 @@ uint16_t adc_read(uint8_t channel) {
 
 void pwm_init(void) {
     // Disable PWM first
-    PWM_CTRL = 0;
+    PWM->CTRL = 0;
 
     // Set carrier frequency: 5 kHz
     // freq_div = CLK_FREQ / (PWM_FREQ * 65536)
-    PWM_FREQ_DIV = CLK_FREQ / (PWM_CARRIER_FREQ * 65536);
+    PWM->FREQ_DIV = CLK_FREQ / (PWM_CARRIER_FREQ * 65536);
 
     // Set output frequency: 50 Hz
-    // sine_freq = (OUTPUT_FREQ * 65536 * 65536) / CLK_FREQ
-    PWM_SINE_FREQ = ((uint64_t)OUTPUT_FREQ * 65536 * 65536) / CLK_FREQ;
+    // sine_freq = (OUTPUT_FREQ * 65536 * 65536) / CLK_FREQ (folded at compile time)
+    PWM->SINE_FREQ = ((uint64_t)OUTPUT_FREQ * 65536 * 65536) / CLK_FREQ;
 
     // Set dead-time: 1 μs @ 50 MHz = 50 cycles
-    PWM_DEADTIME = (DEADTIME_NS * CLK_FREQ) / 1000000000;
+    PWM->DEADTIME = ((uint64_t)DEADTIME_NS * CLK_FREQ) / 1000000000;
 
     // Start with zero modulation
-    PWM_MOD_INDEX = 0;
+    PWM->MOD_INDEX = 0;
 
     uart_puts("  [PWM] PWM accelerator initialized\r\n");
     uart_puts("        Carrier: 5 kHz | Output: 50 Hz | Dead-time: 1 us\r\n");
 }
 
 void pwm_set_modulation(uint16_t mod) {
-    PWM_MOD_INDEX = mod;
+    PWM->MOD_INDEX = mod;
 }
 
 void pwm_enable(void) {
-    PWM_CTRL = PWM_CTRL_ENABLE | PWM_CTRL_AUTO_MODE;
+    // Bit 1 is CPU_MODE (soc_regs.json). This file used to call it
+    // AUTO_MODE and set it for the hardware sine; with the shared map that
+    // would select CPU_REFERENCE, so the sine now runs with it clear.
+    PWM->CTRL = PWM_CTRL_ENABLE;
     uart_puts("  [PWM] PWM output ENABLED\r\n");
 }
 
 void pwm_disable(void) {
-    PWM_CTRL = 0;
+    PWM->CTRL = 0;
     uart_puts("  [PWM] PWM output DISABLED\r\n");
 }
 
 //==============================================================================
-// Soft-Start Sequence
+// Test Sequencing
 //==============================================================================
 
-void soft_start(uint32_t ramp_ms) {
-    uart_puts("  [START] Soft-start sequence initiated...\r\n");
+static uint32_t idle_task(void* arg) {
+    (void)arg;
 
-    uint32_t steps = ramp_ms / 10;  // 10 ms per step
-    uint16_t step_size = 32768 / steps;  // Ramp to 50% modulation
+    // Blink LED to show alive
+    GPIO->DATA_OUT ^= 0x00000004;  // Toggle LED2
+    return sched_ms(500);
+}
 
-    for (uint32_t i = 0; i < steps; i++) {
-        modulation_index = i * step_size;
-        pwm_set_modulation(modulation_index);
+// Called by the last task of a test mode
+static void tests_done(void) {
+    GPIO->DATA_OUT = 0x00000003;  // LED0+LED1 ON = Tests complete
+    uart_puts("\r\n[DONE] All tests completed - entering idle loop\r\n");
+    sched_add(idle_task, NULL, 0);
+}
 
-        // Delay ~10 ms (500,000 cycles @ 50 MHz)
-        for (volatile uint32_t d = 0; d < 500000; d++);
+//==============================================================================
+// Soft-Start Sequence
+//==============================================================================
 
-        // Kick watchdog
-        watchdog_kick();
+static struct {
+    uint32_t steps;
+    uint32_t step;
+    uint16_t step_size;
+    sched_task_fn_t then;       // started when the ramp ends
+} ramp;
+
+static uint32_t soft_start_task(void* arg) {
+    (void)arg;
+
+    if (ramp.step > 0 && check_faults()) {
+        pwm_disable();
+        uart_puts("  [START] Soft-start ABORTED due to fault\r\n");
+        sched_add(ramp.then, NULL, 0);
+        return SCHED_STOP;
+    }
 
-        // Check for faults
-        if (check_faults()) {
-            pwm_disable();
-            uart_puts("  [START] Soft-start ABORTED due to fault\r\n");
-            return;
-        }
+    if (ramp.step == ramp.steps) {
+        uart_puts("  [START] Soft-start COMPLETE - Running at 50% modulation\r\n");
+        sched_add(ramp.then, NULL, 0);
+        return SCHED_STOP;
     }
 
-    uart_puts("  [START] Soft-start COMPLETE - Running at 50% modulation\r\n");
+    modulation_index = ramp.step * ramp.step_size;
+    pwm_set_modulation(modulation_index);
+    ramp.step++;
+    return sched_ms(10);
+}
+
+void soft_start(uint32_t ramp_ms, sched_task_fn_t then) {
+    uart_puts("  [START] Soft-start sequence initiated...\r\n");
+
+    ramp.steps = ramp_ms / 10;  // 10 ms per step
+    ramp.step_size = 32768 / ramp.steps;  // Ramp to 50% modulation
+    ramp.step = 0;
+    ramp.then = then;
+    sched_add(soft_start_task, NULL, 0);
 }
 
 //==============================================================================
@@ -274,68 +231,102 @@ void test_mode_1_pwm_only(void) {
 
     uart_puts("PWM running at 50% modulation index\r\n");
     uart_puts("Observe PWM outputs on oscilloscope\r\n");
+    tests_done();
+}
+
+static uint32_t adc_monitor_task(void* arg) {
+    (void)arg;
+    static int i = 0;
+
+    uart_puts("ADC: ");
+    for (uint8_t ch = 0; ch < 4; ch++) {
+        uint16_t val = adc_read(ch);
+        uart_puts("CH");
+        uart_putc('0' + ch);
+        uart_puts("=");
+        uart_put_hex(val);
+        uart_puts(" ");
+    }
+    uart_puts("\r\n");
+
+    if (++i == 10) {
+        tests_done();
+        return SCHED_STOP;
+    }
+    return sched_ms(20);
 }
 
 void test_mode_2_adc_monitor(void) {
     uart_puts("\r\n=== TEST MODE 2: ADC Monitoring ===\r\n");
+    sched_add(adc_monitor_task, NULL, 0);
+}
+
+// Run for 10 seconds with monitoring, one pass every 100 ms
+static uint32_t full_system_task(void* arg) {
+    (void)arg;
+    static int i = 0;
+
+    if (i == 0) {
+        pwm_enable();
+    }
 
-    for (int i = 0; i < 10; i++) {
-        uart_puts("ADC: ");
-        for (uint8_t ch = 0; ch < 4; ch++) {
-            uint16_t val = adc_read(ch);
-            uart_puts("CH");
-            uart_putc('0' + ch);
-            uart_puts("=");
-            uart_put_hex(val);
-            uart_puts(" ");
-        }
+    // Read ADC values
+    uint16_t current = adc_read(0);
+    uint16_t voltage = adc_read(1);
+
+    // Log every 10th iteration (1 second)
+    if (i % 10 == 0) {
+        uart_puts("MOD=");
+        uart_put_hex(modulation_index);
+        uart_puts(" I=");
+        uart_put_hex(current);
+        uart_puts(" V=");
+        uart_put_hex(voltage);
         uart_puts("\r\n");
+    }
+
+    // Check faults
+    if (check_faults()) {
+        pwm_disable();
+        uart_puts("System halted due to fault\r\n");
+        sched_cancel(watchdog_task_id);     // let the watchdog expire
+        return SCHED_STOP;
+    }
 
-        // Delay
-        for (volatile uint32_t d = 0; d < 1000000; d++);
+    if (++i == 100) {
+        pwm_disable();
+        uart_puts("Test complete - PWM disabled\r\n");
+        tests_done();
+        return SCHED_STOP;
     }
+    return sched_ms(100);
 }
 
 void test_mode_3_full_system(void) {
     uart_puts("\r\n=== TEST MODE 3: Full System Test ===\r\n");
 
-    // Soft-start to 50% modulation
-    soft_start(2000);  // 2 second ramp
-    pwm_enable();
+    // Soft-start to 50% modulation, then the monitored run
+    soft_start(2000, full_system_task);  // 2 second ramp
+}
+
+static uint32_t protection_test_task(void* arg) {
+    (void)arg;
+    static int i = 0;
+
+    fault_status = PROT->STATUS;
 
-    // Run for 10 seconds with monitoring
-    for (int i = 0; i < 100; i++) {
-        // Read ADC values
-        uint16_t current = adc_read(0);
-        uint16_t voltage = adc_read(1);
-
-        // Log every 10th iteration (1 second)
-        if (i % 10 == 0) {
-            uart_puts("MOD=");
-            uart_put_hex(modulation_index);
-            uart_puts(" I=");
-            uart_put_hex(current);
-            uart_puts(" V=");
-            uart_put_hex(voltage);
-            uart_puts("\r\n");
-        }
-
-        // Kick watchdog
-        watchdog_kick();
-
-        // Check faults
-        if (check_faults()) {
-            pwm_disable();
-            uart_puts("System halted due to fault\r\n");
-            while(1);
-        }
-
-        // Delay ~100 ms
-        for (volatile uint32_t d = 0; d < 5000000; d++);
+    if (fault_status) {
+        uart_puts("FAULT DETECTED: ");
+        uart_put_hex(fault_status);
+        uart_puts("\r\n");
     }
 
-    pwm_disable();
-    uart_puts("Test complete - PWM disabled\r\n");
+    if (++i == 50) {
+        uart_puts("Protection test complete\r\n");
+        tests_done();
+        return SCHED_STOP;
+    }
+    return sched_ms(40);
 }
 
 void test_mode_4_protection(void) {
@@ -343,23 +334,7 @@ void test_mode_4_protection(void) {
 
     uart_puts("Monitoring fault inputs...\r\n");
     uart_puts("Trigger OCP, OVP, or E-STOP to test\r\n");
-
-    for (int i = 0; i < 50; i++) {
-        fault_status = PROT_STATUS;
-
-        if (fault_status) {
-            uart_puts("FAULT DETECTED: ");
-            uart_put_hex(fault_status);
-            uart_puts("\r\n");
-        }
-
-        watchdog_kick();
-
-        // Delay
-        for (volatile uint32_t d = 0; d < 2000000; d++);
-    }
-
-    uart_puts("Protection test complete\r\n");
+    sched_add(protection_test_task, NULL, 0);
 }
 
 //==============================================================================
@@ -368,7 +343,8 @@ void test_mode_4_protection(void) {
 
 int main(void) {
     // Initialize UART first for debug output
-    uart_init();
+    uart_init(CLK_FREQ, UART_BAUD);
+    irq_global_enable();
 
     uart_puts("\r\n");
     uart_puts("================================================================================\r\n");
@@ -381,13 +357,15 @@ int main(void) {
 
     // Initialize peripherals
     uart_puts("[INIT] Initializing peripherals...\r\n");
+    sched_init_timer(CLK_FREQ, 1000);   // 1 ms ticks, compare wakeups
     protection_init();
+    watchdog_task_id = sched_add(watchdog_task, NULL, 0);
     adc_init();
     pwm_init();
 
     // Set GPIO for LED status
-    GPIO_DIR = 0x0000000F;  // First 4 pins as output
-    GPIO_OUT = 0x00000001;  // LED0 ON = System ready
+    GPIO->DIR = 0x0000000F;  // First 4 pins as output
+    GPIO->DATA_OUT = 0x00000001;  // LED0 ON = System ready
 
     uart_puts("[INIT] System initialization complete\r\n");
     uart_puts("\r\n");
@@ -422,19 +400,6 @@ int main(void) {
             break;
     }
 
-    // Main loop (idle after tests)
-    GPIO_OUT = 0x00000003;  // LED0+LED1 ON = Tests complete
-    uart_puts("\r\n[DONE] All tests completed - entering idle loop\r\n");
-
-    while (1) {
-        watchdog_kick();
-
-        // Blink LED to show alive
-        GPIO_OUT ^= 0x00000004;  // Toggle LED2
-
-        // Delay ~500 ms
-        for (volatile uint32_t d = 0; d < 25000000; d++);
-    }
-
-    return 0;
+    // The test runs as tasks; idle blinks the LED once it is done
+    sched_run();
 }
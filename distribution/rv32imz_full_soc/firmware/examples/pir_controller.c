@@ -0,0 +1,82 @@
+/**
+ * @file pir_controller.c
+ * @brief PI + Resonant Controller Coefficient Setup
+ *
+ * Runs at init or when the output frequency changes - never in the ISR.
+ * The float design calls cosf() once; the fixed-point design evaluates the
+ * cosine with a Q29 Taylor series so fixed-point builds stay free of
+ * soft-float and libm.
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#include <stdint.h>
+#include <math.h>
+#include "pir_controller.h"
+
+#define PIR_Q29_ONE     (1 << 29)
+#define PIR_PI_4_Q32    3373259426u     // π/4 × 2^32
+
+//==========================================================================
+// Float Design
+//==========================================================================
+
+void pir_design(pir_coeffs_t* c, float kp, float ki, float kr, float limit,
+                float f_res_hz, float f_s_hz) {
+    c->kp = kp;
+    c->ki_dt = ki / f_s_hz;
+    c->kr = kr;
+    c->limit = limit;
+    pir_set_frequency(c, f_res_hz, f_s_hz);
+}
+
+void pir_set_frequency(pir_coeffs_t* c, float f_res_hz, float f_s_hz) {
+    // Only transcendental call of the controller: once per retune
+    c->res_a1 = 2.0f * cosf(2.0f * (float)M_PI * f_res_hz / f_s_hz);
+}
+
+//==========================================================================
+// Fixed-Point Design
+//==========================================================================
+
+uint32_t pir_phase_step(uint32_t f_hz, uint32_t f_s_hz) {
+    // Long division in two 16-bit digits: (f / fs) × 2^32
+    uint32_t num = f_hz << 16;
+    uint32_t hi = num / f_s_hz;
+    uint32_t lo = ((num % f_s_hz) << 16) / f_s_hz;
+    return (hi << 16) | lo;
+}
+
+/**
+ * @brief cos(x) for a binary angle below a quarter turn, Q29 result
+ *
+ * Horner form of the Taylor series up to x^10; error < 3e-7 at π/2 and at
+ * the Q29 resolution limit for the small angles used by the resonator.
+ */
+static q31_t pir_cos_q29(uint32_t angle) {
+    static const int32_t divisors[] = { 90, 56, 30, 12, 2 };
+
+    // x in radians, Q29 (x < π/2)
+    int32_t x = (int32_t)(((uint64_t)angle * PIR_PI_4_Q32) >> 32);
+    int32_t x2 = (int32_t)(((int64_t)x * x) >> 29);
+
+    int32_t acc = PIR_Q29_ONE;
+    for (unsigned i = 0; i < sizeof(divisors) / sizeof(divisors[0]); i++) {
+        acc = PIR_Q29_ONE - (int32_t)(((int64_t)x2 * acc) >> 29) / divisors[i];
+    }
+    return acc;
+}
+
+void pir_q_design(pir_q_coeffs_t* c, qgain_t kp, qgain_t ki, qgain_t kr, q31_t limit,
+                  uint32_t f_res_hz, uint32_t f_s_hz) {
+    c->kp = kp;
+    c->ki_dt = ki / (int32_t)f_s_hz;
+    c->kr = kr;
+    c->limit = limit;
+    pir_q_set_frequency(c, f_res_hz, f_s_hz);
+}
+
+void pir_q_set_frequency(pir_q_coeffs_t* c, uint32_t f_res_hz, uint32_t f_s_hz) {
+    c->res_a1 = 2 * pir_cos_q29(pir_phase_step(f_res_hz, f_s_hz));
+}
@@ -0,0 +1,193 @@
+/**
+ * @file pir_controller.h
+ * @brief PI + Resonant Controller (float and Q31 fixed-point)
+ *
+ * PI+R voltage controller used by chb_5level_control.c:
+ *
+ *   G(s) = Kp + Ki/s + Kr*s/(s² + ωr²)
+ *
+ * The resonator is a two-state recursion:
+ *
+ *   r[n] = 2·cos(ωr·T)·r[n-1] - r[n-2] + Kr·e[n]
+ *
+ * All discretization constants (Ki·T, 2·cos(ωr·T)) are computed once by
+ * pir_design()/pir_q_design() at init, or when the output frequency changes,
+ * and stored in a coefficient struct. The per-sample step functions only
+ * multiply and add.
+ *
+ * Fixed-point variant: inputs are Q15 per-unit errors, the output is a Q31
+ * modulation index (1.0 = full modulation). Gains are 16.16 and already
+ * include the per-unit base of the input signal, so a step costs four
+ * widening (mul + mulh) multiplies and no division. pir_q_design() uses
+ * only 32-bit integer arithmetic, so it never pulls in soft-float or libm.
+ * The step is written with the zpec.h intrinsics: with ZPEC=1 each
+ * multiply, saturating add and clamp is one single-cycle instruction.
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#ifndef PIR_CONTROLLER_H
+#define PIR_CONTROLLER_H
+
+#include <stdint.h>
+#include "fixed_point.h"
+#include "zpec.h"
+
+//==========================================================================
+// Float Controller Data
+//==========================================================================
+
+typedef struct {
+    float kp;               // Proportional gain
+    float ki_dt;            // Integral gain × sample period
+    float kr;               // Resonant input gain
+    float res_a1;           // Resonator coefficient 2·cos(ωr·T)
+    float limit;            // Integrator and output clamp
+} pir_coeffs_t;
+
+typedef struct {
+    float integral;         // Integral accumulator
+    float res_x1;           // Resonator state r[n-1]
+    float res_x2;           // Resonator state r[n-2]
+} pir_state_t;
+
+//==========================================================================
+// Fixed-Point Controller Data
+//==========================================================================
+
+typedef struct {
+    qgain_t kp;             // Proportional gain (per-unit, 16.16)
+    qgain_t ki_dt;          // Integral gain × sample period (16.16)
+    qgain_t kr;             // Resonant input gain (16.16)
+    q31_t   res_a1;         // Resonator coefficient 2·cos(ωr·T) (Q3.29)
+    q31_t   limit;          // Integrator and output clamp (Q31)
+} pir_q_coeffs_t;
+
+typedef struct {
+    q31_t integral;         // Integral accumulator
+    q31_t res_x1;           // Resonator state r[n-1]
+    q31_t res_x2;           // Resonator state r[n-2]
+} pir_q_state_t;
+
+//==========================================================================
+// Coefficient Setup (call at init or on frequency change, not per sample)
+//==========================================================================
+
+/**
+ * @brief Compute float controller coefficients
+ *
+ * @param kp, ki, kr   Continuous-time gains
+ * @param limit        Integrator and output clamp
+ * @param f_res_hz     Resonant frequency
+ * @param f_s_hz       Controller sample rate
+ */
+void pir_design(pir_coeffs_t* c, float kp, float ki, float kr, float limit,
+                float f_res_hz, float f_s_hz);
+
+/**
+ * @brief Retune the float resonator without touching the other gains
+ */
+void pir_set_frequency(pir_coeffs_t* c, float f_res_hz, float f_s_hz);
+
+/**
+ * @brief Compute fixed-point controller coefficients (integer only)
+ *
+ * @param kp, ki, kr   Continuous-time per-unit gains (16.16)
+ * @param limit        Integrator and output clamp (Q31)
+ * @param f_res_hz     Resonant frequency, must be below f_s_hz / 4
+ * @param f_s_hz       Controller sample rate, must be below 65536 Hz
+ */
+void pir_q_design(pir_q_coeffs_t* c, qgain_t kp, qgain_t ki, qgain_t kr, q31_t limit,
+                  uint32_t f_res_hz, uint32_t f_s_hz);
+
+/**
+ * @brief Retune the fixed-point resonator without touching the other gains
+ */
+void pir_q_set_frequency(pir_q_coeffs_t* c, uint32_t f_res_hz, uint32_t f_s_hz);
+
+/**
+ * @brief Phase increment of f_hz sampled at f_s_hz (2^32 = one turn)
+ *
+ * Exact to 1 LSB; uses two 32-bit divides.
+ */
+uint32_t pir_phase_step(uint32_t f_hz, uint32_t f_s_hz);
+
+//==========================================================================
+// Float Controller Step
+//==========================================================================
+
+static inline void pir_reset(pir_state_t* s) {
+    s->integral = 0.0f;
+    s->res_x1 = 0.0f;
+    s->res_x2 = 0.0f;
+}
+
+/**
+ * @brief Run one float controller step
+ *
+ * @param error Reference minus feedback
+ * @return Controller output clamped to ±limit
+ */
+static inline float pir_step(const pir_coeffs_t* c, pir_state_t* s, float error) {
+    // Proportional term
+    float proportional = c->kp * error;
+
+    // Integral term with anti-windup
+    s->integral += c->ki_dt * error;
+    if (s->integral > c->limit) s->integral = c->limit;
+    if (s->integral < -c->limit) s->integral = -c->limit;
+
+    // Resonant term
+    float resonant_new = c->res_a1 * s->res_x1 - s->res_x2 + c->kr * error;
+    s->res_x2 = s->res_x1;
+    s->res_x1 = resonant_new;
+
+    // Combine all terms and clamp output
+    float output = proportional + s->integral + resonant_new;
+    if (output > c->limit) output = c->limit;
+    if (output < -c->limit) output = -c->limit;
+
+    return output;
+}
+
+//==========================================================================
+// Fixed-Point Controller Step
+//==========================================================================
+
+/**
+ * @brief Clear controller state (integrator and resonator)
+ */
+static inline void pir_q_reset(pir_q_state_t* s) {
+    s->integral = 0;
+    s->res_x1 = 0;
+    s->res_x2 = 0;
+}
+
+/**
+ * @brief Run one fixed-point controller step
+ *
+ * @param c     Controller coefficients
+ * @param s     Controller state
+ * @param error Reference minus feedback (Q15 per-unit)
+ * @return Controller output clamped to ±limit (Q31)
+ */
+static inline q31_t pir_q_step(const pir_q_coeffs_t* c, pir_q_state_t* s, q15_t error) {
+    // Proportional term
+    q31_t proportional = zpec_mulg(error, c->kp);
+
+    // Integral term with anti-windup
+    s->integral = zpec_clamp(zpec_adds(s->integral, zpec_mulg(error, c->ki_dt)), c->limit);
+
+    // Resonant term; saturating arithmetic bounds the resonator states
+    q31_t resonant_new = zpec_adds(zpec_subs(zpec_mulq29(c->res_a1, s->res_x1), s->res_x2),
+                                   zpec_mulg(error, c->kr));
+    s->res_x2 = s->res_x1;
+    s->res_x1 = resonant_new;
+
+    // Combine all terms and clamp output
+    q31_t output = zpec_adds(zpec_adds(proportional, s->integral), resonant_new);
+    return zpec_clamp(output, c->limit);
+}
+
+#endif // PIR_CONTROLLER_H
@@ -19,14 +19,16 @@
  * - Channel 2: AC Output Voltage (±150V peak, scaled via AMC1301)
  * - Channel 3: AC Output Current (±15A peak, ACS724)
  *
- * Register Map (Base: 0x00020100):
- * 0x00: CTRL        - Control register (enable, reset)
+ * Register Map (Base: 0x00020100, see soc_regs.json):
+ * 0x00: CTRL        - Control register (enable, FIFO, continuous)
  * 0x04: STATUS      - Status register (data valid flags)
  * 0x08: DATA_CH0    - Channel 0 ADC data [15:0]
  * 0x0C: DATA_CH1    - Channel 1 ADC data [15:0]
  * 0x10: DATA_CH2    - Channel 2 ADC data [15:0]
  * 0x14: DATA_CH3    - Channel 3 ADC data [15:0]
- * 0x18: SAMPLE_CNT  - Sample counter (debug)
+ * 0x18: FIFO_LEVEL  - FIFO fill level
+ * 0x1C: IRQ_EN      - Interrupt enable
+ * 0x20: FIFO_DATA   - FIFO read port (see adc_fifo.h)
  *
  * @author Auto-generated for VexRISCV SoC
  * @date 2025-12-03
@@ -38,50 +40,8 @@
 
 #include <stdint.h>
 
-//==========================================================================
-// Base Address
-//==========================================================================
-
-#define SIGMA_DELTA_ADC_BASE    0x00020100
-
-//==========================================================================
-// Register Offsets
-//==========================================================================
-
-#define ADC_CTRL_OFFSET         0x00    // Control register
-#define ADC_STATUS_OFFSET       0x04    // Status register
-#define ADC_DATA_CH0_OFFSET     0x08    // Channel 0 data
-#define ADC_DATA_CH1_OFFSET     0x0C    // Channel 1 data
-#define ADC_DATA_CH2_OFFSET     0x10    // Channel 2 data
-#define ADC_DATA_CH3_OFFSET     0x14    // Channel 3 data
-#define ADC_SAMPLE_CNT_OFFSET   0x18    // Sample counter
-
-//==========================================================================
-// Register Addresses
-//==========================================================================
-
-#define ADC_CTRL        ((volatile uint32_t*)(SIGMA_DELTA_ADC_BASE + ADC_CTRL_OFFSET))
-#define ADC_STATUS      ((volatile uint32_t*)(SIGMA_DELTA_ADC_BASE + ADC_STATUS_OFFSET))
-#define ADC_DATA_CH0    ((volatile uint32_t*)(SIGMA_DELTA_ADC_BASE + ADC_DATA_CH0_OFFSET))
-#define ADC_DATA_CH1    ((volatile uint32_t*)(SIGMA_DELTA_ADC_BASE + ADC_DATA_CH1_OFFSET))
-#define ADC_DATA_CH2    ((volatile uint32_t*)(SIGMA_DELTA_ADC_BASE + ADC_DATA_CH2_OFFSET))
-#define ADC_DATA_CH3    ((volatile uint32_t*)(SIGMA_DELTA_ADC_BASE + ADC_DATA_CH3_OFFSET))
-#define ADC_SAMPLE_CNT  ((volatile uint32_t*)(SIGMA_DELTA_ADC_BASE + ADC_SAMPLE_CNT_OFFSET))
-
-//==========================================================================
-// Control Register Bits
-//==========================================================================
-
-#define ADC_CTRL_ENABLE     (1 << 0)    // Enable ADC conversion
-
-//==========================================================================
-// Status Register Bits
-//==========================================================================
-
-#define ADC_STATUS_CH0_VALID    (1 << 0)    // Channel 0 data valid
-#define ADC_STATUS_CH1_VALID    (1 << 1)    // Channel 1 data valid
-#define ADC_STATUS_CH2_VALID    (1 << 2)    // Channel 2 data valid
-#define ADC_STATUS_CH3_VALID    (1 << 3)    // Channel 3 data valid
+// Registers and bit fields come from the generated SoC register map
+#include "memory_map.h"
 
 //==========================================================================
 // Calibration Constants (adjust based on external scaling)
@@ -127,14 +87,14 @@ typedef enum {
  * All 4 channels sample simultaneously at 10 kHz.
  */
 static inline void adc_init(void) {
-    *ADC_CTRL = ADC_CTRL_ENABLE;
+    ADC->CTRL = ADC_CTRL_ENABLE;
 }
 
 /**
  * @brief Disable the ADC
  */
 static inline void adc_disable(void) {
-    *ADC_CTRL = 0;
+    ADC->CTRL = 0;
 }
 
 /**
@@ -144,7 +104,7 @@ static inline void adc_disable(void) {
  * @return 1 if data is valid, 0 otherwise
  */
 static inline int adc_is_valid(adc_channel_t channel) {
-    return (*ADC_STATUS >> channel) & 1;
+    return (ADC->STATUS >> (ADC_STATUS_VALID_CH0_SHIFT + channel)) & 1;
 }
 
 /**
@@ -156,12 +116,12 @@ static inline int adc_is_valid(adc_channel_t channel) {
  * @note Reading a channel clears its valid flag
  */
 static inline uint16_t adc_read_raw(adc_channel_t channel) {
-    volatile uint32_t* reg;
+    const volatile uint32_t* reg;
     switch (channel) {
-        case ADC_CHANNEL_DC_BUS1: reg = ADC_DATA_CH0; break;
-        case ADC_CHANNEL_DC_BUS2: reg = ADC_DATA_CH1; break;
-        case ADC_CHANNEL_AC_VOLT: reg = ADC_DATA_CH2; break;
-        case ADC_CHANNEL_AC_CURR: reg = ADC_DATA_CH3; break;
+        case ADC_CHANNEL_DC_BUS1: reg = &ADC->DATA_CH0; break;
+        case ADC_CHANNEL_DC_BUS2: reg = &ADC->DATA_CH1; break;
+        case ADC_CHANNEL_AC_VOLT: reg = &ADC->DATA_CH2; break;
+        case ADC_CHANNEL_AC_CURR: reg = &ADC->DATA_CH3; break;
         default: return 0;
     }
     return (uint16_t)(*reg & 0xFFFF);
@@ -201,12 +161,12 @@ static inline float adc_read_ac_current(void) {
 }
 
 /**
- * @brief Get sample counter (for debug)
+ * @brief Get FIFO fill level (for debug)
  *
- * @return Number of complete sample cycles
+ * @return Samples waiting in the FIFO (FIFO mode only)
  */
-static inline uint32_t adc_get_sample_count(void) {
-    return *ADC_SAMPLE_CNT;
+static inline uint32_t adc_get_fifo_level(void) {
+    return ADC->FIFO_LEVEL;
 }
 
 /**
@@ -234,6 +194,7 @@ static inline int adc_wait_for_data(adc_channel_t channel, uint32_t timeout) {
 // Example: Read all channels continuously
 
 #include "sigma_delta_adc.h"
+#include "perf_counters.h"          // delay_us()
 
 void main(void) {
     // Initialize ADC
@@ -0,0 +1,121 @@
+/**
+ * @file sine_nco.h
+ * @brief Phase-Accumulator Sine Oscillator (quarter-wave LUT)
+ *
+ * Numerically controlled oscillator using the same phase scheme as the
+ * PWM accelerator's SINE_PHASE/SINE_FREQ registers:
+ *
+ *   phase[n+1] = phase[n] + step      (32-bit, 2^32 = 2π, wraps for free)
+ *   step       = f_out × 2^32 / f_update
+ *
+ * The sine is read from a 257-entry Q15 quarter-wave table with linear
+ * interpolation between entries. Peak error is 1 LSB of Q15 (3e-5); a
+ * sample costs one table pair load, one multiply and a handful of ALU
+ * instructions - no division, no soft-float.
+ *
+ * Phase bits:
+ *   [31]    half-wave (negate)
+ *   [30]    quarter (mirror index)
+ *   [29:22] table index (0..255)
+ *   [21:6]  interpolation fraction (16 bits)
+ *
+ * Because firmware and hardware share the phase representation, a firmware
+ * oscillator can be locked to the PWM generator by copying SINE_PHASE
+ * (see nco_sync()).
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#ifndef SINE_NCO_H
+#define SINE_NCO_H
+
+#include <stdint.h>
+#include "fixed_point.h"
+
+#define NCO_QUARTER_TURN    0x40000000u     // π/2
+#define NCO_HALF_TURN       0x80000000u     // π
+
+//==========================================================================
+// Data
+//==========================================================================
+
+typedef struct {
+    uint32_t phase;         // Current phase (2^32 = 2π)
+    uint32_t step;          // Phase increment per update
+} nco_t;
+
+// sin(i·π/512), i = 0..256, Q15 (defined in sine_nco.c)
+extern const q15_t sine_lut_quarter[257];
+
+//==========================================================================
+// Setup (call at init or on frequency change, not per sample)
+//==========================================================================
+
+/**
+ * @brief Phase increment for f_hz updated at f_s_hz
+ *
+ * Computes round(f_hz × 2^32 / f_s_hz) with a 32-step shift-subtract
+ * division, so it works for any 32-bit f_s_hz (control rate or CPU clock)
+ * without 64-bit libgcc helpers. f_hz must be below f_s_hz.
+ */
+uint32_t nco_freq_word(uint32_t f_hz, uint32_t f_s_hz);
+
+static inline void nco_init(nco_t* n, uint32_t step) {
+    n->phase = 0;
+    n->step = step;
+}
+
+static inline void nco_set_step(nco_t* n, uint32_t step) {
+    n->step = step;
+}
+
+/**
+ * @brief Lock the oscillator to an external phase (e.g. PWM SINE_PHASE)
+ *
+ * @param hw_phase Phase read from the reference
+ * @param offset   Constant lead to compensate read-to-use latency
+ */
+static inline void nco_sync(nco_t* n, uint32_t hw_phase, uint32_t offset) {
+    n->phase = hw_phase + offset;
+}
+
+//==========================================================================
+// Per-Sample Functions
+//==========================================================================
+
+/**
+ * @brief Sine of a 32-bit binary angle, Q15 result
+ */
+static inline q15_t sine_lut_q15(uint32_t phase) {
+    uint32_t p = phase & (NCO_QUARTER_TURN - 1);
+    if (phase & NCO_QUARTER_TURN) p ^= NCO_QUARTER_TURN - 1;   // Mirror 2nd/4th quarter
+
+    uint32_t idx = p >> 22;
+    int32_t frac = (int32_t)((p >> 6) & 0xFFFF);
+    int32_t y0 = sine_lut_quarter[idx];
+    int32_t y = y0 + (((sine_lut_quarter[idx + 1] - y0) * frac + 0x8000) >> 16);
+
+    return (q15_t)((phase & NCO_HALF_TURN) ? -y : y);
+}
+
+static inline q15_t cosine_lut_q15(uint32_t phase) {
+    return sine_lut_q15(phase + NCO_QUARTER_TURN);
+}
+
+/**
+ * @brief Advance the oscillator one update and return the new phase
+ */
+static inline uint32_t nco_advance(nco_t* n) {
+    n->phase += n->step;
+    return n->phase;
+}
+
+/**
+ * @brief Advance the oscillator and return sin(phase), Q15
+ */
+static inline q15_t nco_next_sin(nco_t* n) {
+    return sine_lut_q15(nco_advance(n));
+}
+
+#endif // SINE_NCO_H
@@ -0,0 +1,145 @@
+/**
+ * @file zpec.h
+ * @brief Zpec Power-Electronics Custom Instructions (intrinsics + C fallback)
+ *
+ * The control ISR spends most of its time in a few fixed-point kernels:
+ * the saturating multiply-accumulates of the PI+R controller, the clamp to
+ * ±MAX_MODULATION, Q-format scaling of the ADC codes and the sine lookup.
+ * On plain RV32IM each widening multiply is a mul + mulh pair on the
+ * multi-cycle MDU followed by a compare-and-branch saturation sequence.
+ * Zpec implements them as single-cycle R-type instructions on the custom-0
+ * major opcode (rtl/core/zpec_unit.v, synthesized with `make synth_zpec`):
+ *
+ *   funct3  Mnemonic     Operation
+ *   000     pe.mulg      rd = sat32(rs1[15:0] × rs2)          Q15 × 16.16 → Q31
+ *   001     pe.mulq29    rd = sat32((rs1 × rs2) >> 29)        Q3.29 × Q31 → Q31
+ *   010     pe.adds      rd = sat32(rs1 + rs2)
+ *   011     pe.subs      rd = sat32(rs1 - rs2)
+ *   100     pe.clamp     rd = min(max(rs1, -rs2), rs2)        rs2 ≥ 0
+ *   101     pe.adcb      rd = sat16(rs1[15:0] - rs2[15:0])    unsigned ADC codes → Q15
+ *   110     pe.sin       rd = sin(rs1), 2^32 = one turn       Q15, rs2 ignored
+ *   111     pe.mulq15    rd = sat16((rs1 × rs2 + 2^14) >> 15)
+ *
+ * All encodings use opcode 0x0B and funct7 = 0; other funct7 values are
+ * reserved and trap as illegal instructions. A saturating MAC is
+ * zpec_mulg() followed by zpec_adds().
+ *
+ * Build with `make ZPEC=1` (defines USE_ZPEC) to emit the instructions via
+ * the assembler's .insn directive, so no toolchain patch is needed. Without
+ * it each intrinsic compiles to its fixed_point.h / sine_nco.h equivalent.
+ * Hardware and fallback are bit-exact, so a ZPEC=1 image only differs in
+ * cycle count - but it only runs on a core synthesized with ZPEC_ENABLED.
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#ifndef ZPEC_H
+#define ZPEC_H
+
+#include <stdint.h>
+#include "fixed_point.h"
+#include "sine_nco.h"
+
+#define ZPEC_OPCODE         0x0B    // custom-0
+
+#define ZPEC_F3_MULG        0
+#define ZPEC_F3_MULQ29      1
+#define ZPEC_F3_ADDS        2
+#define ZPEC_F3_SUBS        3
+#define ZPEC_F3_CLAMP       4
+#define ZPEC_F3_ADCB        5
+#define ZPEC_F3_SIN         6
+#define ZPEC_F3_MULQ15      7
+
+#ifdef USE_ZPEC
+
+//==========================================================================
+// Custom Instructions
+//==========================================================================
+
+// Stringize the funct3 so it can be pasted into the .insn template
+#define ZPEC_STR_(x)        #x
+#define ZPEC_STR(x)         ZPEC_STR_(x)
+
+#define ZPEC_RR(f3, a, b) ({                                            \
+    int32_t zpec_rd_;                                                   \
+    asm ("\t.insn r " ZPEC_STR(ZPEC_OPCODE) ", " ZPEC_STR(f3)           \
+         ", 0, %0, %1, %2"                                              \
+         : "=r"(zpec_rd_) : "r"((int32_t)(a)), "r"((int32_t)(b)));      \
+    zpec_rd_;                                                           \
+})
+
+static inline q31_t zpec_mulg(q15_t x, qgain_t gain) {
+    return ZPEC_RR(ZPEC_F3_MULG, x, gain);
+}
+
+static inline q31_t zpec_mulq29(q31_t coeff, q31_t x) {
+    return ZPEC_RR(ZPEC_F3_MULQ29, coeff, x);
+}
+
+static inline q31_t zpec_adds(q31_t a, q31_t b) {
+    return ZPEC_RR(ZPEC_F3_ADDS, a, b);
+}
+
+static inline q31_t zpec_subs(q31_t a, q31_t b) {
+    return ZPEC_RR(ZPEC_F3_SUBS, a, b);
+}
+
+static inline q31_t zpec_clamp(q31_t x, q31_t limit) {
+    return ZPEC_RR(ZPEC_F3_CLAMP, x, limit);
+}
+
+static inline q15_t zpec_adc_bipolar(uint16_t raw, uint16_t offset) {
+    return (q15_t)ZPEC_RR(ZPEC_F3_ADCB, raw, offset);
+}
+
+static inline q15_t zpec_sin(uint32_t phase) {
+    return (q15_t)ZPEC_RR(ZPEC_F3_SIN, phase, 0);
+}
+
+static inline q15_t zpec_mulq15(q15_t a, q15_t b) {
+    return (q15_t)ZPEC_RR(ZPEC_F3_MULQ15, a, b);
+}
+
+#else
+
+//==========================================================================
+// C Fallback (reference semantics of the instructions)
+//==========================================================================
+
+static inline q31_t zpec_mulg(q15_t x, qgain_t gain) {
+    return q15_mul_gain(x, gain);
+}
+
+static inline q31_t zpec_mulq29(q31_t coeff, q31_t x) {
+    return q31_mul_q29(coeff, x);
+}
+
+static inline q31_t zpec_adds(q31_t a, q31_t b) {
+    return q31_add(a, b);
+}
+
+static inline q31_t zpec_subs(q31_t a, q31_t b) {
+    return q31_sub(a, b);
+}
+
+static inline q31_t zpec_clamp(q31_t x, q31_t limit) {
+    return q31_clamp(x, limit);
+}
+
+static inline q15_t zpec_adc_bipolar(uint16_t raw, uint16_t offset) {
+    return q15_from_adc_bipolar(raw, offset);
+}
+
+static inline q15_t zpec_sin(uint32_t phase) {
+    return sine_lut_q15(phase);
+}
+
+static inline q15_t zpec_mulq15(q15_t a, q15_t b) {
+    return q15_mul(a, b);
+}
+
+#endif // USE_ZPEC
+
+#endif // ZPEC_H
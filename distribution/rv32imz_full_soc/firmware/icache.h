@@ -0,0 +1,63 @@
+/**
+ * @file icache.h
+ * @brief Instruction Cache Control and Hit/Miss Counters
+ *
+ * rtl/memory/icache.v sits between the core's instruction port and ROM.
+ * It comes out of reset disabled (every fetch goes to ROM, as without the
+ * cache), so the bootloader never runs from stale lines. The application
+ * calls icache_enable() once at init.
+ *
+ * HITS and MISSES count cacheable fetches since the last icache_clear_stats()
+ * and wrap at 2^32. The cache does not snoop writes: the bootloader programs
+ * the application region with it disabled, and anything that rewrites code
+ * while it is enabled must call icache_flush() before executing it.
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#ifndef ICACHE_H
+#define ICACHE_H
+
+#include <stdint.h>
+#include "soc_regs.h"
+
+/**
+ * @brief Invalidate all lines and start caching
+ */
+static inline void icache_enable(void) {
+    ICACHE->CTRL = ICACHE_CTRL_FLUSH | ICACHE_CTRL_CLEAR_STATS;
+    ICACHE->CTRL = ICACHE_CTRL_ENABLE;
+}
+
+/**
+ * @brief Send every fetch to ROM again (lines are kept but not used)
+ */
+static inline void icache_disable(void) {
+    ICACHE->CTRL = 0;
+}
+
+/**
+ * @brief Invalidate all lines, keeping the enable state
+ */
+static inline void icache_flush(void) {
+    ICACHE->CTRL = (ICACHE->CTRL & ICACHE_CTRL_ENABLE) | ICACHE_CTRL_FLUSH;
+}
+
+static inline void icache_clear_stats(void) {
+    ICACHE->CTRL = (ICACHE->CTRL & ICACHE_CTRL_ENABLE) | ICACHE_CTRL_CLEAR_STATS;
+}
+
+static inline uint32_t icache_hits(void) {
+    return ICACHE->HITS;
+}
+
+static inline uint32_t icache_misses(void) {
+    return ICACHE->MISSES;
+}
+
+static inline uint32_t icache_size_bytes(void) {
+    return icache_config_size_get(ICACHE->CONFIG);
+}
+
+#endif // ICACHE_H
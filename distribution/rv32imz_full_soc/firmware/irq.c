@@ -0,0 +1,122 @@
+/**
+ * @file irq.c
+ * @brief Machine-Mode Interrupt Dispatch and Timing Statistics
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "irq.h"
+#include "tcm.h"
+
+typedef struct {
+    irq_handler_t handler;
+    irq_latency_probe_t probe;
+} irq_entry_t;
+
+// Read on every interrupt, so they live in the TCM with trap_dispatch
+FAST_DATA static irq_entry_t irq_table[IRQ_COUNT];
+FAST_DATA static volatile irq_stats_t irq_stats[IRQ_COUNT];
+FAST_DATA static volatile uint32_t irq_spurious;
+
+// Last unhandled exception, for inspection from a debugger
+volatile uint32_t trap_last_cause;
+volatile uint32_t trap_last_epc;
+volatile uint32_t trap_last_tval;
+
+//==========================================================================
+// Registration
+//==========================================================================
+
+void irq_register(unsigned irq, irq_handler_t handler, irq_latency_probe_t probe) {
+    if (irq >= IRQ_COUNT) return;
+    irq_table[irq].handler = handler;
+    irq_table[irq].probe = probe;
+    irq_reset_stats(irq);
+}
+
+void irq_set_deadline(unsigned irq, uint32_t cycles) {
+    if (irq >= IRQ_COUNT) return;
+    irq_stats[irq].deadline = cycles;
+}
+
+const volatile irq_stats_t* irq_get_stats(unsigned irq) {
+    return (irq < IRQ_COUNT) ? &irq_stats[irq] : NULL;
+}
+
+void irq_reset_stats(unsigned irq) {
+    if (irq >= IRQ_COUNT) return;
+    uint32_t mstatus = irq_save();
+    volatile irq_stats_t* s = &irq_stats[irq];
+    s->count = 0;
+    s->latency_last = 0;
+    s->latency_max = 0;
+    s->duration_last = 0;
+    s->duration_max = 0;
+    s->deadline_misses = 0;
+    irq_restore(mstatus);
+}
+
+uint32_t irq_spurious_count(void) {
+    return irq_spurious;
+}
+
+//==========================================================================
+// Trap Handling (called from trap.S)
+//==========================================================================
+
+__attribute__((weak))
+void trap_exception(uint32_t mcause, uint32_t mepc, uint32_t mtval) {
+    trap_last_cause = mcause;
+    trap_last_epc = mepc;
+    trap_last_tval = mtval;
+
+    // No recovery: retrying the faulting instruction would loop forever
+    while (1) {
+        asm volatile("wfi");
+    }
+}
+
+FAST_TEXT void trap_dispatch(uint32_t mcause, uint32_t entry_cycle) {
+    if (!(mcause & MCAUSE_INTERRUPT)) {
+        uint32_t mepc, mtval;
+        asm volatile("csrr %0, mepc" : "=r"(mepc));
+        asm volatile("csrr %0, mtval" : "=r"(mtval));
+        trap_exception(mcause, mepc, mtval);
+        return;
+    }
+
+    uint32_t irq = mcause & MCAUSE_CODE_MASK;
+    if (irq >= IRQ_COUNT || irq_table[irq].handler == NULL) {
+        // Mask it, otherwise a level-triggered source re-enters forever
+        irq_disable(irq);
+        irq_spurious++;
+        return;
+    }
+
+    const irq_entry_t* e = &irq_table[irq];
+    volatile irq_stats_t* s = &irq_stats[irq];
+
+    // Probe reports time since the event; remove the time spent since entry.
+    // Sampling mcycle first errs on the side of over-reporting latency.
+    uint32_t latency = 0;
+    if (e->probe != NULL) {
+        uint32_t in_trap = read_mcycle() - entry_cycle;
+        latency = e->probe() - in_trap;
+    }
+
+    e->handler();
+
+    uint32_t duration = read_mcycle() - entry_cycle;
+
+    s->count++;
+    s->latency_last = latency;
+    if (latency > s->latency_max) s->latency_max = latency;
+    s->duration_last = duration;
+    if (duration > s->duration_max) s->duration_max = duration;
+    if (s->deadline != 0 && latency + duration > s->deadline) {
+        s->deadline_misses++;
+    }
+}
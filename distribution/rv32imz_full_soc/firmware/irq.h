@@ -0,0 +1,143 @@
+/**
+ * @file irq.h
+ * @brief Machine-Mode Interrupt Dispatch and Timing Statistics
+ *
+ * trap.S saves the caller-saved registers, samples mcycle and calls
+ * trap_dispatch(), which looks up the handler registered for the
+ * interrupt cause and records per-IRQ timing:
+ *
+ * - latency : cycles from the source event to the first trap instruction
+ *             (needs a latency probe that reports cycles since the event,
+ *             e.g. the timer COUNT register)
+ * - duration: cycles from trap entry to handler return
+ *
+ * With a deadline set, every interrupt whose latency + duration exceeds it
+ * is counted as a miss, so a control loop can prove its period is met.
+ *
+ * IRQ numbers are mcause exception codes / mie bit positions.
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#ifndef IRQ_H
+#define IRQ_H
+
+#include <stdint.h>
+
+//==========================================================================
+// Interrupt Numbers (mcause code = mie/mip bit)
+//==========================================================================
+
+#define IRQ_SOFTWARE        3       // Machine software interrupt
+#define IRQ_TIMER           7       // Machine timer interrupt (SoC timer)
+#define IRQ_EXTERNAL        11      // Machine external interrupt
+#define IRQ_ADC             16      // Platform interrupts (mie bits 16+)
+#define IRQ_UART            17
+#define IRQ_PROT            18
+#define IRQ_DMA             19
+#define IRQ_COUNT           20
+
+#define MCAUSE_INTERRUPT    0x80000000u
+#define MCAUSE_CODE_MASK    0x0000001Fu
+
+#define MSTATUS_MIE         (1 << 3)
+
+//==========================================================================
+// Types
+//==========================================================================
+
+typedef void (*irq_handler_t)(void);
+
+/**
+ * @brief Returns the cycles elapsed since the interrupt source's event
+ */
+typedef uint32_t (*irq_latency_probe_t)(void);
+
+typedef struct {
+    uint32_t count;             // Interrupts serviced
+    uint32_t latency_last;      // Event → trap entry (cycles)
+    uint32_t latency_max;
+    uint32_t duration_last;     // Trap entry → handler return (cycles)
+    uint32_t duration_max;
+    uint32_t deadline;          // Latency + duration limit (0 = none)
+    uint32_t deadline_misses;   // Interrupts that exceeded the deadline
+} irq_stats_t;
+
+//==========================================================================
+// CSR Access
+//==========================================================================
+
+static inline uint32_t read_mcycle(void) {
+    uint32_t value;
+    asm volatile("csrr %0, mcycle" : "=r"(value));
+    return value;
+}
+
+static inline void irq_global_enable(void) {
+    asm volatile("csrs mstatus, %0" :: "r"(MSTATUS_MIE) : "memory");
+}
+
+static inline void irq_global_disable(void) {
+    asm volatile("csrc mstatus, %0" :: "r"(MSTATUS_MIE) : "memory");
+}
+
+/**
+ * @brief Disable interrupts and return the previous mstatus for irq_restore()
+ */
+static inline uint32_t irq_save(void) {
+    uint32_t mstatus;
+    asm volatile("csrrc %0, mstatus, %1" : "=r"(mstatus) : "r"(MSTATUS_MIE) : "memory");
+    return mstatus;
+}
+
+static inline void irq_restore(uint32_t mstatus) {
+    if (mstatus & MSTATUS_MIE) {
+        irq_global_enable();
+    }
+}
+
+static inline void irq_enable(unsigned irq) {
+    asm volatile("csrs mie, %0" :: "r"(1u << irq) : "memory");
+}
+
+static inline void irq_disable(unsigned irq) {
+    asm volatile("csrc mie, %0" :: "r"(1u << irq) : "memory");
+}
+
+//==========================================================================
+// Handler Registration and Statistics
+//==========================================================================
+
+/**
+ * @brief Install a handler for an interrupt (does not enable it)
+ *
+ * @param probe Optional latency probe, NULL if the source has no timestamp
+ */
+void irq_register(unsigned irq, irq_handler_t handler, irq_latency_probe_t probe);
+
+/**
+ * @brief Set the latency + duration budget for an interrupt (cycles)
+ */
+void irq_set_deadline(unsigned irq, uint32_t cycles);
+
+/**
+ * @brief Timing statistics of an interrupt (updated from trap context)
+ */
+const volatile irq_stats_t* irq_get_stats(unsigned irq);
+
+void irq_reset_stats(unsigned irq);
+
+/**
+ * @brief Interrupts taken with no registered handler (they are masked)
+ */
+uint32_t irq_spurious_count(void);
+
+/**
+ * @brief Synchronous exception hook
+ *
+ * Weak default records the cause and halts; applications may override it.
+ */
+void trap_exception(uint32_t mcause, uint32_t mepc, uint32_t mtval);
+
+#endif // IRQ_H
@@ -0,0 +1,170 @@
+/**
+ * @file perf_counters.h
+ * @brief Zicntr/Zihpm Performance Counters and Cycle-Accurate Delays
+ *
+ * The core counts every clock in mcycle and every retired instruction in
+ * minstret. Four hardware performance counters (mhpmcounter3-6) each count
+ * one event, selected by writing an event number to mhpmevent3-6:
+ *
+ *   perf_select(0, PERF_EV_MDU_BUSY);
+ *   perf_select(1, PERF_EV_DBUS_WAIT);
+ *   perf_reset();
+ *   ... code under test ...
+ *   uint32_t mdu = perf_read(0), bus = perf_read(1);
+ *
+ * Event numbers match rtl/core/custom_riscv_core_pipe.v. All counters are
+ * 64 bits; the 32-bit reads below wrap after 85 s at 50 MHz, which is
+ * plenty for differences. Use perf_cycles64() for absolute timestamps.
+ *
+ * delay_cycles()/delay_us()/delay_ms() spin on mcycle, so they are exact
+ * to a few cycles regardless of optimisation level, cache or wait states
+ * (interrupts still extend them). They replace the volatile counting loops
+ * whose duration depended on the compiler.
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdint.h>
+
+#ifndef PERF_CPU_FREQ_HZ
+#define PERF_CPU_FREQ_HZ    50000000    // mcycle rate (system clock)
+#endif
+
+#define PERF_NUM_COUNTERS   4           // mhpmcounter3-6
+
+//==========================================================================
+// Events (mhpmevent values)
+//==========================================================================
+
+#define PERF_EV_NONE            0
+#define PERF_EV_STALL           1       // ID stalled, any cause
+#define PERF_EV_LOAD_USE        2       // Load/CSR-use bubbles
+#define PERF_EV_IBUS_WAIT       3       // Instruction fetch waiting for ack
+#define PERF_EV_DBUS_WAIT       4       // Load/store waiting for ack
+#define PERF_EV_MDU_BUSY        5       // EX waiting for the multiply/divide unit
+#define PERF_EV_BRANCH          6       // Conditional branches executed
+#define PERF_EV_BRANCH_TAKEN    7       // Conditional branches taken
+#define PERF_EV_JUMP            8       // JAL/JALR
+#define PERF_EV_IRQ             9       // Interrupts taken
+
+// mcountinhibit bits
+#define PERF_INHIBIT_CY         (1u << 0)
+#define PERF_INHIBIT_IR         (1u << 2)
+#define PERF_INHIBIT_HPM(n)     (1u << ((n) + 3))
+#define PERF_INHIBIT_ALL        0x7Du
+
+//==========================================================================
+// CSR Access
+//==========================================================================
+
+#define PERF_CSR_READ(csr) ({                                           \
+    uint32_t perf_v_;                                                   \
+    asm volatile("csrr %0, " #csr : "=r"(perf_v_));                     \
+    perf_v_;                                                            \
+})
+
+#define PERF_CSR_WRITE(csr, value)                                      \
+    asm volatile("csrw " #csr ", %0" :: "r"((uint32_t)(value)))
+
+static inline uint32_t perf_cycles(void) {
+    return PERF_CSR_READ(mcycle);
+}
+
+static inline uint32_t perf_instret(void) {
+    return PERF_CSR_READ(minstret);
+}
+
+/**
+ * @brief Full 64-bit cycle count (re-reads if the low word wrapped)
+ */
+static inline uint64_t perf_cycles64(void) {
+    uint32_t hi, lo;
+    do {
+        hi = PERF_CSR_READ(mcycleh);
+        lo = PERF_CSR_READ(mcycle);
+    } while (hi != PERF_CSR_READ(mcycleh));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+/**
+ * @brief Read hardware counter @p n (0-3 = mhpmcounter3-6)
+ */
+static inline uint32_t perf_read(unsigned n) {
+    switch (n) {
+    case 0:  return PERF_CSR_READ(mhpmcounter3);
+    case 1:  return PERF_CSR_READ(mhpmcounter4);
+    case 2:  return PERF_CSR_READ(mhpmcounter5);
+    case 3:  return PERF_CSR_READ(mhpmcounter6);
+    default: return 0;
+    }
+}
+
+/**
+ * @brief Count @p event on hardware counter @p n (does not clear it)
+ */
+static inline void perf_select(unsigned n, uint32_t event) {
+    switch (n) {
+    case 0:  PERF_CSR_WRITE(mhpmevent3, event); break;
+    case 1:  PERF_CSR_WRITE(mhpmevent4, event); break;
+    case 2:  PERF_CSR_WRITE(mhpmevent5, event); break;
+    case 3:  PERF_CSR_WRITE(mhpmevent6, event); break;
+    default: break;
+    }
+}
+
+/**
+ * @brief Stop the counters set in @p mask (PERF_INHIBIT_*), run the others
+ */
+static inline void perf_inhibit(uint32_t mask) {
+    PERF_CSR_WRITE(mcountinhibit, mask);
+}
+
+/**
+ * @brief Zero minstret and the hardware counters (mcycle keeps running)
+ *
+ * The counters are frozen while they are cleared so all of them start
+ * from the same instruction.
+ */
+static inline void perf_reset(void) {
+    perf_inhibit(PERF_INHIBIT_IR | PERF_INHIBIT_HPM(0) | PERF_INHIBIT_HPM(1) |
+                 PERF_INHIBIT_HPM(2) | PERF_INHIBIT_HPM(3));
+    PERF_CSR_WRITE(minstret, 0);
+    PERF_CSR_WRITE(minstreth, 0);
+    PERF_CSR_WRITE(mhpmcounter3, 0);
+    PERF_CSR_WRITE(mhpmcounter4, 0);
+    PERF_CSR_WRITE(mhpmcounter5, 0);
+    PERF_CSR_WRITE(mhpmcounter6, 0);
+    PERF_CSR_WRITE(mhpmcounter3h, 0);
+    PERF_CSR_WRITE(mhpmcounter4h, 0);
+    PERF_CSR_WRITE(mhpmcounter5h, 0);
+    PERF_CSR_WRITE(mhpmcounter6h, 0);
+    perf_inhibit(0);
+}
+
+//==========================================================================
+// Delays
+//==========================================================================
+
+static inline void delay_cycles(uint32_t cycles) {
+    uint32_t start = perf_cycles();
+    while (perf_cycles() - start < cycles);
+}
+
+static inline void delay_us(uint32_t us) {
+    delay_cycles(us * (PERF_CPU_FREQ_HZ / 1000000));
+}
+
+/**
+ * @brief Busy-wait @p ms milliseconds, in 1 ms steps so any length fits
+ */
+static inline void delay_ms(uint32_t ms) {
+    while (ms--) {
+        delay_cycles(PERF_CPU_FREQ_HZ / 1000);
+    }
+}
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,79 @@
+/**
+ * @file profile.c
+ * @brief mcycle-Based Stage Profiler - Storage and UART Report
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#include <stdint.h>
+#include "profile.h"
+#include "irq.h"
+#include "icache.h"
+#include "uart.h"
+
+profile_stage_t profile_stages[PROFILE_MAX_STAGES];
+uint32_t profile_last_cycle;
+
+static const char* const* profile_names;
+static unsigned profile_count;
+
+void profile_init(const char* const* names, unsigned count) {
+    if (count > PROFILE_MAX_STAGES) count = PROFILE_MAX_STAGES;
+    profile_names = names;
+    profile_count = count;
+    profile_reset();
+}
+
+void profile_reset(void) {
+    // Stats are written from the ISR, so clear them with interrupts masked
+    uint32_t mstatus = irq_save();
+    for (unsigned i = 0; i < PROFILE_MAX_STAGES; i++) {
+        profile_stage_t* s = &profile_stages[i];
+        s->count = 0;
+        s->min = UINT32_MAX;
+        s->max = 0;
+        s->mean = 0;
+        s->block_sum = 0;
+        s->block_count = 0;
+        for (unsigned b = 0; b < PROFILE_HIST_BINS; b++) {
+            s->hist[b] = 0;
+        }
+    }
+    irq_reset_stats(IRQ_TIMER);
+    icache_clear_stats();
+    irq_restore(mstatus);
+}
+
+void profile_dump(void) {
+    uart_puts("\r\n=== Profile (cycles) ===\r\n");
+
+    for (unsigned i = 0; i < profile_count; i++) {
+        const profile_stage_t* s = &profile_stages[i];
+
+        // Snapshot the summary so it is consistent while the ISR runs
+        uint32_t mstatus = irq_save();
+        uint32_t count = s->count;
+        uint32_t min = s->min;
+        uint32_t max = s->max;
+        uint32_t mean = s->mean;
+        irq_restore(mstatus);
+
+        // A full dump is larger than the TX ring: drain between stages
+        uart_flush();
+        uart_printf("%s: n=%u min=%u max=%u mean=%u\r\n  hist",
+                    profile_names[i], count, count ? min : 0, max, mean);
+        for (unsigned b = 0; b < PROFILE_HIST_BINS; b++) {
+            uart_printf(" %u", s->hist[b]);
+        }
+        uart_puts("\r\n");
+    }
+
+    const volatile irq_stats_t* t = irq_get_stats(IRQ_TIMER);
+    uart_flush();
+    uart_printf("timer irq: n=%u latency_max=%u duration_max=%u deadline=%u misses=%u\r\n",
+                t->count, t->latency_max, t->duration_max, t->deadline, t->deadline_misses);
+    uart_printf("uart: tx_dropped=%u rx_dropped=%u tx_high_water=%u\r\n",
+                uart_stats.tx_dropped, uart_stats.rx_dropped, uart_stats.tx_high_water);
+    uart_printf("icache: hits=%u misses=%u\r\n", icache_hits(), icache_misses());
+}
@@ -0,0 +1,128 @@
+/**
+ * @file profile.h
+ * @brief mcycle-Based Stage Profiler
+ *
+ * Splits a code path (typically an ISR) into numbered stages and keeps,
+ * per stage, min/max, a windowed mean and a cycle histogram in RAM:
+ *
+ *   profile_start();
+ *   adc_read_all();       profile_mark(STAGE_ADC);
+ *   run_controller();     profile_mark(STAGE_CTRL);
+ *
+ * Each marker is one mcycle read plus a few loads/stores; no division.
+ * The mean is taken over blocks of 2^PROFILE_MEAN_SHIFT samples so it can
+ * be computed with a shift. Histogram bins are 2^PROFILE_BIN_SHIFT cycles
+ * wide; the last bin collects everything above the range.
+ *
+ * Without USE_PROFILER the markers compile to nothing.
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+#include "irq.h"
+
+#ifndef PROFILE_MAX_STAGES
+#define PROFILE_MAX_STAGES  8
+#endif
+
+#ifndef PROFILE_HIST_BINS
+#define PROFILE_HIST_BINS   16
+#endif
+
+#ifndef PROFILE_BIN_SHIFT
+#define PROFILE_BIN_SHIFT   6       // 64 cycles per bin
+#endif
+
+#ifndef PROFILE_MEAN_SHIFT
+#define PROFILE_MEAN_SHIFT  10      // Mean over 1024 samples
+#endif
+
+//==========================================================================
+// Data
+//==========================================================================
+
+typedef struct {
+    uint32_t count;                     // Samples recorded
+    uint32_t min;                       // Cycles
+    uint32_t max;
+    uint32_t mean;                      // Mean of the last complete block
+    uint32_t block_sum;                 // Running block accumulator
+    uint32_t block_count;
+    uint32_t hist[PROFILE_HIST_BINS];
+} profile_stage_t;
+
+extern profile_stage_t profile_stages[PROFILE_MAX_STAGES];
+extern uint32_t profile_last_cycle;
+
+//==========================================================================
+// Setup and Reporting (background context)
+//==========================================================================
+
+/**
+ * @brief Name the stages and clear all statistics
+ *
+ * @param names Array of @p count stage names (kept by reference)
+ */
+void profile_init(const char* const* names, unsigned count);
+
+void profile_reset(void);
+
+/**
+ * @brief Print all stage statistics and the timer IRQ timing over UART
+ */
+void profile_dump(void);
+
+//==========================================================================
+// Markers (hot path)
+//==========================================================================
+
+static inline void profile_record(unsigned stage, uint32_t cycles) {
+    profile_stage_t* s = &profile_stages[stage];
+
+    s->count++;
+    if (cycles < s->min) s->min = cycles;
+    if (cycles > s->max) s->max = cycles;
+
+    uint32_t bin = cycles >> PROFILE_BIN_SHIFT;
+    if (bin >= PROFILE_HIST_BINS) bin = PROFILE_HIST_BINS - 1;
+    s->hist[bin]++;
+
+    s->block_sum += cycles;
+    if (++s->block_count == (1u << PROFILE_MEAN_SHIFT)) {
+        s->mean = s->block_sum >> PROFILE_MEAN_SHIFT;
+        s->block_sum = 0;
+        s->block_count = 0;
+    }
+}
+
+#ifdef USE_PROFILER
+
+/**
+ * @brief Start timing; the first profile_mark() measures from here
+ */
+static inline void profile_start(void) {
+    profile_last_cycle = read_mcycle();
+}
+
+/**
+ * @brief Close @p stage: record the cycles since the previous marker
+ */
+static inline void profile_mark(unsigned stage) {
+    uint32_t now = read_mcycle();
+    profile_record(stage, now - profile_last_cycle);
+    profile_last_cycle = now;
+}
+
+#else
+
+static inline void profile_start(void) {}
+static inline void profile_mark(unsigned stage) { (void)stage; }
+
+#endif // USE_PROFILER
+
+#endif // PROFILE_H
@@ -0,0 +1,1011 @@
+/**
+ * @file soc_regs.h
+ * @brief RV32IMZ 5-level CHB inverter SoC - memory and peripheral register map
+ *
+ * GENERATED from soc_regs.json by tools/gen_regmap.py - do not edit.
+ *
+ * Access: rw = read/write, ro = read-only (const member),
+ *         wo = write-only, w1c = write 1 to clear.
+ */
+
+#ifndef SOC_REGS_H
+#define SOC_REGS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+//=============================================================================
+// Memory Regions
+//=============================================================================
+
+#define ROM_BASE        0x00000000u  // Instruction ROM (32 KB)
+#define ROM_SIZE        0x00008000u
+#define BOOT_BASE       0x00000000u  // Bootloader region of ROM (16 KB)
+#define BOOT_SIZE       0x00004000u
+#define APP_BASE        0x00004000u  // Application region of ROM (16 KB)
+#define APP_SIZE        0x00004000u
+#define RAM_BASE        0x00010000u  // Data RAM (64 KB)
+#define RAM_SIZE        0x00010000u
+#define PERIPH_BASE     0x00020000u  // Peripheral space
+#define PERIPH_SIZE     0x00010000u
+#define TCM_BASE        0x00030000u  // Tightly-coupled memory, zero wait states (8 KB)
+#define TCM_SIZE        0x00002000u
+
+//=============================================================================
+// PWM Accelerator (Base: 0x00020000)
+//=============================================================================
+
+#define PWM_BASE        (PERIPH_BASE + 0x0000)
+#define PWM_SIZE        0x00000100u
+
+typedef volatile struct {
+    uint32_t CTRL;              // 0x00: Control register (rw)
+    uint32_t FREQ_DIV;          // 0x04: Carrier frequency divider (rw)
+    uint32_t MOD_INDEX;         // 0x08: Modulation index (0-65535 = 0-1.0) (rw)
+    uint32_t SINE_PHASE;        // 0x0C: Sine phase accumulator (2^32 = 2pi) (rw)
+    uint32_t SINE_FREQ;         // 0x10: Phase increment per clock (f_out * 2^32 / f_clk) (rw)
+    uint32_t DEADTIME;          // 0x14: Dead-time in clock cycles (rw)
+    const uint32_t STATUS;      // 0x18: Status register (ro)
+    const uint32_t PWM_OUT;     // 0x1C: Current PWM output state (ro)
+    uint32_t CPU_REFERENCE;     // 0x20: CPU-provided reference for CPU mode (rw)
+    uint32_t BRIDGE1_REF;       // 0x24: H-bridge 1 reference, shadow (Q15) (rw)
+    uint32_t BRIDGE2_REF;       // 0x28: H-bridge 2 reference, shadow (Q15) (rw)
+} pwm_regs_t;
+
+#define PWM ((pwm_regs_t*)PWM_BASE)
+
+_Static_assert(offsetof(pwm_regs_t, CTRL) == 0x00, "PWM.CTRL offset");
+_Static_assert(offsetof(pwm_regs_t, FREQ_DIV) == 0x04, "PWM.FREQ_DIV offset");
+_Static_assert(offsetof(pwm_regs_t, MOD_INDEX) == 0x08, "PWM.MOD_INDEX offset");
+_Static_assert(offsetof(pwm_regs_t, SINE_PHASE) == 0x0C, "PWM.SINE_PHASE offset");
+_Static_assert(offsetof(pwm_regs_t, SINE_FREQ) == 0x10, "PWM.SINE_FREQ offset");
+_Static_assert(offsetof(pwm_regs_t, DEADTIME) == 0x14, "PWM.DEADTIME offset");
+_Static_assert(offsetof(pwm_regs_t, STATUS) == 0x18, "PWM.STATUS offset");
+_Static_assert(offsetof(pwm_regs_t, PWM_OUT) == 0x1C, "PWM.PWM_OUT offset");
+_Static_assert(offsetof(pwm_regs_t, CPU_REFERENCE) == 0x20, "PWM.CPU_REFERENCE offset");
+_Static_assert(offsetof(pwm_regs_t, BRIDGE1_REF) == 0x24, "PWM.BRIDGE1_REF offset");
+_Static_assert(offsetof(pwm_regs_t, BRIDGE2_REF) == 0x28, "PWM.BRIDGE2_REF offset");
+
+// PWM CTRL fields
+#define PWM_CTRL_ENABLE             0x00000001u  // Enable PWM generation
+#define PWM_CTRL_ENABLE_SHIFT       0
+#define PWM_CTRL_ENABLE_WIDTH       1
+#define PWM_CTRL_CPU_MODE           0x00000002u  // 0 = hardware sine, 1 = CPU_REFERENCE (old headers: UPDATE, or AUTO_MODE with the opposite sense; CPU_MODE is what chb_5level_control.c drives)
+#define PWM_CTRL_CPU_MODE_SHIFT     1
+#define PWM_CTRL_CPU_MODE_WIDTH     1
+#define PWM_CTRL_SYNC_EN            0x00000004u  // Enable carrier synchronization
+#define PWM_CTRL_SYNC_EN_SHIFT      2
+#define PWM_CTRL_SYNC_EN_WIDTH      1
+#define PWM_CTRL_BRIDGE_REF         0x00000008u  // CPU mode: per-bridge BRIDGEn_REF instead of CPU_REFERENCE
+#define PWM_CTRL_BRIDGE_REF_SHIFT   3
+#define PWM_CTRL_BRIDGE_REF_WIDTH   1
+#define PWM_CTRL_UPDATE             0x00000010u  // Write 1: latch BRIDGEn_REF at the next carrier sync (reads 1 until done); bit 1 in the old memory_map.h, moved because bit 1 is CPU_MODE
+#define PWM_CTRL_UPDATE_SHIFT       4
+#define PWM_CTRL_UPDATE_WIDTH       1
+
+static inline uint32_t pwm_ctrl_enable_get(uint32_t reg) {
+    return (reg & PWM_CTRL_ENABLE) >> PWM_CTRL_ENABLE_SHIFT;
+}
+static inline uint32_t pwm_ctrl_enable_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PWM_CTRL_ENABLE) | ((value << PWM_CTRL_ENABLE_SHIFT) & PWM_CTRL_ENABLE);
+}
+static inline uint32_t pwm_ctrl_cpu_mode_get(uint32_t reg) {
+    return (reg & PWM_CTRL_CPU_MODE) >> PWM_CTRL_CPU_MODE_SHIFT;
+}
+static inline uint32_t pwm_ctrl_cpu_mode_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PWM_CTRL_CPU_MODE) | ((value << PWM_CTRL_CPU_MODE_SHIFT) & PWM_CTRL_CPU_MODE);
+}
+static inline uint32_t pwm_ctrl_sync_en_get(uint32_t reg) {
+    return (reg & PWM_CTRL_SYNC_EN) >> PWM_CTRL_SYNC_EN_SHIFT;
+}
+static inline uint32_t pwm_ctrl_sync_en_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PWM_CTRL_SYNC_EN) | ((value << PWM_CTRL_SYNC_EN_SHIFT) & PWM_CTRL_SYNC_EN);
+}
+static inline uint32_t pwm_ctrl_bridge_ref_get(uint32_t reg) {
+    return (reg & PWM_CTRL_BRIDGE_REF) >> PWM_CTRL_BRIDGE_REF_SHIFT;
+}
+static inline uint32_t pwm_ctrl_bridge_ref_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PWM_CTRL_BRIDGE_REF) | ((value << PWM_CTRL_BRIDGE_REF_SHIFT) & PWM_CTRL_BRIDGE_REF);
+}
+static inline uint32_t pwm_ctrl_update_get(uint32_t reg) {
+    return (reg & PWM_CTRL_UPDATE) >> PWM_CTRL_UPDATE_SHIFT;
+}
+static inline uint32_t pwm_ctrl_update_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PWM_CTRL_UPDATE) | ((value << PWM_CTRL_UPDATE_SHIFT) & PWM_CTRL_UPDATE);
+}
+
+// PWM MOD_INDEX fields
+#define PWM_MOD_INDEX_VALUE         0x0000FFFFu  // Modulation index
+#define PWM_MOD_INDEX_VALUE_SHIFT   0
+#define PWM_MOD_INDEX_VALUE_WIDTH   16
+
+static inline uint32_t pwm_mod_index_value_get(uint32_t reg) {
+    return (reg & PWM_MOD_INDEX_VALUE) >> PWM_MOD_INDEX_VALUE_SHIFT;
+}
+static inline uint32_t pwm_mod_index_value_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PWM_MOD_INDEX_VALUE) | ((value << PWM_MOD_INDEX_VALUE_SHIFT) & PWM_MOD_INDEX_VALUE);
+}
+
+// PWM PWM_OUT fields
+#define PWM_PWM_OUT_STATE           0x000000FFu  // Gate outputs S1-S8
+#define PWM_PWM_OUT_STATE_SHIFT     0
+#define PWM_PWM_OUT_STATE_WIDTH     8
+
+static inline uint32_t pwm_pwm_out_state_get(uint32_t reg) {
+    return (reg & PWM_PWM_OUT_STATE) >> PWM_PWM_OUT_STATE_SHIFT;
+}
+static inline uint32_t pwm_pwm_out_state_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PWM_PWM_OUT_STATE) | ((value << PWM_PWM_OUT_STATE_SHIFT) & PWM_PWM_OUT_STATE);
+}
+
+// PWM BRIDGE1_REF fields
+#define PWM_BRIDGE1_REF_VALUE       0x0000FFFFu  // Signed Q15 reference
+#define PWM_BRIDGE1_REF_VALUE_SHIFT 0
+#define PWM_BRIDGE1_REF_VALUE_WIDTH 16
+
+static inline uint32_t pwm_bridge1_ref_value_get(uint32_t reg) {
+    return (reg & PWM_BRIDGE1_REF_VALUE) >> PWM_BRIDGE1_REF_VALUE_SHIFT;
+}
+static inline uint32_t pwm_bridge1_ref_value_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PWM_BRIDGE1_REF_VALUE) | ((value << PWM_BRIDGE1_REF_VALUE_SHIFT) & PWM_BRIDGE1_REF_VALUE);
+}
+
+// PWM BRIDGE2_REF fields
+#define PWM_BRIDGE2_REF_VALUE       0x0000FFFFu  // Signed Q15 reference
+#define PWM_BRIDGE2_REF_VALUE_SHIFT 0
+#define PWM_BRIDGE2_REF_VALUE_WIDTH 16
+
+static inline uint32_t pwm_bridge2_ref_value_get(uint32_t reg) {
+    return (reg & PWM_BRIDGE2_REF_VALUE) >> PWM_BRIDGE2_REF_VALUE_SHIFT;
+}
+static inline uint32_t pwm_bridge2_ref_value_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PWM_BRIDGE2_REF_VALUE) | ((value << PWM_BRIDGE2_REF_VALUE_SHIFT) & PWM_BRIDGE2_REF_VALUE);
+}
+
+//=============================================================================
+// Sigma-Delta ADC (Base: 0x00020100)
+//=============================================================================
+
+#define ADC_BASE        (PERIPH_BASE + 0x0100)
+#define ADC_SIZE        0x00000100u
+
+typedef volatile struct {
+    uint32_t CTRL;              // 0x00: Control register (rw)
+    const uint32_t STATUS;      // 0x04: Status register (ro)
+    const uint32_t DATA_CH0;    // 0x08: Channel 0 data [15:0] (ro)
+    const uint32_t DATA_CH1;    // 0x0C: Channel 1 data [15:0] (ro)
+    const uint32_t DATA_CH2;    // 0x10: Channel 2 data [15:0] (ro)
+    const uint32_t DATA_CH3;    // 0x14: Channel 3 data [15:0] (ro)
+    const uint32_t FIFO_LEVEL;  // 0x18: FIFO fill level (samples) (ro)
+    uint32_t IRQ_EN;            // 0x1C: Interrupt enable (rw)
+    const uint32_t FIFO_DATA;   // 0x20: FIFO read port (pops one sample) (ro)
+} adc_regs_t;
+
+#define ADC ((adc_regs_t*)ADC_BASE)
+
+_Static_assert(offsetof(adc_regs_t, CTRL) == 0x00, "ADC.CTRL offset");
+_Static_assert(offsetof(adc_regs_t, STATUS) == 0x04, "ADC.STATUS offset");
+_Static_assert(offsetof(adc_regs_t, DATA_CH0) == 0x08, "ADC.DATA_CH0 offset");
+_Static_assert(offsetof(adc_regs_t, DATA_CH1) == 0x0C, "ADC.DATA_CH1 offset");
+_Static_assert(offsetof(adc_regs_t, DATA_CH2) == 0x10, "ADC.DATA_CH2 offset");
+_Static_assert(offsetof(adc_regs_t, DATA_CH3) == 0x14, "ADC.DATA_CH3 offset");
+_Static_assert(offsetof(adc_regs_t, FIFO_LEVEL) == 0x18, "ADC.FIFO_LEVEL offset");
+_Static_assert(offsetof(adc_regs_t, IRQ_EN) == 0x1C, "ADC.IRQ_EN offset");
+_Static_assert(offsetof(adc_regs_t, FIFO_DATA) == 0x20, "ADC.FIFO_DATA offset");
+
+// ADC CTRL fields
+#define ADC_CTRL_ENABLE             0x00000001u  // Enable ADC
+#define ADC_CTRL_ENABLE_SHIFT       0
+#define ADC_CTRL_ENABLE_WIDTH       1
+#define ADC_CTRL_FIFO_EN            0x00000002u  // Push conversions into the FIFO
+#define ADC_CTRL_FIFO_EN_SHIFT      1
+#define ADC_CTRL_FIFO_EN_WIDTH      1
+#define ADC_CTRL_CONT               0x00000004u  // Continuous conversion mode
+#define ADC_CTRL_CONT_SHIFT         2
+#define ADC_CTRL_CONT_WIDTH         1
+
+static inline uint32_t adc_ctrl_enable_get(uint32_t reg) {
+    return (reg & ADC_CTRL_ENABLE) >> ADC_CTRL_ENABLE_SHIFT;
+}
+static inline uint32_t adc_ctrl_enable_set(uint32_t reg, uint32_t value) {
+    return (reg & ~ADC_CTRL_ENABLE) | ((value << ADC_CTRL_ENABLE_SHIFT) & ADC_CTRL_ENABLE);
+}
+static inline uint32_t adc_ctrl_fifo_en_get(uint32_t reg) {
+    return (reg & ADC_CTRL_FIFO_EN) >> ADC_CTRL_FIFO_EN_SHIFT;
+}
+static inline uint32_t adc_ctrl_fifo_en_set(uint32_t reg, uint32_t value) {
+    return (reg & ~ADC_CTRL_FIFO_EN) | ((value << ADC_CTRL_FIFO_EN_SHIFT) & ADC_CTRL_FIFO_EN);
+}
+static inline uint32_t adc_ctrl_cont_get(uint32_t reg) {
+    return (reg & ADC_CTRL_CONT) >> ADC_CTRL_CONT_SHIFT;
+}
+static inline uint32_t adc_ctrl_cont_set(uint32_t reg, uint32_t value) {
+    return (reg & ~ADC_CTRL_CONT) | ((value << ADC_CTRL_CONT_SHIFT) & ADC_CTRL_CONT);
+}
+
+// ADC STATUS fields
+#define ADC_STATUS_VALID_CH0        0x00000001u  // Channel 0 data valid
+#define ADC_STATUS_VALID_CH0_SHIFT  0
+#define ADC_STATUS_VALID_CH0_WIDTH  1
+#define ADC_STATUS_VALID_CH1        0x00000002u  // Channel 1 data valid
+#define ADC_STATUS_VALID_CH1_SHIFT  1
+#define ADC_STATUS_VALID_CH1_WIDTH  1
+#define ADC_STATUS_VALID_CH2        0x00000004u  // Channel 2 data valid
+#define ADC_STATUS_VALID_CH2_SHIFT  2
+#define ADC_STATUS_VALID_CH2_WIDTH  1
+#define ADC_STATUS_VALID_CH3        0x00000008u  // Channel 3 data valid
+#define ADC_STATUS_VALID_CH3_SHIFT  3
+#define ADC_STATUS_VALID_CH3_WIDTH  1
+#define ADC_STATUS_FIFO_FULL        0x00000100u  // FIFO full
+#define ADC_STATUS_FIFO_FULL_SHIFT  8
+#define ADC_STATUS_FIFO_FULL_WIDTH  1
+#define ADC_STATUS_FIFO_EMPTY       0x00000200u  // FIFO empty
+#define ADC_STATUS_FIFO_EMPTY_SHIFT 9
+#define ADC_STATUS_FIFO_EMPTY_WIDTH 1
+
+static inline uint32_t adc_status_valid_ch0_get(uint32_t reg) {
+    return (reg & ADC_STATUS_VALID_CH0) >> ADC_STATUS_VALID_CH0_SHIFT;
+}
+static inline uint32_t adc_status_valid_ch0_set(uint32_t reg, uint32_t value) {
+    return (reg & ~ADC_STATUS_VALID_CH0) | ((value << ADC_STATUS_VALID_CH0_SHIFT) & ADC_STATUS_VALID_CH0);
+}
+static inline uint32_t adc_status_valid_ch1_get(uint32_t reg) {
+    return (reg & ADC_STATUS_VALID_CH1) >> ADC_STATUS_VALID_CH1_SHIFT;
+}
+static inline uint32_t adc_status_valid_ch1_set(uint32_t reg, uint32_t value) {
+    return (reg & ~ADC_STATUS_VALID_CH1) | ((value << ADC_STATUS_VALID_CH1_SHIFT) & ADC_STATUS_VALID_CH1);
+}
+static inline uint32_t adc_status_valid_ch2_get(uint32_t reg) {
+    return (reg & ADC_STATUS_VALID_CH2) >> ADC_STATUS_VALID_CH2_SHIFT;
+}
+static inline uint32_t adc_status_valid_ch2_set(uint32_t reg, uint32_t value) {
+    return (reg & ~ADC_STATUS_VALID_CH2) | ((value << ADC_STATUS_VALID_CH2_SHIFT) & ADC_STATUS_VALID_CH2);
+}
+static inline uint32_t adc_status_valid_ch3_get(uint32_t reg) {
+    return (reg & ADC_STATUS_VALID_CH3) >> ADC_STATUS_VALID_CH3_SHIFT;
+}
+static inline uint32_t adc_status_valid_ch3_set(uint32_t reg, uint32_t value) {
+    return (reg & ~ADC_STATUS_VALID_CH3) | ((value << ADC_STATUS_VALID_CH3_SHIFT) & ADC_STATUS_VALID_CH3);
+}
+static inline uint32_t adc_status_fifo_full_get(uint32_t reg) {
+    return (reg & ADC_STATUS_FIFO_FULL) >> ADC_STATUS_FIFO_FULL_SHIFT;
+}
+static inline uint32_t adc_status_fifo_full_set(uint32_t reg, uint32_t value) {
+    return (reg & ~ADC_STATUS_FIFO_FULL) | ((value << ADC_STATUS_FIFO_FULL_SHIFT) & ADC_STATUS_FIFO_FULL);
+}
+static inline uint32_t adc_status_fifo_empty_get(uint32_t reg) {
+    return (reg & ADC_STATUS_FIFO_EMPTY) >> ADC_STATUS_FIFO_EMPTY_SHIFT;
+}
+static inline uint32_t adc_status_fifo_empty_set(uint32_t reg, uint32_t value) {
+    return (reg & ~ADC_STATUS_FIFO_EMPTY) | ((value << ADC_STATUS_FIFO_EMPTY_SHIFT) & ADC_STATUS_FIFO_EMPTY);
+}
+
+// ADC IRQ_EN fields
+#define ADC_IRQ_EN_FRAME            0x00000001u  // FIFO holds a complete 4-channel frame
+#define ADC_IRQ_EN_FRAME_SHIFT      0
+#define ADC_IRQ_EN_FRAME_WIDTH      1
+
+static inline uint32_t adc_irq_en_frame_get(uint32_t reg) {
+    return (reg & ADC_IRQ_EN_FRAME) >> ADC_IRQ_EN_FRAME_SHIFT;
+}
+static inline uint32_t adc_irq_en_frame_set(uint32_t reg, uint32_t value) {
+    return (reg & ~ADC_IRQ_EN_FRAME) | ((value << ADC_IRQ_EN_FRAME_SHIFT) & ADC_IRQ_EN_FRAME);
+}
+
+// ADC FIFO_DATA fields
+#define ADC_FIFO_DATA_SAMPLE        0x0000FFFFu  // Sample value
+#define ADC_FIFO_DATA_SAMPLE_SHIFT  0
+#define ADC_FIFO_DATA_SAMPLE_WIDTH  16
+#define ADC_FIFO_DATA_CH            0x00030000u  // Channel tag
+#define ADC_FIFO_DATA_CH_SHIFT      16
+#define ADC_FIFO_DATA_CH_WIDTH      2
+
+static inline uint32_t adc_fifo_data_sample_get(uint32_t reg) {
+    return (reg & ADC_FIFO_DATA_SAMPLE) >> ADC_FIFO_DATA_SAMPLE_SHIFT;
+}
+static inline uint32_t adc_fifo_data_sample_set(uint32_t reg, uint32_t value) {
+    return (reg & ~ADC_FIFO_DATA_SAMPLE) | ((value << ADC_FIFO_DATA_SAMPLE_SHIFT) & ADC_FIFO_DATA_SAMPLE);
+}
+static inline uint32_t adc_fifo_data_ch_get(uint32_t reg) {
+    return (reg & ADC_FIFO_DATA_CH) >> ADC_FIFO_DATA_CH_SHIFT;
+}
+static inline uint32_t adc_fifo_data_ch_set(uint32_t reg, uint32_t value) {
+    return (reg & ~ADC_FIFO_DATA_CH) | ((value << ADC_FIFO_DATA_CH_SHIFT) & ADC_FIFO_DATA_CH);
+}
+
+//=============================================================================
+// Protection/Fault (Base: 0x00020200)
+//=============================================================================
+
+#define PROT_BASE       (PERIPH_BASE + 0x0200)
+#define PROT_SIZE       0x00000100u
+
+typedef volatile struct {
+    uint32_t CTRL;              // 0x00: Control register (rw)
+    const uint32_t STATUS;      // 0x04: Latched fault status (ro)
+    uint32_t FAULT_MASK;        // 0x08: Fault enable mask (STATUS bit layout) (rw)
+    uint32_t FAULT_CLEAR;       // 0x0C: Fault clear (write 1 to clear) (w1c)
+    uint32_t OCP_THRESHOLD;     // 0x10: Overcurrent threshold (rw)
+    uint32_t OVP_THRESHOLD;     // 0x14: Overvoltage threshold (rw)
+    uint32_t WATCHDOG;          // 0x18: Watchdog timeout in cycles; any write reloads (kick) (rw)
+    uint32_t IRQ_EN;            // 0x1C: Interrupt enable (STATUS bit layout) (rw)
+    uint32_t CMP_CTRL;          // 0x20: Fast comparators on the decimated ADC samples (rw)
+    uint32_t CMP0_WINDOW;       // 0x24: Channel 0 (I_out) trip window, raw ADC codes (rw)
+    uint32_t CMP1_WINDOW;       // 0x28: Channel 1 (V_out) trip window, raw ADC codes (rw)
+    uint32_t CMP2_WINDOW;       // 0x2C: Channel 2 (V_dc1) trip window, raw ADC codes (rw)
+    uint32_t CMP3_WINDOW;       // 0x30: Channel 3 (V_dc2) trip window, raw ADC codes (rw)
+    const uint32_t CMP_CAPTURE; // 0x34: Sample that caused the first comparator trip (ro)
+} prot_regs_t;
+
+#define PROT ((prot_regs_t*)PROT_BASE)
+
+_Static_assert(offsetof(prot_regs_t, CTRL) == 0x00, "PROT.CTRL offset");
+_Static_assert(offsetof(prot_regs_t, STATUS) == 0x04, "PROT.STATUS offset");
+_Static_assert(offsetof(prot_regs_t, FAULT_MASK) == 0x08, "PROT.FAULT_MASK offset");
+_Static_assert(offsetof(prot_regs_t, FAULT_CLEAR) == 0x0C, "PROT.FAULT_CLEAR offset");
+_Static_assert(offsetof(prot_regs_t, OCP_THRESHOLD) == 0x10, "PROT.OCP_THRESHOLD offset");
+_Static_assert(offsetof(prot_regs_t, OVP_THRESHOLD) == 0x14, "PROT.OVP_THRESHOLD offset");
+_Static_assert(offsetof(prot_regs_t, WATCHDOG) == 0x18, "PROT.WATCHDOG offset");
+_Static_assert(offsetof(prot_regs_t, IRQ_EN) == 0x1C, "PROT.IRQ_EN offset");
+_Static_assert(offsetof(prot_regs_t, CMP_CTRL) == 0x20, "PROT.CMP_CTRL offset");
+_Static_assert(offsetof(prot_regs_t, CMP0_WINDOW) == 0x24, "PROT.CMP0_WINDOW offset");
+_Static_assert(offsetof(prot_regs_t, CMP1_WINDOW) == 0x28, "PROT.CMP1_WINDOW offset");
+_Static_assert(offsetof(prot_regs_t, CMP2_WINDOW) == 0x2C, "PROT.CMP2_WINDOW offset");
+_Static_assert(offsetof(prot_regs_t, CMP3_WINDOW) == 0x30, "PROT.CMP3_WINDOW offset");
+_Static_assert(offsetof(prot_regs_t, CMP_CAPTURE) == 0x34, "PROT.CMP_CAPTURE offset");
+
+// PROT CTRL fields
+#define PROT_CTRL_ENABLE            0x00000001u  // Enable fault shutdown of the PWM outputs
+#define PROT_CTRL_ENABLE_SHIFT      0
+#define PROT_CTRL_ENABLE_WIDTH      1
+
+static inline uint32_t prot_ctrl_enable_get(uint32_t reg) {
+    return (reg & PROT_CTRL_ENABLE) >> PROT_CTRL_ENABLE_SHIFT;
+}
+static inline uint32_t prot_ctrl_enable_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PROT_CTRL_ENABLE) | ((value << PROT_CTRL_ENABLE_SHIFT) & PROT_CTRL_ENABLE);
+}
+
+// PROT STATUS fields
+#define PROT_STATUS_OCP             0x00000001u  // Overcurrent fault
+#define PROT_STATUS_OCP_SHIFT       0
+#define PROT_STATUS_OCP_WIDTH       1
+#define PROT_STATUS_OVP             0x00000002u  // Overvoltage fault
+#define PROT_STATUS_OVP_SHIFT       1
+#define PROT_STATUS_OVP_WIDTH       1
+#define PROT_STATUS_ESTOP           0x00000004u  // Emergency stop
+#define PROT_STATUS_ESTOP_SHIFT     2
+#define PROT_STATUS_ESTOP_WIDTH     1
+#define PROT_STATUS_WD              0x00000008u  // Watchdog timeout
+#define PROT_STATUS_WD_SHIFT        3
+#define PROT_STATUS_WD_WIDTH        1
+#define PROT_STATUS_ANY             0x0000000Fu  // Any fault
+#define PROT_STATUS_ANY_SHIFT       0
+#define PROT_STATUS_ANY_WIDTH       4
+#define PROT_STATUS_CMP             0x00000F00u  // Fast comparator channels that tripped
+#define PROT_STATUS_CMP_SHIFT       8
+#define PROT_STATUS_CMP_WIDTH       4
+
+static inline uint32_t prot_status_ocp_get(uint32_t reg) {
+    return (reg & PROT_STATUS_OCP) >> PROT_STATUS_OCP_SHIFT;
+}
+static inline uint32_t prot_status_ocp_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PROT_STATUS_OCP) | ((value << PROT_STATUS_OCP_SHIFT) & PROT_STATUS_OCP);
+}
+static inline uint32_t prot_status_ovp_get(uint32_t reg) {
+    return (reg & PROT_STATUS_OVP) >> PROT_STATUS_OVP_SHIFT;
+}
+static inline uint32_t prot_status_ovp_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PROT_STATUS_OVP) | ((value << PROT_STATUS_OVP_SHIFT) & PROT_STATUS_OVP);
+}
+static inline uint32_t prot_status_estop_get(uint32_t reg) {
+    return (reg & PROT_STATUS_ESTOP) >> PROT_STATUS_ESTOP_SHIFT;
+}
+static inline uint32_t prot_status_estop_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PROT_STATUS_ESTOP) | ((value << PROT_STATUS_ESTOP_SHIFT) & PROT_STATUS_ESTOP);
+}
+static inline uint32_t prot_status_wd_get(uint32_t reg) {
+    return (reg & PROT_STATUS_WD) >> PROT_STATUS_WD_SHIFT;
+}
+static inline uint32_t prot_status_wd_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PROT_STATUS_WD) | ((value << PROT_STATUS_WD_SHIFT) & PROT_STATUS_WD);
+}
+static inline uint32_t prot_status_any_get(uint32_t reg) {
+    return (reg & PROT_STATUS_ANY) >> PROT_STATUS_ANY_SHIFT;
+}
+static inline uint32_t prot_status_any_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PROT_STATUS_ANY) | ((value << PROT_STATUS_ANY_SHIFT) & PROT_STATUS_ANY);
+}
+static inline uint32_t prot_status_cmp_get(uint32_t reg) {
+    return (reg & PROT_STATUS_CMP) >> PROT_STATUS_CMP_SHIFT;
+}
+static inline uint32_t prot_status_cmp_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PROT_STATUS_CMP) | ((value << PROT_STATUS_CMP_SHIFT) & PROT_STATUS_CMP);
+}
+
+// PROT CMP_CTRL fields
+#define PROT_CMP_CTRL_EN            0x0000000Fu  // Enable per ADC channel (0 -> OCP, 1-3 -> OVP)
+#define PROT_CMP_CTRL_EN_SHIFT      0
+#define PROT_CMP_CTRL_EN_WIDTH      4
+
+static inline uint32_t prot_cmp_ctrl_en_get(uint32_t reg) {
+    return (reg & PROT_CMP_CTRL_EN) >> PROT_CMP_CTRL_EN_SHIFT;
+}
+static inline uint32_t prot_cmp_ctrl_en_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PROT_CMP_CTRL_EN) | ((value << PROT_CMP_CTRL_EN_SHIFT) & PROT_CMP_CTRL_EN);
+}
+
+// PROT CMP0_WINDOW fields
+#define PROT_CMP0_WINDOW_LOW        0x0000FFFFu  // Trip below this code
+#define PROT_CMP0_WINDOW_LOW_SHIFT  0
+#define PROT_CMP0_WINDOW_LOW_WIDTH  16
+#define PROT_CMP0_WINDOW_HIGH       0xFFFF0000u  // Trip above this code
+#define PROT_CMP0_WINDOW_HIGH_SHIFT 16
+#define PROT_CMP0_WINDOW_HIGH_WIDTH 16
+
+static inline uint32_t prot_cmp0_window_low_get(uint32_t reg) {
+    return (reg & PROT_CMP0_WINDOW_LOW) >> PROT_CMP0_WINDOW_LOW_SHIFT;
+}
+static inline uint32_t prot_cmp0_window_low_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PROT_CMP0_WINDOW_LOW) | ((value << PROT_CMP0_WINDOW_LOW_SHIFT) & PROT_CMP0_WINDOW_LOW);
+}
+static inline uint32_t prot_cmp0_window_high_get(uint32_t reg) {
+    return (reg & PROT_CMP0_WINDOW_HIGH) >> PROT_CMP0_WINDOW_HIGH_SHIFT;
+}
+static inline uint32_t prot_cmp0_window_high_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PROT_CMP0_WINDOW_HIGH) | ((value << PROT_CMP0_WINDOW_HIGH_SHIFT) & PROT_CMP0_WINDOW_HIGH);
+}
+
+// PROT CMP1_WINDOW fields
+#define PROT_CMP1_WINDOW_LOW        0x0000FFFFu  // Trip below this code
+#define PROT_CMP1_WINDOW_LOW_SHIFT  0
+#define PROT_CMP1_WINDOW_LOW_WIDTH  16
+#define PROT_CMP1_WINDOW_HIGH       0xFFFF0000u  // Trip above this code
+#define PROT_CMP1_WINDOW_HIGH_SHIFT 16
+#define PROT_CMP1_WINDOW_HIGH_WIDTH 16
+
+static inline uint32_t prot_cmp1_window_low_get(uint32_t reg) {
+    return (reg & PROT_CMP1_WINDOW_LOW) >> PROT_CMP1_WINDOW_LOW_SHIFT;
+}
+static inline uint32_t prot_cmp1_window_low_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PROT_CMP1_WINDOW_LOW) | ((value << PROT_CMP1_WINDOW_LOW_SHIFT) & PROT_CMP1_WINDOW_LOW);
+}
+static inline uint32_t prot_cmp1_window_high_get(uint32_t reg) {
+    return (reg & PROT_CMP1_WINDOW_HIGH) >> PROT_CMP1_WINDOW_HIGH_SHIFT;
+}
+static inline uint32_t prot_cmp1_window_high_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PROT_CMP1_WINDOW_HIGH) | ((value << PROT_CMP1_WINDOW_HIGH_SHIFT) & PROT_CMP1_WINDOW_HIGH);
+}
+
+// PROT CMP2_WINDOW fields
+#define PROT_CMP2_WINDOW_LOW        0x0000FFFFu  // Trip below this code
+#define PROT_CMP2_WINDOW_LOW_SHIFT  0
+#define PROT_CMP2_WINDOW_LOW_WIDTH  16
+#define PROT_CMP2_WINDOW_HIGH       0xFFFF0000u  // Trip above this code
+#define PROT_CMP2_WINDOW_HIGH_SHIFT 16
+#define PROT_CMP2_WINDOW_HIGH_WIDTH 16
+
+static inline uint32_t prot_cmp2_window_low_get(uint32_t reg) {
+    return (reg & PROT_CMP2_WINDOW_LOW) >> PROT_CMP2_WINDOW_LOW_SHIFT;
+}
+static inline uint32_t prot_cmp2_window_low_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PROT_CMP2_WINDOW_LOW) | ((value << PROT_CMP2_WINDOW_LOW_SHIFT) & PROT_CMP2_WINDOW_LOW);
+}
+static inline uint32_t prot_cmp2_window_high_get(uint32_t reg) {
+    return (reg & PROT_CMP2_WINDOW_HIGH) >> PROT_CMP2_WINDOW_HIGH_SHIFT;
+}
+static inline uint32_t prot_cmp2_window_high_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PROT_CMP2_WINDOW_HIGH) | ((value << PROT_CMP2_WINDOW_HIGH_SHIFT) & PROT_CMP2_WINDOW_HIGH);
+}
+
+// PROT CMP3_WINDOW fields
+#define PROT_CMP3_WINDOW_LOW        0x0000FFFFu  // Trip below this code
+#define PROT_CMP3_WINDOW_LOW_SHIFT  0
+#define PROT_CMP3_WINDOW_LOW_WIDTH  16
+#define PROT_CMP3_WINDOW_HIGH       0xFFFF0000u  // Trip above this code
+#define PROT_CMP3_WINDOW_HIGH_SHIFT 16
+#define PROT_CMP3_WINDOW_HIGH_WIDTH 16
+
+static inline uint32_t prot_cmp3_window_low_get(uint32_t reg) {
+    return (reg & PROT_CMP3_WINDOW_LOW) >> PROT_CMP3_WINDOW_LOW_SHIFT;
+}
+static inline uint32_t prot_cmp3_window_low_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PROT_CMP3_WINDOW_LOW) | ((value << PROT_CMP3_WINDOW_LOW_SHIFT) & PROT_CMP3_WINDOW_LOW);
+}
+static inline uint32_t prot_cmp3_window_high_get(uint32_t reg) {
+    return (reg & PROT_CMP3_WINDOW_HIGH) >> PROT_CMP3_WINDOW_HIGH_SHIFT;
+}
+static inline uint32_t prot_cmp3_window_high_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PROT_CMP3_WINDOW_HIGH) | ((value << PROT_CMP3_WINDOW_HIGH_SHIFT) & PROT_CMP3_WINDOW_HIGH);
+}
+
+// PROT CMP_CAPTURE fields
+#define PROT_CMP_CAPTURE_CODE       0x0000FFFFu  // Raw ADC code
+#define PROT_CMP_CAPTURE_CODE_SHIFT 0
+#define PROT_CMP_CAPTURE_CODE_WIDTH 16
+#define PROT_CMP_CAPTURE_CH         0x00030000u  // ADC channel
+#define PROT_CMP_CAPTURE_CH_SHIFT   16
+#define PROT_CMP_CAPTURE_CH_WIDTH   2
+#define PROT_CMP_CAPTURE_VALID      0x80000000u  // Capture holds a trip (cleared with the STATUS.CMP bits)
+#define PROT_CMP_CAPTURE_VALID_SHIFT 31
+#define PROT_CMP_CAPTURE_VALID_WIDTH 1
+
+static inline uint32_t prot_cmp_capture_code_get(uint32_t reg) {
+    return (reg & PROT_CMP_CAPTURE_CODE) >> PROT_CMP_CAPTURE_CODE_SHIFT;
+}
+static inline uint32_t prot_cmp_capture_code_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PROT_CMP_CAPTURE_CODE) | ((value << PROT_CMP_CAPTURE_CODE_SHIFT) & PROT_CMP_CAPTURE_CODE);
+}
+static inline uint32_t prot_cmp_capture_ch_get(uint32_t reg) {
+    return (reg & PROT_CMP_CAPTURE_CH) >> PROT_CMP_CAPTURE_CH_SHIFT;
+}
+static inline uint32_t prot_cmp_capture_ch_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PROT_CMP_CAPTURE_CH) | ((value << PROT_CMP_CAPTURE_CH_SHIFT) & PROT_CMP_CAPTURE_CH);
+}
+static inline uint32_t prot_cmp_capture_valid_get(uint32_t reg) {
+    return (reg & PROT_CMP_CAPTURE_VALID) >> PROT_CMP_CAPTURE_VALID_SHIFT;
+}
+static inline uint32_t prot_cmp_capture_valid_set(uint32_t reg, uint32_t value) {
+    return (reg & ~PROT_CMP_CAPTURE_VALID) | ((value << PROT_CMP_CAPTURE_VALID_SHIFT) & PROT_CMP_CAPTURE_VALID);
+}
+
+//=============================================================================
+// Timer (Base: 0x00020300)
+//=============================================================================
+
+#define TIMER_BASE      (PERIPH_BASE + 0x0300)
+#define TIMER_SIZE      0x00000100u
+
+typedef volatile struct {
+    uint32_t CTRL;              // 0x00: Control register (rw)
+    uint32_t STATUS;            // 0x04: Status register (w1c)
+    uint32_t PRESCALER;         // 0x08: Clock prescaler (count every PRESCALER+1 clocks) (rw)
+    uint32_t COUNT;             // 0x0C: Counter value (rw)
+    uint32_t COMPARE;           // 0x10: Compare value (rw)
+    uint32_t IRQ_EN;            // 0x14: Interrupt enable (rw)
+} timer_regs_t;
+
+#define TIMER ((timer_regs_t*)TIMER_BASE)
+
+_Static_assert(offsetof(timer_regs_t, CTRL) == 0x00, "TIMER.CTRL offset");
+_Static_assert(offsetof(timer_regs_t, STATUS) == 0x04, "TIMER.STATUS offset");
+_Static_assert(offsetof(timer_regs_t, PRESCALER) == 0x08, "TIMER.PRESCALER offset");
+_Static_assert(offsetof(timer_regs_t, COUNT) == 0x0C, "TIMER.COUNT offset");
+_Static_assert(offsetof(timer_regs_t, COMPARE) == 0x10, "TIMER.COMPARE offset");
+_Static_assert(offsetof(timer_regs_t, IRQ_EN) == 0x14, "TIMER.IRQ_EN offset");
+
+// TIMER CTRL fields
+#define TIMER_CTRL_ENABLE           0x00000001u  // Enable timer
+#define TIMER_CTRL_ENABLE_SHIFT     0
+#define TIMER_CTRL_ENABLE_WIDTH     1
+#define TIMER_CTRL_IRQ_EN           0x00000002u  // Enable interrupt
+#define TIMER_CTRL_IRQ_EN_SHIFT     1
+#define TIMER_CTRL_IRQ_EN_WIDTH     1
+#define TIMER_CTRL_AUTO             0x00000004u  // Auto-reload: COUNT restarts at 0 on compare match
+#define TIMER_CTRL_AUTO_SHIFT       2
+#define TIMER_CTRL_AUTO_WIDTH       1
+
+static inline uint32_t timer_ctrl_enable_get(uint32_t reg) {
+    return (reg & TIMER_CTRL_ENABLE) >> TIMER_CTRL_ENABLE_SHIFT;
+}
+static inline uint32_t timer_ctrl_enable_set(uint32_t reg, uint32_t value) {
+    return (reg & ~TIMER_CTRL_ENABLE) | ((value << TIMER_CTRL_ENABLE_SHIFT) & TIMER_CTRL_ENABLE);
+}
+static inline uint32_t timer_ctrl_irq_en_get(uint32_t reg) {
+    return (reg & TIMER_CTRL_IRQ_EN) >> TIMER_CTRL_IRQ_EN_SHIFT;
+}
+static inline uint32_t timer_ctrl_irq_en_set(uint32_t reg, uint32_t value) {
+    return (reg & ~TIMER_CTRL_IRQ_EN) | ((value << TIMER_CTRL_IRQ_EN_SHIFT) & TIMER_CTRL_IRQ_EN);
+}
+static inline uint32_t timer_ctrl_auto_get(uint32_t reg) {
+    return (reg & TIMER_CTRL_AUTO) >> TIMER_CTRL_AUTO_SHIFT;
+}
+static inline uint32_t timer_ctrl_auto_set(uint32_t reg, uint32_t value) {
+    return (reg & ~TIMER_CTRL_AUTO) | ((value << TIMER_CTRL_AUTO_SHIFT) & TIMER_CTRL_AUTO);
+}
+
+// TIMER STATUS fields
+#define TIMER_STATUS_MATCH          0x00000001u  // Compare match (write 1 to clear)
+#define TIMER_STATUS_MATCH_SHIFT    0
+#define TIMER_STATUS_MATCH_WIDTH    1
+
+static inline uint32_t timer_status_match_get(uint32_t reg) {
+    return (reg & TIMER_STATUS_MATCH) >> TIMER_STATUS_MATCH_SHIFT;
+}
+static inline uint32_t timer_status_match_set(uint32_t reg, uint32_t value) {
+    return (reg & ~TIMER_STATUS_MATCH) | ((value << TIMER_STATUS_MATCH_SHIFT) & TIMER_STATUS_MATCH);
+}
+
+// TIMER IRQ_EN fields
+#define TIMER_IRQ_EN_MATCH          0x00000001u  // Compare match interrupt
+#define TIMER_IRQ_EN_MATCH_SHIFT    0
+#define TIMER_IRQ_EN_MATCH_WIDTH    1
+
+static inline uint32_t timer_irq_en_match_get(uint32_t reg) {
+    return (reg & TIMER_IRQ_EN_MATCH) >> TIMER_IRQ_EN_MATCH_SHIFT;
+}
+static inline uint32_t timer_irq_en_match_set(uint32_t reg, uint32_t value) {
+    return (reg & ~TIMER_IRQ_EN_MATCH) | ((value << TIMER_IRQ_EN_MATCH_SHIFT) & TIMER_IRQ_EN_MATCH);
+}
+
+//=============================================================================
+// GPIO (Base: 0x00020400)
+//=============================================================================
+
+#define GPIO_BASE       (PERIPH_BASE + 0x0400)
+#define GPIO_SIZE       0x00000100u
+
+typedef volatile struct {
+    uint32_t DATA_OUT;          // 0x00: Output data (rw)
+    const uint32_t DATA_IN;     // 0x04: Input data (ro)
+    uint32_t DIR;               // 0x08: Direction (1 = output, 0 = input) (rw)
+    uint32_t IRQ_EN;            // 0x0C: Interrupt enable (rw)
+    uint32_t IRQ_TYPE;          // 0x10: Interrupt type (edge/level) (rw)
+    uint32_t IRQ_POL;           // 0x14: Interrupt polarity (rw)
+} gpio_regs_t;
+
+#define GPIO ((gpio_regs_t*)GPIO_BASE)
+
+_Static_assert(offsetof(gpio_regs_t, DATA_OUT) == 0x00, "GPIO.DATA_OUT offset");
+_Static_assert(offsetof(gpio_regs_t, DATA_IN) == 0x04, "GPIO.DATA_IN offset");
+_Static_assert(offsetof(gpio_regs_t, DIR) == 0x08, "GPIO.DIR offset");
+_Static_assert(offsetof(gpio_regs_t, IRQ_EN) == 0x0C, "GPIO.IRQ_EN offset");
+_Static_assert(offsetof(gpio_regs_t, IRQ_TYPE) == 0x10, "GPIO.IRQ_TYPE offset");
+_Static_assert(offsetof(gpio_regs_t, IRQ_POL) == 0x14, "GPIO.IRQ_POL offset");
+
+//=============================================================================
+// UART (Base: 0x00020500)
+//=============================================================================
+
+#define UART_BASE       (PERIPH_BASE + 0x0500)
+#define UART_SIZE       0x00000100u
+
+typedef volatile struct {
+    uint32_t DATA;              // 0x00: TX/RX data (rw)
+    const uint32_t STATUS;      // 0x04: Status register (ro)
+    uint32_t BAUD_DIV;          // 0x08: Baud rate divisor (clk / baud) (rw)
+    uint32_t CTRL;              // 0x0C: Control register (rw)
+    uint32_t IRQ_EN;            // 0x10: Interrupt enable (rw)
+} uart_regs_t;
+
+#define UART ((uart_regs_t*)UART_BASE)
+
+_Static_assert(offsetof(uart_regs_t, DATA) == 0x00, "UART.DATA offset");
+_Static_assert(offsetof(uart_regs_t, STATUS) == 0x04, "UART.STATUS offset");
+_Static_assert(offsetof(uart_regs_t, BAUD_DIV) == 0x08, "UART.BAUD_DIV offset");
+_Static_assert(offsetof(uart_regs_t, CTRL) == 0x0C, "UART.CTRL offset");
+_Static_assert(offsetof(uart_regs_t, IRQ_EN) == 0x10, "UART.IRQ_EN offset");
+
+// UART DATA fields
+#define UART_DATA_BYTE              0x000000FFu  // Data byte
+#define UART_DATA_BYTE_SHIFT        0
+#define UART_DATA_BYTE_WIDTH        8
+
+static inline uint32_t uart_data_byte_get(uint32_t reg) {
+    return (reg & UART_DATA_BYTE) >> UART_DATA_BYTE_SHIFT;
+}
+static inline uint32_t uart_data_byte_set(uint32_t reg, uint32_t value) {
+    return (reg & ~UART_DATA_BYTE) | ((value << UART_DATA_BYTE_SHIFT) & UART_DATA_BYTE);
+}
+
+// UART STATUS fields
+#define UART_STATUS_TX_FULL         0x00000001u  // TX FIFO full
+#define UART_STATUS_TX_FULL_SHIFT   0
+#define UART_STATUS_TX_FULL_WIDTH   1
+#define UART_STATUS_TX_EMPTY        0x00000002u  // TX FIFO empty
+#define UART_STATUS_TX_EMPTY_SHIFT  1
+#define UART_STATUS_TX_EMPTY_WIDTH  1
+#define UART_STATUS_RX_FULL         0x00000004u  // RX FIFO full
+#define UART_STATUS_RX_FULL_SHIFT   2
+#define UART_STATUS_RX_FULL_WIDTH   1
+#define UART_STATUS_RX_EMPTY        0x00000008u  // RX FIFO empty
+#define UART_STATUS_RX_EMPTY_SHIFT  3
+#define UART_STATUS_RX_EMPTY_WIDTH  1
+#define UART_STATUS_RX_AVAIL        0x00000010u  // RX data available
+#define UART_STATUS_RX_AVAIL_SHIFT  4
+#define UART_STATUS_RX_AVAIL_WIDTH  1
+
+static inline uint32_t uart_status_tx_full_get(uint32_t reg) {
+    return (reg & UART_STATUS_TX_FULL) >> UART_STATUS_TX_FULL_SHIFT;
+}
+static inline uint32_t uart_status_tx_full_set(uint32_t reg, uint32_t value) {
+    return (reg & ~UART_STATUS_TX_FULL) | ((value << UART_STATUS_TX_FULL_SHIFT) & UART_STATUS_TX_FULL);
+}
+static inline uint32_t uart_status_tx_empty_get(uint32_t reg) {
+    return (reg & UART_STATUS_TX_EMPTY) >> UART_STATUS_TX_EMPTY_SHIFT;
+}
+static inline uint32_t uart_status_tx_empty_set(uint32_t reg, uint32_t value) {
+    return (reg & ~UART_STATUS_TX_EMPTY) | ((value << UART_STATUS_TX_EMPTY_SHIFT) & UART_STATUS_TX_EMPTY);
+}
+static inline uint32_t uart_status_rx_full_get(uint32_t reg) {
+    return (reg & UART_STATUS_RX_FULL) >> UART_STATUS_RX_FULL_SHIFT;
+}
+static inline uint32_t uart_status_rx_full_set(uint32_t reg, uint32_t value) {
+    return (reg & ~UART_STATUS_RX_FULL) | ((value << UART_STATUS_RX_FULL_SHIFT) & UART_STATUS_RX_FULL);
+}
+static inline uint32_t uart_status_rx_empty_get(uint32_t reg) {
+    return (reg & UART_STATUS_RX_EMPTY) >> UART_STATUS_RX_EMPTY_SHIFT;
+}
+static inline uint32_t uart_status_rx_empty_set(uint32_t reg, uint32_t value) {
+    return (reg & ~UART_STATUS_RX_EMPTY) | ((value << UART_STATUS_RX_EMPTY_SHIFT) & UART_STATUS_RX_EMPTY);
+}
+static inline uint32_t uart_status_rx_avail_get(uint32_t reg) {
+    return (reg & UART_STATUS_RX_AVAIL) >> UART_STATUS_RX_AVAIL_SHIFT;
+}
+static inline uint32_t uart_status_rx_avail_set(uint32_t reg, uint32_t value) {
+    return (reg & ~UART_STATUS_RX_AVAIL) | ((value << UART_STATUS_RX_AVAIL_SHIFT) & UART_STATUS_RX_AVAIL);
+}
+
+// UART CTRL fields
+#define UART_CTRL_TX_EN             0x00000001u  // Enable transmitter
+#define UART_CTRL_TX_EN_SHIFT       0
+#define UART_CTRL_TX_EN_WIDTH       1
+#define UART_CTRL_RX_EN             0x00000002u  // Enable receiver
+#define UART_CTRL_RX_EN_SHIFT       1
+#define UART_CTRL_RX_EN_WIDTH       1
+
+static inline uint32_t uart_ctrl_tx_en_get(uint32_t reg) {
+    return (reg & UART_CTRL_TX_EN) >> UART_CTRL_TX_EN_SHIFT;
+}
+static inline uint32_t uart_ctrl_tx_en_set(uint32_t reg, uint32_t value) {
+    return (reg & ~UART_CTRL_TX_EN) | ((value << UART_CTRL_TX_EN_SHIFT) & UART_CTRL_TX_EN);
+}
+static inline uint32_t uart_ctrl_rx_en_get(uint32_t reg) {
+    return (reg & UART_CTRL_RX_EN) >> UART_CTRL_RX_EN_SHIFT;
+}
+static inline uint32_t uart_ctrl_rx_en_set(uint32_t reg, uint32_t value) {
+    return (reg & ~UART_CTRL_RX_EN) | ((value << UART_CTRL_RX_EN_SHIFT) & UART_CTRL_RX_EN);
+}
+
+// UART IRQ_EN fields
+#define UART_IRQ_EN_RX_AVAIL        0x00000001u  // RX data available
+#define UART_IRQ_EN_RX_AVAIL_SHIFT  0
+#define UART_IRQ_EN_RX_AVAIL_WIDTH  1
+#define UART_IRQ_EN_TX_EMPTY        0x00000002u  // TX FIFO empty
+#define UART_IRQ_EN_TX_EMPTY_SHIFT  1
+#define UART_IRQ_EN_TX_EMPTY_WIDTH  1
+
+static inline uint32_t uart_irq_en_rx_avail_get(uint32_t reg) {
+    return (reg & UART_IRQ_EN_RX_AVAIL) >> UART_IRQ_EN_RX_AVAIL_SHIFT;
+}
+static inline uint32_t uart_irq_en_rx_avail_set(uint32_t reg, uint32_t value) {
+    return (reg & ~UART_IRQ_EN_RX_AVAIL) | ((value << UART_IRQ_EN_RX_AVAIL_SHIFT) & UART_IRQ_EN_RX_AVAIL);
+}
+static inline uint32_t uart_irq_en_tx_empty_get(uint32_t reg) {
+    return (reg & UART_IRQ_EN_TX_EMPTY) >> UART_IRQ_EN_TX_EMPTY_SHIFT;
+}
+static inline uint32_t uart_irq_en_tx_empty_set(uint32_t reg, uint32_t value) {
+    return (reg & ~UART_IRQ_EN_TX_EMPTY) | ((value << UART_IRQ_EN_TX_EMPTY_SHIFT) & UART_IRQ_EN_TX_EMPTY);
+}
+
+//=============================================================================
+// Instruction Cache (Base: 0x00020600)
+//=============================================================================
+
+#define ICACHE_BASE     (PERIPH_BASE + 0x0600)
+#define ICACHE_SIZE     0x00000100u
+
+typedef volatile struct {
+    uint32_t CTRL;              // 0x00: Control register (rw)
+    const uint32_t HITS;        // 0x04: Fetches answered from the cache (ro)
+    const uint32_t MISSES;      // 0x08: Line fills (ro)
+    const uint32_t CONFIG;      // 0x0C: Cache geometry (ro)
+} icache_regs_t;
+
+#define ICACHE ((icache_regs_t*)ICACHE_BASE)
+
+_Static_assert(offsetof(icache_regs_t, CTRL) == 0x00, "ICACHE.CTRL offset");
+_Static_assert(offsetof(icache_regs_t, HITS) == 0x04, "ICACHE.HITS offset");
+_Static_assert(offsetof(icache_regs_t, MISSES) == 0x08, "ICACHE.MISSES offset");
+_Static_assert(offsetof(icache_regs_t, CONFIG) == 0x0C, "ICACHE.CONFIG offset");
+
+// ICACHE CTRL fields
+#define ICACHE_CTRL_ENABLE          0x00000001u  // Cache ROM fetches (reset: disabled)
+#define ICACHE_CTRL_ENABLE_SHIFT    0
+#define ICACHE_CTRL_ENABLE_WIDTH    1
+#define ICACHE_CTRL_FLUSH           0x00000002u  // Invalidate all lines (self-clearing)
+#define ICACHE_CTRL_FLUSH_SHIFT     1
+#define ICACHE_CTRL_FLUSH_WIDTH     1
+#define ICACHE_CTRL_CLEAR_STATS     0x00000004u  // Zero HITS and MISSES (self-clearing)
+#define ICACHE_CTRL_CLEAR_STATS_SHIFT 2
+#define ICACHE_CTRL_CLEAR_STATS_WIDTH 1
+
+static inline uint32_t icache_ctrl_enable_get(uint32_t reg) {
+    return (reg & ICACHE_CTRL_ENABLE) >> ICACHE_CTRL_ENABLE_SHIFT;
+}
+static inline uint32_t icache_ctrl_enable_set(uint32_t reg, uint32_t value) {
+    return (reg & ~ICACHE_CTRL_ENABLE) | ((value << ICACHE_CTRL_ENABLE_SHIFT) & ICACHE_CTRL_ENABLE);
+}
+static inline uint32_t icache_ctrl_flush_get(uint32_t reg) {
+    return (reg & ICACHE_CTRL_FLUSH) >> ICACHE_CTRL_FLUSH_SHIFT;
+}
+static inline uint32_t icache_ctrl_flush_set(uint32_t reg, uint32_t value) {
+    return (reg & ~ICACHE_CTRL_FLUSH) | ((value << ICACHE_CTRL_FLUSH_SHIFT) & ICACHE_CTRL_FLUSH);
+}
+static inline uint32_t icache_ctrl_clear_stats_get(uint32_t reg) {
+    return (reg & ICACHE_CTRL_CLEAR_STATS) >> ICACHE_CTRL_CLEAR_STATS_SHIFT;
+}
+static inline uint32_t icache_ctrl_clear_stats_set(uint32_t reg, uint32_t value) {
+    return (reg & ~ICACHE_CTRL_CLEAR_STATS) | ((value << ICACHE_CTRL_CLEAR_STATS_SHIFT) & ICACHE_CTRL_CLEAR_STATS);
+}
+
+// ICACHE CONFIG fields
+#define ICACHE_CONFIG_SIZE          0x0000FFFFu  // Capacity in bytes
+#define ICACHE_CONFIG_SIZE_SHIFT    0
+#define ICACHE_CONFIG_SIZE_WIDTH    16
+#define ICACHE_CONFIG_LINE_WORDS    0x00FF0000u  // Words per line
+#define ICACHE_CONFIG_LINE_WORDS_SHIFT 16
+#define ICACHE_CONFIG_LINE_WORDS_WIDTH 8
+
+static inline uint32_t icache_config_size_get(uint32_t reg) {
+    return (reg & ICACHE_CONFIG_SIZE) >> ICACHE_CONFIG_SIZE_SHIFT;
+}
+static inline uint32_t icache_config_size_set(uint32_t reg, uint32_t value) {
+    return (reg & ~ICACHE_CONFIG_SIZE) | ((value << ICACHE_CONFIG_SIZE_SHIFT) & ICACHE_CONFIG_SIZE);
+}
+static inline uint32_t icache_config_line_words_get(uint32_t reg) {
+    return (reg & ICACHE_CONFIG_LINE_WORDS) >> ICACHE_CONFIG_LINE_WORDS_SHIFT;
+}
+static inline uint32_t icache_config_line_words_set(uint32_t reg, uint32_t value) {
+    return (reg & ~ICACHE_CONFIG_LINE_WORDS) | ((value << ICACHE_CONFIG_LINE_WORDS_SHIFT) & ICACHE_CONFIG_LINE_WORDS);
+}
+
+//=============================================================================
+// DMA Controller (Base: 0x00020700)
+//=============================================================================
+
+#define DMA_BASE        (PERIPH_BASE + 0x0700)
+#define DMA_SIZE        0x00000100u
+
+typedef volatile struct {
+    uint32_t CH0_CTRL;          // 0x00: Channel 0 control (rw)
+    uint32_t CH0_STATUS;        // 0x04: Channel 0 status (w1c)
+    uint32_t CH0_DESC;          // 0x08: Next descriptor address (write while idle) (rw)
+    const uint32_t CH0_SRC;     // 0x0C: Current source address (ro)
+    const uint32_t CH0_DST;     // 0x10: Current destination address (ro)
+    const uint32_t CH0_COUNT;   // 0x14: Elements left in the current descriptor (ro)
+    const uint32_t _reserved0[2];
+    uint32_t CH1_CTRL;          // 0x20: Channel 1 control (rw)
+    uint32_t CH1_STATUS;        // 0x24: Channel 1 status (w1c)
+    uint32_t CH1_DESC;          // 0x28: Next descriptor address (write while idle) (rw)
+    const uint32_t CH1_SRC;     // 0x2C: Current source address (ro)
+    const uint32_t CH1_DST;     // 0x30: Current destination address (ro)
+    const uint32_t CH1_COUNT;   // 0x34: Elements left in the current descriptor (ro)
+} dma_regs_t;
+
+#define DMA ((dma_regs_t*)DMA_BASE)
+
+_Static_assert(offsetof(dma_regs_t, CH0_CTRL) == 0x00, "DMA.CH0_CTRL offset");
+_Static_assert(offsetof(dma_regs_t, CH0_STATUS) == 0x04, "DMA.CH0_STATUS offset");
+_Static_assert(offsetof(dma_regs_t, CH0_DESC) == 0x08, "DMA.CH0_DESC offset");
+_Static_assert(offsetof(dma_regs_t, CH0_SRC) == 0x0C, "DMA.CH0_SRC offset");
+_Static_assert(offsetof(dma_regs_t, CH0_DST) == 0x10, "DMA.CH0_DST offset");
+_Static_assert(offsetof(dma_regs_t, CH0_COUNT) == 0x14, "DMA.CH0_COUNT offset");
+_Static_assert(offsetof(dma_regs_t, CH1_CTRL) == 0x20, "DMA.CH1_CTRL offset");
+_Static_assert(offsetof(dma_regs_t, CH1_STATUS) == 0x24, "DMA.CH1_STATUS offset");
+_Static_assert(offsetof(dma_regs_t, CH1_DESC) == 0x28, "DMA.CH1_DESC offset");
+_Static_assert(offsetof(dma_regs_t, CH1_SRC) == 0x2C, "DMA.CH1_SRC offset");
+_Static_assert(offsetof(dma_regs_t, CH1_DST) == 0x30, "DMA.CH1_DST offset");
+_Static_assert(offsetof(dma_regs_t, CH1_COUNT) == 0x34, "DMA.CH1_COUNT offset");
+
+// DMA CH0_CTRL fields
+#define DMA_CH0_CTRL_START          0x00000001u  // Fetch DESC and run the chain (self-clearing)
+#define DMA_CH0_CTRL_START_SHIFT    0
+#define DMA_CH0_CTRL_START_WIDTH    1
+#define DMA_CH0_CTRL_ABORT          0x00000002u  // Stop after the current element (self-clearing)
+#define DMA_CH0_CTRL_ABORT_SHIFT    1
+#define DMA_CH0_CTRL_ABORT_WIDTH    1
+#define DMA_CH0_CTRL_IRQ_EN         0x00000004u  // Interrupt on DONE or ERROR
+#define DMA_CH0_CTRL_IRQ_EN_SHIFT   2
+#define DMA_CH0_CTRL_IRQ_EN_WIDTH   1
+
+static inline uint32_t dma_ch0_ctrl_start_get(uint32_t reg) {
+    return (reg & DMA_CH0_CTRL_START) >> DMA_CH0_CTRL_START_SHIFT;
+}
+static inline uint32_t dma_ch0_ctrl_start_set(uint32_t reg, uint32_t value) {
+    return (reg & ~DMA_CH0_CTRL_START) | ((value << DMA_CH0_CTRL_START_SHIFT) & DMA_CH0_CTRL_START);
+}
+static inline uint32_t dma_ch0_ctrl_abort_get(uint32_t reg) {
+    return (reg & DMA_CH0_CTRL_ABORT) >> DMA_CH0_CTRL_ABORT_SHIFT;
+}
+static inline uint32_t dma_ch0_ctrl_abort_set(uint32_t reg, uint32_t value) {
+    return (reg & ~DMA_CH0_CTRL_ABORT) | ((value << DMA_CH0_CTRL_ABORT_SHIFT) & DMA_CH0_CTRL_ABORT);
+}
+static inline uint32_t dma_ch0_ctrl_irq_en_get(uint32_t reg) {
+    return (reg & DMA_CH0_CTRL_IRQ_EN) >> DMA_CH0_CTRL_IRQ_EN_SHIFT;
+}
+static inline uint32_t dma_ch0_ctrl_irq_en_set(uint32_t reg, uint32_t value) {
+    return (reg & ~DMA_CH0_CTRL_IRQ_EN) | ((value << DMA_CH0_CTRL_IRQ_EN_SHIFT) & DMA_CH0_CTRL_IRQ_EN);
+}
+
+// DMA CH0_STATUS fields
+#define DMA_CH0_STATUS_BUSY         0x00000001u  // Chain running (read-only)
+#define DMA_CH0_STATUS_BUSY_SHIFT   0
+#define DMA_CH0_STATUS_BUSY_WIDTH   1
+#define DMA_CH0_STATUS_DONE         0x00000002u  // Chain or IRQ descriptor completed
+#define DMA_CH0_STATUS_DONE_SHIFT   1
+#define DMA_CH0_STATUS_DONE_WIDTH   1
+#define DMA_CH0_STATUS_ERROR        0x00000004u  // Bus error, channel stopped
+#define DMA_CH0_STATUS_ERROR_SHIFT  2
+#define DMA_CH0_STATUS_ERROR_WIDTH  1
+
+static inline uint32_t dma_ch0_status_busy_get(uint32_t reg) {
+    return (reg & DMA_CH0_STATUS_BUSY) >> DMA_CH0_STATUS_BUSY_SHIFT;
+}
+static inline uint32_t dma_ch0_status_busy_set(uint32_t reg, uint32_t value) {
+    return (reg & ~DMA_CH0_STATUS_BUSY) | ((value << DMA_CH0_STATUS_BUSY_SHIFT) & DMA_CH0_STATUS_BUSY);
+}
+static inline uint32_t dma_ch0_status_done_get(uint32_t reg) {
+    return (reg & DMA_CH0_STATUS_DONE) >> DMA_CH0_STATUS_DONE_SHIFT;
+}
+static inline uint32_t dma_ch0_status_done_set(uint32_t reg, uint32_t value) {
+    return (reg & ~DMA_CH0_STATUS_DONE) | ((value << DMA_CH0_STATUS_DONE_SHIFT) & DMA_CH0_STATUS_DONE);
+}
+static inline uint32_t dma_ch0_status_error_get(uint32_t reg) {
+    return (reg & DMA_CH0_STATUS_ERROR) >> DMA_CH0_STATUS_ERROR_SHIFT;
+}
+static inline uint32_t dma_ch0_status_error_set(uint32_t reg, uint32_t value) {
+    return (reg & ~DMA_CH0_STATUS_ERROR) | ((value << DMA_CH0_STATUS_ERROR_SHIFT) & DMA_CH0_STATUS_ERROR);
+}
+
+// DMA CH1_CTRL fields
+#define DMA_CH1_CTRL_START          0x00000001u  // Fetch DESC and run the chain (self-clearing)
+#define DMA_CH1_CTRL_START_SHIFT    0
+#define DMA_CH1_CTRL_START_WIDTH    1
+#define DMA_CH1_CTRL_ABORT          0x00000002u  // Stop after the current element (self-clearing)
+#define DMA_CH1_CTRL_ABORT_SHIFT    1
+#define DMA_CH1_CTRL_ABORT_WIDTH    1
+#define DMA_CH1_CTRL_IRQ_EN         0x00000004u  // Interrupt on DONE or ERROR
+#define DMA_CH1_CTRL_IRQ_EN_SHIFT   2
+#define DMA_CH1_CTRL_IRQ_EN_WIDTH   1
+
+static inline uint32_t dma_ch1_ctrl_start_get(uint32_t reg) {
+    return (reg & DMA_CH1_CTRL_START) >> DMA_CH1_CTRL_START_SHIFT;
+}
+static inline uint32_t dma_ch1_ctrl_start_set(uint32_t reg, uint32_t value) {
+    return (reg & ~DMA_CH1_CTRL_START) | ((value << DMA_CH1_CTRL_START_SHIFT) & DMA_CH1_CTRL_START);
+}
+static inline uint32_t dma_ch1_ctrl_abort_get(uint32_t reg) {
+    return (reg & DMA_CH1_CTRL_ABORT) >> DMA_CH1_CTRL_ABORT_SHIFT;
+}
+static inline uint32_t dma_ch1_ctrl_abort_set(uint32_t reg, uint32_t value) {
+    return (reg & ~DMA_CH1_CTRL_ABORT) | ((value << DMA_CH1_CTRL_ABORT_SHIFT) & DMA_CH1_CTRL_ABORT);
+}
+static inline uint32_t dma_ch1_ctrl_irq_en_get(uint32_t reg) {
+    return (reg & DMA_CH1_CTRL_IRQ_EN) >> DMA_CH1_CTRL_IRQ_EN_SHIFT;
+}
+static inline uint32_t dma_ch1_ctrl_irq_en_set(uint32_t reg, uint32_t value) {
+    return (reg & ~DMA_CH1_CTRL_IRQ_EN) | ((value << DMA_CH1_CTRL_IRQ_EN_SHIFT) & DMA_CH1_CTRL_IRQ_EN);
+}
+
+// DMA CH1_STATUS fields
+#define DMA_CH1_STATUS_BUSY         0x00000001u  // Chain running (read-only)
+#define DMA_CH1_STATUS_BUSY_SHIFT   0
+#define DMA_CH1_STATUS_BUSY_WIDTH   1
+#define DMA_CH1_STATUS_DONE         0x00000002u  // Chain or IRQ descriptor completed
+#define DMA_CH1_STATUS_DONE_SHIFT   1
+#define DMA_CH1_STATUS_DONE_WIDTH   1
+#define DMA_CH1_STATUS_ERROR        0x00000004u  // Bus error, channel stopped
+#define DMA_CH1_STATUS_ERROR_SHIFT  2
+#define DMA_CH1_STATUS_ERROR_WIDTH  1
+
+static inline uint32_t dma_ch1_status_busy_get(uint32_t reg) {
+    return (reg & DMA_CH1_STATUS_BUSY) >> DMA_CH1_STATUS_BUSY_SHIFT;
+}
+static inline uint32_t dma_ch1_status_busy_set(uint32_t reg, uint32_t value) {
+    return (reg & ~DMA_CH1_STATUS_BUSY) | ((value << DMA_CH1_STATUS_BUSY_SHIFT) & DMA_CH1_STATUS_BUSY);
+}
+static inline uint32_t dma_ch1_status_done_get(uint32_t reg) {
+    return (reg & DMA_CH1_STATUS_DONE) >> DMA_CH1_STATUS_DONE_SHIFT;
+}
+static inline uint32_t dma_ch1_status_done_set(uint32_t reg, uint32_t value) {
+    return (reg & ~DMA_CH1_STATUS_DONE) | ((value << DMA_CH1_STATUS_DONE_SHIFT) & DMA_CH1_STATUS_DONE);
+}
+static inline uint32_t dma_ch1_status_error_get(uint32_t reg) {
+    return (reg & DMA_CH1_STATUS_ERROR) >> DMA_CH1_STATUS_ERROR_SHIFT;
+}
+static inline uint32_t dma_ch1_status_error_set(uint32_t reg, uint32_t value) {
+    return (reg & ~DMA_CH1_STATUS_ERROR) | ((value << DMA_CH1_STATUS_ERROR_SHIFT) & DMA_CH1_STATUS_ERROR);
+}
+
+#endif // SOC_REGS_H
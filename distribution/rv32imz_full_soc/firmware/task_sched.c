@@ -0,0 +1,184 @@
+/**
+ * @file task_sched.c
+ * @brief Cooperative Tick Scheduler with WFI Between Events
+ *
+ * The sleep closes the race between "nothing is due" and wfi by masking
+ * mstatus.MIE around it: wfi still wakes on a pending enabled interrupt,
+ * which is then taken as soon as MIE is restored, so a tick or compare
+ * match that arrives after the check cannot be slept through.
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-20
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "soc_regs.h"
+#include "irq.h"
+#include "perf_counters.h"
+#include "tcm.h"
+#include "task_sched.h"
+
+typedef struct {
+    sched_task_fn_t fn;                 // NULL = free slot
+    void* arg;
+    uint32_t due;                       // tick of the next run
+} sched_task_t;
+
+static sched_task_t tasks[SCHED_MAX_TASKS];
+
+uint32_t sched_tick_hz = 1000;
+static int sched_owns_timer;
+FAST_DATA static volatile uint32_t sched_ticks;   // sched_init_tick mode
+static uint32_t polled_at;              // sched_now() of the last poll
+
+static uint32_t idle_cycles;
+static uint32_t idle_window_start;
+
+//==========================================================================
+// Time Base
+//==========================================================================
+
+// Compare match only wakes the core; the scheduler reads COUNT itself
+FAST_TEXT static void sched_timer_isr(void) {
+    TIMER->STATUS = TIMER_STATUS_MATCH;
+}
+
+void sched_init_timer(uint32_t cpu_hz, uint32_t tick_hz) {
+    sched_tick_hz = tick_hz;
+    sched_owns_timer = 1;
+
+    // Free-running COUNT (no AUTO); COMPARE moves with the next deadline
+    TIMER->CTRL = 0;
+    TIMER->PRESCALER = cpu_hz / tick_hz - 1;
+    TIMER->COUNT = 0;
+    TIMER->COMPARE = 0xFFFFFFFFu;
+    TIMER->STATUS = TIMER_STATUS_MATCH;
+    TIMER->IRQ_EN = TIMER_IRQ_EN_MATCH;
+
+    irq_register(IRQ_TIMER, sched_timer_isr, NULL);
+    irq_enable(IRQ_TIMER);
+    TIMER->CTRL = TIMER_CTRL_ENABLE | TIMER_CTRL_IRQ_EN;
+
+    idle_window_start = perf_cycles();
+}
+
+void sched_init_tick(uint32_t tick_hz) {
+    sched_tick_hz = tick_hz;
+    sched_owns_timer = 0;
+    idle_window_start = perf_cycles();
+}
+
+// Called from the control ISR (tick mode): TCM like its caller
+FAST_TEXT void sched_tick(void) {
+    sched_ticks++;
+}
+
+uint32_t sched_now(void) {
+    return sched_owns_timer ? TIMER->COUNT : sched_ticks;
+}
+
+//==========================================================================
+// Tasks
+//==========================================================================
+
+sched_task_id_t sched_add(sched_task_fn_t fn, void* arg, uint32_t delay) {
+    for (int i = 0; i < SCHED_MAX_TASKS; i++) {
+        if (tasks[i].fn == NULL) {
+            tasks[i].arg = arg;
+            tasks[i].due = sched_now() + delay;
+            tasks[i].fn = fn;
+            return i;
+        }
+    }
+    return -1;
+}
+
+void sched_cancel(sched_task_id_t id) {
+    if (id >= 0 && id < SCHED_MAX_TASKS) {
+        tasks[id].fn = NULL;
+    }
+}
+
+int sched_active(sched_task_id_t id) {
+    return id >= 0 && id < SCHED_MAX_TASKS && tasks[id].fn != NULL;
+}
+
+uint32_t sched_poll(void) {
+    uint32_t next = UINT32_MAX;
+    polled_at = sched_now();
+
+    for (int i = 0; i < SCHED_MAX_TASKS; i++) {
+        sched_task_t* t = &tasks[i];
+        if (t->fn == NULL) continue;
+
+        uint32_t now = sched_now();
+        int32_t wait = (int32_t)(t->due - now);
+        if (wait <= 0) {
+            uint32_t period = t->fn(t->arg);
+            if (t->fn == NULL) continue;        // cancelled itself
+            if (period == SCHED_STOP) {
+                t->fn = NULL;
+                continue;
+            }
+            // From the deadline, so periodic tasks keep their rate; an
+            // overrun skips the missed runs instead of bunching them up
+            t->due += period;
+            if ((int32_t)(t->due - now) <= 0) t->due = now + period;
+            wait = (int32_t)(t->due - now);
+        }
+        if ((uint32_t)wait < next) next = (uint32_t)wait;
+    }
+    return next;
+}
+
+//==========================================================================
+// Sleep
+//==========================================================================
+
+static void sched_sleep(uint32_t wait) {
+    uint32_t mstatus = irq_save();
+
+    if (sched_owns_timer) {
+        // Match fires when COUNT passes COMPARE, i.e. at COMPARE + 1
+        if (wait > 0x7FFFFFFFu) wait = 0x7FFFFFFFu;
+        uint32_t deadline = polled_at + wait;
+        TIMER->COMPARE = deadline - 1;
+        TIMER->STATUS = TIMER_STATUS_MATCH;
+        if ((int32_t)(deadline - TIMER->COUNT) <= 0) {
+            irq_restore(mstatus);
+            return;                             // deadline passed meanwhile
+        }
+    } else if (sched_ticks != polled_at) {
+        irq_restore(mstatus);
+        return;                                 // ticked since the poll
+    }
+
+    uint32_t start = perf_cycles();
+    asm volatile("wfi");
+    idle_cycles += perf_cycles() - start;
+
+    irq_restore(mstatus);
+}
+
+void sched_run(void) {
+    while (1) {
+        uint32_t wait = sched_poll();
+        if (wait != 0) {
+            sched_sleep(wait);
+        }
+    }
+}
+
+uint32_t sched_idle_percent(void) {
+    uint32_t mstatus = irq_save();
+    uint32_t now = perf_cycles();
+    uint32_t total = now - idle_window_start;
+    uint32_t idle = idle_cycles;
+    idle_window_start = now;
+    idle_cycles = 0;
+    irq_restore(mstatus);
+
+    uint32_t percent = total >= 100 ? idle / (total / 100) : 0;
+    return percent < 100 ? percent : 100;
+}
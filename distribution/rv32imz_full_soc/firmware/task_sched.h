@@ -0,0 +1,123 @@
+/**
+ * @file task_sched.h
+ * @brief Cooperative Tick Scheduler with WFI Between Events
+ *
+ * Background work (soft-start ramps, watchdog kicks, status prints,
+ * telemetry, console) runs as timed tasks from the main loop instead of
+ * calibrated delay loops. A task runs to completion and returns how many
+ * ticks until it wants to run again; periodic tasks are rescheduled from
+ * their deadline, not from when they happened to run, so they do not
+ * drift. When nothing is due the core sleeps in wfi until the next
+ * interrupt.
+ *
+ * Two time bases:
+ *
+ *   sched_init_timer(hz)   the scheduler owns TIMER: COUNT runs free at
+ *                          hz and COMPARE is set to the earliest deadline,
+ *                          so the core wakes exactly when a task is due.
+ *   sched_init_tick(hz)    an existing periodic interrupt (the 10 kHz
+ *                          control timer) calls sched_tick(); every tick
+ *                          wakes the core and the scheduler checks its
+ *                          deadlines.
+ *
+ *   sched_init_tick(CONTROL_FREQ_HZ);
+ *   sched_add(status_task, NULL, sched_ms(1000));
+ *   sched_run();                                // never returns
+ *
+ * A task returning SCHED_STOP is removed; sched_add() can start it again.
+ * Tasks must not block: a wait becomes a return with the wait in ticks.
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-20
+ */
+
+#ifndef TASK_SCHED_H
+#define TASK_SCHED_H
+
+#include <stdint.h>
+
+#ifndef SCHED_MAX_TASKS
+#define SCHED_MAX_TASKS     8
+#endif
+
+#define SCHED_STOP          0u      // task return: do not run again
+
+/**
+ * @brief Task body: returns ticks until the next run, or SCHED_STOP
+ */
+typedef uint32_t (*sched_task_fn_t)(void* arg);
+
+typedef int sched_task_id_t;        // -1 = no free slot
+
+extern uint32_t sched_tick_hz;
+
+/**
+ * @brief Milliseconds to ticks (at least one tick)
+ */
+static inline uint32_t sched_ms(uint32_t ms) {
+    // 32-bit only: the fixed-point builds link without libgcc
+    uint32_t ticks = ms * (sched_tick_hz / 1000) + ms * (sched_tick_hz % 1000) / 1000;
+    return ticks != 0 ? ticks : 1;
+}
+
+//==========================================================================
+// Setup
+//==========================================================================
+
+/**
+ * @brief Own TIMER as a free-running @p tick_hz clock with compare wakeups
+ *
+ * @param cpu_hz Core clock (the TIMER input)
+ */
+void sched_init_timer(uint32_t cpu_hz, uint32_t tick_hz);
+
+/**
+ * @brief Take ticks from sched_tick(), called by a periodic ISR at @p tick_hz
+ */
+void sched_init_tick(uint32_t tick_hz);
+
+/**
+ * @brief Advance the tick count (interrupt context, sched_init_tick mode)
+ */
+void sched_tick(void);
+
+//==========================================================================
+// Tasks
+//==========================================================================
+
+/**
+ * @brief Run @p fn(@p arg) after @p delay ticks (0 = on the next pass)
+ */
+sched_task_id_t sched_add(sched_task_fn_t fn, void* arg, uint32_t delay);
+
+/**
+ * @brief Remove a task; a no-op if it has already stopped
+ */
+void sched_cancel(sched_task_id_t id);
+
+int sched_active(sched_task_id_t id);
+
+/**
+ * @brief Current time in ticks (wraps; compare with differences)
+ */
+uint32_t sched_now(void);
+
+/**
+ * @brief Run every due task once; returns ticks until the next deadline
+ *
+ * UINT32_MAX if no task is waiting. For callers with their own loop;
+ * sched_run() is this plus the sleep.
+ */
+uint32_t sched_poll(void);
+
+/**
+ * @brief Run tasks forever, sleeping in wfi while nothing is due
+ */
+void sched_run(void) __attribute__((noreturn));
+
+/**
+ * @brief Percentage of cycles spent in wfi since the previous call
+ */
+uint32_t sched_idle_percent(void);
+
+#endif // TASK_SCHED_H
@@ -0,0 +1,40 @@
+/**
+ * @file tcm.h
+ * @brief Placement of the ISR Hot Path in Tightly-Coupled Memory
+ *
+ * Code and data executed from ROM/RAM share the system bus with instruction
+ * fills, peripheral accesses and the UART, so ISR timing depends on what
+ * else is going on. The TCM (rtl/memory/tcm.v, TCM_BASE) has private
+ * zero-wait-state instruction and data ports. Tag what the 10 kHz loop
+ * touches every cycle:
+ *
+ *   FAST_TEXT void control_isr(void) { ... }
+ *   FAST_DATA static control_state_t ctrl;
+ *   FAST_RODATA const q15_t sine_lut_quarter[257] = { ... };
+ *
+ * application.ld collects these into .fast_text/.fast_data (load address in
+ * ROM) and startup.S copies them to the TCM before main(), the same way as
+ * .data. FAST_DATA objects are initialised from their image values (zero if
+ * none is given), never by the .bss loop.
+ *
+ * The trap entry (trap.S), trap_dispatch() and sched_tick() are already
+ * there. Only what is tagged moves: untagged callees that are not inlined
+ * still run from ROM, so tag the whole call chain below the dispatch. The
+ * linker reports overflow of the 8 KB region (--print-memory-usage shows
+ * the TCM line).
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#ifndef TCM_H
+#define TCM_H
+
+#define FAST_TEXT   __attribute__((section(".fast_text")))
+#define FAST_DATA   __attribute__((section(".fast_data")))
+
+// Separate input section: GCC rejects const and non-const objects in one
+// named section within a translation unit
+#define FAST_RODATA __attribute__((section(".fast_data.rodata")))
+
+#endif // TCM_H
@@ -0,0 +1,102 @@
+/**
+ * @file telemetry.c
+ * @brief SPSC Telemetry Consumer and UART Framing
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#include <stdint.h>
+#include "telemetry.h"
+#include "uart.h"
+
+#define FRAME_HEADER    8       // sync(2) type channels seq(2) count dropped
+#define FRAME_CRC       2
+#define FRAME_MAX       (FRAME_HEADER + TELEMETRY_FRAME_SAMPLES * TELEMETRY_CHANNELS * 2 + FRAME_CRC)
+
+// TX ring space left for console messages while streaming
+#define UART_RESERVE    (UART_TX_BUF_SIZE / 4)
+
+telemetry_ring_t telemetry;
+
+static uint32_t dropped_reported;       // consumer's copy of telemetry.dropped
+
+/**
+ * @brief CRC-16/CCITT-FALSE, nibble table (32 bytes of ROM)
+ */
+static uint16_t crc16_update(uint16_t crc, const uint8_t* data, uint32_t len) {
+    static const uint16_t table[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    };
+
+    for (uint32_t i = 0; i < len; i++) {
+        crc = (uint16_t)((crc << 4) ^ table[(crc >> 12) ^ (data[i] >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ table[(crc >> 12) ^ (data[i] & 0x0F)]);
+    }
+    return crc;
+}
+
+void telemetry_init(uint32_t decimation) {
+    telemetry.enabled = 0;
+    telemetry.head = 0;
+    telemetry.tail = 0;
+    telemetry.dropped = 0;
+    telemetry.phase = 0;
+    telemetry.decimation = decimation ? decimation : 1;
+    dropped_reported = 0;
+}
+
+void telemetry_enable(int on) {
+    telemetry.enabled = on ? 1 : 0;
+}
+
+void telemetry_poll(void) {
+    uint8_t frame[FRAME_MAX];
+
+    while (1) {
+        uint32_t tail = telemetry.tail;
+        uint32_t avail = telemetry.head - tail;
+        if (avail < TELEMETRY_FRAME_SAMPLES) {
+            return;                     // full frames only: 10 bytes overhead each
+        }
+        avail = TELEMETRY_FRAME_SAMPLES;
+
+        uint32_t len = FRAME_HEADER + avail * TELEMETRY_CHANNELS * 2 + FRAME_CRC;
+        if (uart_tx_free() < len + UART_RESERVE) {
+            return;                     // try again next pass, never drop a frame
+        }
+
+        uint32_t lost = telemetry.dropped - dropped_reported;
+        if (lost > 255) lost = 255;
+        dropped_reported += lost;
+
+        frame[0] = TELEMETRY_SYNC0;
+        frame[1] = TELEMETRY_SYNC1;
+        frame[2] = TELEMETRY_TYPE_WAVE;
+        frame[3] = TELEMETRY_CHANNELS;
+        frame[4] = (uint8_t)tail;
+        frame[5] = (uint8_t)(tail >> 8);
+        frame[6] = (uint8_t)avail;
+        frame[7] = (uint8_t)lost;
+
+        uint8_t* p = &frame[FRAME_HEADER];
+        for (uint32_t n = 0; n < avail; n++) {
+            const telemetry_sample_t* s = &telemetry.buf[(tail + n) & (TELEMETRY_DEPTH - 1)];
+            for (uint32_t c = 0; c < TELEMETRY_CHANNELS; c++) {
+                *p++ = (uint8_t)s->ch[c];
+                *p++ = (uint8_t)((uint16_t)s->ch[c] >> 8);
+            }
+        }
+
+        // Samples are copied out: hand the slots back to the producer
+        asm volatile("" ::: "memory");
+        telemetry.tail = tail + avail;
+
+        uint16_t crc = crc16_update(0xFFFF, &frame[2], (uint32_t)(p - &frame[2]));
+        *p++ = (uint8_t)crc;
+        *p++ = (uint8_t)(crc >> 8);
+
+        uart_write((const char*)frame, len);
+    }
+}
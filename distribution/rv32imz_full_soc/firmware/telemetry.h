@@ -0,0 +1,109 @@
+/**
+ * @file telemetry.h
+ * @brief Lock-Free SPSC Waveform Telemetry (ISR -> background -> UART)
+ *
+ * The control ISR is the only producer and the background loop the only
+ * consumer, so the ring needs no interrupt masking: the producer owns
+ * head and the drop counter, the consumer owns tail. A sample is stored
+ * before head is published (compiler barrier; the core is in-order and
+ * single-issue, so no hardware fence is needed).
+ *
+ *   ISR:   telemetry_push(v_ref, v_fb, i_fb, mi);     // ~10 instructions
+ *   loop:  telemetry_poll();                          // frames out over UART
+ *
+ * Wire frame (little-endian), decoded by tools/telemetry_decode.py:
+ *
+ *   A5 5A | type(1) | channels(1) | seq(2) | count(1) | dropped(1) |
+ *   samples[count][channels] int16 | CRC-16/CCITT(2) over type..samples
+ *
+ * seq is the ring index of the first sample (mod 2^16); dropped counts
+ * samples lost to a full ring since the previous frame (saturates at 255).
+ * Frames are only queued when the UART TX ring can take them whole, so
+ * console text and telemetry interleave without corrupting each other.
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+
+#define TELEMETRY_CHANNELS      4
+
+#ifndef TELEMETRY_DEPTH
+#define TELEMETRY_DEPTH         512     // samples, power of two
+#endif
+
+#ifndef TELEMETRY_FRAME_SAMPLES
+#define TELEMETRY_FRAME_SAMPLES 16      // samples per UART frame
+#endif
+
+#define TELEMETRY_SYNC0         0xA5
+#define TELEMETRY_SYNC1         0x5A
+#define TELEMETRY_TYPE_WAVE     0x01
+
+//==========================================================================
+// Data
+//==========================================================================
+
+typedef struct {
+    int16_t ch[TELEMETRY_CHANNELS];
+} telemetry_sample_t;
+
+typedef struct {
+    telemetry_sample_t buf[TELEMETRY_DEPTH];
+    volatile uint32_t head;             // producer: samples written
+    volatile uint32_t tail;             // consumer: samples sent
+    volatile uint32_t dropped;          // producer: samples lost (total)
+    uint32_t decimation;                // push every Nth call
+    uint32_t phase;
+    volatile uint32_t enabled;
+} telemetry_ring_t;
+
+extern telemetry_ring_t telemetry;
+
+//==========================================================================
+// Control (background context)
+//==========================================================================
+
+/**
+ * @brief Reset the ring and set the decimation (1 = every ISR call)
+ */
+void telemetry_init(uint32_t decimation);
+
+void telemetry_enable(int on);
+
+/**
+ * @brief Send as many complete frames as the UART TX ring has room for
+ */
+void telemetry_poll(void);
+
+//==========================================================================
+// Producer (ISR)
+//==========================================================================
+
+static inline void telemetry_push(int16_t a, int16_t b, int16_t c, int16_t d) {
+    if (!telemetry.enabled) return;
+    if (++telemetry.phase < telemetry.decimation) return;
+    telemetry.phase = 0;
+
+    uint32_t head = telemetry.head;
+    if (head - telemetry.tail >= TELEMETRY_DEPTH) {
+        telemetry.dropped++;
+        return;
+    }
+
+    telemetry_sample_t* s = &telemetry.buf[head & (TELEMETRY_DEPTH - 1)];
+    s->ch[0] = a;
+    s->ch[1] = b;
+    s->ch[2] = c;
+    s->ch[3] = d;
+
+    // Publish only after the sample is in RAM
+    asm volatile("" ::: "memory");
+    telemetry.head = head + 1;
+}
+
+#endif // TELEMETRY_H
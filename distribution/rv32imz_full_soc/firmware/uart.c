@@ -0,0 +1,444 @@
+/**
+ * @file uart.c
+ * @brief Shared Interrupt-Driven UART Driver
+ *
+ * Ring indices run freely and are masked on access. Producers (main loop
+ * and any ISR) update the TX head with interrupts masked; the UART ISR is
+ * the only consumer of the TX ring and the only producer of the RX ring.
+ *
+ * With USE_DMA the TX ring is drained by DMA channel 1 instead: each
+ * contiguous span of queued bytes becomes one descriptor paced by the UART
+ * TX request, and the DMA completion advances the tail and starts the
+ * next span. The CPU no longer copies bytes into the FIFO.
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#include <stdint.h>
+#include <stdarg.h>
+#include "soc_regs.h"
+#include "irq.h"
+#include "uart.h"
+#ifdef USE_DMA
+#include "dma.h"
+#endif
+
+#define TX_MASK     (UART_TX_BUF_SIZE - 1)
+#define RX_MASK     (UART_RX_BUF_SIZE - 1)
+
+static char tx_buf[UART_TX_BUF_SIZE];
+static volatile uint32_t tx_head;       // written by producers
+static volatile uint32_t tx_tail;       // written by the ISR
+
+static char rx_buf[UART_RX_BUF_SIZE];
+static volatile uint32_t rx_head;       // written by the ISR
+static volatile uint32_t rx_tail;
+
+volatile uart_stats_t uart_stats;
+
+#ifdef USE_DMA
+static dma_desc_t tx_desc;
+static uint32_t tx_dma_len;             // bytes owned by the running transfer
+
+static void uart_dma_done(unsigned ch, uint32_t status);
+#endif
+
+//==========================================================================
+// Interrupt Service
+//==========================================================================
+
+/**
+ * @brief Move queued bytes into the hardware FIFO (interrupts masked)
+ */
+#ifdef USE_DMA
+static void uart_tx_fill(void) {
+    // Also polled by uart_flush(), so completion is detected here rather
+    // than only in the DMA interrupt
+    if (tx_dma_len != 0) {
+        if (dma_busy(DMA_CH_UART)) return;
+        tx_tail += tx_dma_len;
+        tx_dma_len = 0;
+    }
+
+    uint32_t tail = tx_tail;
+    uint32_t len = tx_head - tail;
+    if (len == 0) return;
+
+    // Up to the end of the ring; the wrapped part goes in the next span
+    uint32_t offset = tail & TX_MASK;
+    if (len > UART_TX_BUF_SIZE - offset) {
+        len = UART_TX_BUF_SIZE - offset;
+    }
+
+    tx_desc.src = (uint32_t)&tx_buf[offset];
+    tx_desc.dst = (uint32_t)&UART->DATA;
+    tx_desc.cfg = DMA_CFG_COUNT(len) | DMA_CFG_SIZE_BYTE | DMA_CFG_SRC_INC |
+                  DMA_CFG_REQ_UART_TX;
+    tx_desc.next = 0;
+    tx_dma_len = len;
+    dma_start(DMA_CH_UART, &tx_desc, uart_dma_done);
+}
+
+static void uart_dma_done(unsigned ch, uint32_t status) {
+    (void)ch;
+    (void)status;
+    uart_tx_fill();
+}
+#else
+static void uart_tx_fill(void) {
+    uint32_t tail = tx_tail;
+
+    while (tail != tx_head && !(UART->STATUS & UART_STATUS_TX_FULL)) {
+        UART->DATA = (uint8_t)tx_buf[tail & TX_MASK];
+        tail++;
+    }
+    tx_tail = tail;
+
+    // TX_EMPTY is only wanted while there is something left to send
+    if (tail == tx_head) {
+        UART->IRQ_EN &= ~UART_IRQ_EN_TX_EMPTY;
+    } else {
+        UART->IRQ_EN |= UART_IRQ_EN_TX_EMPTY;
+    }
+}
+#endif
+
+static void uart_isr(void) {
+    while (UART->STATUS & UART_STATUS_RX_AVAIL) {
+        char c = (char)(UART->DATA & UART_DATA_BYTE);
+        uint32_t head = rx_head;
+        if (head - rx_tail < UART_RX_BUF_SIZE) {
+            rx_buf[head & RX_MASK] = c;
+            rx_head = head + 1;
+        } else {
+            uart_stats.rx_dropped++;
+        }
+    }
+
+    uart_tx_fill();
+}
+
+//==========================================================================
+// Raw Output
+//==========================================================================
+
+void uart_init(uint32_t clk_hz, uint32_t baud) {
+    UART->IRQ_EN = 0;
+    UART->BAUD_DIV = clk_hz / baud;
+    UART->CTRL = UART_CTRL_TX_EN | UART_CTRL_RX_EN;
+
+    tx_head = tx_tail = 0;
+    rx_head = rx_tail = 0;
+#ifdef USE_DMA
+    tx_dma_len = 0;
+    dma_init();
+    dma_abort(DMA_CH_UART);
+#endif
+
+    irq_register(IRQ_UART, uart_isr, 0);
+    UART->IRQ_EN = UART_IRQ_EN_RX_AVAIL;
+    irq_enable(IRQ_UART);
+}
+
+uint32_t uart_tx_free(void) {
+    return UART_TX_BUF_SIZE - (tx_head - tx_tail);
+}
+
+uint32_t uart_write(const char* buf, uint32_t len) {
+    uint32_t mstatus = irq_save();
+    uint32_t head = tx_head;
+    uint32_t used = head - tx_tail;
+
+    if (len > UART_TX_BUF_SIZE - used) {
+        uart_stats.tx_dropped++;
+        uart_stats.tx_dropped_bytes += len;
+        irq_restore(mstatus);
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < len; i++) {
+        tx_buf[(head + i) & TX_MASK] = buf[i];
+    }
+    tx_head = head + len;
+
+    if (used + len > uart_stats.tx_high_water) {
+        uart_stats.tx_high_water = used + len;
+    }
+
+    // Prime the FIFO now: output starts even with interrupts still off
+    uart_tx_fill();
+    irq_restore(mstatus);
+    return len;
+}
+
+void uart_putc(char c) {
+    uart_write(&c, 1);
+}
+
+void uart_puts(const char* s) {
+    uint32_t len = 0;
+    while (s[len] != '\0') {
+        len++;
+    }
+    uart_write(s, len);
+}
+
+void uart_flush(void) {
+    while (tx_head != tx_tail) {
+        // Poll as well, so this also drains with interrupts masked
+        uint32_t mstatus = irq_save();
+        uart_tx_fill();
+        irq_restore(mstatus);
+    }
+    while (!(UART->STATUS & UART_STATUS_TX_EMPTY));
+}
+
+int uart_getc_nonblock(void) {
+    uint32_t tail = rx_tail;
+    if (tail == rx_head) {
+        return -1;
+    }
+    int c = (uint8_t)rx_buf[tail & RX_MASK];
+    rx_tail = tail + 1;
+    return c;
+}
+
+//==========================================================================
+// Formatted Output
+//==========================================================================
+
+typedef struct {
+    char* buf;
+    uint32_t size;              // including the terminator
+    uint32_t len;
+} fmt_out_t;
+
+static void fmt_putc(fmt_out_t* out, char c) {
+    if (out->len + 1 < out->size) {
+        out->buf[out->len++] = c;
+    }
+}
+
+/**
+ * @brief Emit digits (most significant first) with width and padding
+ */
+static void fmt_field(fmt_out_t* out, const char* digits, uint32_t n, char sign,
+                      uint32_t width, char pad, int left) {
+    uint32_t total = n + (sign != 0);
+    uint32_t fill = (width > total) ? width - total : 0;
+
+    if (!left && pad == ' ') {
+        while (fill > 0) { fmt_putc(out, ' '); fill--; }
+    }
+    if (sign) fmt_putc(out, sign);
+    if (!left) {
+        while (fill > 0) { fmt_putc(out, pad); fill--; }
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        fmt_putc(out, digits[i]);
+    }
+    while (fill > 0) { fmt_putc(out, ' '); fill--; }
+}
+
+/**
+ * @brief Digits of value in base 10 or 16, into tmp from the end
+ *
+ * @return Pointer to the first digit, *n = digit count
+ */
+static const char* fmt_digits(char* tmp_end, uint32_t value, uint32_t base, int upper,
+                              uint32_t* n) {
+    const char* hex = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char* p = tmp_end;
+
+    do {
+        *--p = hex[value % base];       // 32-bit divu (RV32M), no libgcc
+        value /= base;
+    } while (value != 0);
+
+    *n = (uint32_t)(tmp_end - p);
+    return p;
+}
+
+/**
+ * @brief Fixed point with frac_bits fractional bits, prec decimals
+ *
+ * Only multiplies and shifts on the fraction: frac < 2^16 and 10^4 keep
+ * every product inside 32 bits.
+ */
+static void fmt_fixed(fmt_out_t* out, int32_t value, uint32_t frac_bits, uint32_t prec,
+                      uint32_t width, char pad, int left) {
+    static const uint32_t pow10[] = { 1, 10, 100, 1000, 10000 };
+    char tmp[20];
+    char sign = 0;
+    uint32_t mag = (uint32_t)value;
+
+    if (value < 0) {
+        sign = '-';
+        mag = 0u - mag;
+    }
+    if (prec > 4) prec = 4;
+
+    uint32_t ipart = mag >> frac_bits;
+    uint32_t frac = mag & ((1u << frac_bits) - 1);
+    uint32_t scaled = (frac * pow10[prec] + (1u << (frac_bits - 1))) >> frac_bits;
+    if (scaled >= pow10[prec]) {
+        ipart++;                        // rounding carried into the integer part
+        scaled -= pow10[prec];
+    }
+    if (ipart == 0 && scaled == 0) {
+        sign = 0;                       // no "-0.000"
+    }
+
+    // Integer digits, then '.', then zero-padded fraction digits
+    char* end = tmp + sizeof(tmp);
+    char* p = end;
+    for (uint32_t i = 0; i < prec; i++) {
+        *--p = (char)('0' + scaled % 10);
+        scaled /= 10;
+    }
+    if (prec > 0) *--p = '.';
+    uint32_t n;
+    const char* ip = fmt_digits(p, ipart, 10, 0, &n);
+
+    fmt_field(out, ip, (uint32_t)(end - ip), sign, width, pad, left);
+}
+
+uint32_t uart_vsnprintf(char* buf, uint32_t size, const char* fmt, va_list ap) {
+    fmt_out_t out = { buf, size, 0 };
+    char tmp[12];
+
+    if (size == 0) {
+        return 0;
+    }
+
+    while (*fmt != '\0') {
+        char c = *fmt++;
+        if (c != '%') {
+            fmt_putc(&out, c);
+            continue;
+        }
+
+        int left = 0;
+        char pad = ' ';
+        uint32_t width = 0;
+        int prec = -1;
+
+        for (;; fmt++) {
+            if (*fmt == '-') left = 1;
+            else if (*fmt == '0') pad = '0';
+            else break;
+        }
+        while (*fmt >= '0' && *fmt <= '9') {
+            width = width * 10 + (uint32_t)(*fmt++ - '0');
+        }
+        if (*fmt == '.') {
+            fmt++;
+            prec = 0;
+            while (*fmt >= '0' && *fmt <= '9') {
+                prec = prec * 10 + (*fmt++ - '0');
+            }
+        }
+        while (*fmt == 'l') {
+            fmt++;                      // long == int on RV32
+        }
+
+        const char* digits;
+        uint32_t n;
+        char conv = *fmt;
+        if (conv == '\0') {
+            break;
+        }
+        fmt++;
+
+        switch (conv) {
+        case 'd':
+        case 'i': {
+            int32_t v = va_arg(ap, int32_t);
+            uint32_t mag = (v < 0) ? 0u - (uint32_t)v : (uint32_t)v;
+            digits = fmt_digits(tmp + sizeof(tmp), mag, 10, 0, &n);
+            fmt_field(&out, digits, n, (v < 0) ? '-' : 0, width, pad, left);
+            break;
+        }
+        case 'u':
+            digits = fmt_digits(tmp + sizeof(tmp), va_arg(ap, uint32_t), 10, 0, &n);
+            fmt_field(&out, digits, n, 0, width, pad, left);
+            break;
+        case 'x':
+        case 'X':
+            digits = fmt_digits(tmp + sizeof(tmp), va_arg(ap, uint32_t), 16, conv == 'X', &n);
+            fmt_field(&out, digits, n, 0, width, pad, left);
+            break;
+        case 'p':
+            fmt_putc(&out, '0');
+            fmt_putc(&out, 'x');
+            digits = fmt_digits(tmp + sizeof(tmp), (uint32_t)(uintptr_t)va_arg(ap, void*), 16, 0, &n);
+            fmt_field(&out, digits, n, 0, 8, '0', 0);
+            break;
+        case 'c':
+            tmp[0] = (char)va_arg(ap, int);
+            fmt_field(&out, tmp, 1, 0, width, ' ', left);
+            break;
+        case 's': {
+            const char* s = va_arg(ap, const char*);
+            if (s == 0) s = "(null)";
+            n = 0;
+            while (s[n] != '\0' && (prec < 0 || n < (uint32_t)prec)) n++;
+            fmt_field(&out, s, n, 0, width, ' ', left);
+            break;
+        }
+        case 'r':       // Q15 fract (passed as int)
+            fmt_fixed(&out, va_arg(ap, int32_t), 15, (prec < 0) ? 3 : (uint32_t)prec,
+                      width, pad, left);
+            break;
+        case 'k':       // 16.16 accum
+            fmt_fixed(&out, va_arg(ap, int32_t), 16, (prec < 0) ? 3 : (uint32_t)prec,
+                      width, pad, left);
+            break;
+        case '%':
+            fmt_putc(&out, '%');
+            break;
+        default:
+            fmt_putc(&out, '%');
+            fmt_putc(&out, conv);
+            break;
+        }
+    }
+
+    buf[out.len] = '\0';
+    return out.len;
+}
+
+uint32_t uart_vprintf(const char* fmt, va_list ap) {
+    char buf[UART_PRINTF_MAX];
+    uint32_t len = uart_vsnprintf(buf, sizeof(buf), fmt, ap);
+    return uart_write(buf, len);
+}
+
+uint32_t uart_printf(const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    uint32_t len = uart_vprintf(fmt, ap);
+    va_end(ap);
+    return len;
+}
+
+void uart_put_dec(uint32_t value) {
+    char tmp[12];
+    uint32_t n;
+    const char* digits = fmt_digits(tmp + sizeof(tmp), value, 10, 0, &n);
+    uart_write(digits, n);
+}
+
+void uart_put_hex(uint32_t value) {
+    static const char hex[] = "0123456789ABCDEF";
+    char out[10];
+
+    // 0x + 8 digits as one message instead of ten writes
+    out[0] = '0';
+    out[1] = 'x';
+    for (int i = 0; i < 8; i++) {
+        out[2 + i] = hex[(value >> (28 - 4 * i)) & 0xF];
+    }
+    uart_write(out, sizeof(out));
+}
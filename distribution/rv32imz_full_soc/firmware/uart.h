@@ -0,0 +1,112 @@
+/**
+ * @file uart.h
+ * @brief Shared Interrupt-Driven UART Driver (soc_regs.h UART, IRQ_UART)
+ *
+ * TX and RX go through RAM ring buffers serviced by the UART interrupt, so
+ * output never spins on UART_STATUS. When the TX ring cannot take a whole
+ * message the message is dropped and counted in uart_stats - logging from
+ * the control ISR costs the formatting time and nothing else.
+ *
+ * uart_printf() is a small formatter with integer and fixed-point
+ * conversions (no soft-float, no libc):
+ *
+ *   %d %i %u %x %X %c %s %p %%     flags '-' '0', width, 'l' accepted
+ *   %r                             Q15 fract, e.g. "%.3r" of 0x4000 -> 0.500
+ *   %k                             16.16 accum, e.g. "%.2k" of 0x18000 -> 1.50
+ *
+ * (%r/%k follow the ISO/IEC TR 18037 fract/accum conversions; precision
+ * defaults to 3 and is at most 4 digits.)
+ *
+ * @author RV32IMZ Team
+ * @date 2025-12-18
+ */
+
+#ifndef UART_H
+#define UART_H
+
+#include <stdint.h>
+#include <stdarg.h>
+
+#ifndef UART_TX_BUF_SIZE
+#define UART_TX_BUF_SIZE    1024    // power of two
+#endif
+
+#ifndef UART_RX_BUF_SIZE
+#define UART_RX_BUF_SIZE    64      // power of two
+#endif
+
+#define UART_PRINTF_MAX     128     // longest formatted message
+
+typedef struct {
+    uint32_t tx_dropped;        // messages rejected on a full TX ring
+    uint32_t tx_dropped_bytes;
+    uint32_t rx_dropped;        // bytes lost on a full RX ring
+    uint32_t tx_high_water;     // peak TX ring occupancy (bytes)
+} uart_stats_t;
+
+extern volatile uart_stats_t uart_stats;
+
+/**
+ * @brief Enable TX/RX at the given baud rate and hook IRQ_UART
+ *
+ * Output is queued even before irq_global_enable(); the hardware FIFO is
+ * primed directly and the rest drains once interrupts are on.
+ */
+void uart_init(uint32_t clk_hz, uint32_t baud);
+
+/**
+ * @brief Queue len bytes, all or nothing
+ *
+ * @return len, or 0 if the message was dropped
+ */
+uint32_t uart_write(const char* buf, uint32_t len);
+
+void uart_putc(char c);
+void uart_puts(const char* s);
+
+/**
+ * @brief Unsigned decimal
+ */
+void uart_put_dec(uint32_t value);
+
+/**
+ * @brief 0x-prefixed, 8-digit hexadecimal
+ */
+void uart_put_hex(uint32_t value);
+
+/**
+ * @brief Format and queue one message (see file header), never blocks
+ *
+ * @return Bytes queued, 0 if dropped
+ */
+uint32_t uart_printf(const char* fmt, ...);
+uint32_t uart_vprintf(const char* fmt, va_list ap);
+
+/**
+ * @brief Format into buf (always NUL-terminated)
+ *
+ * @return Length written, excluding the terminator
+ */
+uint32_t uart_vsnprintf(char* buf, uint32_t size, const char* fmt, va_list ap);
+
+/**
+ * @brief Receive one byte if available
+ *
+ * @return Byte value, or -1 when the RX ring is empty
+ */
+int uart_getc_nonblock(void);
+
+/**
+ * @brief Free space in the TX ring (bytes)
+ */
+uint32_t uart_tx_free(void);
+
+/**
+ * @brief Block until everything queued has left the shifter
+ *
+ * Works with interrupts masked. Main-loop use only: before a reset, a halt,
+ * or between large dumps that exceed the ring.
+ */
+void uart_flush(void);
+
+#endif // UART_H
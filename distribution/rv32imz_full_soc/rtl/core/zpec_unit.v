@@ -0,0 +1,215 @@
+//==============================================================================
+// Zpec Execution Unit - Power-Electronics Custom Instructions
+//
+// Single-cycle fixed-point operations for the control ISR, decoded on the
+// RISC-V custom-0 major opcode (0x0B) as R-type instructions:
+//
+//   31      25 24  20 19  15 14  12 11   7 6       0
+//   | funct7  | rs2  | rs1  |funct3|  rd  | 0001011 |
+//
+//   funct7   funct3  Mnemonic     Operation
+//   0000000  000     pe.mulg      rd = sat32(rs1[15:0] * rs2)          Q15 x 16.16 -> Q31
+//   0000000  001     pe.mulq29    rd = sat32((rs1 * rs2) >>> 29)       Q3.29 x Q31 -> Q31
+//   0000000  010     pe.adds      rd = sat32(rs1 + rs2)
+//   0000000  011     pe.subs      rd = sat32(rs1 - rs2)
+//   0000000  100     pe.clamp     rd = min(max(rs1, -rs2), rs2)        rs2 >= 0
+//   0000000  101     pe.adcb      rd = sat16(rs1[15:0] - rs2[15:0])    unsigned codes
+//   0000000  110     pe.sin       rd = sin(rs1 * 2pi / 2^32)           Q15, rs2 ignored
+//   0000000  111     pe.mulq15    rd = sat16((rs1[15:0] * rs2[15:0] + 2^14) >>> 15)
+//
+// Q15 results are sign-extended to 32 bits. Every result is bit-exact with
+// the C reference in firmware/examples/zpec.h (the fallback used when the
+// firmware is built without ZPEC=1), so both builds produce the same
+// waveforms. A saturating multiply-accumulate is pe.mulg + pe.adds; the
+// register file has two read ports, so no instruction reads rd.
+//
+// Encodings with funct7 != 0 are reserved: 'valid' is low and the core
+// raises an illegal-instruction exception.
+//
+// Integration (ZPEC_ENABLED): rtl/core/custom_riscv_core_pipe.v decodes
+// opcode 0x0B, feeds the forwarded rs1/rs2 to this unit in EX and selects
+// 'result' like an ALU operation, so the instruction issues every cycle.
+// The core checks funct7 in decode; 'valid' is for other integrations.
+// Verilator: make -C sim/verilator ZPEC=1.
+//==============================================================================
+
+module zpec_unit (
+    input  wire [2:0]  funct3,
+    input  wire [6:0]  funct7,
+    input  wire [31:0] rs1_data,
+    input  wire [31:0] rs2_data,
+    output reg  [31:0] result,
+    output wire        valid
+);
+
+    localparam [2:0] ZPEC_MULG   = 3'b000;
+    localparam [2:0] ZPEC_MULQ29 = 3'b001;
+    localparam [2:0] ZPEC_ADDS   = 3'b010;
+    localparam [2:0] ZPEC_SUBS   = 3'b011;
+    localparam [2:0] ZPEC_CLAMP  = 3'b100;
+    localparam [2:0] ZPEC_ADCB   = 3'b101;
+    localparam [2:0] ZPEC_SIN    = 3'b110;
+    localparam [2:0] ZPEC_MULQ15 = 3'b111;
+
+    localparam signed [31:0] Q31_MAX = 32'sh7FFFFFFF;
+    localparam signed [31:0] Q31_MIN = 32'sh80000000;
+    localparam signed [31:0] Q15_MAX = 32'sh00007FFF;
+    localparam signed [31:0] Q15_MIN = 32'shFFFF8000;
+
+    assign valid = (funct7 == 7'b0000000);
+
+    wire signed [31:0] a   = rs1_data;
+    wire signed [31:0] b   = rs2_data;
+    wire signed [15:0] a16 = rs1_data[15:0];
+    wire signed [15:0] b16 = rs2_data[15:0];
+
+    //--------------------------------------------------------------------------
+    // Saturation helpers
+    //--------------------------------------------------------------------------
+
+    function [31:0] sat32;
+        input signed [63:0] x;
+        begin
+            if (x > $signed({{32{1'b0}}, Q31_MAX}))
+                sat32 = Q31_MAX;
+            else if (x < $signed({{32{1'b1}}, Q31_MIN}))
+                sat32 = Q31_MIN;
+            else
+                sat32 = x[31:0];
+        end
+    endfunction
+
+    function [31:0] sat16;
+        input signed [31:0] x;
+        begin
+            if (x > Q15_MAX)
+                sat16 = Q15_MAX;
+            else if (x < Q15_MIN)
+                sat16 = Q15_MIN;
+            else
+                sat16 = x;
+        end
+    endfunction
+
+    //--------------------------------------------------------------------------
+    // Multipliers and adders
+    //--------------------------------------------------------------------------
+
+    wire signed [63:0] mulg_p   = a16 * b;                          // fits in 48 bits
+    wire signed [63:0] mulq29_p = (a * b) >>> 29;
+    wire signed [63:0] adds_s   = {{32{a[31]}}, a} + {{32{b[31]}}, b};
+    wire signed [63:0] subs_s   = {{32{a[31]}}, a} - {{32{b[31]}}, b};
+    wire signed [31:0] adcb_d   = $signed({16'd0, rs1_data[15:0]}) - $signed({16'd0, rs2_data[15:0]});
+    wire signed [31:0] mulq15_p = (a16 * b16 + 32'sd16384) >>> 15;
+
+    wire signed [31:0] neg_b    = -b;
+    wire [31:0] clamp_r = (a > b) ? b : (a < neg_b) ? neg_b : a;
+
+    //--------------------------------------------------------------------------
+    // Sine: 257-entry quarter-wave table with linear interpolation
+    //
+    // Phase bits: [31] half-wave (negate), [30] quarter (mirror),
+    // [29:22] table index, [21:6] interpolation fraction.
+    //--------------------------------------------------------------------------
+
+    function [15:0] sine_rom;
+        input [8:0] idx;
+        begin
+            case (idx)
+            9'd0: sine_rom = 16'd0;    9'd1: sine_rom = 16'd201;  9'd2: sine_rom = 16'd402;  9'd3: sine_rom = 16'd603;
+            9'd4: sine_rom = 16'd804;  9'd5: sine_rom = 16'd1005; 9'd6: sine_rom = 16'd1206; 9'd7: sine_rom = 16'd1407;
+            9'd8: sine_rom = 16'd1608; 9'd9: sine_rom = 16'd1809; 9'd10: sine_rom = 16'd2009; 9'd11: sine_rom = 16'd2210;
+            9'd12: sine_rom = 16'd2411; 9'd13: sine_rom = 16'd2611; 9'd14: sine_rom = 16'd2811; 9'd15: sine_rom = 16'd3012;
+            9'd16: sine_rom = 16'd3212; 9'd17: sine_rom = 16'd3412; 9'd18: sine_rom = 16'd3612; 9'd19: sine_rom = 16'd3812;
+            9'd20: sine_rom = 16'd4011; 9'd21: sine_rom = 16'd4211; 9'd22: sine_rom = 16'd4410; 9'd23: sine_rom = 16'd4609;
+            9'd24: sine_rom = 16'd4808; 9'd25: sine_rom = 16'd5007; 9'd26: sine_rom = 16'd5205; 9'd27: sine_rom = 16'd5404;
+            9'd28: sine_rom = 16'd5602; 9'd29: sine_rom = 16'd5800; 9'd30: sine_rom = 16'd5998; 9'd31: sine_rom = 16'd6195;
+            9'd32: sine_rom = 16'd6393; 9'd33: sine_rom = 16'd6590; 9'd34: sine_rom = 16'd6787; 9'd35: sine_rom = 16'd6983;
+            9'd36: sine_rom = 16'd7180; 9'd37: sine_rom = 16'd7376; 9'd38: sine_rom = 16'd7571; 9'd39: sine_rom = 16'd7767;
+            9'd40: sine_rom = 16'd7962; 9'd41: sine_rom = 16'd8157; 9'd42: sine_rom = 16'd8351; 9'd43: sine_rom = 16'd8546;
+            9'd44: sine_rom = 16'd8740; 9'd45: sine_rom = 16'd8933; 9'd46: sine_rom = 16'd9127; 9'd47: sine_rom = 16'd9319;
+            9'd48: sine_rom = 16'd9512; 9'd49: sine_rom = 16'd9704; 9'd50: sine_rom = 16'd9896; 9'd51: sine_rom = 16'd10088;
+            9'd52: sine_rom = 16'd10279; 9'd53: sine_rom = 16'd10469; 9'd54: sine_rom = 16'd10660; 9'd55: sine_rom = 16'd10850;
+            9'd56: sine_rom = 16'd11039; 9'd57: sine_rom = 16'd11228; 9'd58: sine_rom = 16'd11417; 9'd59: sine_rom = 16'd11605;
+            9'd60: sine_rom = 16'd11793; 9'd61: sine_rom = 16'd11980; 9'd62: sine_rom = 16'd12167; 9'd63: sine_rom = 16'd12354;
+            9'd64: sine_rom = 16'd12540; 9'd65: sine_rom = 16'd12725; 9'd66: sine_rom = 16'd12910; 9'd67: sine_rom = 16'd13095;
+            9'd68: sine_rom = 16'd13279; 9'd69: sine_rom = 16'd13463; 9'd70: sine_rom = 16'd13646; 9'd71: sine_rom = 16'd13828;
+            9'd72: sine_rom = 16'd14010; 9'd73: sine_rom = 16'd14192; 9'd74: sine_rom = 16'd14373; 9'd75: sine_rom = 16'd14553;
+            9'd76: sine_rom = 16'd14733; 9'd77: sine_rom = 16'd14912; 9'd78: sine_rom = 16'd15091; 9'd79: sine_rom = 16'd15269;
+            9'd80: sine_rom = 16'd15447; 9'd81: sine_rom = 16'd15624; 9'd82: sine_rom = 16'd15800; 9'd83: sine_rom = 16'd15976;
+            9'd84: sine_rom = 16'd16151; 9'd85: sine_rom = 16'd16326; 9'd86: sine_rom = 16'd16500; 9'd87: sine_rom = 16'd16673;
+            9'd88: sine_rom = 16'd16846; 9'd89: sine_rom = 16'd17018; 9'd90: sine_rom = 16'd17190; 9'd91: sine_rom = 16'd17361;
+            9'd92: sine_rom = 16'd17531; 9'd93: sine_rom = 16'd17700; 9'd94: sine_rom = 16'd17869; 9'd95: sine_rom = 16'd18037;
+            9'd96: sine_rom = 16'd18205; 9'd97: sine_rom = 16'd18372; 9'd98: sine_rom = 16'd18538; 9'd99: sine_rom = 16'd18703;
+            9'd100: sine_rom = 16'd18868; 9'd101: sine_rom = 16'd19032; 9'd102: sine_rom = 16'd19195; 9'd103: sine_rom = 16'd19358;
+            9'd104: sine_rom = 16'd19520; 9'd105: sine_rom = 16'd19681; 9'd106: sine_rom = 16'd19841; 9'd107: sine_rom = 16'd20001;
+            9'd108: sine_rom = 16'd20160; 9'd109: sine_rom = 16'd20318; 9'd110: sine_rom = 16'd20475; 9'd111: sine_rom = 16'd20632;
+            9'd112: sine_rom = 16'd20788; 9'd113: sine_rom = 16'd20943; 9'd114: sine_rom = 16'd21097; 9'd115: sine_rom = 16'd21251;
+            9'd116: sine_rom = 16'd21403; 9'd117: sine_rom = 16'd21555; 9'd118: sine_rom = 16'd21706; 9'd119: sine_rom = 16'd21856;
+            9'd120: sine_rom = 16'd22006; 9'd121: sine_rom = 16'd22154; 9'd122: sine_rom = 16'd22302; 9'd123: sine_rom = 16'd22449;
+            9'd124: sine_rom = 16'd22595; 9'd125: sine_rom = 16'd22740; 9'd126: sine_rom = 16'd22884; 9'd127: sine_rom = 16'd23028;
+            9'd128: sine_rom = 16'd23170; 9'd129: sine_rom = 16'd23312; 9'd130: sine_rom = 16'd23453; 9'd131: sine_rom = 16'd23593;
+            9'd132: sine_rom = 16'd23732; 9'd133: sine_rom = 16'd23870; 9'd134: sine_rom = 16'd24008; 9'd135: sine_rom = 16'd24144;
+            9'd136: sine_rom = 16'd24279; 9'd137: sine_rom = 16'd24414; 9'd138: sine_rom = 16'd24548; 9'd139: sine_rom = 16'd24680;
+            9'd140: sine_rom = 16'd24812; 9'd141: sine_rom = 16'd24943; 9'd142: sine_rom = 16'd25073; 9'd143: sine_rom = 16'd25202;
+            9'd144: sine_rom = 16'd25330; 9'd145: sine_rom = 16'd25457; 9'd146: sine_rom = 16'd25583; 9'd147: sine_rom = 16'd25708;
+            9'd148: sine_rom = 16'd25833; 9'd149: sine_rom = 16'd25956; 9'd150: sine_rom = 16'd26078; 9'd151: sine_rom = 16'd26199;
+            9'd152: sine_rom = 16'd26320; 9'd153: sine_rom = 16'd26439; 9'd154: sine_rom = 16'd26557; 9'd155: sine_rom = 16'd26674;
+            9'd156: sine_rom = 16'd26791; 9'd157: sine_rom = 16'd26906; 9'd158: sine_rom = 16'd27020; 9'd159: sine_rom = 16'd27133;
+            9'd160: sine_rom = 16'd27246; 9'd161: sine_rom = 16'd27357; 9'd162: sine_rom = 16'd27467; 9'd163: sine_rom = 16'd27576;
+            9'd164: sine_rom = 16'd27684; 9'd165: sine_rom = 16'd27791; 9'd166: sine_rom = 16'd27897; 9'd167: sine_rom = 16'd28002;
+            9'd168: sine_rom = 16'd28106; 9'd169: sine_rom = 16'd28209; 9'd170: sine_rom = 16'd28311; 9'd171: sine_rom = 16'd28411;
+            9'd172: sine_rom = 16'd28511; 9'd173: sine_rom = 16'd28610; 9'd174: sine_rom = 16'd28707; 9'd175: sine_rom = 16'd28803;
+            9'd176: sine_rom = 16'd28899; 9'd177: sine_rom = 16'd28993; 9'd178: sine_rom = 16'd29086; 9'd179: sine_rom = 16'd29178;
+            9'd180: sine_rom = 16'd29269; 9'd181: sine_rom = 16'd29359; 9'd182: sine_rom = 16'd29448; 9'd183: sine_rom = 16'd29535;
+            9'd184: sine_rom = 16'd29622; 9'd185: sine_rom = 16'd29707; 9'd186: sine_rom = 16'd29792; 9'd187: sine_rom = 16'd29875;
+            9'd188: sine_rom = 16'd29957; 9'd189: sine_rom = 16'd30038; 9'd190: sine_rom = 16'd30118; 9'd191: sine_rom = 16'd30196;
+            9'd192: sine_rom = 16'd30274; 9'd193: sine_rom = 16'd30350; 9'd194: sine_rom = 16'd30425; 9'd195: sine_rom = 16'd30499;
+            9'd196: sine_rom = 16'd30572; 9'd197: sine_rom = 16'd30644; 9'd198: sine_rom = 16'd30715; 9'd199: sine_rom = 16'd30784;
+            9'd200: sine_rom = 16'd30853; 9'd201: sine_rom = 16'd30920; 9'd202: sine_rom = 16'd30986; 9'd203: sine_rom = 16'd31050;
+            9'd204: sine_rom = 16'd31114; 9'd205: sine_rom = 16'd31177; 9'd206: sine_rom = 16'd31238; 9'd207: sine_rom = 16'd31298;
+            9'd208: sine_rom = 16'd31357; 9'd209: sine_rom = 16'd31415; 9'd210: sine_rom = 16'd31471; 9'd211: sine_rom = 16'd31527;
+            9'd212: sine_rom = 16'd31581; 9'd213: sine_rom = 16'd31634; 9'd214: sine_rom = 16'd31686; 9'd215: sine_rom = 16'd31737;
+            9'd216: sine_rom = 16'd31786; 9'd217: sine_rom = 16'd31834; 9'd218: sine_rom = 16'd31881; 9'd219: sine_rom = 16'd31927;
+            9'd220: sine_rom = 16'd31972; 9'd221: sine_rom = 16'd32015; 9'd222: sine_rom = 16'd32058; 9'd223: sine_rom = 16'd32099;
+            9'd224: sine_rom = 16'd32138; 9'd225: sine_rom = 16'd32177; 9'd226: sine_rom = 16'd32214; 9'd227: sine_rom = 16'd32251;
+            9'd228: sine_rom = 16'd32286; 9'd229: sine_rom = 16'd32319; 9'd230: sine_rom = 16'd32352; 9'd231: sine_rom = 16'd32383;
+            9'd232: sine_rom = 16'd32413; 9'd233: sine_rom = 16'd32442; 9'd234: sine_rom = 16'd32470; 9'd235: sine_rom = 16'd32496;
+            9'd236: sine_rom = 16'd32522; 9'd237: sine_rom = 16'd32546; 9'd238: sine_rom = 16'd32568; 9'd239: sine_rom = 16'd32590;
+            9'd240: sine_rom = 16'd32610; 9'd241: sine_rom = 16'd32629; 9'd242: sine_rom = 16'd32647; 9'd243: sine_rom = 16'd32664;
+            9'd244: sine_rom = 16'd32679; 9'd245: sine_rom = 16'd32693; 9'd246: sine_rom = 16'd32706; 9'd247: sine_rom = 16'd32718;
+            9'd248: sine_rom = 16'd32729; 9'd249: sine_rom = 16'd32738; 9'd250: sine_rom = 16'd32746; 9'd251: sine_rom = 16'd32753;
+            9'd252: sine_rom = 16'd32758; 9'd253: sine_rom = 16'd32762; 9'd254: sine_rom = 16'd32766; 9'd255: sine_rom = 16'd32767;
+            9'd256: sine_rom = 16'd32767;
+            default: sine_rom = 16'd32767;
+            endcase
+        end
+    endfunction
+
+    wire [29:0] sin_p    = rs1_data[30] ? ~rs1_data[29:0] : rs1_data[29:0];
+    wire [8:0]  sin_idx  = {1'b0, sin_p[29:22]};
+    wire signed [31:0] sin_y0   = {16'd0, sine_rom(sin_idx)};
+    wire signed [31:0] sin_y1   = {16'd0, sine_rom(sin_idx + 9'd1)};
+    wire signed [31:0] sin_frac = {16'd0, sin_p[21:6]};
+    wire signed [31:0] sin_y    = sin_y0 + (((sin_y1 - sin_y0) * sin_frac + 32'sd32768) >>> 16);
+    wire [31:0] sin_r = rs1_data[31] ? -sin_y : sin_y;
+
+    //--------------------------------------------------------------------------
+    // Result select
+    //--------------------------------------------------------------------------
+
+    always @(*) begin
+        case (funct3)
+            ZPEC_MULG:   result = sat32(mulg_p);
+            ZPEC_MULQ29: result = sat32(mulq29_p);
+            ZPEC_ADDS:   result = sat32(adds_s);
+            ZPEC_SUBS:   result = sat32(subs_s);
+            ZPEC_CLAMP:  result = clamp_r;
+            ZPEC_ADCB:   result = sat16(adcb_d);
+            ZPEC_SIN:    result = sin_r;
+            ZPEC_MULQ15: result = sat16(mulq15_p);
+            default:     result = 32'd0;
+        endcase
+    end
+
+endmodule
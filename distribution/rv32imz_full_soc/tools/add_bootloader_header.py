@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""
+Bootloader Image Header Tool for RV32IMZ SoC
+
+Prepends the 20-byte firmware_header_t expected by firmware/bootloader:
+
+    magic    u32  0xB007ABCD
+    version  u32  (major << 16) | (minor << 8) | patch
+    size     u32  total image size in bytes, header included
+    crc32    u32  CRC32 (zlib) of the bytes after the header
+    reserved u32  0 (format and packed size of a packed image, see pack_image.py)
+
+The application is linked at APP_BASE + 20 (firmware/application.ld), so
+the raw binary goes directly after the header.
+
+Usage:
+    python3 add_bootloader_header.py app.bin app_with_header.bin --version 1.0.0
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+from pathlib import Path
+
+BOOT_MAGIC = 0xB007ABCD
+HEADER_FORMAT = "<5I"
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+MAX_APP_SIZE = 16 * 1024
+
+
+def parse_version(text):
+    parts = [int(p) for p in text.split(".")]
+    if len(parts) != 3 or any(p < 0 or p > 255 for p in parts):
+        raise ValueError(f"version must be major.minor.patch (0-255 each), got '{text}'")
+    return (parts[0] << 16) | (parts[1] << 8) | parts[2]
+
+
+def make_header(body, version):
+    return struct.pack(HEADER_FORMAT, BOOT_MAGIC, version, HEADER_SIZE + len(body),
+                       zlib.crc32(body) & 0xFFFFFFFF, 0)
+
+
+def parse_header(image):
+    """Return (magic, version, size, crc32, reserved) or None if no header"""
+    if len(image) < HEADER_SIZE:
+        return None
+    fields = struct.unpack_from(HEADER_FORMAT, image)
+    return fields if fields[0] == BOOT_MAGIC else None
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Prepend the bootloader header to an application binary")
+    parser.add_argument("input", help="Raw application binary")
+    parser.add_argument("output", help="Image with header")
+    parser.add_argument("--version", default="1.0.0", help="Firmware version major.minor.patch")
+    args = parser.parse_args()
+
+    body = Path(args.input).read_bytes()
+    try:
+        version = parse_version(args.version)
+    except ValueError as e:
+        print(f"Error: {e}", file=sys.stderr)
+        return 1
+
+    if HEADER_SIZE + len(body) > MAX_APP_SIZE:
+        print(f"Error: image is {HEADER_SIZE + len(body)} bytes, application space is {MAX_APP_SIZE}",
+              file=sys.stderr)
+        return 1
+
+    header = make_header(body, version)
+    Path(args.output).write_bytes(header + body)
+    print(f"Generated {args.output}: {HEADER_SIZE + len(body)} bytes, CRC32 0x{zlib.crc32(body) & 0xFFFFFFFF:08X}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
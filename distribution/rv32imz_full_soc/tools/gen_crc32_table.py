@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""
+CRC32 Slicing Table Generator for RV32IMZ Firmware
+
+Generates the constant lookup tables used by firmware/crc32.c. The tables
+are emitted as const data so the linker places them in .rodata (ROM); the
+bootloader no longer builds a table in RAM at boot.
+
+Polynomial: 0xEDB88320 (reflected IEEE 802.3, same as zlib/binascii.crc32)
+
+Table k maps a byte that is followed by k further bytes of the same word:
+    T[0][n]     = classic byte-at-a-time table
+    T[k][n]     = (T[k-1][n] >> 8) ^ T[0][T[k-1][n] & 0xFF]
+
+Usage:
+    python3 gen_crc32_table.py crc32_table.c
+    python3 gen_crc32_table.py --slices 4 --check crc32_table.c
+"""
+
+import argparse
+import sys
+from pathlib import Path
+
+POLY = 0xEDB88320
+
+
+def build_tables(slices):
+    base = []
+    for n in range(256):
+        crc = n
+        for _ in range(8):
+            crc = (crc >> 1) ^ POLY if crc & 1 else crc >> 1
+        base.append(crc)
+
+    tables = [base]
+    for _ in range(1, slices):
+        prev = tables[-1]
+        tables.append([(prev[n] >> 8) ^ base[prev[n] & 0xFF] for n in range(256)])
+    return tables
+
+
+def generate(slices):
+    tables = build_tables(slices)
+    out = []
+    out.append("/**")
+    out.append(" * @file crc32_table.c")
+    out.append(f" * @brief CRC32 slicing-by-{slices} lookup tables (ROM-resident)")
+    out.append(" *")
+    out.append(" * AUTO-GENERATED by tools/gen_crc32_table.py - DO NOT EDIT.")
+    out.append(" */")
+    out.append("")
+    out.append('#include "crc32.h"')
+    out.append("")
+    out.append(f"const uint32_t crc32_table[CRC32_SLICES][256] = {{")
+    for k, table in enumerate(tables):
+        out.append("    {")
+        for row in range(0, 256, 6):
+            words = ", ".join(f"0x{v:08X}" for v in table[row:row + 6])
+            out.append(f"        {words},")
+        out.append("    }," if k < slices - 1 else "    }")
+    out.append("};")
+    out.append("")
+    return "\n".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate the CRC32 slicing tables for crc32.c")
+    parser.add_argument("output", help="Generated C source")
+    parser.add_argument("--slices", type=int, default=4,
+                        help="Number of tables, must match CRC32_SLICES in crc32.h (default: 4)")
+    parser.add_argument("--check", action="store_true",
+                        help="Fail if the output is not up to date instead of writing it")
+    args = parser.parse_args()
+
+    if args.slices < 1 or args.slices > 8:
+        print("Error: --slices must be between 1 and 8", file=sys.stderr)
+        return 1
+
+    text = generate(args.slices)
+
+    output = Path(args.output)
+    if args.check:
+        if not output.exists() or output.read_text() != text:
+            print(f"Error: {output} is out of date, regenerate with {Path(sys.argv[0]).name}", file=sys.stderr)
+            return 1
+        return 0
+
+    output.write_text(text)
+    print(f"Generated {output}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+"""
+Register Map Header Generator for RV32IMZ SoC
+
+Generates the authoritative C register header (soc_regs.h) from the
+machine-readable description (firmware/soc_regs.json):
+
+- memory region and peripheral base addresses
+- one volatile register struct per peripheral (read-only registers are
+  const, gaps become reserved words) with static offset checks
+- per field: <P>_<REG>_<FIELD> (in-place mask), _SHIFT, _WIDTH
+- per field: static inline get/set accessors
+
+Usage:
+    python3 gen_regmap.py soc_regs.json soc_regs.h
+    python3 gen_regmap.py --check soc_regs.json soc_regs.h
+"""
+
+import argparse
+import json
+import sys
+from pathlib import Path
+
+HEADER_GUARD = "SOC_REGS_H"
+
+
+def parse_int(value):
+    return int(value, 0) if isinstance(value, str) else int(value)
+
+
+def field_geometry(field):
+    if "bit" in field:
+        return parse_int(field["bit"]), 1
+    return parse_int(field["lsb"]), parse_int(field["width"])
+
+
+def validate(regmap):
+    """Reject overlapping registers and fields that do not fit in 32 bits"""
+    for periph in regmap["peripherals"]:
+        size = parse_int(periph["size"])
+        offsets = set()
+        for reg in periph["registers"]:
+            offset = parse_int(reg["offset"])
+            if offset % 4 or offset >= size:
+                raise ValueError(f"{periph['name']}.{reg['name']}: bad offset 0x{offset:X}")
+            if offset in offsets:
+                raise ValueError(f"{periph['name']}.{reg['name']}: duplicate offset 0x{offset:X}")
+            offsets.add(offset)
+            if reg["access"] not in ("rw", "ro", "wo", "w1c"):
+                raise ValueError(f"{periph['name']}.{reg['name']}: unknown access {reg['access']}")
+            for field in reg.get("fields", []):
+                lsb, width = field_geometry(field)
+                if width < 1 or lsb + width > 32:
+                    raise ValueError(f"{periph['name']}.{reg['name']}.{field['name']}: "
+                                     f"does not fit in 32 bits")
+
+
+def emit_memory(regmap, out):
+    out.append("//=============================================================================")
+    out.append("// Memory Regions")
+    out.append("//=============================================================================")
+    out.append("")
+    for region in regmap["memory"]:
+        name = region["name"]
+        out.append(f"#define {name + '_BASE':<16}0x{parse_int(region['base']):08X}u  // {region['description']}")
+        out.append(f"#define {name + '_SIZE':<16}0x{parse_int(region['size']):08X}u")
+    out.append("")
+
+
+def emit_peripheral(periph, periph_base, out):
+    name = periph["name"]
+    lower = name.lower()
+    base = periph_base + parse_int(periph["offset"])
+    regs = sorted(periph["registers"], key=lambda r: parse_int(r["offset"]))
+
+    out.append("//=============================================================================")
+    out.append(f"// {periph['title']} (Base: 0x{base:08X})")
+    out.append("//=============================================================================")
+    out.append("")
+    out.append(f"#define {name + '_BASE':<16}(PERIPH_BASE + 0x{parse_int(periph['offset']):04X})")
+    out.append(f"#define {name + '_SIZE':<16}0x{parse_int(periph['size']):08X}u")
+    out.append("")
+
+    # Register struct
+    out.append("typedef volatile struct {")
+    next_offset = 0
+    reserved = 0
+    for reg in regs:
+        offset = parse_int(reg["offset"])
+        if offset > next_offset:
+            words = (offset - next_offset) // 4
+            out.append(f"    const uint32_t _reserved{reserved}[{words}];")
+            reserved += 1
+        qualifier = "const uint32_t" if reg["access"] == "ro" else "uint32_t"
+        decl = f"    {qualifier} {reg['name']};"
+        out.append(f"{decl:<32}// 0x{offset:02X}: {reg['description']} ({reg['access']})")
+        next_offset = offset + 4
+    out.append(f"}} {lower}_regs_t;")
+    out.append("")
+    out.append(f"#define {name} (({lower}_regs_t*){name}_BASE)")
+    out.append("")
+    for reg in regs:
+        out.append(f"_Static_assert(offsetof({lower}_regs_t, {reg['name']}) == 0x{parse_int(reg['offset']):02X}, "
+                   f"\"{name}.{reg['name']} offset\");")
+    out.append("")
+
+    # Field masks and accessors
+    for reg in regs:
+        fields = reg.get("fields", [])
+        if not fields:
+            continue
+        out.append(f"// {name} {reg['name']} fields")
+        for field in fields:
+            lsb, width = field_geometry(field)
+            mask = ((1 << width) - 1) << lsb
+            prefix = f"{name}_{reg['name']}_{field['name']}"
+            out.append(f"#define {prefix:<27} 0x{mask:08X}u  // {field['description']}")
+            out.append(f"#define {prefix + '_SHIFT':<27} {lsb}")
+            out.append(f"#define {prefix + '_WIDTH':<27} {width}")
+        out.append("")
+        for field in fields:
+            prefix = f"{name}_{reg['name']}_{field['name']}"
+            func = prefix.lower()
+            out.append(f"static inline uint32_t {func}_get(uint32_t reg) {{")
+            out.append(f"    return (reg & {prefix}) >> {prefix}_SHIFT;")
+            out.append("}")
+            out.append(f"static inline uint32_t {func}_set(uint32_t reg, uint32_t value) {{")
+            out.append(f"    return (reg & ~{prefix}) | ((value << {prefix}_SHIFT) & {prefix});")
+            out.append("}")
+        out.append("")
+
+
+def generate(regmap, source_name):
+    validate(regmap)
+    out = []
+    out.append("/**")
+    out.append(" * @file soc_regs.h")
+    out.append(f" * @brief {regmap['description']}")
+    out.append(" *")
+    out.append(f" * GENERATED from {source_name} by tools/gen_regmap.py - do not edit.")
+    out.append(" *")
+    out.append(" * Access: rw = read/write, ro = read-only (const member),")
+    out.append(" *         wo = write-only, w1c = write 1 to clear.")
+    out.append(" */")
+    out.append("")
+    out.append(f"#ifndef {HEADER_GUARD}")
+    out.append(f"#define {HEADER_GUARD}")
+    out.append("")
+    out.append("#include <stdint.h>")
+    out.append("#include <stddef.h>")
+    out.append("")
+    emit_memory(regmap, out)
+
+    periph_base = next(parse_int(r["base"]) for r in regmap["memory"] if r["name"] == "PERIPH")
+    for periph in regmap["peripherals"]:
+        emit_peripheral(periph, periph_base, out)
+
+    out.append(f"#endif // {HEADER_GUARD}")
+    out.append("")
+    return "\n".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate soc_regs.h from a JSON register map")
+    parser.add_argument("input", help="Register map JSON")
+    parser.add_argument("output", help="Generated C header")
+    parser.add_argument("--check", action="store_true",
+                        help="Fail if the output is not up to date instead of writing it")
+    args = parser.parse_args()
+
+    with open(args.input) as f:
+        regmap = json.load(f)
+
+    try:
+        text = generate(regmap, Path(args.input).name)
+    except ValueError as e:
+        print(f"Error: {e}", file=sys.stderr)
+        return 1
+
+    output = Path(args.output)
+    if args.check:
+        if not output.exists() or output.read_text() != text:
+            print(f"Error: {output} is out of date, regenerate from {args.input}", file=sys.stderr)
+            return 1
+        return 0
+
+    output.write_text(text)
+    print(f"Generated {output}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
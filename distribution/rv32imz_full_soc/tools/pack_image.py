@@ -0,0 +1,275 @@
+#!/usr/bin/env python3
+"""
+Compressed / Delta Image Packer for the RV32IMZ Bootloader
+
+Packs an application image so fewer bytes cross the serial link. The
+bootloader (firmware/bootloader/bootloader.c, unpack_*) expands the stream
+while it programs, without a window buffer of its own: back-references
+read what has already been written.
+
+Header: size and crc32 still describe the unpacked image (verify_application()
+checks what ends up in the region). reserved carries the format:
+
+    reserved[31:24]  format   0 = raw, 1 = LZ, 2 = delta
+    reserved[23:0]   number of packed bytes after the header
+
+A delta image is followed by the CRC32 of the image body it was made against
+(u32, sent in the HEADER frame). The bootloader refuses it unless that is the
+installed image.
+
+Stream: a sequence of tokens, lengths extended LZ4-style (a 0x3F length field
+is followed by bytes added to it, up to and including the first byte != 255):
+
+    0x00-0x7F  LITERAL  (c + 1) bytes follow
+    0x80-0xBF  COPY     len = (c & 0x3F) + 3, u16 distance back in the output
+    0xC0-0xFF  BASE     len = (c & 0x3F) + 3, u16 offset from the output
+                        position into the installed image (delta only)
+
+BASE copies read the installed image at or after the output position, which
+is not overwritten yet: unchanged code costs 3 bytes per run, but code that
+moved towards the end of the image (an insertion before it) is sent as COPY
+or literals.
+
+Usage:
+    python3 pack_image.py app_with_header.bin app.lz.bin
+    python3 pack_image.py new_app.bin app.delta.bin --base installed_app.bin --version 1.2.0
+"""
+
+import argparse
+import bisect
+import struct
+import sys
+import zlib
+from pathlib import Path
+
+from add_bootloader_header import HEADER_FORMAT, HEADER_SIZE, make_header, parse_header, parse_version
+
+FORMAT_RAW = 0
+FORMAT_LZ = 1
+FORMAT_DELTA = 2
+FORMAT_NAMES = {FORMAT_RAW: "raw", FORMAT_LZ: "LZ", FORMAT_DELTA: "delta"}
+
+MIN_MATCH = 3
+LEN_FIELD_MAX = 0x3F
+MAX_LITERAL = 128
+MAX_DISTANCE = 0xFFFF
+MAX_CHAIN = 64          # candidates tried per position
+
+
+def format_of(reserved):
+    return reserved >> 24, reserved & 0xFFFFFF
+
+
+#==============================================================================
+# Encoder
+#==============================================================================
+
+def _emit_len(out, token, length):
+    field = length - MIN_MATCH
+    if field < LEN_FIELD_MAX:
+        out.append(token | field)
+        return
+    out.append(token | LEN_FIELD_MAX)
+    field -= LEN_FIELD_MAX
+    while field >= 255:
+        out.append(255)
+        field -= 255
+    out.append(field)
+
+
+def _flush_literals(out, data, start, end):
+    while start < end:
+        n = min(MAX_LITERAL, end - start)
+        out.append(n - 1)
+        out += data[start:start + n]
+        start += n
+
+
+def _match_len(a, i, b, j, limit):
+    n = 0
+    while n < limit and a[i + n] == b[j + n]:
+        n += 1
+    return n
+
+
+def pack(data, base=None):
+    """Token stream for data; BASE copies against base if given"""
+    out = bytearray()
+    chains = {}             # 3-byte prefix -> positions in data, newest last
+    base_index = {}         # 3-byte prefix -> positions in base
+    if base is not None:
+        for j in range(len(base) - MIN_MATCH + 1):
+            base_index.setdefault(base[j:j + MIN_MATCH], []).append(j)
+
+    literal_start = 0
+    i = 0
+    while i < len(data):
+        best_len, best_kind, best_arg = 0, None, 0
+        remaining = len(data) - i
+        key = data[i:i + MIN_MATCH]
+
+        if base is not None and remaining >= MIN_MATCH:
+            # Same position first: the common case of unchanged code
+            if i < len(base):
+                n = _match_len(data, i, base, i, min(remaining, len(base) - i))
+                if n >= MIN_MATCH:
+                    best_len, best_kind, best_arg = n, "base", 0
+            positions = base_index.get(key, [])
+            start = bisect.bisect_left(positions, i)
+            for j in positions[start:start + MAX_CHAIN]:
+                if j - i > MAX_DISTANCE or best_len == remaining:
+                    break
+                n = _match_len(data, i, base, j, min(remaining, len(base) - j))
+                if n > best_len:
+                    best_len, best_kind, best_arg = n, "base", j - i
+
+        if remaining >= MIN_MATCH:
+            for j in reversed(chains.get(key, [])[-MAX_CHAIN:]):
+                if i - j > MAX_DISTANCE:
+                    break
+                n = _match_len(data, i, data, j, remaining)
+                if n > best_len:
+                    best_len, best_kind, best_arg = n, "copy", i - j
+
+        if best_len >= MIN_MATCH:
+            _flush_literals(out, data, literal_start, i)
+            _emit_len(out, 0xC0 if best_kind == "base" else 0x80, best_len)
+            out += struct.pack("<H", best_arg)
+            step = best_len
+        else:
+            step = 1
+
+        for k in range(i, min(i + step, len(data) - MIN_MATCH + 1)):
+            chains.setdefault(data[k:k + MIN_MATCH], []).append(k)
+        i += step
+        if step > 1:
+            literal_start = i
+
+    _flush_literals(out, data, literal_start, len(data))
+    return bytes(out)
+
+
+#==============================================================================
+# Decoder (mirror of the bootloader, used to verify packed images)
+#==============================================================================
+
+def unpack(stream, size, base=None):
+    out = bytearray()
+    p = 0
+    while p < len(stream):
+        c = stream[p]
+        p += 1
+        if c < 0x80:
+            out += stream[p:p + c + 1]
+            p += c + 1
+            continue
+        length = (c & LEN_FIELD_MAX) + MIN_MATCH
+        if c & LEN_FIELD_MAX == LEN_FIELD_MAX:
+            while True:
+                b = stream[p]
+                p += 1
+                length += b
+                if b != 255:
+                    break
+        (arg,) = struct.unpack_from("<H", stream, p)
+        p += 2
+        if c & 0x40:
+            src = len(out) + arg
+            if base is None or src + length > len(base):
+                raise ValueError("BASE copy outside the base image")
+            out += base[src:src + length]
+        else:
+            if arg == 0 or arg > len(out):
+                raise ValueError("COPY distance before the start of the image")
+            for _ in range(length):
+                out.append(out[-arg])
+        if len(out) > size:
+            raise ValueError("stream expands past the image size")
+    if len(out) != size:
+        raise ValueError(f"stream expands to {len(out)} bytes, header says {size}")
+    return bytes(out)
+
+
+#==============================================================================
+# Images
+#==============================================================================
+
+def body_of(image):
+    """Image body without the header (a raw binary is all body)"""
+    return image[HEADER_SIZE:] if parse_header(image) is not None else image
+
+
+def pack_image(image, version, base=None):
+    """Packed image (header, [base CRC], stream) for a raw or headered image"""
+    header = parse_header(image)
+    if header is not None:
+        version = header[1]
+    body = body_of(image)
+
+    if base is not None:
+        base_body = body_of(base)
+        stream = pack(body, base_body)
+        fmt, extra = FORMAT_DELTA, struct.pack("<I", zlib.crc32(base_body) & 0xFFFFFFFF)
+    else:
+        stream = pack(body)
+        fmt, extra = FORMAT_LZ, b""
+
+    magic, _, size, crc, _ = struct.unpack(HEADER_FORMAT, make_header(body, version))
+    reserved = (fmt << 24) | len(stream)
+    return struct.pack(HEADER_FORMAT, magic, version, size, crc, reserved) + extra + stream
+
+
+def unpack_image(image, base=None):
+    """Raw headered image from a packed one (raw images pass through)"""
+    magic, version, size, crc, reserved = parse_header(image)
+    fmt, packed = format_of(reserved)
+    if fmt == FORMAT_RAW:
+        return image
+    extra = 4 if fmt == FORMAT_DELTA else 0
+    stream = image[HEADER_SIZE + extra:]
+    if len(stream) != packed:
+        raise ValueError(f"{len(stream)} packed bytes, header says {packed}")
+
+    base_body = None
+    if fmt == FORMAT_DELTA:
+        if base is None:
+            raise ValueError("delta image needs its base image to unpack")
+        base_body = body_of(base)
+        (base_crc,) = struct.unpack_from("<I", image, HEADER_SIZE)
+        if zlib.crc32(base_body) & 0xFFFFFFFF != base_crc:
+            raise ValueError("base image does not match the one the delta was made against")
+
+    body = unpack(stream, size - HEADER_SIZE, base_body)
+    if zlib.crc32(body) & 0xFFFFFFFF != crc:
+        raise ValueError("unpacked image CRC mismatch")
+    return struct.pack(HEADER_FORMAT, magic, version, size, crc, 0) + body
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Pack an application image for the UART bootloader")
+    parser.add_argument("input", help="Application binary, with or without bootloader header")
+    parser.add_argument("output", help="Packed image")
+    parser.add_argument("--base", help="Installed image to delta against (default: plain LZ)")
+    parser.add_argument("--version", default="1.0.0",
+                        help="Version for a raw binary without header (default: 1.0.0)")
+    args = parser.parse_args()
+
+    try:
+        image = Path(args.input).read_bytes()
+        base = Path(args.base).read_bytes() if args.base else None
+        packed = pack_image(image, parse_version(args.version), base)
+        unpack_image(packed, base)          # round trip before anyone flashes it
+    except (OSError, ValueError) as e:
+        print(f"Error: {e}", file=sys.stderr)
+        return 1
+
+    fmt, _ = format_of(parse_header(packed)[4])
+    raw_size = HEADER_SIZE + len(body_of(image))
+    Path(args.output).write_bytes(packed)
+    print(f"Packed {args.output} ({FORMAT_NAMES[fmt]}): {raw_size} -> {len(packed)} bytes "
+          f"({100 * len(packed) / raw_size:.0f}%)")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+"""
+Firmware Kernel Benchmarks on the RTL Model
+
+Builds the benchmark variants of chb_5level_control (make BENCHMARK=1,
+fixed-point and float), runs each on the Verilator model of the core
+(sim/verilator, SoC mode) and prints cycles and instructions per call:
+
+    python3 run_benchmarks.py                      # from firmware/examples: make bench
+    python3 run_benchmarks.py --core multicycle --mdu serial   # needs the multicycle sources
+
+Every run is appended to a CSV history (date, commit, core, mdu, variant,
+kernel, cycles, instret) and compared with the previous run of the same
+configuration. A kernel that got slower by more than --threshold percent
+is reported as a regression; --fail-on-regression turns that into exit
+status 1 for CI.
+"""
+
+import argparse
+import csv
+import datetime
+import re
+import shutil
+import subprocess
+import sys
+from pathlib import Path
+
+TOOLS_DIR = Path(__file__).resolve().parent
+EXAMPLES_DIR = TOOLS_DIR.parent / "firmware" / "examples"
+REPO_ROOT = TOOLS_DIR.parents[2]
+SIM_DIR = REPO_ROOT / "sim" / "verilator"
+
+APP = "chb_5level_control"
+VARIANTS = {
+    "fixed": ["FIXED_POINT=1"],
+    "float": ["FIXED_POINT=0"],
+}
+MAX_CYCLES = 50000000
+
+BENCH_LINE = re.compile(r"BENCH (\S+) calls=(\d+) cycles=(\d+) instret=(\d+)")
+FIELDS = ["date", "commit", "core", "mdu", "variant", "kernel", "cycles", "instret"]
+
+
+def run(cmd, **kwargs):
+    result = subprocess.run(cmd, capture_output=True, text=True, **kwargs)
+    if result.returncode != 0:
+        sys.stderr.write(result.stdout[-2000:] + result.stderr[-2000:])
+    return result
+
+
+def build_variant(variant, out_dir):
+    """Build one benchmark ELF; objects are shared, so clean in between"""
+    make = ["make", "-C", str(EXAMPLES_DIR), f"APP={APP}", "BENCHMARK=1", *VARIANTS[variant]]
+    run(make + ["clean"])
+    elf = EXAMPLES_DIR / f"{APP}.elf"
+    result = run(make + [elf.name])
+    if result.returncode != 0:
+        return None
+    out = out_dir / f"bench_{variant}.elf"
+    shutil.copy(elf, out)
+    return out
+
+
+def build_sim(core, mdu):
+    result = run(["make", "-C", str(SIM_DIR), f"CORE={core}", f"MDU={mdu}"])
+    if result.returncode != 0:
+        return None
+    return SIM_DIR / "build" / f"{core}_{mdu}" / "Vsim_top"
+
+
+def run_bench(sim_bin, elf):
+    """Run one image; returns {kernel: (cycles, instret)} or None"""
+    result = run([str(sim_bin), "--soc", "--quiet", "--max-cycles", str(MAX_CYCLES), str(elf)])
+    if result.returncode != 0:
+        return None
+    return {m.group(1): (int(m.group(3)), int(m.group(4)))
+            for m in BENCH_LINE.finditer(result.stdout)}
+
+
+def git_commit():
+    result = subprocess.run(["git", "-C", str(REPO_ROOT), "rev-parse", "--short", "HEAD"],
+                            capture_output=True, text=True)
+    return result.stdout.strip() if result.returncode == 0 else "unknown"
+
+
+def load_history(path):
+    if not path.exists():
+        return []
+    with open(path, newline="") as f:
+        return list(csv.DictReader(f))
+
+
+def previous_results(history, core, mdu):
+    """Latest cycles per (variant, kernel) for this core/MDU configuration"""
+    last = {}
+    for row in history:
+        if row["core"] == core and row["mdu"] == mdu:
+            last[(row["variant"], row["kernel"])] = int(row["cycles"])
+    return last
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark firmware kernels on the Verilator core model")
+    parser.add_argument("--core", choices=["multicycle", "pipelined"], default="pipelined")
+    parser.add_argument("--mdu", choices=["serial", "fast"], default="fast")
+    parser.add_argument("--variant", choices=sorted(VARIANTS), action="append",
+                        help="Variant to run (repeatable, default: all)")
+    parser.add_argument("--history", type=Path, default=EXAMPLES_DIR / "bench_history.csv",
+                        help="CSV the results are appended to")
+    parser.add_argument("--no-record", action="store_true", help="Compare only, do not append")
+    parser.add_argument("--threshold", type=float, default=2.0,
+                        help="Slow-down in percent reported as a regression (default 2)")
+    parser.add_argument("--fail-on-regression", action="store_true")
+    args = parser.parse_args()
+
+    variants = args.variant or sorted(VARIANTS)
+    out_dir = EXAMPLES_DIR / "bench"
+    out_dir.mkdir(exist_ok=True)
+
+    sim_bin = build_sim(args.core, args.mdu)
+    if sim_bin is None:
+        print("Error: Verilator model build failed")
+        return 1
+
+    results = {}
+    for variant in variants:
+        elf = build_variant(variant, out_dir)
+        if elf is None:
+            print(f"Error: {variant} build failed")
+            return 1
+        kernels = run_bench(sim_bin, elf)
+        if not kernels:
+            print(f"Error: {variant} benchmark did not finish")
+            return 1
+        for kernel, value in kernels.items():
+            results[(variant, kernel)] = value
+
+    history = load_history(args.history)
+    last = previous_results(history, args.core, args.mdu)
+
+    print(f"Core: {args.core}, MDU: {args.mdu}")
+    print(f"{'variant':<8} {'kernel':<16} {'cycles':>9} {'instret':>9} {'CPI':>6} {'change':>9}")
+    regressions = []
+    for (variant, kernel), (cycles, instret) in sorted(results.items()):
+        cpi = f"{cycles / instret:.2f}" if instret else "-"
+        change = ""
+        prev = last.get((variant, kernel))
+        if prev:
+            pct = 100.0 * (cycles - prev) / prev
+            change = f"{pct:+.1f}%"
+            if pct > args.threshold:
+                regressions.append(f"{variant}/{kernel}: {prev} -> {cycles} cycles ({change})")
+        print(f"{variant:<8} {kernel:<16} {cycles:>9} {instret:>9} {cpi:>6} {change:>9}")
+
+    if not args.no_record:
+        new_file = not args.history.exists()
+        date = datetime.datetime.now().strftime("%Y-%m-%d %H:%M")
+        commit = git_commit()
+        with open(args.history, "a", newline="") as f:
+            writer = csv.DictWriter(f, fieldnames=FIELDS)
+            if new_file:
+                writer.writeheader()
+            for (variant, kernel), (cycles, instret) in sorted(results.items()):
+                writer.writerow({"date": date, "commit": commit, "core": args.core, "mdu": args.mdu,
+                                 "variant": variant, "kernel": kernel,
+                                 "cycles": cycles, "instret": instret})
+        print(f"Recorded in {args.history}")
+
+    if regressions:
+        print(f"\nRegressions (> {args.threshold:.1f}%):")
+        for r in regressions:
+            print(f"  {r}")
+        if args.fail_on_regression:
+            return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
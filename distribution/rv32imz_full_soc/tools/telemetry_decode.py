@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""
+Telemetry Frame Decoder for RV32IMZ Firmware
+
+Decodes the binary waveform frames of firmware/telemetry.h from a serial
+port or a raw capture file and writes CSV. Console text that shares the
+UART is skipped (frames are found by sync word and checked by CRC).
+
+Frame (little-endian):
+    A5 5A | type | channels | seq u16 | count u8 | dropped u8 |
+    samples[count][channels] int16 | CRC-16/CCITT-FALSE u16 over type..samples
+
+Samples are Q15; --scale multiplies each channel by its full-scale value,
+e.g. the chb_5level_control order V_ref, V_fb, I_fb, MI:
+
+    python3 telemetry_decode.py /dev/ttyUSB0 --scale 165,165,33,1 -o capture.csv
+    python3 telemetry_decode.py capture.bin --raw
+
+Use --enable to send the firmware's toggle command ('t') after opening
+the port.
+"""
+
+import argparse
+import struct
+import sys
+
+SYNC = b"\xA5\x5A"
+TYPE_WAVE = 0x01
+HEADER_SIZE = 8
+DEFAULT_NAMES = ["v_ref", "v_fb", "i_fb", "mi"]
+
+
+def crc16_ccitt(data, crc=0xFFFF):
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+class FrameDecoder:
+    """Incremental decoder, yields (seq, dropped, samples)"""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.frames = 0
+        self.crc_errors = 0
+
+    def feed(self, data):
+        self.buf += data
+        while True:
+            start = self.buf.find(SYNC)
+            if start < 0:
+                # Keep a trailing 0xA5, it may be the first half of a sync word
+                del self.buf[:max(0, len(self.buf) - 1)]
+                return
+            del self.buf[:start]
+            if len(self.buf) < HEADER_SIZE:
+                return
+            ftype, channels, seq, count, dropped = struct.unpack_from("<BBHBB", self.buf, 2)
+            if ftype != TYPE_WAVE or channels == 0 or channels > 16:
+                del self.buf[:1]
+                continue
+            total = HEADER_SIZE + count * channels * 2 + 2
+            if len(self.buf) < total:
+                return
+            (crc,) = struct.unpack_from("<H", self.buf, total - 2)
+            if crc16_ccitt(self.buf[2:total - 2]) != crc:
+                self.crc_errors += 1
+                del self.buf[:1]
+                continue
+            values = struct.unpack_from(f"<{count * channels}h", self.buf, HEADER_SIZE)
+            samples = [values[i:i + channels] for i in range(0, len(values), channels)]
+            del self.buf[:total]
+            self.frames += 1
+            yield seq, dropped, samples
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode RV32IMZ telemetry frames to CSV")
+    parser.add_argument("source", help="Serial port or raw capture file")
+    parser.add_argument("-o", "--output", help="CSV output (default: stdout)")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--scale", help="Comma-separated full-scale value per channel")
+    parser.add_argument("--names", default=",".join(DEFAULT_NAMES), help="Comma-separated column names")
+    parser.add_argument("--raw", action="store_true", help="Source is a file, not a serial port")
+    parser.add_argument("--enable", action="store_true", help="Send 't' to start streaming")
+    parser.add_argument("--samples", type=int, default=0, help="Stop after this many samples")
+    args = parser.parse_args()
+
+    scale = [float(s) for s in args.scale.split(",")] if args.scale else None
+    names = args.names.split(",")
+
+    if args.raw:
+        port = None
+        source = open(args.source, "rb")
+    else:
+        try:
+            import serial
+        except ImportError:
+            print("Error: pyserial is required for serial capture (or use --raw)", file=sys.stderr)
+            return 1
+        port = serial.Serial(args.source, args.baud, timeout=0.1)
+        source = port
+        if args.enable:
+            port.write(b"t")
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    decoder = FrameDecoder()
+    expected_seq = None
+    written = 0
+    lost = 0
+
+    try:
+        header_done = False
+        while args.samples == 0 or written < args.samples:
+            data = source.read(4096)
+            if not data:
+                if port is None:
+                    break
+                continue
+            for seq, dropped, samples in decoder.feed(data):
+                if not header_done:
+                    cols = [names[i] if i < len(names) else f"ch{i}" for i in range(len(samples[0]))]
+                    out.write("seq," + ",".join(cols) + "\n")
+                    header_done = True
+                if expected_seq is not None and seq != expected_seq:
+                    lost += (seq - expected_seq) & 0xFFFF
+                expected_seq = (seq + len(samples)) & 0xFFFF
+                lost += dropped
+                for n, sample in enumerate(samples):
+                    if scale:
+                        fields = [f"{v / 32768.0 * (scale[i] if i < len(scale) else 1.0):.4f}"
+                                  for i, v in enumerate(sample)]
+                    else:
+                        fields = [str(v) for v in sample]
+                    out.write(f"{(seq + n) & 0xFFFF}," + ",".join(fields) + "\n")
+                    written += 1
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if port is not None and args.enable:
+            port.write(b"t")
+        if out is not sys.stdout:
+            out.close()
+
+    print(f"{written} samples in {decoder.frames} frames, {lost} lost, "
+          f"{decoder.crc_errors} CRC errors", file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,325 @@
+#!/usr/bin/env python3
+"""
+Serial Firmware Uploader for the RV32IMZ Bootloader
+
+Speaks the framed, windowed protocol of firmware/bootloader/boot_protocol.h:
+
+- wakes the bootloader with 'U' during its boot countdown
+- HELLO negotiates the window and, optionally, a faster baud rate
+- HEADER, then DATA frames with up to <window> frames in flight
+  (go-back-N: rewind on NAK or ACK timeout)
+- END: the bootloader checks size and image CRC before acknowledging
+
+The input may be a raw binary (a header is generated, see
+add_bootloader_header.py), an image that already carries one, or a packed
+image from pack_image.py. --pack and --base pack on the way out (LZ, or
+delta against the image installed on the board); the smaller of packed and
+raw is sent.
+
+Usage:
+    python3 upload_tool.py /dev/ttyUSB0 app_with_header.bin
+    python3 upload_tool.py /dev/ttyUSB0 app.bin --version 1.2.0 --fast-baud 921600
+    python3 upload_tool.py /dev/ttyUSB0 app.bin --base installed_app.bin
+
+Requires pyserial.
+"""
+
+import argparse
+import struct
+import sys
+import time
+import zlib
+from pathlib import Path
+
+from add_bootloader_header import HEADER_SIZE, make_header, parse_header, parse_version
+from pack_image import FORMAT_DELTA, FORMAT_NAMES, FORMAT_RAW, format_of, pack_image, unpack_image
+
+# boot_protocol.h
+PROTO_VERSION = 2
+PROTO_VERSION_PACKED = 2        # first version that unpacks images
+PROTO_SYNC = 0xA5
+PROTO_MAX_PAYLOAD = 4 + 256
+
+PROTO_HELLO = 0x01
+PROTO_HEADER = 0x02
+PROTO_DATA = 0x03
+PROTO_END = 0x04
+PROTO_ABORT = 0x05
+PROTO_ACK = 0x80
+PROTO_NAK = 0x81
+
+PROTO_ERR_CRC = 0x01
+PROTO_ERR_SEQ = 0x02
+NAK_REASONS = {
+    0x01: "frame CRC mismatch",
+    0x02: "sequence gap",
+    0x03: "bad frame length",
+    0x04: "DATA/END before HEADER",
+    0x05: "bad header (magic or size)",
+    0x06: "bad DATA offset",
+    0x07: "image CRC mismatch",
+    0x08: "baud rate not reachable",
+    0x09: "unknown frame type",
+    0x0A: "unknown format or bad packed stream",
+    0x0B: "delta base is not the installed image (send a full image)",
+}
+
+ACK_TIMEOUT_S = 0.5
+MAX_RETRIES = 10
+
+
+class ProtocolError(Exception):
+    pass
+
+
+def encode_frame(ftype, seq, payload=b""):
+    body = struct.pack("<BBH", ftype, seq & 0xFF, len(payload)) + payload
+    return bytes([PROTO_SYNC]) + body + struct.pack("<I", zlib.crc32(body) & 0xFFFFFFFF)
+
+
+class FrameParser:
+    """Incremental decoder; skips console text and corrupt frames"""
+
+    def __init__(self):
+        self.buf = bytearray()
+
+    def feed(self, data):
+        self.buf += data
+        frames = []
+        while True:
+            start = self.buf.find(PROTO_SYNC)
+            if start < 0:
+                self.buf.clear()
+                return frames
+            del self.buf[:start]
+            if len(self.buf) < 5:
+                return frames
+            ftype, seq, length = struct.unpack_from("<BBH", self.buf, 1)
+            if length > PROTO_MAX_PAYLOAD:
+                del self.buf[0]
+                continue
+            total = 1 + 4 + length + 4
+            if len(self.buf) < total:
+                return frames
+            body = bytes(self.buf[1:5 + length])
+            (crc,) = struct.unpack_from("<I", self.buf, 5 + length)
+            if zlib.crc32(body) & 0xFFFFFFFF != crc:
+                del self.buf[0]
+                continue
+            frames.append((ftype, seq, body[4:]))
+            del self.buf[:total]
+
+
+class Uploader:
+    def __init__(self, port, verbose=False):
+        self.port = port
+        self.parser = FrameParser()
+        self.verbose = verbose
+        self.seq = 0
+
+    def log(self, msg):
+        if self.verbose:
+            print(msg)
+
+    def poll(self, timeout):
+        """Frames received within timeout seconds (returns on the first batch)"""
+        deadline = time.monotonic() + timeout
+        while True:
+            data = self.port.read(max(1, self.port.in_waiting))
+            if data:
+                frames = self.parser.feed(data)
+                if frames:
+                    return frames
+            if time.monotonic() >= deadline:
+                return []
+
+    def transact(self, ftype, payload=b"", retries=MAX_RETRIES):
+        """Stop-and-wait exchange of a single control frame"""
+        seq = self.seq
+        for _ in range(retries):
+            self.port.write(encode_frame(ftype, seq, payload))
+            deadline = time.monotonic() + ACK_TIMEOUT_S
+            while time.monotonic() < deadline:
+                for rtype, rseq, rpayload in self.poll(deadline - time.monotonic()):
+                    if rtype == PROTO_ACK and rseq == (seq + 1) & 0xFF:
+                        self.seq = rseq
+                        return rpayload
+                    if rtype == PROTO_NAK and rpayload and rpayload[0] not in (PROTO_ERR_CRC, PROTO_ERR_SEQ):
+                        raise ProtocolError(NAK_REASONS.get(rpayload[0], f"NAK 0x{rpayload[0]:02X}"))
+        raise ProtocolError(f"no response to frame type 0x{ftype:02X}")
+
+    def hello(self, baud):
+        self.seq = 0
+        info = self.transact(PROTO_HELLO, struct.pack("<I", baud))
+        version, window, max_data, max_image = struct.unpack("<BBHI", info[:8])
+        if not 1 <= version <= PROTO_VERSION:
+            raise ProtocolError(f"bootloader speaks protocol v{version}, tool speaks v{PROTO_VERSION}")
+        return version, window, max_data, max_image
+
+    def send_data(self, body, window, max_data):
+        """Go-back-N transfer of the image body"""
+        chunks = [body[i:i + max_data] for i in range(0, len(body), max_data)]
+        base_seq = self.seq
+        acked = 0           # chunks confirmed
+        sent = 0            # chunks written since the last rewind
+        retries = 0
+        last_progress = time.monotonic()
+
+        while acked < len(chunks):
+            while sent < len(chunks) and sent - acked < window:
+                offset = sent * max_data
+                self.port.write(encode_frame(PROTO_DATA, base_seq + sent,
+                                             struct.pack("<I", offset) + chunks[sent]))
+                sent += 1
+
+            rewind = False
+            for rtype, rseq, rpayload in self.poll(ACK_TIMEOUT_S):
+                # Sequence numbers are 8-bit, the window keeps them unambiguous
+                ahead = (rseq - base_seq - acked) & 0xFF
+                if ahead > window:
+                    continue
+                if rtype == PROTO_ACK and ahead > 0:
+                    acked += ahead
+                    retries = 0
+                    last_progress = time.monotonic()
+                elif rtype == PROTO_NAK:
+                    reason = rpayload[0] if rpayload else 0
+                    if reason not in (PROTO_ERR_CRC, PROTO_ERR_SEQ):
+                        raise ProtocolError(NAK_REASONS.get(reason, f"NAK 0x{reason:02X}"))
+                    acked += ahead
+                    rewind = True
+
+            if time.monotonic() - last_progress > ACK_TIMEOUT_S:
+                rewind = True
+                last_progress = time.monotonic()
+                retries += 1
+                if retries > MAX_RETRIES:
+                    raise ProtocolError(f"no progress at offset {acked * max_data}")
+
+            if rewind and sent > acked:
+                self.log(f"  rewind to offset {acked * max_data}")
+                sent = acked
+
+            done = min(acked * max_data, len(body))
+            print(f"\r  {done}/{len(body)} bytes", end="", flush=True)
+
+        print()
+        self.seq = (base_seq + len(chunks)) & 0xFF
+
+    def upload(self, image, baud, fast_baud):
+        version, window, max_data, max_image = self.hello(fast_baud or 0)
+        _, _, size, _, reserved = parse_header(image)
+        fmt, _ = format_of(reserved)
+        if size > max_image:
+            raise ProtocolError(f"image is {size} bytes, bootloader accepts {max_image}")
+        if fmt != FORMAT_RAW and version < PROTO_VERSION_PACKED:
+            raise ProtocolError(f"bootloader protocol v{version} cannot unpack images, send it raw")
+        if fast_baud:
+            time.sleep(0.01)
+            self.port.baudrate = fast_baud
+            self.parser = FrameParser()
+        print(f"Session: window {window}, {max_data} bytes/frame, {self.port.baudrate} baud")
+
+        # A delta image carries its base CRC in the HEADER frame
+        header_len = HEADER_SIZE + (4 if fmt == FORMAT_DELTA else 0)
+        try:
+            self.transact(PROTO_HEADER, image[:header_len])
+            self.send_data(image[header_len:], window, max_data)
+            self.transact(PROTO_END, retries=3)
+        finally:
+            # The bootloader returns to the boot rate when the session ends
+            self.port.baudrate = baud
+
+
+def enter_bootloader(port, timeout):
+    """Send 'U' until the bootloader leaves its countdown"""
+    deadline = time.monotonic() + timeout
+    seen = b""
+    while time.monotonic() < deadline:
+        port.write(b"U")
+        time.sleep(0.05)
+        seen = (seen + port.read(port.in_waiting))[-256:]
+        if b"UPDATE MODE" in seen:
+            return True
+    return False
+
+
+def load_image(path, version, pack=False, base_path=None):
+    image = Path(path).read_bytes()
+    if parse_header(image) is None:
+        image = make_header(image, parse_version(version)) + image
+    base = Path(base_path).read_bytes() if base_path else None
+
+    fmt, _ = format_of(parse_header(image)[4])
+    try:
+        raw = unpack_image(image, base)
+    except ValueError as e:
+        if fmt == FORMAT_DELTA and base is None:
+            return image            # the bootloader checks it against its base
+        raise ProtocolError(f"{path}: {e}")
+    _, _, size, crc, _ = parse_header(raw)
+    if size != len(raw) or zlib.crc32(raw[HEADER_SIZE:]) & 0xFFFFFFFF != crc:
+        raise ProtocolError(f"{path}: header does not match the image")
+
+    if fmt == FORMAT_RAW and (pack or base is not None):
+        packed = pack_image(raw, 0, base)
+        if len(packed) < len(raw):
+            return packed
+    return image
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Upload firmware through the RV32IMZ UART bootloader")
+    parser.add_argument("port", help="Serial port, e.g. /dev/ttyUSB0")
+    parser.add_argument("image", help="Application binary, with or without bootloader header")
+    parser.add_argument("--baud", type=int, default=115200, help="Boot baud rate (default: 115200)")
+    parser.add_argument("--fast-baud", type=int, default=0,
+                        help="Switch to this rate for the transfer (bootloader checks reachability)")
+    parser.add_argument("--version", default="1.0.0",
+                        help="Version for a raw binary without header (default: 1.0.0)")
+    parser.add_argument("--pack", action="store_true", help="Send LZ packed (pack_image.py)")
+    parser.add_argument("--base", metavar="IMAGE",
+                        help="Send as a delta against IMAGE, the image installed on the board")
+    parser.add_argument("--no-enter", action="store_true",
+                        help="Bootloader is already in update mode, do not send 'U'")
+    parser.add_argument("--wait", type=float, default=10.0,
+                        help="Seconds to wait for the bootloader countdown (default: 10)")
+    parser.add_argument("-v", "--verbose", action="store_true")
+    args = parser.parse_args()
+
+    try:
+        import serial
+    except ImportError:
+        print("Error: pyserial is required (pip install pyserial)", file=sys.stderr)
+        return 1
+
+    try:
+        image = load_image(args.image, args.version, args.pack, args.base)
+    except (OSError, ValueError, ProtocolError) as e:
+        print(f"Error: {e}", file=sys.stderr)
+        return 1
+
+    with serial.Serial(args.port, args.baud, timeout=0) as port:
+        if not args.no_enter:
+            print("Waiting for bootloader (reset the board)...")
+            if not enter_bootloader(port, args.wait):
+                print("Error: bootloader did not enter update mode", file=sys.stderr)
+                return 1
+
+        start = time.monotonic()
+        try:
+            Uploader(port, args.verbose).upload(image, args.baud, args.fast_baud)
+        except ProtocolError as e:
+            print(f"\nError: {e}", file=sys.stderr)
+            return 1
+
+    elapsed = time.monotonic() - start
+    _, _, size, _, reserved = parse_header(image)
+    fmt, _ = format_of(reserved)
+    packed = f", {FORMAT_NAMES[fmt]} packed to {len(image)}" if fmt != FORMAT_RAW else ""
+    print(f"Uploaded {size} bytes{packed} in {elapsed:.2f} s ({len(image) / elapsed:.0f} B/s on the link)")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,1008 @@
+//==============================================================================
+// Pipelined RV32IM Core - 5-Stage Variant
+//
+// Drop-in replacement for custom_riscv_core.v (same module name and ports),
+// selected with `./synthesize_soc.sh --core pipelined` and
+// `python3 run_compliance_tests.py --core pipelined`.
+//
+//   IF  - instruction fetch over iwb (one Wishbone classic cycle per word)
+//   ID  - decode, register read (write-back bypass), load-use interlock
+//   EX  - ALU, branch resolution, MDU (stalls until done)
+//   MEM - load/store over dwb, CSR access, trap and interrupt commit
+//   WB  - register write, minstret
+//
+// Hazards:
+//   - EX/MEM and MEM/WB results are forwarded to EX. Loads and CSR reads
+//     produce their value in MEM, so a dependent instruction directly
+//     behind one stalls for one cycle.
+//   - Branches and jumps resolve in EX and are predicted not-taken: a taken
+//     branch costs two cycles.
+//   - Traps, interrupts, MRET and FENCE.I commit in MEM, flush the younger
+//     stages and redirect fetch. MEM is the retirement point, so exceptions
+//     are precise: no younger instruction has written a register or memory.
+//
+// With single-cycle memories an instruction issues every clock apart from
+// load-use, taken-branch and MDU stalls (the multi-cycle core needs ~5).
+// A fetch that is in flight when fetch is redirected is completed and
+// discarded, as Wishbone classic requires.
+//
+// CSRs: mstatus (MIE/MPIE, MPP fixed to M), misa, mie, mip, mtvec (direct
+// and vectored), mscratch, mepc, mcause, mtval, mhartid and the other ID
+// registers (read as zero). Unimplemented CSR addresses read as zero and
+// ignore writes.
+//
+// Counters (Zicntr/Zihpm): mcycle[h], minstret[h], mhpmcounter3-6[h] with
+// their read-only cycle/instret/hpmcounter aliases, mhpmevent3-6 and
+// mcountinhibit (CY, IR, HPM3-6). time[h] is not implemented (reads zero);
+// use the TIMER peripheral. Each mhpmevent selects one of:
+//
+//   0  none                      5  EX waiting for the MDU
+//   1  ID stalled (any cause)    6  conditional branches executed
+//   2  load/CSR-use bubbles      7  conditional branches taken
+//   3  instruction bus wait      8  JAL/JALR
+//   4  data bus wait             9  interrupts taken
+//
+// Event numbers and CSR helpers are in firmware/perf_counters.h.
+//
+// Interrupts: interrupts[i] drives mip[i] (bits 3, 7, 11 and 16-31).
+// Platform interrupts 16-31 have priority over the standard ones, lowest
+// number first; then external (11), software (3) and timer (7).
+//
+// Zpec (ZPEC_ENABLED): custom-0 (opcode 0x0B) R-type instructions execute
+// in zpec_unit.v (distribution/rv32imz_full_soc/rtl/core) on the forwarded
+// operands and retire like an ALU operation, without a stall; misa.X is set.
+// Without the define custom-0 is an illegal instruction.
+//==============================================================================
+
+module custom_riscv_core #(
+    parameter [31:0] RESET_PC = 32'h00000000
+) (
+    input  wire        clk,
+    input  wire        rst_n,
+
+    // Instruction Wishbone (read-only)
+    output wire [31:0] iwb_adr_o,
+    input  wire [31:0] iwb_dat_i,
+    output wire        iwb_cyc_o,
+    output wire        iwb_stb_o,
+    input  wire        iwb_ack_i,
+
+    // Data Wishbone
+    output wire [31:0] dwb_adr_o,
+    output wire [31:0] dwb_dat_o,
+    input  wire [31:0] dwb_dat_i,
+    output wire        dwb_we_o,
+    output wire [3:0]  dwb_sel_o,
+    output wire        dwb_cyc_o,
+    output wire        dwb_stb_o,
+    input  wire        dwb_ack_i,
+    input  wire        dwb_err_i,
+
+    // Interrupt lines (mip bits)
+    input  wire [31:0] interrupts
+);
+
+    //--------------------------------------------------------------------------
+    // Encodings
+    //--------------------------------------------------------------------------
+
+    localparam [6:0] OP_LUI    = 7'b0110111;
+    localparam [6:0] OP_AUIPC  = 7'b0010111;
+    localparam [6:0] OP_JAL    = 7'b1101111;
+    localparam [6:0] OP_JALR   = 7'b1100111;
+    localparam [6:0] OP_BRANCH = 7'b1100011;
+    localparam [6:0] OP_LOAD   = 7'b0000011;
+    localparam [6:0] OP_STORE  = 7'b0100011;
+    localparam [6:0] OP_IMM    = 7'b0010011;
+    localparam [6:0] OP_REG    = 7'b0110011;
+    localparam [6:0] OP_FENCE  = 7'b0001111;
+    localparam [6:0] OP_SYSTEM = 7'b1110011;
+    localparam [6:0] OP_CUSTOM0 = 7'b0001011;  // Zpec
+
+    localparam [3:0] ALU_ADD  = 4'd0;
+    localparam [3:0] ALU_SUB  = 4'd1;
+    localparam [3:0] ALU_SLL  = 4'd2;
+    localparam [3:0] ALU_SLT  = 4'd3;
+    localparam [3:0] ALU_SLTU = 4'd4;
+    localparam [3:0] ALU_XOR  = 4'd5;
+    localparam [3:0] ALU_SRL  = 4'd6;
+    localparam [3:0] ALU_SRA  = 4'd7;
+    localparam [3:0] ALU_OR   = 4'd8;
+    localparam [3:0] ALU_AND  = 4'd9;
+    localparam [3:0] ALU_PASS = 4'd10;     // operand B (LUI)
+
+    localparam [31:0] CAUSE_MISALIGNED_FETCH = 32'd0;
+    localparam [31:0] CAUSE_ILLEGAL_INSTR    = 32'd2;
+    localparam [31:0] CAUSE_BREAKPOINT       = 32'd3;
+    localparam [31:0] CAUSE_MISALIGNED_LOAD  = 32'd4;
+    localparam [31:0] CAUSE_LOAD_FAULT       = 32'd5;
+    localparam [31:0] CAUSE_MISALIGNED_STORE = 32'd6;
+    localparam [31:0] CAUSE_STORE_FAULT      = 32'd7;
+    localparam [31:0] CAUSE_ECALL_M          = 32'd11;
+
+`ifdef ZPEC_ENABLED
+    localparam [31:0] MISA_RV32IM = 32'h40801100;   // + X (non-standard)
+`else
+    localparam [31:0] MISA_RV32IM = 32'h40001100;
+`endif
+    localparam [31:0] MIP_MASK    = 32'hFFFF0888;
+
+    localparam [6:0]  MCOUNTINHIBIT_MASK = 7'b1111101;   // CY, IR, HPM3-6
+
+    //--------------------------------------------------------------------------
+    // Pipeline registers
+    //--------------------------------------------------------------------------
+
+    // IF/ID
+    reg        ifid_valid;
+    reg [31:0] ifid_pc;
+    reg [31:0] ifid_instr;
+
+    // ID/EX
+    reg        idex_valid;
+    reg [31:0] idex_pc;
+    reg [31:0] idex_rs1_val;
+    reg [31:0] idex_rs2_val;
+    reg [4:0]  idex_rs1;
+    reg [4:0]  idex_rs2;
+    reg [4:0]  idex_rd;
+    reg [31:0] idex_imm;
+    reg [3:0]  idex_alu_op;
+    reg        idex_a_pc;          // operand A = pc
+    reg        idex_a_zero;        // operand A = 0
+    reg        idex_b_imm;         // operand B = immediate
+    reg        idex_rd_wen;
+    reg        idex_is_load;
+    reg        idex_is_store;
+    reg        idex_is_branch;
+    reg        idex_is_jal;
+    reg        idex_is_jalr;
+    reg        idex_is_m;
+    reg        idex_is_zpec;
+    reg        idex_is_csr;
+    reg        idex_is_mret;
+    reg        idex_is_fencei;
+    reg [2:0]  idex_funct3;
+    reg        idex_exc;
+    reg [31:0] idex_exc_cause;
+    reg [31:0] idex_exc_tval;
+
+    // EX/MEM
+    reg        exmem_valid;
+    reg [31:0] exmem_pc;
+    reg [31:0] exmem_result;
+    reg [31:0] exmem_store_data;
+    reg [4:0]  exmem_rs1;
+    reg [4:0]  exmem_rd;
+    reg        exmem_rd_wen;
+    reg        exmem_is_load;
+    reg        exmem_is_store;
+    reg        exmem_is_csr;
+    reg        exmem_is_mret;
+    reg        exmem_is_fencei;
+    reg [2:0]  exmem_funct3;
+    reg [11:0] exmem_csr_addr;
+    reg [31:0] exmem_csr_src;
+    reg        exmem_exc;
+    reg [31:0] exmem_exc_cause;
+    reg [31:0] exmem_exc_tval;
+
+    // MEM/WB
+    reg        memwb_valid;
+    reg [4:0]  memwb_rd;
+    reg        memwb_rd_wen;
+    reg [31:0] memwb_wdata;
+
+    //--------------------------------------------------------------------------
+    // Register file (x0 reads as zero)
+    //--------------------------------------------------------------------------
+
+    reg [31:0] regs [1:31];
+
+    wire wb_write = memwb_valid && memwb_rd_wen && (memwb_rd != 5'd0);
+
+    always @(posedge clk) begin
+        if (wb_write)
+            regs[memwb_rd] <= memwb_wdata;
+    end
+
+    //--------------------------------------------------------------------------
+    // CSR state
+    //--------------------------------------------------------------------------
+
+    reg        mstatus_mie;
+    reg        mstatus_mpie;
+    reg [31:0] csr_mie;
+    reg [31:0] csr_mtvec;
+    reg [31:0] csr_mscratch;
+    reg [31:0] csr_mepc;
+    reg [31:0] csr_mcause;
+    reg [31:0] csr_mtval;
+    reg [63:0] csr_mcycle;
+    reg [63:0] csr_minstret;
+    reg [6:0]  csr_mcountinhibit;
+
+    // mhpmcounter3-6 and mhpmevent3-6, counter n at slice n - 3
+    reg [4*64-1:0] hpm_count;
+    reg [4*4-1:0]  hpm_event;
+
+    wire [31:0] csr_mip     = interrupts & MIP_MASK;
+    wire [31:0] csr_mstatus = {19'd0, 2'b11, 3'd0, mstatus_mpie, 3'd0, mstatus_mie, 3'd0};
+
+    //--------------------------------------------------------------------------
+    // Stall / flush control (driven below)
+    //--------------------------------------------------------------------------
+
+    wire        stall_m;            // MEM waiting for the data bus
+    wire        stall_x;            // EX held (MDU busy or MEM stalled)
+    wire        stall_d;            // ID held (load-use or EX stalled)
+    wire        trap_commit;        // MEM takes a trap or interrupt
+    wire        mem_redirect;       // trap, MRET or FENCE.I in MEM
+    wire [31:0] mem_redirect_pc;
+    wire        ex_redirect;        // taken branch / jump in EX
+    wire [31:0] ex_redirect_pc;
+
+    wire        redirect    = mem_redirect || ex_redirect;
+    wire [31:0] redirect_pc = mem_redirect ? mem_redirect_pc : ex_redirect_pc;
+
+    //==========================================================================
+    // IF
+    //==========================================================================
+
+    reg [31:0] fetch_pc;            // address on iwb / next to fetch
+    reg        fetch_discard;       // in-flight word belongs to a dead path
+    reg [31:0] fetch_target;        // where to fetch after the discard
+    reg        fetch_pending;       // iwb cycle started in an earlier clock
+
+    // Fetch whenever IF/ID can take a word; once raised, stb stays up until
+    // ack because IF/ID cannot fill without one.
+    wire ifid_accept = !ifid_valid || !stall_d;
+
+    assign iwb_cyc_o = ifid_accept || fetch_pending;
+    assign iwb_stb_o = iwb_cyc_o;
+    assign iwb_adr_o = fetch_pc;
+
+    wire fetch_done = iwb_stb_o && iwb_ack_i;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            fetch_pc      <= RESET_PC;
+            fetch_discard <= 1'b0;
+            fetch_target  <= RESET_PC;
+            fetch_pending <= 1'b0;
+        end else begin
+            fetch_pending <= iwb_stb_o && !iwb_ack_i;
+
+            if (redirect) begin
+                if (iwb_stb_o && !iwb_ack_i) begin
+                    // Wishbone classic: finish the cycle, then drop the word
+                    fetch_discard <= 1'b1;
+                    fetch_target  <= redirect_pc;
+                end else begin
+                    fetch_discard <= 1'b0;
+                    fetch_pc      <= redirect_pc;
+                end
+            end else if (fetch_done) begin
+                if (fetch_discard) begin
+                    fetch_discard <= 1'b0;
+                    fetch_pc      <= fetch_target;
+                end else begin
+                    fetch_pc      <= fetch_pc + 32'd4;
+                end
+            end
+        end
+    end
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            ifid_valid <= 1'b0;
+            ifid_pc    <= 32'd0;
+            ifid_instr <= 32'h00000013;
+        end else if (redirect) begin
+            ifid_valid <= 1'b0;
+        end else if (!stall_d) begin
+            ifid_valid <= fetch_done && !fetch_discard;
+            ifid_pc    <= fetch_pc;
+            ifid_instr <= iwb_dat_i;
+        end else if (!ifid_valid && fetch_done && !fetch_discard) begin
+            // ID empty but held behind a stall: park the word
+            ifid_valid <= 1'b1;
+            ifid_pc    <= fetch_pc;
+            ifid_instr <= iwb_dat_i;
+        end
+    end
+
+    //==========================================================================
+    // ID
+    //==========================================================================
+
+    wire [31:0] id_instr  = ifid_instr;
+    wire [6:0]  id_opcode = id_instr[6:0];
+    wire [2:0]  id_funct3 = id_instr[14:12];
+    wire [6:0]  id_funct7 = id_instr[31:25];
+    wire [4:0]  id_rs1    = id_instr[19:15];
+    wire [4:0]  id_rs2    = id_instr[24:20];
+    wire [4:0]  id_rd     = id_instr[11:7];
+
+    wire [31:0] imm_i = {{21{id_instr[31]}}, id_instr[30:20]};
+    wire [31:0] imm_s = {{21{id_instr[31]}}, id_instr[30:25], id_instr[11:7]};
+    wire [31:0] imm_b = {{20{id_instr[31]}}, id_instr[7], id_instr[30:25], id_instr[11:8], 1'b0};
+    wire [31:0] imm_u = {id_instr[31:12], 12'd0};
+    wire [31:0] imm_j = {{12{id_instr[31]}}, id_instr[19:12], id_instr[20], id_instr[30:21], 1'b0};
+
+    // Decoded controls
+    reg [31:0] id_imm;
+    reg [3:0]  id_alu_op;
+    reg        id_a_pc, id_a_zero, id_b_imm;
+    reg        id_rd_wen, id_is_load, id_is_store, id_is_branch;
+    reg        id_is_jal, id_is_jalr, id_is_m, id_is_zpec, id_is_csr;
+    reg        id_is_mret, id_is_fencei, id_is_ecall, id_is_ebreak;
+    reg        id_uses_rs1, id_uses_rs2;
+    reg        id_illegal;
+
+    always @(*) begin
+        id_imm       = imm_i;
+        id_alu_op    = ALU_ADD;
+        id_a_pc      = 1'b0;
+        id_a_zero    = 1'b0;
+        id_b_imm     = 1'b0;
+        id_rd_wen    = 1'b0;
+        id_is_load   = 1'b0;
+        id_is_store  = 1'b0;
+        id_is_branch = 1'b0;
+        id_is_jal    = 1'b0;
+        id_is_jalr   = 1'b0;
+        id_is_m      = 1'b0;
+        id_is_zpec   = 1'b0;
+        id_is_csr    = 1'b0;
+        id_is_mret   = 1'b0;
+        id_is_fencei = 1'b0;
+        id_is_ecall  = 1'b0;
+        id_is_ebreak = 1'b0;
+        id_uses_rs1  = 1'b0;
+        id_uses_rs2  = 1'b0;
+        id_illegal   = (id_instr[1:0] != 2'b11);
+
+        case (id_opcode)
+            OP_LUI: begin
+                id_imm    = imm_u;
+                id_alu_op = ALU_PASS;
+                id_b_imm  = 1'b1;
+                id_rd_wen = 1'b1;
+            end
+
+            OP_AUIPC: begin
+                id_imm    = imm_u;
+                id_a_pc   = 1'b1;
+                id_b_imm  = 1'b1;
+                id_rd_wen = 1'b1;
+            end
+
+            OP_JAL: begin
+                id_imm    = imm_j;
+                id_is_jal = 1'b1;
+                id_rd_wen = 1'b1;
+            end
+
+            OP_JALR: begin
+                id_is_jalr  = 1'b1;
+                id_b_imm    = 1'b1;
+                id_rd_wen   = 1'b1;
+                id_uses_rs1 = 1'b1;
+                if (id_funct3 != 3'b000) id_illegal = 1'b1;
+            end
+
+            OP_BRANCH: begin
+                id_imm       = imm_b;
+                id_is_branch = 1'b1;
+                id_uses_rs1  = 1'b1;
+                id_uses_rs2  = 1'b1;
+                if (id_funct3 == 3'b010 || id_funct3 == 3'b011) id_illegal = 1'b1;
+            end
+
+            OP_LOAD: begin
+                id_is_load  = 1'b1;
+                id_b_imm    = 1'b1;
+                id_rd_wen   = 1'b1;
+                id_uses_rs1 = 1'b1;
+                if (id_funct3 == 3'b011 || id_funct3[2:1] == 2'b11) id_illegal = 1'b1;
+            end
+
+            OP_STORE: begin
+                id_imm      = imm_s;
+                id_is_store = 1'b1;
+                id_b_imm    = 1'b1;
+                id_uses_rs1 = 1'b1;
+                id_uses_rs2 = 1'b1;
+                if (id_funct3[2] || id_funct3[1:0] == 2'b11) id_illegal = 1'b1;
+            end
+
+            OP_IMM: begin
+                id_b_imm    = 1'b1;
+                id_rd_wen   = 1'b1;
+                id_uses_rs1 = 1'b1;
+                case (id_funct3)
+                    3'b000: id_alu_op = ALU_ADD;
+                    3'b010: id_alu_op = ALU_SLT;
+                    3'b011: id_alu_op = ALU_SLTU;
+                    3'b100: id_alu_op = ALU_XOR;
+                    3'b110: id_alu_op = ALU_OR;
+                    3'b111: id_alu_op = ALU_AND;
+                    3'b001: begin
+                        id_alu_op = ALU_SLL;
+                        if (id_funct7 != 7'b0000000) id_illegal = 1'b1;
+                    end
+                    3'b101: begin
+                        id_alu_op = id_funct7[5] ? ALU_SRA : ALU_SRL;
+                        if ((id_funct7 & 7'b1011111) != 7'b0000000) id_illegal = 1'b1;
+                    end
+                endcase
+            end
+
+            OP_REG: begin
+                id_rd_wen   = 1'b1;
+                id_uses_rs1 = 1'b1;
+                id_uses_rs2 = 1'b1;
+                if (id_funct7 == 7'b0000001) begin
+                    id_is_m = 1'b1;
+                end else if (id_funct7 == 7'b0000000) begin
+                    case (id_funct3)
+                        3'b000: id_alu_op = ALU_ADD;
+                        3'b001: id_alu_op = ALU_SLL;
+                        3'b010: id_alu_op = ALU_SLT;
+                        3'b011: id_alu_op = ALU_SLTU;
+                        3'b100: id_alu_op = ALU_XOR;
+                        3'b101: id_alu_op = ALU_SRL;
+                        3'b110: id_alu_op = ALU_OR;
+                        3'b111: id_alu_op = ALU_AND;
+                    endcase
+                end else if (id_funct7 == 7'b0100000 && id_funct3 == 3'b000) begin
+                    id_alu_op = ALU_SUB;
+                end else if (id_funct7 == 7'b0100000 && id_funct3 == 3'b101) begin
+                    id_alu_op = ALU_SRA;
+                end else begin
+                    id_illegal = 1'b1;
+                end
+            end
+
+            OP_FENCE: begin
+                // FENCE is a no-op on this in-order core; FENCE.I refetches
+                if (id_funct3 == 3'b001)
+                    id_is_fencei = 1'b1;
+                else if (id_funct3 != 3'b000)
+                    id_illegal = 1'b1;
+            end
+
+            OP_SYSTEM: begin
+                if (id_funct3 == 3'b000) begin
+                    case (id_instr)
+                        32'h00000073: id_is_ecall  = 1'b1;
+                        32'h00100073: id_is_ebreak = 1'b1;
+                        32'h30200073: id_is_mret   = 1'b1;
+                        32'h10500073: ;                         // WFI: no-op
+                        default:      id_illegal   = 1'b1;
+                    endcase
+                end else if (id_funct3 == 3'b100) begin
+                    id_illegal = 1'b1;
+                end else begin
+                    id_is_csr   = 1'b1;
+                    id_rd_wen   = 1'b1;
+                    id_uses_rs1 = !id_funct3[2];
+                end
+            end
+
+`ifdef ZPEC_ENABLED
+            OP_CUSTOM0: begin
+                // funct7 != 0 is reserved (zpec_unit 'valid' low)
+                id_is_zpec  = 1'b1;
+                id_rd_wen   = 1'b1;
+                id_uses_rs1 = 1'b1;
+                id_uses_rs2 = 1'b1;
+                if (id_funct7 != 7'b0000000) id_illegal = 1'b1;
+            end
+`endif
+
+            default: id_illegal = 1'b1;
+        endcase
+    end
+
+    // Register read with write-back bypass
+    wire [31:0] id_rs1_val = (id_rs1 == 5'd0) ? 32'd0 :
+                             (wb_write && memwb_rd == id_rs1) ? memwb_wdata : regs[id_rs1];
+    wire [31:0] id_rs2_val = (id_rs2 == 5'd0) ? 32'd0 :
+                             (wb_write && memwb_rd == id_rs2) ? memwb_wdata : regs[id_rs2];
+
+    // Load-use / CSR-use interlock: the value only exists once EX -> MEM
+    wire load_use = ifid_valid && idex_valid && (idex_is_load || idex_is_csr) &&
+                    idex_rd_wen && (idex_rd != 5'd0) &&
+                    ((id_uses_rs1 && id_rs1 == idex_rd) || (id_uses_rs2 && id_rs2 == idex_rd));
+
+    // Exceptions raised in decode travel with the instruction to MEM
+    wire        id_exc       = id_illegal || id_is_ecall || id_is_ebreak;
+    wire [31:0] id_exc_cause = id_illegal   ? CAUSE_ILLEGAL_INSTR :
+                               id_is_ebreak ? CAUSE_BREAKPOINT : CAUSE_ECALL_M;
+    wire [31:0] id_exc_tval  = id_illegal ? id_instr : id_is_ebreak ? ifid_pc : 32'd0;
+
+    //==========================================================================
+    // EX
+    //==========================================================================
+
+    // Forwarding: EX/MEM (ALU results only) has priority over MEM/WB
+    wire exmem_fwd_ok = exmem_valid && exmem_rd_wen && (exmem_rd != 5'd0) &&
+                        !exmem_is_load && !exmem_is_csr;
+
+    wire [31:0] ex_rs1 = (exmem_fwd_ok && exmem_rd == idex_rs1)  ? exmem_result :
+                         (wb_write && memwb_rd == idex_rs1)      ? memwb_wdata  : idex_rs1_val;
+    wire [31:0] ex_rs2 = (exmem_fwd_ok && exmem_rd == idex_rs2)  ? exmem_result :
+                         (wb_write && memwb_rd == idex_rs2)      ? memwb_wdata  : idex_rs2_val;
+
+    wire [31:0] alu_a = idex_a_zero ? 32'd0 : idex_a_pc ? idex_pc : ex_rs1;
+    wire [31:0] alu_b = idex_b_imm ? idex_imm : ex_rs2;
+
+    reg [31:0] alu_result;
+    always @(*) begin
+        case (idex_alu_op)
+            ALU_ADD:  alu_result = alu_a + alu_b;
+            ALU_SUB:  alu_result = alu_a - alu_b;
+            ALU_SLL:  alu_result = alu_a << alu_b[4:0];
+            ALU_SLT:  alu_result = {31'd0, $signed(alu_a) < $signed(alu_b)};
+            ALU_SLTU: alu_result = {31'd0, alu_a < alu_b};
+            ALU_XOR:  alu_result = alu_a ^ alu_b;
+            ALU_SRL:  alu_result = alu_a >> alu_b[4:0];
+            ALU_SRA:  alu_result = $signed(alu_a) >>> alu_b[4:0];
+            ALU_OR:   alu_result = alu_a | alu_b;
+            ALU_AND:  alu_result = alu_a & alu_b;
+            ALU_PASS: alu_result = alu_b;
+            default:  alu_result = 32'd0;
+        endcase
+    end
+
+    // Branch resolution
+    reg branch_cond;
+    always @(*) begin
+        case (idex_funct3)
+            3'b000:  branch_cond = (ex_rs1 == ex_rs2);
+            3'b001:  branch_cond = (ex_rs1 != ex_rs2);
+            3'b100:  branch_cond = ($signed(ex_rs1) <  $signed(ex_rs2));
+            3'b101:  branch_cond = ($signed(ex_rs1) >= $signed(ex_rs2));
+            3'b110:  branch_cond = (ex_rs1 <  ex_rs2);
+            3'b111:  branch_cond = (ex_rs1 >= ex_rs2);
+            default: branch_cond = 1'b0;
+        endcase
+    end
+
+    wire [31:0] ex_target = idex_is_jalr ? {alu_result[31:1], 1'b0} : (idex_pc + idex_imm);
+    wire        ex_taken  = idex_is_jal || idex_is_jalr || (idex_is_branch && branch_cond);
+    wire        ex_misaligned_target = ex_taken && (ex_target[1:0] != 2'b00);
+
+    // Kill by a trap in MEM has priority over everything in EX
+    wire ex_live = idex_valid && !mem_redirect;
+
+    assign ex_redirect    = ex_live && !idex_exc && ex_taken && !ex_misaligned_target && !stall_x;
+    assign ex_redirect_pc = ex_target;
+
+    // Multiply / divide (multi-cycle, handshake as in custom_riscv_core.v)
+    wire        mdu_busy;
+    wire        mdu_done;
+    wire [63:0] mdu_product;
+    wire [31:0] mdu_quotient;
+    wire [31:0] mdu_remainder;
+    reg         mdu_pending;        // started, not yet acknowledged
+    reg         mdu_owner;          // result belongs to the instruction in EX
+
+    wire ex_is_m     = ex_live && idex_is_m && !idex_exc;
+    wire mdu_start   = ex_is_m && !mdu_pending;
+    wire mdu_ready   = mdu_pending && mdu_owner && mdu_done;
+    wire mdu_wait    = ex_is_m && !mdu_ready;
+    wire mdu_ack     = mdu_done && mdu_pending && (!mdu_owner || !stall_m || mem_redirect);
+
+    mdu mdu_inst (
+        .clk(clk),
+        .rst_n(rst_n),
+        .start(mdu_start),
+        .ack(mdu_ack),
+        .funct3(idex_funct3),
+        .a(ex_rs1),
+        .b(ex_rs2),
+        .busy(mdu_busy),
+        .done(mdu_done),
+        .product(mdu_product),
+        .quotient(mdu_quotient),
+        .remainder(mdu_remainder)
+    );
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            mdu_pending <= 1'b0;
+            mdu_owner   <= 1'b0;
+        end else begin
+            if (mdu_start) begin
+                mdu_pending <= 1'b1;
+                mdu_owner   <= 1'b1;
+            end else begin
+                if (mdu_ack)
+                    mdu_pending <= 1'b0;
+                if (mdu_ack || mem_redirect)
+                    mdu_owner <= 1'b0;          // flushed: drain and drop the result
+            end
+        end
+    end
+
+    reg [31:0] mdu_result;
+    always @(*) begin
+        case (idex_funct3)
+            3'b000:                 mdu_result = mdu_product[31:0];
+            3'b001, 3'b010, 3'b011: mdu_result = mdu_product[63:32];
+            3'b100, 3'b101:         mdu_result = mdu_quotient;
+            default:                mdu_result = mdu_remainder;
+        endcase
+    end
+
+    // Zpec: combinational, selected like an ALU result. funct7 is
+    // idex_imm[11:5] (the I-immediate of an R-type word).
+    wire [31:0] zpec_result;
+`ifdef ZPEC_ENABLED
+    zpec_unit zpec_inst (
+        .funct3(idex_funct3),
+        .funct7(idex_imm[11:5]),
+        .rs1_data(ex_rs1),
+        .rs2_data(ex_rs2),
+        .result(zpec_result),
+        .valid()
+    );
+`else
+    assign zpec_result = 32'd0;
+`endif
+
+    wire [31:0] ex_result = (idex_is_jal || idex_is_jalr) ? (idex_pc + 32'd4) :
+                            idex_is_m    ? mdu_result  :
+                            idex_is_zpec ? zpec_result : alu_result;
+
+    //==========================================================================
+    // MEM
+    //==========================================================================
+
+    wire [1:0] mem_off = exmem_result[1:0];
+    wire mem_access = exmem_valid && (exmem_is_load || exmem_is_store) && !exmem_exc;
+    wire mem_misaligned = (exmem_funct3[1:0] == 2'b10 && mem_off != 2'b00) ||
+                          (exmem_funct3[1:0] == 2'b01 && mem_off[0]);
+
+    // Interrupts are taken in front of the instruction in MEM, unless it
+    // already has a data bus cycle in progress
+    reg         mem_bus_pending;
+    wire [31:0] irq_active = csr_mip & csr_mie;
+    wire        irq_take = exmem_valid && mstatus_mie && (irq_active != 32'd0) && !mem_bus_pending;
+
+    reg [4:0] irq_code;
+    integer k;
+    always @(*) begin
+        irq_code = 5'd7;
+        if (irq_active[3])  irq_code = 5'd3;
+        if (irq_active[11]) irq_code = 5'd11;
+        for (k = 31; k >= 16; k = k - 1)
+            if (irq_active[k]) irq_code = k[4:0];
+    end
+
+    wire bus_go = mem_access && !mem_misaligned && !irq_take;
+
+    reg [3:0]  mem_sel;
+    reg [31:0] mem_wdata;
+    always @(*) begin
+        case (exmem_funct3[1:0])
+            2'b00: begin
+                mem_sel   = 4'b0001 << mem_off;
+                mem_wdata = {4{exmem_store_data[7:0]}};
+            end
+            2'b01: begin
+                mem_sel   = mem_off[1] ? 4'b1100 : 4'b0011;
+                mem_wdata = {2{exmem_store_data[15:0]}};
+            end
+            default: begin
+                mem_sel   = 4'b1111;
+                mem_wdata = exmem_store_data;
+            end
+        endcase
+    end
+
+    assign dwb_adr_o = exmem_result;
+    assign dwb_dat_o = mem_wdata;
+    assign dwb_we_o  = exmem_is_store;
+    assign dwb_sel_o = mem_sel;
+    assign dwb_cyc_o = bus_go;
+    assign dwb_stb_o = bus_go;
+
+    assign stall_m = bus_go && !dwb_ack_i && !dwb_err_i;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n)
+            mem_bus_pending <= 1'b0;
+        else
+            mem_bus_pending <= stall_m;
+    end
+
+    // Load data alignment
+    wire [31:0] load_shifted = dwb_dat_i >> {mem_off, 3'b000};
+    reg  [31:0] load_data;
+    always @(*) begin
+        case (exmem_funct3)
+            3'b000:  load_data = {{24{load_shifted[7]}},  load_shifted[7:0]};
+            3'b001:  load_data = {{16{load_shifted[15]}}, load_shifted[15:0]};
+            3'b100:  load_data = {24'd0, load_shifted[7:0]};
+            3'b101:  load_data = {16'd0, load_shifted[15:0]};
+            default: load_data = dwb_dat_i;
+        endcase
+    end
+
+    // Exceptions resolved in MEM (decode/EX ones first)
+    wire        mem_exc = exmem_valid && !irq_take &&
+                          (exmem_exc || (mem_access && mem_misaligned) || (bus_go && dwb_err_i));
+    wire [31:0] mem_exc_cause = exmem_exc      ? exmem_exc_cause :
+                                mem_misaligned ? (exmem_is_store ? CAUSE_MISALIGNED_STORE : CAUSE_MISALIGNED_LOAD) :
+                                                 (exmem_is_store ? CAUSE_STORE_FAULT : CAUSE_LOAD_FAULT);
+    wire [31:0] mem_exc_tval  = exmem_exc ? exmem_exc_tval : exmem_result;
+
+    assign trap_commit = irq_take || mem_exc;
+
+    wire [31:0] trap_cause = irq_take ? {1'b1, 26'd0, irq_code} : mem_exc_cause;
+    wire [31:0] trap_tval  = irq_take ? 32'd0 : mem_exc_tval;
+    wire [31:0] trap_vector = (irq_take && csr_mtvec[1:0] == 2'b01) ?
+                              {csr_mtvec[31:2], 2'b00} + {25'd0, irq_code, 2'b00} :
+                              {csr_mtvec[31:2], 2'b00};
+
+    wire mem_commit = exmem_valid && !trap_commit && !stall_m;
+
+    assign mem_redirect    = trap_commit || (mem_commit && (exmem_is_mret || exmem_is_fencei));
+    assign mem_redirect_pc = trap_commit   ? trap_vector :
+                             exmem_is_mret ? csr_mepc : (exmem_pc + 32'd4);
+
+    // CSR access
+    wire [11:0] csr_addr = exmem_csr_addr;
+    reg  [31:0] csr_rdata;
+    always @(*) begin
+        case (csr_addr)
+            12'h300: csr_rdata = csr_mstatus;
+            12'h301: csr_rdata = MISA_RV32IM;
+            12'h304: csr_rdata = csr_mie;
+            12'h305: csr_rdata = csr_mtvec;
+            12'h340: csr_rdata = csr_mscratch;
+            12'h341: csr_rdata = csr_mepc;
+            12'h342: csr_rdata = csr_mcause;
+            12'h343: csr_rdata = csr_mtval;
+            12'h344: csr_rdata = csr_mip;
+            12'hB00, 12'hC00: csr_rdata = csr_mcycle[31:0];
+            12'hB80, 12'hC80: csr_rdata = csr_mcycle[63:32];
+            12'hB02, 12'hC02: csr_rdata = csr_minstret[31:0];
+            12'hB82, 12'hC82: csr_rdata = csr_minstret[63:32];
+            12'hB03, 12'hC03: csr_rdata = hpm_count[0*64 +: 32];
+            12'hB83, 12'hC83: csr_rdata = hpm_count[0*64+32 +: 32];
+            12'hB04, 12'hC04: csr_rdata = hpm_count[1*64 +: 32];
+            12'hB84, 12'hC84: csr_rdata = hpm_count[1*64+32 +: 32];
+            12'hB05, 12'hC05: csr_rdata = hpm_count[2*64 +: 32];
+            12'hB85, 12'hC85: csr_rdata = hpm_count[2*64+32 +: 32];
+            12'hB06, 12'hC06: csr_rdata = hpm_count[3*64 +: 32];
+            12'hB86, 12'hC86: csr_rdata = hpm_count[3*64+32 +: 32];
+            12'h320: csr_rdata = {25'd0, csr_mcountinhibit};
+            12'h323: csr_rdata = {28'd0, hpm_event[0*4 +: 4]};
+            12'h324: csr_rdata = {28'd0, hpm_event[1*4 +: 4]};
+            12'h325: csr_rdata = {28'd0, hpm_event[2*4 +: 4]};
+            12'h326: csr_rdata = {28'd0, hpm_event[3*4 +: 4]};
+            default: csr_rdata = 32'd0;     // mvendorid/marchid/mimpid/mhartid, unimplemented
+        endcase
+    end
+
+    // CSRRS/CSRRC with rs1 = x0 (or zimm = 0) read without writing; for the
+    // immediate forms the rs1 field is the zimm operand
+    wire        csr_write = mem_commit && exmem_is_csr &&
+                            (exmem_funct3[1:0] == 2'b01 || exmem_rs1 != 5'd0);
+    reg  [31:0] csr_wdata;
+    always @(*) begin
+        case (exmem_funct3[1:0])
+            2'b01:   csr_wdata = exmem_csr_src;
+            2'b10:   csr_wdata = csr_rdata | exmem_csr_src;
+            default: csr_wdata = csr_rdata & ~exmem_csr_src;
+        endcase
+    end
+
+    wire [31:0] mem_wb_value = exmem_is_load ? load_data :
+                               exmem_is_csr  ? csr_rdata : exmem_result;
+
+    //==========================================================================
+    // Pipeline advance
+    //==========================================================================
+
+    assign stall_x = stall_m || (mdu_wait && !mem_redirect);
+    assign stall_d = stall_x || load_use;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            idex_valid  <= 1'b0;
+            exmem_valid <= 1'b0;
+            memwb_valid <= 1'b0;
+            memwb_rd_wen <= 1'b0;
+        end else begin
+            //------------------------------------------------------------------
+            // ID -> EX
+            //------------------------------------------------------------------
+            if (mem_redirect || (ex_redirect && !stall_x)) begin
+                idex_valid <= 1'b0;
+            end else if (stall_x) begin
+                // Hold, but keep forwarded operands: the producers may retire
+                // before EX is released
+                idex_rs1_val <= ex_rs1;
+                idex_rs2_val <= ex_rs2;
+            end else if (stall_d) begin
+                idex_valid <= 1'b0;                    // load-use bubble
+            end else begin
+                idex_valid     <= ifid_valid;
+                idex_pc        <= ifid_pc;
+                idex_rs1_val   <= id_rs1_val;
+                idex_rs2_val   <= id_rs2_val;
+                idex_rs1       <= id_rs1;
+                idex_rs2       <= id_rs2;
+                idex_rd        <= id_rd;
+                idex_imm       <= id_imm;
+                idex_alu_op    <= id_alu_op;
+                idex_a_pc      <= id_a_pc;
+                idex_a_zero    <= id_a_zero;
+                idex_b_imm     <= id_b_imm;
+                idex_rd_wen    <= id_rd_wen && !id_exc;
+                idex_is_load   <= id_is_load && !id_exc;
+                idex_is_store  <= id_is_store && !id_exc;
+                idex_is_branch <= id_is_branch;
+                idex_is_jal    <= id_is_jal;
+                idex_is_jalr   <= id_is_jalr;
+                idex_is_m      <= id_is_m;
+                idex_is_zpec   <= id_is_zpec;
+                idex_is_csr    <= id_is_csr;
+                idex_is_mret   <= id_is_mret;
+                idex_is_fencei <= id_is_fencei;
+                idex_funct3    <= id_funct3;
+                idex_exc       <= id_exc;
+                idex_exc_cause <= id_exc_cause;
+                idex_exc_tval  <= id_exc_tval;
+            end
+
+            //------------------------------------------------------------------
+            // EX -> MEM
+            //------------------------------------------------------------------
+            if (trap_commit) begin
+                exmem_valid <= 1'b0;
+            end else if (stall_m) begin
+                // hold
+            end else if (stall_x || mem_redirect) begin
+                exmem_valid <= 1'b0;                    // MDU busy or killed
+            end else begin
+                exmem_valid      <= idex_valid;
+                exmem_pc         <= idex_pc;
+                exmem_result     <= ex_result;
+                exmem_store_data <= ex_rs2;
+                exmem_rs1        <= idex_rs1;
+                exmem_rd         <= idex_rd;
+                exmem_rd_wen     <= idex_rd_wen && !ex_misaligned_target;
+                exmem_is_load    <= idex_is_load;
+                exmem_is_store   <= idex_is_store;
+                exmem_is_csr     <= idex_is_csr && !idex_exc;
+                exmem_is_mret    <= idex_is_mret;
+                exmem_is_fencei  <= idex_is_fencei;
+                exmem_funct3     <= idex_funct3;
+                exmem_csr_addr   <= idex_imm[11:0];
+                exmem_csr_src    <= idex_funct3[2] ? {27'd0, idex_rs1} : ex_rs1;
+                exmem_exc        <= idex_exc || ex_misaligned_target;
+                exmem_exc_cause  <= idex_exc ? idex_exc_cause : CAUSE_MISALIGNED_FETCH;
+                exmem_exc_tval   <= idex_exc ? idex_exc_tval : ex_target;
+            end
+
+            //------------------------------------------------------------------
+            // MEM -> WB
+            //------------------------------------------------------------------
+            memwb_valid  <= mem_commit;
+            memwb_rd     <= exmem_rd;
+            memwb_rd_wen <= exmem_rd_wen;
+            memwb_wdata  <= mem_wb_value;
+        end
+    end
+
+    //--------------------------------------------------------------------------
+    // CSR and trap state update
+    //--------------------------------------------------------------------------
+
+    wire retire = memwb_valid;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            mstatus_mie  <= 1'b0;
+            mstatus_mpie <= 1'b0;
+            csr_mie      <= 32'd0;
+            csr_mtvec    <= 32'd0;
+            csr_mscratch <= 32'd0;
+            csr_mepc     <= 32'd0;
+            csr_mcause   <= 32'd0;
+            csr_mtval    <= 32'd0;
+            csr_mcycle   <= 64'd0;
+            csr_minstret <= 64'd0;
+            csr_mcountinhibit <= 7'd0;
+        end else begin
+            if (!csr_mcountinhibit[0])
+                csr_mcycle   <= csr_mcycle + 64'd1;
+            if (retire && !csr_mcountinhibit[2])
+                csr_minstret <= csr_minstret + 64'd1;
+
+            if (trap_commit) begin
+                csr_mepc     <= exmem_pc;
+                csr_mcause   <= trap_cause;
+                csr_mtval    <= trap_tval;
+                mstatus_mpie <= mstatus_mie;
+                mstatus_mie  <= 1'b0;
+            end else if (mem_commit && exmem_is_mret) begin
+                mstatus_mie  <= mstatus_mpie;
+                mstatus_mpie <= 1'b1;
+            end else if (csr_write) begin
+                case (csr_addr)
+                    12'h300: begin
+                        mstatus_mie  <= csr_wdata[3];
+                        mstatus_mpie <= csr_wdata[7];
+                    end
+                    12'h304: csr_mie      <= csr_wdata & MIP_MASK;
+                    12'h305: csr_mtvec    <= {csr_wdata[31:2], 1'b0, csr_wdata[0]};
+                    12'h340: csr_mscratch <= csr_wdata;
+                    12'h341: csr_mepc     <= {csr_wdata[31:2], 2'b00};
+                    12'h342: csr_mcause   <= csr_wdata;
+                    12'h343: csr_mtval    <= csr_wdata;
+                    12'hB00: csr_mcycle[31:0]    <= csr_wdata;
+                    12'hB80: csr_mcycle[63:32]   <= csr_wdata;
+                    12'hB02: csr_minstret[31:0]  <= csr_wdata;
+                    12'hB82: csr_minstret[63:32] <= csr_wdata;
+                    12'h320: csr_mcountinhibit   <= csr_wdata[6:0] & MCOUNTINHIBIT_MASK;
+                    default: ;
+                endcase
+            end
+        end
+    end
+
+    //--------------------------------------------------------------------------
+    // Hardware performance monitor
+    //--------------------------------------------------------------------------
+
+    // One bit per event number (see the header); an event is counted once
+    // per cycle in which it is true
+    wire [15:0] hpm_events = {
+        6'd0,
+        irq_take,                                               // 9
+        ex_redirect && !idex_is_branch,                         // 8
+        ex_redirect && idex_is_branch,                          // 7
+        ex_live && !idex_exc && idex_is_branch && !stall_x,     // 6
+        mdu_wait && !mem_redirect,                              // 5
+        stall_m,                                                // 4
+        iwb_cyc_o && !iwb_ack_i,                                // 3
+        load_use && !stall_x && !redirect,                      // 2
+        ifid_valid && stall_d && !redirect,                     // 1
+        1'b0                                                    // 0
+    };
+
+    genvar h;
+    generate
+        for (h = 0; h < 4; h = h + 1) begin : hpm
+            wire [3:0] sel = hpm_event[h*4 +: 4];
+
+            always @(posedge clk or negedge rst_n) begin
+                if (!rst_n) begin
+                    hpm_count[h*64 +: 64] <= 64'd0;
+                    hpm_event[h*4 +: 4]   <= 4'd0;
+                end else begin
+                    if (hpm_events[sel] && !csr_mcountinhibit[h + 3])
+                        hpm_count[h*64 +: 64] <= hpm_count[h*64 +: 64] + 64'd1;
+
+                    if (csr_write) begin
+                        if (csr_addr == 12'hB03 + h)
+                            hpm_count[h*64 +: 32]    <= csr_wdata;
+                        if (csr_addr == 12'hB83 + h)
+                            hpm_count[h*64+32 +: 32] <= csr_wdata;
+                        if (csr_addr == 12'h323 + h)
+                            hpm_event[h*4 +: 4]      <= csr_wdata[3:0];
+                    end
+                end
+            end
+        end
+    endgenerate
+
+endmodule
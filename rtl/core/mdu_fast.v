@@ -0,0 +1,216 @@
+//==============================================================================
+// Fast Multiply/Divide Unit - Radix-4 with Early Termination
+//
+// Drop-in replacement for mdu.v (same module name and ports), selected at
+// build time with `./synthesize_soc.sh --mdu fast`. The core's handshake is
+// unchanged: pulse 'start', wait for 'done', read the result, pulse 'ack'.
+//
+// Both datapaths work on operand magnitudes and fix the sign at the end:
+//
+//   Multiply: radix-4 shift-add, two multiplier bits per cycle. The smaller
+//             magnitude is used as the multiplier and the loop stops as soon
+//             as its remaining bits are zero, so a Q15 x gain product takes
+//             8 cycles or less instead of 32.
+//   Divide:   two chained restoring steps per cycle. Leading zero bit pairs
+//             of the dividend are skipped, and dividend < divisor, x / 0 and
+//             0 / x finish without iterating.
+//
+// Latency (start to done, including the operand latch cycle):
+//
+//   Operation         mdu.v    mdu_fast.v
+//   MUL*, 16-bit op   33       9
+//   MUL*, 32-bit op   33       17
+//   DIV*/REM*         33       1 + ceil(significant dividend bits / 2)
+//   |rs1| < |rs2|, /0 33       1
+//
+// Results follow the RISC-V M specification, including division by zero
+// (quotient all ones, remainder = dividend) and signed overflow
+// (0x80000000 / -1 = 0x80000000, remainder 0).
+//==============================================================================
+
+module mdu (
+    input  wire        clk,
+    input  wire        rst_n,
+    input  wire        start,
+    input  wire        ack,
+    input  wire [2:0]  funct3,
+    input  wire [31:0] a,
+    input  wire [31:0] b,
+    output wire        busy,
+    output wire        done,
+    output reg  [63:0] product,
+    output reg  [31:0] quotient,
+    output reg  [31:0] remainder
+);
+
+    localparam [1:0] S_IDLE = 2'd0;
+    localparam [1:0] S_MUL  = 2'd1;
+    localparam [1:0] S_DIV  = 2'd2;
+    localparam [1:0] S_DONE = 2'd3;
+
+    reg [1:0] state;
+
+    assign busy = (state == S_MUL) || (state == S_DIV);
+    assign done = (state == S_DONE);
+
+    //--------------------------------------------------------------------------
+    // Operand decode (combinational, used in the latch cycle)
+    //--------------------------------------------------------------------------
+
+    wire is_div   = funct3[2];
+    // MUL/MULH/MULHSU/DIV/REM treat rs1 as signed; MUL/MULH/DIV/REM rs2
+    wire a_signed = is_div ? ~funct3[0] : (funct3 != 3'b011);
+    wire b_signed = is_div ? ~funct3[0] : ~funct3[1];
+
+    wire        a_neg = a_signed & a[31];
+    wire        b_neg = b_signed & b[31];
+    wire [31:0] a_mag = a_neg ? (~a + 32'd1) : a;
+    wire [31:0] b_mag = b_neg ? (~b + 32'd1) : b;
+
+    // Leading zeros of the dividend, rounded down to an even count
+    function [5:0] clz2;
+        input [31:0] x;
+        integer i;
+        begin
+            clz2 = 6'd32;
+            for (i = 0; i < 32; i = i + 2)
+                if (x[i +: 2] != 2'b00)
+                    clz2 = 6'd30 - i[5:0];
+        end
+    endfunction
+
+    wire [5:0] a_clz = clz2(a_mag);
+
+    //--------------------------------------------------------------------------
+    // Datapath registers
+    //--------------------------------------------------------------------------
+
+    reg [63:0] acc;             // multiply: partial product
+    reg [63:0] mcand;           // multiply: multiplicand << 2k
+    reg [63:0] mcand3;          // multiply: 3 x multiplicand << 2k
+    reg [31:0] mplier;          // multiply: remaining multiplier bits
+
+    reg [31:0] div_q;           // divide: dividend bits shifting out / quotient in
+    reg [31:0] div_r;           // divide: partial remainder
+    reg [31:0] div_d;           // divide: divisor magnitude
+    reg [4:0]  div_steps;       // divide: radix-4 steps left
+
+    reg        res_neg;         // negate product / quotient
+    reg        rem_neg;         // negate remainder
+
+    //--------------------------------------------------------------------------
+    // One radix-4 multiply step
+    //--------------------------------------------------------------------------
+
+    wire [63:0] mul_pp = (mplier[1:0] == 2'd0) ? 64'd0 :
+                         (mplier[1:0] == 2'd1) ? mcand :
+                         (mplier[1:0] == 2'd2) ? {mcand[62:0], 1'b0} : mcand3;
+    wire [63:0] mul_acc_next    = acc + mul_pp;
+    wire [31:0] mul_mplier_next = {2'b00, mplier[31:2]};
+
+    //--------------------------------------------------------------------------
+    // Two restoring divide steps
+    //--------------------------------------------------------------------------
+
+    wire [32:0] div_t1 = {div_r, div_q[31]};
+    wire [32:0] div_s1 = div_t1 - {1'b0, div_d};
+    wire        div_b1 = ~div_s1[32];
+    wire [31:0] div_r1 = div_b1 ? div_s1[31:0] : div_t1[31:0];
+
+    wire [32:0] div_t2 = {div_r1, div_q[30]};
+    wire [32:0] div_s2 = div_t2 - {1'b0, div_d};
+    wire        div_b2 = ~div_s2[32];
+    wire [31:0] div_r2 = div_b2 ? div_s2[31:0] : div_t2[31:0];
+
+    wire [31:0] div_q_next = {div_q[29:0], div_b1, div_b2};
+
+    //--------------------------------------------------------------------------
+    // Control
+    //--------------------------------------------------------------------------
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            state     <= S_IDLE;
+            product   <= 64'd0;
+            quotient  <= 32'd0;
+            remainder <= 32'd0;
+            acc       <= 64'd0;
+            mcand     <= 64'd0;
+            mcand3    <= 64'd0;
+            mplier    <= 32'd0;
+            div_q     <= 32'd0;
+            div_r     <= 32'd0;
+            div_d     <= 32'd0;
+            div_steps <= 5'd0;
+            res_neg   <= 1'b0;
+            rem_neg   <= 1'b0;
+        end else begin
+            case (state)
+                S_IDLE: begin
+                    if (start) begin
+                        res_neg <= a_neg ^ b_neg;
+                        rem_neg <= a_neg;
+
+                        if (!is_div) begin
+                            // Iterate over the narrower operand
+                            acc <= 64'd0;
+                            if (a_mag < b_mag) begin
+                                mcand  <= {32'd0, b_mag};
+                                mcand3 <= {32'd0, b_mag} + {31'd0, b_mag, 1'b0};
+                                mplier <= a_mag;
+                            end else begin
+                                mcand  <= {32'd0, a_mag};
+                                mcand3 <= {32'd0, a_mag} + {31'd0, a_mag, 1'b0};
+                                mplier <= b_mag;
+                            end
+                            state <= S_MUL;
+                        end else if (b == 32'd0) begin
+                            quotient  <= 32'hFFFFFFFF;
+                            remainder <= a;
+                            state     <= S_DONE;
+                        end else if (a_mag < b_mag) begin
+                            // Covers 0 / x: quotient 0, remainder is the dividend
+                            quotient  <= 32'd0;
+                            remainder <= a;
+                            state     <= S_DONE;
+                        end else begin
+                            div_q     <= a_mag << a_clz;
+                            div_r     <= 32'd0;
+                            div_d     <= b_mag;
+                            div_steps <= 5'd15 - a_clz[5:1];
+                            state     <= S_DIV;
+                        end
+                    end
+                end
+
+                S_MUL: begin
+                    acc    <= mul_acc_next;
+                    mcand  <= {mcand[61:0], 2'b00};
+                    mcand3 <= {mcand3[61:0], 2'b00};
+                    mplier <= mul_mplier_next;
+                    if (mul_mplier_next == 32'd0) begin
+                        product <= res_neg ? (~mul_acc_next + 64'd1) : mul_acc_next;
+                        state   <= S_DONE;
+                    end
+                end
+
+                S_DIV: begin
+                    div_q     <= div_q_next;
+                    div_r     <= div_r2;
+                    div_steps <= div_steps - 5'd1;
+                    if (div_steps == 5'd0) begin
+                        quotient  <= res_neg ? (~div_q_next + 32'd1) : div_q_next;
+                        remainder <= rem_neg ? (~div_r2 + 32'd1) : div_r2;
+                        state     <= S_DONE;
+                    end
+                end
+
+                S_DONE: begin
+                    if (ack)
+                        state <= S_IDLE;
+                end
+            endcase
+        end
+    end
+
+endmodule
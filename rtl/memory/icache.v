@@ -0,0 +1,190 @@
+//==============================================================================
+// Direct-Mapped Instruction Cache
+//
+// Sits between the core's instruction Wishbone port and the ROM / system
+// bus. Hits inside the cacheable window are answered in the same cycle as
+// the request (zero wait states); a miss fills the whole line with
+// LINE_WORDS sequential reads and then serves the fetch from the array.
+// Fetches outside the window, or with the cache disabled, pass straight
+// through to the bus.
+//
+//   SIZE_BYTES  = 1024       capacity (power of two)
+//   LINE_WORDS  = 4          words per line (power of two)
+//   CACHE_BASE  = ROM_BASE   cacheable window
+//   CACHE_SIZE  = 32 KB
+//
+// The cache does not snoop data writes. Software that writes instructions
+// (the bootloader programming the application region) must flush it, or
+// leave it disabled; it comes out of reset disabled.
+//
+// Control registers (Wishbone slave, PERIPH_BASE + 0x0600, see
+// firmware/soc_regs.json):
+//
+//   0x00 CTRL    [0] ENABLE, [1] FLUSH (self-clearing), [2] CLEAR_STATS
+//   0x04 HITS    fetches answered from the array (a miss is counted again
+//                when it is served after its fill)
+//   0x08 MISSES  line fills
+//   0x0C CONFIG  [15:0] size in bytes, [23:16] words per line
+//
+// Integration in soc_simple.v:
+//   core iwb_* -> icache c_*, icache m_* -> instruction bus / ROM port,
+//   icache r_* on the peripheral decoder at offset 0x0600.
+//==============================================================================
+
+module icache #(
+    parameter        SIZE_BYTES = 1024,
+    parameter        LINE_WORDS = 4,
+    parameter [31:0] CACHE_BASE = 32'h00000000,
+    parameter [31:0] CACHE_SIZE = 32'h00008000
+) (
+    input  wire        clk,
+    input  wire        rst_n,
+
+    // Core side (instruction fetch, read-only)
+    input  wire [31:0] c_adr_i,
+    input  wire        c_cyc_i,
+    input  wire        c_stb_i,
+    output wire        c_ack_o,
+    output wire [31:0] c_dat_o,
+
+    // Memory side
+    output wire [31:0] m_adr_o,
+    output wire        m_cyc_o,
+    output wire        m_stb_o,
+    input  wire        m_ack_i,
+    input  wire [31:0] m_dat_i,
+
+    // Control registers
+    input  wire [3:0]  r_adr_i,         // byte offset [3:0]
+    input  wire [31:0] r_dat_i,
+    output reg  [31:0] r_dat_o,
+    input  wire        r_we_i,
+    input  wire        r_cyc_i,
+    input  wire        r_stb_i,
+    output reg         r_ack_o
+);
+
+    localparam WORDS       = SIZE_BYTES / 4;
+    localparam LINES       = WORDS / LINE_WORDS;
+    localparam OFFSET_BITS = $clog2(LINE_WORDS);
+    localparam INDEX_BITS  = $clog2(LINES);
+    localparam TAG_BITS    = 30 - OFFSET_BITS - INDEX_BITS;
+
+    //--------------------------------------------------------------------------
+    // Storage
+    //--------------------------------------------------------------------------
+
+    reg [31:0]         data_ram [0:WORDS-1];
+    reg [TAG_BITS-1:0] tag_ram  [0:LINES-1];
+    reg [LINES-1:0]    line_valid;
+
+    //--------------------------------------------------------------------------
+    // Control registers
+    //--------------------------------------------------------------------------
+
+    reg        enable;
+    reg [31:0] hits;
+    reg [31:0] misses;
+
+    wire reg_write = r_cyc_i && r_stb_i && r_we_i && !r_ack_o;
+    wire flush     = reg_write && (r_adr_i[3:2] == 2'd0) && r_dat_i[1];
+    wire clr_stats = reg_write && (r_adr_i[3:2] == 2'd0) && r_dat_i[2];
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            enable  <= 1'b0;
+            r_ack_o <= 1'b0;
+            r_dat_o <= 32'd0;
+        end else begin
+            r_ack_o <= r_cyc_i && r_stb_i && !r_ack_o;
+            if (reg_write && r_adr_i[3:2] == 2'd0)
+                enable <= r_dat_i[0];
+            case (r_adr_i[3:2])
+                2'd0: r_dat_o <= {31'd0, enable};
+                2'd1: r_dat_o <= hits;
+                2'd2: r_dat_o <= misses;
+                2'd3: r_dat_o <= {8'd0, LINE_WORDS[7:0], SIZE_BYTES[15:0]};
+            endcase
+        end
+    end
+
+    //--------------------------------------------------------------------------
+    // Lookup
+    //--------------------------------------------------------------------------
+
+    wire [INDEX_BITS-1:0]  c_index  = c_adr_i[2+OFFSET_BITS +: INDEX_BITS];
+    wire [TAG_BITS-1:0]    c_tag    = c_adr_i[31 -: TAG_BITS];
+    wire [OFFSET_BITS-1:0] c_offset = c_adr_i[2 +: OFFSET_BITS];
+
+    wire request   = c_cyc_i && c_stb_i;
+    wire cacheable = enable && (c_adr_i >= CACHE_BASE) && (c_adr_i - CACHE_BASE < CACHE_SIZE);
+    wire hit       = line_valid[c_index] && (tag_ram[c_index] == c_tag);
+
+    //--------------------------------------------------------------------------
+    // Line fill
+    //--------------------------------------------------------------------------
+
+    reg                   filling;
+    reg                   fill_drop;        // flushed while filling: discard the line
+    reg [OFFSET_BITS-1:0] fill_count;
+
+    wire [31:0] fill_adr = {c_adr_i[31:2+OFFSET_BITS], fill_count, 2'b00};
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            filling    <= 1'b0;
+            fill_drop  <= 1'b0;
+            fill_count <= {OFFSET_BITS{1'b0}};
+            line_valid <= {LINES{1'b0}};
+            hits       <= 32'd0;
+            misses     <= 32'd0;
+        end else begin
+            if (clr_stats) begin
+                hits   <= 32'd0;
+                misses <= 32'd0;
+            end else if (request && cacheable && hit && !filling) begin
+                hits <= hits + 32'd1;
+            end else if (request && cacheable && !hit && !filling) begin
+                misses <= misses + 32'd1;
+            end
+
+            if (flush) begin
+                // A fill in progress still runs to the end of its bus cycles
+                line_valid <= {LINES{1'b0}};
+                fill_drop  <= filling;
+            end
+
+            if (!filling) begin
+                // The fetch address is held until ack, so it names the line
+                if (request && cacheable && !hit) begin
+                    filling    <= 1'b1;
+                    fill_drop  <= 1'b0;
+                    fill_count <= {OFFSET_BITS{1'b0}};
+                    line_valid[c_index] <= 1'b0;
+                end
+            end else if (m_ack_i) begin
+                data_ram[{c_index, fill_count}] <= m_dat_i;
+                fill_count <= fill_count + 1'b1;
+                if (fill_count == LINE_WORDS - 1) begin
+                    tag_ram[c_index]    <= c_tag;
+                    line_valid[c_index] <= !(fill_drop || flush);
+                    filling             <= 1'b0;
+                end
+            end
+        end
+    end
+
+    //--------------------------------------------------------------------------
+    // Port muxing
+    //--------------------------------------------------------------------------
+
+    wire bypass = request && !cacheable && !filling;
+
+    assign m_adr_o = filling ? fill_adr : c_adr_i;
+    assign m_cyc_o = filling || bypass;
+    assign m_stb_o = filling || bypass;
+
+    assign c_ack_o = bypass ? m_ack_i : (request && cacheable && hit && !filling);
+    assign c_dat_o = bypass ? m_dat_i : data_ram[{c_index, c_offset}];
+
+endmodule
@@ -0,0 +1,80 @@
+//==============================================================================
+// Tightly-Coupled Memory (dual-port, zero wait states)
+//
+// Private RAM for the control ISR hot path. The instruction port and the
+// data port each have their own path into the array, so neither ever waits
+// for the other, for the ROM, or for peripheral traffic on the system bus:
+// every access is acknowledged in the cycle it is requested. ISR timing out
+// of the TCM is therefore fixed by the instruction stream alone.
+//
+//   SIZE_BYTES = 8192        capacity (power of two)
+//   Map:         TCM_BASE = 0x00030000 (firmware/soc_regs.json)
+//
+// The instruction port is read-only. The firmware fills the TCM through the
+// data port at startup (startup.S copies .fast_text/.fast_data from their
+// ROM load addresses) before anything executes from it.
+//
+// Reads are asynchronous so the ack can be combinational; this maps to
+// distributed (LUT) RAM rather than block RAM, which is why the default
+// capacity is small.
+//
+// Integration in soc_simple.v:
+//   core iwb_* -> address decode: TCM window -> tcm i_*, else -> icache c_*
+//   core dwb_* -> address decode: TCM window -> tcm d_*, else -> system bus
+//==============================================================================
+
+module tcm #(
+    parameter SIZE_BYTES = 8192
+) (
+    input  wire        clk,
+
+    // Instruction port (read-only)
+    input  wire [31:0] i_adr_i,
+    input  wire        i_cyc_i,
+    input  wire        i_stb_i,
+    output wire        i_ack_o,
+    output wire [31:0] i_dat_o,
+
+    // Data port
+    input  wire [31:0] d_adr_i,
+    input  wire [31:0] d_dat_i,
+    output wire [31:0] d_dat_o,
+    input  wire [3:0]  d_sel_i,
+    input  wire        d_we_i,
+    input  wire        d_cyc_i,
+    input  wire        d_stb_i,
+    output wire        d_ack_o
+);
+
+    localparam WORDS     = SIZE_BYTES / 4;
+    localparam ADDR_BITS = $clog2(WORDS);
+
+    reg [31:0] mem [0:WORDS-1];
+
+    wire [ADDR_BITS-1:0] i_index = i_adr_i[2 +: ADDR_BITS];
+    wire [ADDR_BITS-1:0] d_index = d_adr_i[2 +: ADDR_BITS];
+
+    //--------------------------------------------------------------------------
+    // Instruction port
+    //--------------------------------------------------------------------------
+
+    assign i_ack_o = i_cyc_i && i_stb_i;
+    assign i_dat_o = mem[i_index];
+
+    //--------------------------------------------------------------------------
+    // Data port (byte-lane writes)
+    //--------------------------------------------------------------------------
+
+    assign d_ack_o = d_cyc_i && d_stb_i;
+    assign d_dat_o = mem[d_index];
+
+    always @(posedge clk) begin
+        if (d_cyc_i && d_stb_i && d_we_i) begin
+            if (d_sel_i[0]) mem[d_index][7:0]   <= d_dat_i[7:0];
+            if (d_sel_i[1]) mem[d_index][15:8]  <= d_dat_i[15:8];
+            if (d_sel_i[2]) mem[d_index][23:16] <= d_dat_i[23:16];
+            if (d_sel_i[3]) mem[d_index][31:24] <= d_dat_i[31:24];
+        end
+    end
+
+endmodule
@@ -0,0 +1,146 @@
+//==============================================================================
+// Fast-Path Protection Comparators on Raw ADC Codes
+//
+// Checks every decimated sample of the sigma-delta ADC against a window of
+// raw codes. A sample outside the window latches a trip, and the trip gates
+// the PWM outputs in the next clock. Overcurrent shutdown no longer waits
+// for the control ISR to read PROT.STATUS every 100 us: from the CIC output
+// to gates off, the latency is two clocks (40 ns at 50 MHz).
+//
+// Each channel has a LOW/HIGH window, and a sample trips when code < LOW or
+// code > HIGH. The current channel is bipolar around CURRENT_OFFSET, so its
+// window is symmetric. The voltage channels normally use HIGH only. Codes
+// are what the ADC delivers, so the firmware converts its engineering-unit
+// limits once at init (ADC_CODE_AMPS in chb_5level_control.c, which only
+// enables the current channel: the voltage channels saturate below the
+// nominal DC link).
+//
+// Channel 0 (I_out) reports as STATUS.OCP and channels 1-3 (V_out, V_dc1,
+// V_dc2) as STATUS.OVP, both through FAULT_MASK as usual. STATUS.CMP
+// names the channels that tripped. CMP_CAPTURE keeps the first offending
+// sample, and FAULT_CLEAR with the CMP bits clears both the trip and the
+// capture.
+//
+// Registers (in the PROT block, PERIPH_BASE + 0x0200, see
+// firmware/soc_regs.json):
+//
+//   0x0C FAULT_CLEAR  [11:8] clear comparator trips (w1c)
+//   0x20 CMP_CTRL     [3:0] EN per channel
+//   0x24 CMP0_WINDOW  [15:0] LOW, [31:16] HIGH  (I_out)
+//   0x28 CMP1_WINDOW                            (V_out)
+//   0x2C CMP2_WINDOW                            (V_dc1)
+//   0x30 CMP3_WINDOW                            (V_dc2)
+//   0x34 CMP_CAPTURE  [15:0] CODE, [17:16] CH, [31] VALID (ro)
+//
+// Integration in protection.v: forward register writes and reads at
+// 0x0C and 0x20-0x34 to reg_*. OR fault_ocp/fault_ovp into the OCP/OVP
+// fault inputs ahead of FAULT_MASK, and OR trip into STATUS[11:8].
+// pwm_kill joins the existing fault shutdown of the PWM outputs. The
+// sample_* inputs come from adc_interface: the CIC output strobe, the
+// channel and the code that is written to DATA_CHn and the FIFO.
+//==============================================================================
+
+module prot_fast_compare (
+    input  wire        clk,
+    input  wire        rst_n,
+
+    // Register access (byte offset inside the PROT block)
+    input  wire [7:0]  reg_adr,
+    input  wire [31:0] reg_wdata,
+    input  wire        reg_we,
+    output reg  [31:0] reg_rdata,
+
+    // Decimated ADC samples
+    input  wire        sample_valid,
+    input  wire [1:0]  sample_ch,
+    input  wire [15:0] sample_code,
+
+    // Protection block state
+    input  wire        prot_enable,     // PROT.CTRL.ENABLE
+    input  wire [1:0]  fault_mask,      // PROT.FAULT_MASK[1:0] (OVP, OCP)
+
+    output reg  [3:0]  trip,
+    output wire        fault_ocp,
+    output wire        fault_ovp,
+    output wire        pwm_kill
+);
+
+    localparam [7:0] REG_FAULT_CLEAR = 8'h0C;
+    localparam [7:0] REG_CMP_CTRL    = 8'h20;
+    localparam [7:0] REG_CMP_WINDOW  = 8'h24;   // + 4 * channel
+    localparam [7:0] REG_CMP_CAPTURE = 8'h34;
+
+    reg [3:0]  cmp_en;
+    reg [15:0] win_low  [0:3];
+    reg [15:0] win_high [0:3];
+    reg [17:0] capture;
+    reg        capture_valid;
+
+    assign fault_ocp = trip[0];
+    assign fault_ovp = |trip[3:1];
+    assign pwm_kill  = prot_enable && ((fault_ocp && fault_mask[0]) || (fault_ovp && fault_mask[1]));
+
+    //--------------------------------------------------------------------------
+    // Window compare on the incoming sample
+    //--------------------------------------------------------------------------
+
+    wire        out_of_window = (sample_code < win_low[sample_ch]) || (sample_code > win_high[sample_ch]);
+    wire        sample_trip   = sample_valid && cmp_en[sample_ch] && out_of_window;
+    wire [3:0]  trip_set      = sample_trip ? (4'b0001 << sample_ch) : 4'b0000;
+
+    wire        window_we = reg_we && (reg_adr >= REG_CMP_WINDOW) && (reg_adr < REG_CMP_CAPTURE);
+    wire [1:0]  window_ch = reg_adr[3:2] - 2'd1;        // 0x24 -> 0 ... 0x30 -> 3
+    wire [3:0]  trip_clr  = (reg_we && reg_adr == REG_FAULT_CLEAR) ? reg_wdata[11:8] : 4'b0000;
+
+    //--------------------------------------------------------------------------
+    // Registers and trip latches
+    //--------------------------------------------------------------------------
+
+    integer i;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            cmp_en        <= 4'b0000;
+            trip          <= 4'b0000;
+            capture       <= 18'd0;
+            capture_valid <= 1'b0;
+            for (i = 0; i < 4; i = i + 1) begin
+                win_low[i]  <= 16'h0000;
+                win_high[i] <= 16'hFFFF;
+            end
+        end else begin
+            if (reg_we && reg_adr == REG_CMP_CTRL) cmp_en <= reg_wdata[3:0];
+            if (window_we) begin
+                win_low[window_ch]  <= reg_wdata[15:0];
+                win_high[window_ch] <= reg_wdata[31:16];
+            end
+
+            // A trip in the same cycle as its clear wins
+            trip <= (trip & ~trip_clr) | trip_set;
+
+            if (sample_trip && (!capture_valid || (trip_clr != 4'b0000))) begin
+                capture       <= {sample_ch, sample_code};
+                capture_valid <= 1'b1;
+            end else if (trip_clr != 4'b0000 && (trip & ~trip_clr) == 4'b0000) begin
+                capture_valid <= 1'b0;
+            end
+        end
+    end
+
+    //--------------------------------------------------------------------------
+    // Read-back
+    //--------------------------------------------------------------------------
+
+    always @(*) begin
+        case (reg_adr)
+            REG_CMP_CTRL:    reg_rdata = {28'd0, cmp_en};
+            8'h24:           reg_rdata = {win_high[0], win_low[0]};
+            8'h28:           reg_rdata = {win_high[1], win_low[1]};
+            8'h2C:           reg_rdata = {win_high[2], win_low[2]};
+            8'h30:           reg_rdata = {win_high[3], win_low[3]};
+            REG_CMP_CAPTURE: reg_rdata = {capture_valid, 13'd0, capture};
+            default:         reg_rdata = 32'd0;
+        endcase
+    end
+
+endmodule
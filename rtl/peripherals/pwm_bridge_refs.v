@@ -0,0 +1,100 @@
+//==============================================================================
+// Per-Bridge CPU References for the PWM Accelerator
+//
+// In the default CPU mode every comparator of the accelerator compares its
+// carrier with the one CPU_REFERENCE. With CTRL.BRIDGE_REF set, the two
+// H-bridges get their own references instead, so the firmware can drive
+// them unequally (DC-link imbalance compensation, per-bridge limits) with
+// two register writes per control cycle instead of comparing per carrier
+// in software.
+//
+// The references are double-buffered. BRIDGE1_REF/BRIDGE2_REF write shadow
+// registers. Writing CTRL with UPDATE set arms a transfer, and the next
+// carrier sync pulse copies both shadows into the active references together.
+// A bridge therefore never switches on a half-written pair or in the middle
+// of a carrier period. CTRL.UPDATE reads 1 until the transfer has happened.
+// While the PWM is disabled no carrier runs, so an armed transfer completes
+// at once and the initial values are in place before ENABLE.
+//
+// Registers (in the PWM block, PERIPH_BASE + 0x0000, see
+// firmware/soc_regs.json):
+//
+//   0x00 CTRL         [3] BRIDGE_REF (with CPU_MODE), [4] UPDATE
+//                     (the old memory_map.h had an UPDATE at bit 1, which
+//                     is CPU_MODE in the shared map)
+//   0x24 BRIDGE1_REF  [15:0] signed Q15, H-bridge 1 (S1-S4), shadow
+//   0x28 BRIDGE2_REF  [15:0] signed Q15, H-bridge 2 (S5-S8), shadow
+//
+// Integration in pwm_accelerator.v: the register decoder drives ref*_we,
+// update_set (CTRL write with bit 4) and bridge_mode (CPU_MODE &
+// BRIDGE_REF). common_ref is the reference the comparators use today
+// (MOD_INDEX * sine or CPU_REFERENCE), and carrier_sync is the carrier
+// generator's period pulse. The comparators of bridge n take bridgeN_ref
+// in place of common_ref and keep their carriers and polarity.
+//==============================================================================
+
+module pwm_bridge_refs (
+    input  wire               clk,
+    input  wire               rst_n,
+
+    // Register writes
+    input  wire [15:0]        wdata,
+    input  wire               ref1_we,
+    input  wire               ref2_we,
+    input  wire               update_set,
+
+    // Carrier timing and mode
+    input  wire               enable,           // CTRL.ENABLE
+    input  wire               carrier_sync,     // one pulse per carrier period
+    input  wire               bridge_mode,      // CTRL.CPU_MODE & CTRL.BRIDGE_REF
+    input  wire signed [15:0] common_ref,
+
+    // Read-back
+    output reg  [15:0]        shadow1,
+    output reg  [15:0]        shadow2,
+    output reg                update_pending,
+
+    // References for the comparators of each bridge
+    output wire signed [15:0] bridge1_ref,
+    output wire signed [15:0] bridge2_ref
+);
+
+    reg signed [15:0] active1;
+    reg signed [15:0] active2;
+
+    assign bridge1_ref = bridge_mode ? active1 : common_ref;
+    assign bridge2_ref = bridge_mode ? active2 : common_ref;
+
+    //--------------------------------------------------------------------------
+    // Shadow registers
+    //--------------------------------------------------------------------------
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            shadow1 <= 16'd0;
+            shadow2 <= 16'd0;
+        end else begin
+            if (ref1_we) shadow1 <= wdata;
+            if (ref2_we) shadow2 <= wdata;
+        end
+    end
+
+    //--------------------------------------------------------------------------
+    // Transfer to the active references
+    //--------------------------------------------------------------------------
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            active1        <= 16'sd0;
+            active2        <= 16'sd0;
+            update_pending <= 1'b0;
+        end else if (update_pending && (carrier_sync || !enable)) begin
+            active1        <= shadow1;
+            active2        <= shadow2;
+            update_pending <= update_set;   // re-armed in the same cycle
+        end else if (update_set) begin
+            update_pending <= 1'b1;
+        end
+    end
+
+endmodule
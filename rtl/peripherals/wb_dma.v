@@ -0,0 +1,348 @@
+//==============================================================================
+// Two-Channel Wishbone DMA Engine with Descriptor Chaining
+//
+// Moves data between memory and peripherals without the CPU: ADC FIFO ->
+// RAM on channel 0, RAM -> UART TX on channel 1 (any channel can use any
+// request line). Each channel runs a chain of descriptors in RAM:
+//
+//   +0x0 SRC   source address
+//   +0x4 DST   destination address
+//   +0x8 CFG   [15:0]  COUNT   elements (0 = skip to NEXT)
+//              [17:16] SIZE    0 byte, 1 halfword, 2 word
+//              [18]    SRC_INC increment SRC by the element size
+//              [19]    DST_INC increment DST by the element size
+//              [21:20] REQ     0 free-running, 1 dreq[0] (ADC), 2 dreq[1]
+//                              (UART TX), 3 dreq[2]
+//              [22]    IRQ     set DONE when this descriptor completes
+//   +0xC NEXT  next descriptor (word aligned), 0 = end of chain
+//
+// A paced channel only starts an element while its request line is high:
+// ADC dreq = FIFO not empty, UART dreq = TX FIFO not full. The element is
+// read and written back-to-back, and the engine samples the request again
+// only after the write, so the FIFO flag has updated by then. A chain that
+// points back into itself runs until ABORT.
+//
+// One master port serves both channels, round-robin per element, so a
+// free-running copy cannot starve a paced channel.
+//
+// Registers (Wishbone slave, PERIPH_BASE + 0x0700, see
+// firmware/soc_regs.json), channel n at 0x20 * n:
+//
+//   0x00 CTRL    [0] START (fetch DESC, run the chain; ignored while
+//                BUSY), [1] ABORT, [2] IRQ_EN
+//   0x04 STATUS  [0] BUSY (ro), [1] DONE (w1c), [2] ERROR (w1c, bus error)
+//   0x08 DESC    next descriptor; write before START
+//   0x0C SRC     current source (ro)
+//   0x10 DST     current destination (ro)
+//   0x14 COUNT   elements left in the current descriptor (ro)
+//
+// irq = OR over channels of (DONE | ERROR) & IRQ_EN -> IRQ_DMA (mip[19]).
+//
+// Integration in soc_simple.v: m_* is a third master on the system bus
+// (wishbone_arbiter_2x1 -> 3x1, CPU data port first), r_* on the
+// peripheral decoder at offset 0x0700, dreq = {1'b0, uart_tx_ready,
+// adc_fifo_nonempty}.
+//==============================================================================
+
+module wb_dma (
+    input  wire        clk,
+    input  wire        rst_n,
+
+    // Control registers
+    input  wire [7:0]  r_adr_i,         // byte offset [7:0]
+    input  wire [31:0] r_dat_i,
+    output reg  [31:0] r_dat_o,
+    input  wire        r_we_i,
+    input  wire        r_cyc_i,
+    input  wire        r_stb_i,
+    output reg         r_ack_o,
+
+    // Bus master
+    output reg  [31:0] m_adr_o,
+    output reg  [31:0] m_dat_o,
+    input  wire [31:0] m_dat_i,
+    output reg         m_we_o,
+    output reg  [3:0]  m_sel_o,
+    output reg         m_cyc_o,
+    output wire        m_stb_o,
+    input  wire        m_ack_i,
+    input  wire        m_err_i,
+
+    // Peripheral requests
+    input  wire [2:0]  dreq,
+
+    output wire        irq
+);
+
+    localparam [2:0] S_IDLE  = 3'd0;
+    localparam [2:0] S_DESC  = 3'd1;
+    localparam [2:0] S_READ  = 3'd2;
+    localparam [2:0] S_WRITE = 3'd3;
+
+    assign m_stb_o = m_cyc_o;
+
+    //--------------------------------------------------------------------------
+    // Channel state
+    //--------------------------------------------------------------------------
+
+    reg [31:0] ch_src   [0:1];
+    reg [31:0] ch_dst   [0:1];
+    reg [31:0] ch_desc  [0:1];
+    reg [15:0] ch_count [0:1];
+    reg [1:0]  ch_size  [0:1];
+    reg [1:0]  ch_req   [0:1];
+    reg [1:0]  ch_src_inc;
+    reg [1:0]  ch_dst_inc;
+    reg [1:0]  ch_irq_desc;         // IRQ bit of the current descriptor
+
+    reg [1:0]  ch_run;              // chain active
+    reg [1:0]  ch_fetch;            // descriptor fetch pending
+    reg [1:0]  ch_done;
+    reg [1:0]  ch_error;
+    reg [1:0]  ch_irq_en;
+
+    assign irq = |((ch_done | ch_error) & ch_irq_en);
+
+    //--------------------------------------------------------------------------
+    // Channel selection (round-robin, one element or descriptor at a time)
+    //--------------------------------------------------------------------------
+
+    wire [3:0] dreq_ext = {dreq, 1'b1};             // REQ 0 = always ready
+
+    wire [1:0] ch_ready;
+    assign ch_ready[0] = ch_run[0] && (ch_fetch[0] || dreq_ext[ch_req[0]]);
+    assign ch_ready[1] = ch_run[1] && (ch_fetch[1] || dreq_ext[ch_req[1]]);
+
+    reg        last_ch;
+    wire       pick = (ch_ready[0] && ch_ready[1]) ? !last_ch : ch_ready[1];
+
+    //--------------------------------------------------------------------------
+    // Byte lanes
+    //--------------------------------------------------------------------------
+
+    reg        cur;                 // channel being served
+    reg [1:0]  desc_word;
+
+    function [3:0] lane_sel;
+        input [1:0] size;
+        input [1:0] off;
+        begin
+            case (size)
+                2'd0:    lane_sel = 4'b0001 << off;
+                2'd1:    lane_sel = off[1] ? 4'b1100 : 4'b0011;
+                default: lane_sel = 4'b1111;
+            endcase
+        end
+    endfunction
+
+    wire [1:0]  cur_size = ch_size[cur];
+    wire [31:0] step     = (cur_size == 2'd0) ? 32'd1 : (cur_size == 2'd1) ? 32'd2 : 32'd4;
+    wire [31:0] rd_shift = m_dat_i >> {ch_src[cur][1:0], 3'b000};
+    wire [31:0] rd_elem  = (cur_size == 2'd0) ? {24'd0, rd_shift[7:0]}  :
+                           (cur_size == 2'd1) ? {16'd0, rd_shift[15:0]} : m_dat_i;
+
+    //--------------------------------------------------------------------------
+    // Register interface
+    //--------------------------------------------------------------------------
+
+    reg [2:0]  state;
+
+    // BUSY stays up after ABORT until the element in flight has completed
+    wire [1:0] ch_busy = ch_run | ({2{state != S_IDLE}} & {cur, !cur});
+
+    wire       reg_write = r_cyc_i && r_stb_i && r_we_i && !r_ack_o;
+    wire       r_ch      = r_adr_i[5];
+    wire [2:0] r_reg     = r_adr_i[4:2];
+    wire       wr_ctrl   = reg_write && !r_adr_i[7:6] && r_reg == 3'd0;
+    wire       wr_status = reg_write && !r_adr_i[7:6] && r_reg == 3'd1;
+    wire       wr_desc   = reg_write && !r_adr_i[7:6] && r_reg == 3'd2;
+
+    always @(*) begin
+        case (r_reg)
+            3'd0:    r_dat_o = {29'd0, ch_irq_en[r_ch], 2'b00};
+            3'd1:    r_dat_o = {29'd0, ch_error[r_ch], ch_done[r_ch],
+                                ch_busy[r_ch]};
+            3'd2:    r_dat_o = ch_desc[r_ch];
+            3'd3:    r_dat_o = ch_src[r_ch];
+            3'd4:    r_dat_o = ch_dst[r_ch];
+            3'd5:    r_dat_o = {16'd0, ch_count[r_ch]};
+            default: r_dat_o = 32'd0;
+        endcase
+        if (r_adr_i[7:6] != 2'd0)
+            r_dat_o = 32'd0;
+    end
+
+    //--------------------------------------------------------------------------
+    // Engine
+    //--------------------------------------------------------------------------
+
+    integer c;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            state       <= S_IDLE;
+            r_ack_o     <= 1'b0;
+            m_adr_o     <= 32'd0;
+            m_dat_o     <= 32'd0;
+            m_we_o      <= 1'b0;
+            m_sel_o     <= 4'd0;
+            m_cyc_o     <= 1'b0;
+            cur         <= 1'b0;
+            last_ch     <= 1'b1;
+            desc_word   <= 2'd0;
+            ch_src_inc  <= 2'd0;
+            ch_dst_inc  <= 2'd0;
+            ch_irq_desc <= 2'd0;
+            ch_run      <= 2'd0;
+            ch_fetch    <= 2'd0;
+            ch_done     <= 2'd0;
+            ch_error    <= 2'd0;
+            ch_irq_en   <= 2'd0;
+            for (c = 0; c < 2; c = c + 1) begin
+                ch_src[c]   <= 32'd0;
+                ch_dst[c]   <= 32'd0;
+                ch_desc[c]  <= 32'd0;
+                ch_count[c] <= 16'd0;
+                ch_size[c]  <= 2'd0;
+                ch_req[c]   <= 2'd0;
+            end
+        end else begin
+            r_ack_o <= r_cyc_i && r_stb_i && !r_ack_o;
+
+            //------------------------------------------------------------------
+            // Software control
+            //------------------------------------------------------------------
+            if (wr_ctrl) begin
+                ch_irq_en[r_ch] <= r_dat_i[2];
+                if (r_dat_i[0] && !r_dat_i[1] && !ch_busy[r_ch]) begin
+                    ch_run[r_ch]   <= 1'b1;
+                    ch_fetch[r_ch] <= 1'b1;
+                end
+            end
+            if (wr_status) begin
+                if (r_dat_i[1]) ch_done[r_ch]  <= 1'b0;
+                if (r_dat_i[2]) ch_error[r_ch] <= 1'b0;
+            end
+            if (wr_desc && !ch_busy[r_ch])
+                ch_desc[r_ch] <= {r_dat_i[31:2], 2'b00};
+
+            //------------------------------------------------------------------
+            // Transfers
+            //------------------------------------------------------------------
+            case (state)
+                S_IDLE: begin
+                    if (ch_ready != 2'b00) begin
+                        cur     <= pick;
+                        last_ch <= pick;
+                        m_cyc_o <= 1'b1;
+                        if (ch_fetch[pick]) begin
+                            desc_word <= 2'd0;
+                            m_adr_o   <= ch_desc[pick];
+                            m_we_o    <= 1'b0;
+                            m_sel_o   <= 4'b1111;
+                            state     <= S_DESC;
+                        end else begin
+                            m_adr_o   <= {ch_src[pick][31:2], 2'b00};
+                            m_we_o    <= 1'b0;
+                            m_sel_o   <= lane_sel(ch_size[pick], ch_src[pick][1:0]);
+                            state     <= S_READ;
+                        end
+                    end
+                end
+
+                S_DESC: begin
+                    if (m_err_i) begin
+                        m_cyc_o        <= 1'b0;
+                        ch_run[cur]    <= 1'b0;
+                        ch_fetch[cur]  <= 1'b0;
+                        ch_error[cur]  <= 1'b1;
+                        state          <= S_IDLE;
+                    end else if (m_ack_i) begin
+                        case (desc_word)
+                            2'd0: ch_src[cur] <= m_dat_i;
+                            2'd1: ch_dst[cur] <= m_dat_i;
+                            2'd2: begin
+                                ch_count[cur]    <= m_dat_i[15:0];
+                                ch_size[cur]     <= m_dat_i[17:16];
+                                ch_src_inc[cur]  <= m_dat_i[18];
+                                ch_dst_inc[cur]  <= m_dat_i[19];
+                                ch_req[cur]      <= m_dat_i[21:20];
+                                ch_irq_desc[cur] <= m_dat_i[22];
+                            end
+                            2'd3: ch_desc[cur] <= {m_dat_i[31:2], 2'b00};
+                        endcase
+                        desc_word <= desc_word + 2'd1;
+                        m_adr_o   <= m_adr_o + 32'd4;
+                        if (desc_word == 2'd3) begin
+                            // Empty descriptor: follow NEXT straight away
+                            m_cyc_o <= 1'b0;
+                            if (ch_count[cur] == 16'd0) begin
+                                if (m_dat_i[31:2] == 30'd0) begin
+                                    ch_run[cur]   <= 1'b0;
+                                    ch_fetch[cur] <= 1'b0;
+                                    ch_done[cur]  <= 1'b1;
+                                end
+                            end else begin
+                                ch_fetch[cur] <= 1'b0;
+                            end
+                            state <= S_IDLE;
+                        end
+                    end
+                end
+
+                S_READ: begin
+                    if (m_err_i) begin
+                        m_cyc_o       <= 1'b0;
+                        ch_run[cur]   <= 1'b0;
+                        ch_error[cur] <= 1'b1;
+                        state         <= S_IDLE;
+                    end else if (m_ack_i) begin
+                        m_adr_o <= {ch_dst[cur][31:2], 2'b00};
+                        m_we_o  <= 1'b1;
+                        m_sel_o <= lane_sel(cur_size, ch_dst[cur][1:0]);
+                        m_dat_o <= (cur_size == 2'd0) ? {4{rd_elem[7:0]}} :
+                                   (cur_size == 2'd1) ? {2{rd_elem[15:0]}} : rd_elem;
+                        state   <= S_WRITE;
+                    end
+                end
+
+                S_WRITE: begin
+                    if (m_err_i) begin
+                        m_cyc_o       <= 1'b0;
+                        m_we_o        <= 1'b0;
+                        ch_run[cur]   <= 1'b0;
+                        ch_error[cur] <= 1'b1;
+                        state         <= S_IDLE;
+                    end else if (m_ack_i) begin
+                        m_cyc_o <= 1'b0;
+                        m_we_o  <= 1'b0;
+                        if (ch_src_inc[cur]) ch_src[cur] <= ch_src[cur] + step;
+                        if (ch_dst_inc[cur]) ch_dst[cur] <= ch_dst[cur] + step;
+                        ch_count[cur] <= ch_count[cur] - 16'd1;
+                        if (ch_count[cur] == 16'd1) begin
+                            if (ch_irq_desc[cur])
+                                ch_done[cur] <= 1'b1;
+                            if (ch_desc[cur] == 32'd0) begin
+                                ch_run[cur]  <= 1'b0;
+                                ch_done[cur] <= 1'b1;
+                            end else begin
+                                ch_fetch[cur] <= 1'b1;
+                            end
+                        end
+                        state <= S_IDLE;
+                    end
+                end
+
+                default: state <= S_IDLE;
+            endcase
+
+            // ABORT wins over the engine's own updates of the same channel;
+            // an element already on the bus is completed first
+            if (wr_ctrl && r_dat_i[1]) begin
+                ch_run[r_ch]   <= 1'b0;
+                ch_fetch[r_ch] <= 1'b0;
+            end
+        end
+    end
+
+endmodule
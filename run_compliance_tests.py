@@ -2,8 +2,15 @@
 """
 RISC-V Compliance Test Runner
 Converts official riscv-tests to memory format and runs them on the custom RISC-V core
+
+Two simulators:
+  --sim iverilog   (default) one generated testbench and compile per test
+  --sim verilator  sim/verilator model built once per core/MDU variant; the
+                   ELF is loaded at run time and tests run in parallel (-j)
 """
 
+import argparse
+import concurrent.futures
 import os
 import sys
 import subprocess
@@ -22,6 +29,27 @@ OBJDUMP = "/opt/riscv/bin/riscv32-unknown-elf-objdump"
 IVERILOG = "iverilog"
 VVP = "vvp"
 
+# Compiled harness (sim/verilator/Makefile)
+VERILATOR_DIR = Path("sim/verilator")
+VERILATOR_MAX_CYCLES = 1000000
+
+# Build variants: each maps a base RTL file to its drop-in replacement.
+# Only the selected file of each group is compiled.
+CORE_VARIANTS = {
+    "multicycle": "custom_riscv_core.v",
+    "pipelined": "custom_riscv_core_pipe.v",
+}
+MDU_VARIANTS = {
+    "serial": "mdu.v",
+    "fast": "mdu_fast.v",
+}
+
+def rtl_sources(core, mdu):
+    """RTL files for the selected core and MDU variants"""
+    excluded = (set(CORE_VARIANTS.values()) | set(MDU_VARIANTS.values())) - \
+               {CORE_VARIANTS[core], MDU_VARIANTS[mdu]}
+    return sorted(f for f in RTL_DIR.glob("*.v") if f.name not in excluded)
+
 def convert_elf_to_hex(elf_file, hex_file):
     """Convert ELF file to hex format suitable for Verilog $readmemh"""
     try:
@@ -84,7 +112,63 @@ def get_test_info(elf_file):
     except:
         return {'tohost_word_offset': 0x400}
 
-def create_testbench(test_name, hex_file, test_info):
+# Instruction port timing. The multi-cycle core fetches at most every other
+# cycle, so it keeps the registered ack; the pipelined core gets a
+# single-cycle (combinational) port so its CPI is not bounded by the bench.
+IFETCH_REGISTERED = '''    // Instruction fetch from unified memory
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            imem_ack <= 0;
+            imem_data <= 32'h00000013;
+        end else begin
+            if (iwb_stb_o && iwb_cyc_o && !imem_ack) begin
+                imem_data <= mem[iwb_adr_o[14:2]];  // Read from unified memory
+                imem_ack <= 1;
+            end else begin
+                imem_ack <= 0;
+            end
+        end
+    end'''
+
+IFETCH_COMBINATIONAL = '''    // Instruction fetch from unified memory (zero wait states)
+    always @(*) begin
+        imem_ack = iwb_stb_o && iwb_cyc_o;
+        imem_data = mem[iwb_adr_o[14:2]];
+    end'''
+
+TRACE_MULTICYCLE = '''    // Trace execution for debugging
+    always @(posedge clk) begin
+        if (rst_n && dut.state == dut.STATE_MEM && dwb_cyc_o && !dwb_we_o) begin
+            $display("[LOAD] PC=0x%08x addr=0x%08x funct3=%b data=0x%08x",
+                     dut.pc, dwb_adr_o, dut.funct3, dwb_dat_i);
+        end
+        if (rst_n && dut.state == dut.STATE_WRITEBACK && dut.rd_wen && dut.mem_read) begin
+            $display("[WB_LOAD] PC=0x%08x x%0d <= 0x%08x (mem_data_reg=0x%08x, addr_offset=%b)",
+                     dut.pc, dut.rd_addr, dut.rd_data, dut.mem_data_reg, dut.alu_result_reg[1:0]);
+        end
+        if (rst_n && dut.state == dut.STATE_TRAP) begin
+            $display("[TRAP] PC=0x%08x, cause=0x%08x, val=0x%08x",
+                     dut.trap_pc, dut.trap_cause, dut.trap_val);
+        end
+    end'''
+
+TRACE_PIPELINED = '''    // Trace execution for debugging
+    always @(posedge clk) begin
+        if (rst_n && dut.mem_commit && dut.exmem_is_load) begin
+            $display("[LOAD] PC=0x%08x addr=0x%08x funct3=%b data=0x%08x",
+                     dut.exmem_pc, dwb_adr_o, dut.exmem_funct3, dut.load_data);
+        end
+        if (rst_n && dut.trap_commit) begin
+            $display("[TRAP] PC=0x%08x, cause=0x%08x, val=0x%08x",
+                     dut.exmem_pc, dut.trap_cause, dut.trap_tval);
+        end
+    end'''
+
+# Printed on pass so the CPI of a variant can be compared
+CPI_REPORT_PIPELINED = '''$display("*** CPI: cycles=%0d instret=%0d ***",
+                                         dut.csr_mcycle[31:0], dut.csr_minstret[31:0]);'''
+
+def create_testbench(test_name, hex_file, test_info, core="multicycle"):
     """Create Verilog testbench for compliance test"""
 
     # tohost is at fixed word offset
@@ -93,6 +177,11 @@ def create_testbench(test_name, hex_file, test_info):
     # Sanitize test name for Verilog (replace hyphens with underscores)
     verilog_name = test_name.replace('-', '_')
 
+    pipelined = core == "pipelined"
+    ifetch = IFETCH_COMBINATIONAL if pipelined else IFETCH_REGISTERED
+    trace = TRACE_PIPELINED if pipelined else TRACE_MULTICYCLE
+    cpi_report = CPI_REPORT_PIPELINED if pipelined else ""
+
     testbench = f'''`timescale 1ns/1ps
 `include "riscv_defines.vh"
 
@@ -127,20 +216,7 @@ module tb_compliance_{verilog_name};
         .dwb_err_i(dwb_err_i), .interrupts(interrupts)
     );
 
-    // Instruction fetch from unified memory
-    always @(posedge clk or negedge rst_n) begin
-        if (!rst_n) begin
-            imem_ack <= 0;
-            imem_data <= 32'h00000013;
-        end else begin
-            if (iwb_stb_o && iwb_cyc_o && !imem_ack) begin
-                imem_data <= mem[iwb_adr_o[14:2]];  // Read from unified memory
-                imem_ack <= 1;
-            end else begin
-                imem_ack <= 0;
-            end
-        end
-    end
+{ifetch}
 
     // Data read - combinational (Wishbone requires data valid same cycle as ACK)
     always @(*) begin
@@ -174,6 +250,7 @@ module tb_compliance_{verilog_name};
                         if (dwb_dat_o != 0) begin
                             if (dwb_dat_o == 1) begin
                                 $display("\\n*** TEST PASSED ***");
+                                {cpi_report}
                                 $finish;
                             end else begin
                                 $display("\\n*** TEST FAILED *** (code: %0d)", dwb_dat_o >> 1);
@@ -211,21 +288,7 @@ module tb_compliance_{verilog_name};
         $finish;
     end
 
-    // Trace execution for debugging
-    always @(posedge clk) begin
-        if (rst_n && dut.state == dut.STATE_MEM && dwb_cyc_o && !dwb_we_o) begin
-            $display("[LOAD] PC=0x%08x addr=0x%08x funct3=%b data=0x%08x",
-                     dut.pc, dwb_adr_o, dut.funct3, dwb_dat_i);
-        end
-        if (rst_n && dut.state == dut.STATE_WRITEBACK && dut.rd_wen && dut.mem_read) begin
-            $display("[WB_LOAD] PC=0x%08x x%0d <= 0x%08x (mem_data_reg=0x%08x, addr_offset=%b)",
-                     dut.pc, dut.rd_addr, dut.rd_data, dut.mem_data_reg, dut.alu_result_reg[1:0]);
-        end
-        if (rst_n && dut.state == dut.STATE_TRAP) begin
-            $display("[TRAP] PC=0x%08x, cause=0x%08x, val=0x%08x",
-                     dut.trap_pc, dut.trap_cause, dut.trap_val);
-        end
-    end
+{trace}
 endmodule
 '''
 
@@ -235,7 +298,7 @@ endmodule
 
     return tb_file
 
-def run_test(test_name, tb_file):
+def run_test(test_name, tb_file, sources):
     """Compile and run test"""
     try:
         # Compile
@@ -248,7 +311,7 @@ def run_test(test_name, tb_file):
             f"-I{RTL_DIR}",
             "-o", str(sim_file),
             str(tb_file),
-            *[str(f) for f in RTL_DIR.glob("*.v")]
+            *[str(f) for f in sources]
         ]
 
         result = subprocess.run(compile_cmd, capture_output=True, text=True)
@@ -288,18 +351,86 @@ def run_test(test_name, tb_file):
         print(f"  Error running test: {e}")
         return False
 
+def build_verilator(core, mdu):
+    """Build (or bring up to date) the Verilator model; returns its path"""
+    result = subprocess.run(["make", "-C", str(VERILATOR_DIR), f"CORE={core}", f"MDU={mdu}"],
+                            capture_output=True, text=True)
+    if result.returncode != 0:
+        print("Verilator build failed:")
+        print(result.stdout[-2000:])
+        print(result.stderr[-2000:])
+        return None
+    return VERILATOR_DIR / "build" / f"{core}_{mdu}" / "Vsim_top"
+
+def run_verilator_test(sim_bin, test_file):
+    """Run one ELF on the compiled model: (passed, cycles, instret, output)"""
+    try:
+        result = subprocess.run(
+            [str(sim_bin), "--quiet", "--max-cycles", str(VERILATOR_MAX_CYCLES), str(test_file)],
+            capture_output=True, text=True, timeout=60
+        )
+    except subprocess.TimeoutExpired:
+        return False, 0, 0, "  Simulation timeout"
+
+    match = re.search(r'cycles=(\d+) instret=(\d+)', result.stdout)
+    cycles, instret = (int(match.group(1)), int(match.group(2))) if match else (0, 0)
+    return result.returncode == 0, cycles, instret, result.stdout + result.stderr
+
+def run_verilator(test_files, core, mdu, jobs):
+    """Run all tests on one Verilator build, in parallel; returns (passed, failed)"""
+    sim_bin = build_verilator(core, mdu)
+    if sim_bin is None:
+        return 0, len(test_files)
+
+    with concurrent.futures.ThreadPoolExecutor(max_workers=jobs) as pool:
+        results = list(pool.map(lambda f: run_verilator_test(sim_bin, f), test_files))
+
+    passed = failed = 0
+    total_cycles = total_instret = 0
+    for test_file, (ok, cycles, instret, output) in zip(test_files, results):
+        cpi = f"{cycles / instret:5.2f}" if instret else "  -  "
+        mark = "✓ PASSED" if ok else "✗ FAILED"
+        print(f"{test_file.name:<24} {mark}  cycles={cycles:<8} instret={instret:<8} CPI={cpi}")
+        if ok:
+            passed += 1
+            total_cycles += cycles
+            total_instret += instret
+        else:
+            failed += 1
+            print("--- Simulator output ---")
+            print(output.strip())
+            print("--- End simulator output ---")
+
+    if total_instret:
+        print(f"\nPassing tests: {total_cycles} cycles, {total_instret} instructions, "
+              f"CPI {total_cycles / total_instret:.2f}")
+    return passed, failed
+
 def main():
     """Main test runner"""
 
-    # Test patterns to run (can be overridden with --pattern <pattern>)
-    if len(sys.argv) >= 3 and sys.argv[1] == "--pattern":
-        test_patterns = [sys.argv[2]]
+    parser = argparse.ArgumentParser(description="Run riscv-tests on the custom RISC-V core")
+    parser.add_argument("--pattern", help="Test glob, e.g. rv32ui-p-add (default: rv32ui-p-* and rv32um-p-*)")
+    parser.add_argument("--core", choices=sorted(CORE_VARIANTS), default="multicycle",
+                        help="Core variant to simulate")
+    parser.add_argument("--mdu", choices=sorted(MDU_VARIANTS), default="serial",
+                        help="Multiply/divide unit variant")
+    parser.add_argument("--sim", choices=["iverilog", "verilator"], default="iverilog",
+                        help="Simulator (verilator: compile once, run in parallel)")
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 1,
+                        help="Parallel tests with --sim verilator (default: all cores)")
+    args = parser.parse_args()
+
+    if args.pattern:
+        test_patterns = [args.pattern]
     else:
         test_patterns = [
             "rv32ui-p-*",  # RV32I base integer tests
             "rv32um-p-*",  # RV32M multiply/divide tests
         ]
 
+    sources = rtl_sources(args.core, args.mdu)
+
     # Find all test files
     test_files = []
     for pattern in test_patterns:
@@ -309,12 +440,17 @@ def main():
     test_files = [f for f in test_files if f.suffix != '.dump' and not f.name.endswith('.dump')]
     test_files.sort()
 
-    print(f"Found {len(test_files)} compliance tests")
+    print(f"Found {len(test_files)} compliance tests "
+          f"(core: {args.core}, mdu: {args.mdu}, sim: {args.sim})")
     print("=" * 60)
 
     passed = 0
     failed = 0
 
+    if args.sim == "verilator":
+        passed, failed = run_verilator(test_files, args.core, args.mdu, max(1, args.jobs))
+        test_files = []
+
     for test_file in test_files:
         test_name = test_file.name
         print(f"\\nRunning {test_name}...")
@@ -334,10 +470,10 @@ def main():
             continue
 
         # Create testbench
-        tb_file = create_testbench(test_name, hex_file, test_info)
+        tb_file = create_testbench(test_name, hex_file, test_info, args.core)
 
         # Run test
-        if run_test(test_name, tb_file):
+        if run_test(test_name, tb_file, sources):
             print(f"  ✓ PASSED")
             passed += 1
         else:
@@ -346,7 +482,8 @@ def main():
 
     print("\\n" + "=" * 60)
     print(f"Results: {passed} passed, {failed} failed, {passed + failed} total")
-    print(f"Pass rate: {100 * passed / (passed + failed):.1f}%")
+    if passed + failed:
+        print(f"Pass rate: {100 * passed / (passed + failed):.1f}%")
 
     return 0 if failed == 0 else 1
 
@@ -0,0 +1,438 @@
+//==============================================================================
+// cpu.cpp - RV32IM + Zicsr Instruction-Set Model
+//==============================================================================
+
+#include "cpu.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t MISA_RV32IM = 0x40001100;
+constexpr uint32_t MIP_MASK = 0xFFFF0888;
+constexpr uint32_t MCOUNTINHIBIT_MASK = 0x7D;      // CY, IR, HPM3-6
+constexpr uint32_t MCOUNTINHIBIT_CY = 1u << 0;
+constexpr uint32_t MCOUNTINHIBIT_IR = 1u << 2;
+constexpr uint32_t MSTATUS_MPIE = 1u << 7;
+constexpr uint32_t MSTATUS_MPP = 3u << 11;         // Machine mode only
+
+// A run of synchronous traps without a retired instruction in between
+// means the handler itself faults
+constexpr uint32_t TRAP_LOOP_LIMIT = 1000;
+
+inline int32_t sext(uint32_t v, int bits) {
+    return static_cast<int32_t>(v << (32 - bits)) >> (32 - bits);
+}
+
+inline uint32_t imm_i(uint32_t insn) { return static_cast<uint32_t>(static_cast<int32_t>(insn) >> 20); }
+
+inline uint32_t imm_s(uint32_t insn) {
+    return static_cast<uint32_t>(sext(((insn >> 25) << 5) | ((insn >> 7) & 0x1F), 12));
+}
+
+inline uint32_t imm_b(uint32_t insn) {
+    uint32_t v = ((insn >> 31) << 12) | (((insn >> 7) & 1) << 11) |
+                 (((insn >> 25) & 0x3F) << 5) | (((insn >> 8) & 0xF) << 1);
+    return static_cast<uint32_t>(sext(v, 13));
+}
+
+inline uint32_t imm_j(uint32_t insn) {
+    uint32_t v = ((insn >> 31) << 20) | (insn & 0xFF000) | (((insn >> 20) & 1) << 11) |
+                 (((insn >> 21) & 0x3FF) << 1);
+    return static_cast<uint32_t>(sext(v, 21));
+}
+
+}  // namespace
+
+//==============================================================================
+// Main Loop
+//==============================================================================
+
+StopReason Cpu::run(uint64_t max_cycles, uint64_t max_instr) {
+    while (cycle_ < max_cycles) {
+        if (cycle_ >= soc_.next_event()) soc_.sync(cycle_);
+
+        if (wfi_) {
+            // Wakes on any enabled interrupt, even with mstatus.MIE clear
+            if (irq_active() == 0) {
+                cycle_ = std::min(std::max(cycle_ + 1, soc_.next_event()), max_cycles);
+                continue;
+            }
+            wfi_ = false;
+        }
+
+        if ((mstatus_ & MSTATUS_MIE) && irq_active() != 0) {
+            take_interrupt();
+            continue;
+        }
+
+        if (instret_ >= max_instr) return StopReason::INSTR_LIMIT;
+
+        if (pc_ & 3) {
+            trap(CAUSE_MISALIGNED_FETCH, pc_);
+        } else if (const uint8_t* p = soc_.mem_ptr(pc_, 4)) {
+            uint32_t insn;
+            std::memcpy(&insn, p, 4);
+            execute(insn);
+        } else {
+            trap(CAUSE_FETCH_FAULT, pc_);
+        }
+
+        if (tohost_hit_) return StopReason::TOHOST;
+        if (trap_loop_ > TRAP_LOOP_LIMIT) return StopReason::ILLEGAL_LOOP;
+    }
+    return StopReason::TIME_LIMIT;
+}
+
+//==============================================================================
+// Traps
+//==============================================================================
+
+void Cpu::trap(uint32_t cause, uint32_t tval) {
+    mepc_ = pc_;
+    mcause_ = cause;
+    mtval_ = tval;
+    mstatus_ = (mstatus_ & MSTATUS_MIE) ? (mstatus_ | MSTATUS_MPIE) : (mstatus_ & ~MSTATUS_MPIE);
+    mstatus_ &= ~MSTATUS_MIE;
+    pc_ = mtvec_ & ~3u;
+    cycle_ += t_.trap;
+    trap_loop_++;
+}
+
+bool Cpu::take_interrupt() {
+    uint32_t active = irq_active();
+    uint32_t code;
+
+    if (active & 0xFFFF0000u) {
+        code = 16;
+        while (!(active & (1u << code))) code++;
+    } else if (active & (1u << IRQ_EXTERNAL)) {
+        code = IRQ_EXTERNAL;
+    } else if (active & (1u << IRQ_SOFTWARE)) {
+        code = IRQ_SOFTWARE;
+    } else if (active & (1u << IRQ_TIMER)) {
+        code = IRQ_TIMER;
+    } else {
+        return false;
+    }
+
+    trap(MCAUSE_INTERRUPT | code, 0);
+    trap_loop_ = 0;
+    if ((mtvec_ & 3) == 1) pc_ += 4 * code;
+    return true;
+}
+
+//==============================================================================
+// Memory Access
+//==============================================================================
+
+bool Cpu::load(uint32_t addr, uint32_t size, uint32_t& value) {
+    if (const uint8_t* p = soc_.mem_ptr(addr, size)) {
+        value = 0;
+        std::memcpy(&value, p, size);
+        return true;
+    }
+    if (soc_.is_periph(addr)) {
+        value = soc_.periph_read(addr & ~3u, cycle_) >> (8 * (addr & 3));
+        if (size < 4) value &= (1u << (8 * size)) - 1;
+        return true;
+    }
+    return false;
+}
+
+bool Cpu::store(uint32_t addr, uint32_t size, uint32_t value) {
+    if (has_tohost_ && addr == tohost_) {
+        tohost_hit_ = true;
+        tohost_value_ = value;
+    }
+    if (addr >= ROM_SIZE) {
+        if (uint8_t* p = soc_.mem_ptr(addr, size)) {
+            std::memcpy(p, &value, size);
+            return true;
+        }
+    }
+    if (soc_.is_periph(addr)) {
+        // The core replicates a byte/halfword on every lane and peripherals
+        // take the whole bus word (no byte selects, cf. wb_dma.v)
+        uint32_t lanes = size == 1 ? (value & 0xFFu) * 0x01010101u
+                       : size == 2 ? (value & 0xFFFFu) * 0x00010001u : value;
+        soc_.periph_write(addr & ~3u, lanes, cycle_);
+        return true;
+    }
+    return false;
+}
+
+//==============================================================================
+// CSRs
+//==============================================================================
+
+uint64_t Cpu::mcycle() const {
+    if (mcountinhibit_ & MCOUNTINHIBIT_CY) return mcycle_base_;
+    return mcycle_base_ + (cycle_ - mcycle_at_);
+}
+
+void Cpu::mcycle_set(uint64_t value) {
+    mcycle_base_ = value;
+    mcycle_at_ = cycle_;
+}
+
+// Like the core: unimplemented addresses (including time[h]) read as zero,
+// and writes to them or to read-only CSRs are ignored, never illegal
+uint32_t Cpu::csr_read(uint32_t addr) {
+    switch (addr) {
+    case 0x300: return mstatus_ | MSTATUS_MPP;
+    case 0x301: return MISA_RV32IM;
+    case 0x304: return mie_;
+    case 0x305: return mtvec_;
+    case 0x320: return mcountinhibit_;
+    case 0x323: case 0x324: case 0x325: case 0x326:
+        return mhpmevent_[addr - 0x323];
+    case 0x340: return mscratch_;
+    case 0x341: return mepc_;
+    case 0x342: return mcause_;
+    case 0x343: return mtval_;
+    case 0x344: return soc_.irq_lines() & MIP_MASK;
+    case 0xB00: case 0xC00: return static_cast<uint32_t>(mcycle());
+    case 0xB80: case 0xC80: return static_cast<uint32_t>(mcycle() >> 32);
+    case 0xB02: case 0xC02: return static_cast<uint32_t>(minstret_);
+    case 0xB82: case 0xC82: return static_cast<uint32_t>(minstret_ >> 32);
+    default:                return 0;   // mhpmcounter3-6, ID registers, unimplemented
+    }
+}
+
+void Cpu::csr_write(uint32_t addr, uint32_t value) {
+    switch (addr) {
+    case 0x300: mstatus_ = value & (MSTATUS_MIE | MSTATUS_MPIE); break;
+    case 0x304: mie_ = value & MIP_MASK; break;
+    case 0x305: mtvec_ = value & ~2u; break;
+    case 0x320: {
+        uint64_t now = mcycle();
+        mcountinhibit_ = value & MCOUNTINHIBIT_MASK;
+        mcycle_set(now);
+        break;
+    }
+    case 0x323: case 0x324: case 0x325: case 0x326:
+        mhpmevent_[addr - 0x323] = value & 0xF;
+        break;
+    case 0x340: mscratch_ = value; break;
+    case 0x341: mepc_ = value & ~3u; break;
+    case 0x342: mcause_ = value; break;
+    case 0x343: mtval_ = value; break;
+    case 0xB00: mcycle_set((mcycle() & 0xFFFFFFFF00000000ull) | value); break;
+    case 0xB80: mcycle_set((mcycle() & 0xFFFFFFFFull) | (static_cast<uint64_t>(value) << 32)); break;
+    case 0xB02: minstret_ = (minstret_ & 0xFFFFFFFF00000000ull) | value; break;
+    case 0xB82: minstret_ = (minstret_ & 0xFFFFFFFFull) | (static_cast<uint64_t>(value) << 32); break;
+    default:    break;                              // misa, mip, read-only, unimplemented
+    }
+}
+
+//==============================================================================
+// Execute
+//==============================================================================
+
+void Cpu::execute(uint32_t insn) {
+    const uint32_t opcode = insn & 0x7F;
+    const uint32_t rd = (insn >> 7) & 0x1F;
+    const uint32_t funct3 = (insn >> 12) & 0x7;
+    const uint32_t rs1 = (insn >> 15) & 0x1F;
+    const uint32_t rs2 = (insn >> 20) & 0x1F;
+    const uint32_t funct7 = insn >> 25;
+    const uint32_t a = x_[rs1];
+    const uint32_t b = x_[rs2];
+
+    uint32_t next = pc_ + 4;
+    uint32_t cost = t_.alu;
+    uint32_t result = 0;
+    bool write_rd = true;
+
+    switch (opcode) {
+    case 0x37:  // LUI
+        result = insn & 0xFFFFF000u;
+        break;
+
+    case 0x17:  // AUIPC
+        result = pc_ + (insn & 0xFFFFF000u);
+        break;
+
+    case 0x6F:  // JAL
+        result = next;
+        next = pc_ + imm_j(insn);
+        cost = t_.jump;
+        break;
+
+    case 0x67:  // JALR
+        if (funct3 != 0) { trap(CAUSE_ILLEGAL, insn); return; }
+        result = next;
+        next = (a + imm_i(insn)) & ~1u;
+        cost = t_.jump;
+        break;
+
+    case 0x63: {  // Branches
+        bool take;
+        switch (funct3) {
+        case 0: take = a == b; break;
+        case 1: take = a != b; break;
+        case 4: take = static_cast<int32_t>(a) < static_cast<int32_t>(b); break;
+        case 5: take = static_cast<int32_t>(a) >= static_cast<int32_t>(b); break;
+        case 6: take = a < b; break;
+        case 7: take = a >= b; break;
+        default: trap(CAUSE_ILLEGAL, insn); return;
+        }
+        if (take) {
+            next = pc_ + imm_b(insn);
+            cost = t_.branch_taken;
+        }
+        write_rd = false;
+        break;
+    }
+
+    case 0x03: {  // Loads
+        uint32_t addr = a + imm_i(insn);
+        uint32_t size = 1u << (funct3 & 3);
+        if (funct3 == 3 || funct3 > 5) { trap(CAUSE_ILLEGAL, insn); return; }
+        if (addr & (size - 1)) { trap(CAUSE_MISALIGNED_LOAD, addr); return; }
+        if (!load(addr, size, result)) { trap(CAUSE_LOAD_FAULT, addr); return; }
+        if (funct3 == 0) result = static_cast<uint32_t>(sext(result, 8));
+        if (funct3 == 1) result = static_cast<uint32_t>(sext(result, 16));
+        cost = t_.load;
+        break;
+    }
+
+    case 0x23: {  // Stores
+        uint32_t addr = a + imm_s(insn);
+        uint32_t size = 1u << funct3;
+        if (funct3 > 2) { trap(CAUSE_ILLEGAL, insn); return; }
+        if (addr & (size - 1)) { trap(CAUSE_MISALIGNED_STORE, addr); return; }
+        if (!store(addr, size, b)) { trap(CAUSE_STORE_FAULT, addr); return; }
+        cost = t_.store;
+        write_rd = false;
+        break;
+    }
+
+    case 0x13: {  // OP-IMM
+        uint32_t imm = imm_i(insn);
+        uint32_t shamt = rs2;
+        switch (funct3) {
+        case 0: result = a + imm; break;
+        case 2: result = static_cast<int32_t>(a) < static_cast<int32_t>(imm); break;
+        case 3: result = a < imm; break;
+        case 4: result = a ^ imm; break;
+        case 6: result = a | imm; break;
+        case 7: result = a & imm; break;
+        case 1:
+            if (funct7 != 0) { trap(CAUSE_ILLEGAL, insn); return; }
+            result = a << shamt;
+            break;
+        default:  // 5
+            if (funct7 == 0x00) result = a >> shamt;
+            else if (funct7 == 0x20) result = static_cast<uint32_t>(static_cast<int32_t>(a) >> shamt);
+            else { trap(CAUSE_ILLEGAL, insn); return; }
+            break;
+        }
+        break;
+    }
+
+    case 0x33:  // OP
+        if (funct7 == 0x01) {
+            const int32_t sa = static_cast<int32_t>(a);
+            const int32_t sb = static_cast<int32_t>(b);
+            cost = funct3 < 4 ? t_.mul : t_.div;
+            switch (funct3) {
+            case 0: result = a * b; break;
+            case 1: result = static_cast<uint32_t>((static_cast<int64_t>(sa) * sb) >> 32); break;
+            case 2: result = static_cast<uint32_t>((static_cast<int64_t>(sa) * static_cast<int64_t>(b)) >> 32); break;
+            case 3: result = static_cast<uint32_t>((static_cast<uint64_t>(a) * b) >> 32); break;
+            case 4:
+                result = b == 0 ? 0xFFFFFFFFu
+                       : (a == 0x80000000u && sb == -1) ? a
+                       : static_cast<uint32_t>(sa / sb);
+                break;
+            case 5: result = b == 0 ? 0xFFFFFFFFu : a / b; break;
+            case 6:
+                result = b == 0 ? a
+                       : (a == 0x80000000u && sb == -1) ? 0
+                       : static_cast<uint32_t>(sa % sb);
+                break;
+            default: result = b == 0 ? a : a % b; break;
+            }
+            break;
+        }
+        if (funct7 != 0x00 && !(funct7 == 0x20 && (funct3 == 0 || funct3 == 5))) {
+            trap(CAUSE_ILLEGAL, insn);
+            return;
+        }
+        switch (funct3) {
+        case 0: result = funct7 ? a - b : a + b; break;
+        case 1: result = a << (b & 31); break;
+        case 2: result = static_cast<int32_t>(a) < static_cast<int32_t>(b); break;
+        case 3: result = a < b; break;
+        case 4: result = a ^ b; break;
+        case 5:
+            result = funct7 ? static_cast<uint32_t>(static_cast<int32_t>(a) >> (b & 31)) : a >> (b & 31);
+            break;
+        case 6: result = a | b; break;
+        default: result = a & b; break;
+        }
+        break;
+
+    case 0x0F:  // FENCE, FENCE.I: memory is always coherent here
+        write_rd = false;
+        break;
+
+    case 0x73:  // SYSTEM
+        if (funct3 == 0) {
+            write_rd = false;
+            switch (insn) {
+            case 0x00000073: trap(CAUSE_ECALL_M, 0); return;
+            case 0x00100073: trap(CAUSE_BREAKPOINT, pc_); return;
+            case 0x30200073:  // MRET
+                mstatus_ = (mstatus_ & MSTATUS_MPIE) ? (mstatus_ | MSTATUS_MIE) : (mstatus_ & ~MSTATUS_MIE);
+                mstatus_ |= MSTATUS_MPIE;
+                next = mepc_;
+                cost = t_.trap;
+                break;
+            case 0x10500073:  // WFI
+                wfi_ = true;
+                break;
+            default:
+                trap(CAUSE_ILLEGAL, insn);
+                return;
+            }
+        } else if (funct3 != 4) {
+            const uint32_t csr = insn >> 20;
+            const uint32_t src = (funct3 & 4) ? rs1 : a;    // CSRR*I: zimm
+            const bool writes = (funct3 & 3) == 1 || rs1 != 0;
+            const uint32_t old = csr_read(csr);
+            if (writes) {
+                csr_write(csr, (funct3 & 3) == 1 ? src
+                             : (funct3 & 3) == 2 ? old | src
+                             : old & ~src);
+            }
+            result = old;
+            cost = t_.csr;
+        } else {
+            trap(CAUSE_ILLEGAL, insn);
+            return;
+        }
+        break;
+
+    default:
+        trap(CAUSE_ILLEGAL, insn);
+        return;
+    }
+
+    // A misaligned jump or taken-branch target traps on the jump itself
+    // (mepc = its pc, rd not written), as in the core's EX stage
+    if (next & 3) {
+        trap(CAUSE_MISALIGNED_FETCH, next);
+        return;
+    }
+
+    if (write_rd && rd != 0) x_[rd] = result;
+    pc_ = next;
+    cycle_ += cost;
+    instret_++;
+    if (!(mcountinhibit_ & MCOUNTINHIBIT_IR)) minstret_++;
+    trap_loop_ = 0;
+}
@@ -0,0 +1,121 @@
+//==============================================================================
+// cpu.h - RV32IM + Zicsr Instruction-Set Model
+//
+// Interprets one instruction at a time against a Soc. The machine-mode CSRs
+// follow custom_riscv_core_pipe.v: mstatus.MIE/MPIE, mie/mip with the
+// platform lines at bits 16+, direct or vectored mtvec, mcycle/minstret with
+// mcountinhibit, and the core's interrupt priority (platform IRQs lowest
+// number first, then external, software, timer). mhpmcounter3-6 read as
+// zero: there is no pipeline to count stalls in. The Zpec custom-0
+// instructions are not decoded, so run images built without ZPEC=1.
+//
+// Also as in the core: unimplemented CSRs (time[h] included) read as zero
+// and ignore writes, writes to read-only CSRs are dropped rather than
+// illegal, a misaligned jump or branch target traps with mepc at the jump,
+// and a sub-word peripheral store puts the byte/halfword on every lane of
+// the bus word the peripheral receives.
+//
+// Timing is approximate. Every instruction costs a fixed number of cycles
+// per class (CpuTiming); the defaults are those of the pipelined core with
+// mdu_fast.v on single-cycle memory. WFI skips ahead to the next peripheral
+// event, so idle time costs nothing to simulate.
+//==============================================================================
+
+#ifndef ISS_CPU_H
+#define ISS_CPU_H
+
+#include <cstdint>
+
+#include "soc.h"
+
+// Cycles charged per instruction class
+struct CpuTiming {
+    uint32_t alu = 1;
+    uint32_t load = 2;              // Includes the load-use bubble
+    uint32_t store = 1;
+    uint32_t branch_taken = 3;      // Resolved in EX: two squashed fetches
+    uint32_t jump = 3;
+    uint32_t mul = 9;
+    uint32_t div = 18;
+    uint32_t csr = 1;
+    uint32_t trap = 4;              // Redirect from MEM
+
+    // Same cost for everything: cycles = instructions * cpi
+    void flat(uint32_t cpi) {
+        alu = load = store = branch_taken = jump = mul = div = csr = trap = cpi;
+    }
+};
+
+enum class StopReason { TIME_LIMIT, INSTR_LIMIT, TOHOST, ILLEGAL_LOOP };
+
+class Cpu {
+public:
+    Cpu(Soc& soc, const CpuTiming& timing) : soc_(soc), t_(timing) {}
+
+    void reset(uint32_t pc) { pc_ = pc; }
+
+    // Stores to this address end the run (riscv-tests / benchmark.h protocol)
+    void set_tohost(uint32_t addr) { tohost_ = addr; has_tohost_ = true; }
+
+    /**
+     * @brief Run until @p max_cycles, @p max_instr retired, or a tohost write
+     */
+    StopReason run(uint64_t max_cycles, uint64_t max_instr);
+
+    uint64_t cycles() const { return cycle_; }
+    uint64_t instret() const { return instret_; }
+    uint32_t tohost_value() const { return tohost_value_; }
+    uint32_t pc() const { return pc_; }
+
+private:
+    // mcause exception codes
+    static constexpr uint32_t CAUSE_MISALIGNED_FETCH = 0;
+    static constexpr uint32_t CAUSE_FETCH_FAULT = 1;
+    static constexpr uint32_t CAUSE_ILLEGAL = 2;
+    static constexpr uint32_t CAUSE_BREAKPOINT = 3;
+    static constexpr uint32_t CAUSE_MISALIGNED_LOAD = 4;
+    static constexpr uint32_t CAUSE_LOAD_FAULT = 5;
+    static constexpr uint32_t CAUSE_MISALIGNED_STORE = 6;
+    static constexpr uint32_t CAUSE_STORE_FAULT = 7;
+    static constexpr uint32_t CAUSE_ECALL_M = 11;
+
+    bool load(uint32_t addr, uint32_t size, uint32_t& value);
+    bool store(uint32_t addr, uint32_t size, uint32_t value);
+    uint32_t csr_read(uint32_t addr);
+    void csr_write(uint32_t addr, uint32_t value);
+    uint64_t mcycle() const;
+    void mcycle_set(uint64_t value);
+
+    void trap(uint32_t cause, uint32_t tval);
+    bool take_interrupt();
+    void execute(uint32_t insn);
+
+    // Pending and enabled interrupts
+    uint32_t irq_active() const { return soc_.irq_lines() & mie_; }
+
+    Soc& soc_;
+    CpuTiming t_;
+
+    uint32_t x_[32] = {0};
+    uint32_t pc_ = 0;
+    uint32_t next_pc_ = 0;
+
+    uint64_t cycle_ = 0;
+    uint64_t instret_ = 0;
+    uint64_t mcycle_base_ = 0;      // mcycle = base + (cycle_ - at) unless inhibited
+    uint64_t mcycle_at_ = 0;
+    uint64_t minstret_ = 0;
+
+    uint32_t mstatus_ = 0, mie_ = 0, mtvec_ = 0, mscratch_ = 0;
+    uint32_t mepc_ = 0, mcause_ = 0, mtval_ = 0, mcountinhibit_ = 0;
+    uint32_t mhpmevent_[4] = {0, 0, 0, 0};
+
+    bool wfi_ = false;
+    bool has_tohost_ = false;
+    bool tohost_hit_ = false;
+    uint32_t tohost_ = 0;
+    uint32_t tohost_value_ = 0;
+    uint32_t trap_loop_ = 0;        // Back-to-back synchronous traps
+};
+
+#endif // ISS_CPU_H
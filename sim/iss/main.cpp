@@ -0,0 +1,316 @@
+//==============================================================================
+// main.cpp - rv32iss Command Line
+//
+// Runs a firmware image on the instruction-set model with the SoC
+// peripherals and the inverter plant in the loop:
+//
+//   rv32iss [options] <image.elf>
+//
+//   --time SEC          simulated time to run (default 1.0)
+//   --max-instr N       stop after N instructions
+//   --clock HZ          core clock (default 50000000)
+//   --cpi N             charge N cycles for every instruction instead of
+//                       the pipelined-core timing
+//   --csv FILE          plant/PWM trace, one row per --csv-every cycles
+//   --csv-every N       trace interval in cycles (default 5000 = 100 us)
+//   --load OHMS         load resistance, 0 = open circuit (default 20)
+//   --vdc V[,V2]        DC link voltages, one value for both (default 170)
+//   --load-step SEC:OHMS  change the load at SEC (repeatable)
+//   --uart-in SEC:TEXT  type TEXT into the UART at SEC (repeatable, "\n"
+//                       and "\r" escapes allowed)
+//   --quiet             no summary on stderr
+//
+// Console output is the firmware's UART. An image that defines tohost
+// (benchmark.h, riscv-tests) ends the run when it writes it and the exit
+// status follows the verilator harness: 0 pass, 1 fail, 2 time limit,
+// 3 usage/load error or a trap loop.
+//
+// An application image linked behind the bootloader gets a jump to its
+// entry point at the reset vector, as in sim/verilator.
+//==============================================================================
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "cpu.h"
+#include "soc.h"
+
+namespace {
+
+enum Result { RESULT_PASS = 0, RESULT_FAIL = 1, RESULT_TIMEOUT = 2, RESULT_ERROR = 3 };
+
+struct Options {
+    std::string image;
+    std::string csv;
+    double time_s = 1.0;
+    uint64_t max_instr = UINT64_MAX;
+    uint64_t csv_every = 5000;
+    uint32_t cpi = 0;
+    bool quiet = false;
+    SocConfig soc;
+    std::vector<std::pair<double, double>> load_steps;
+    std::vector<std::pair<double, std::string>> uart_in;
+};
+
+//------------------------------------------------------------------------------
+// ELF loader
+//------------------------------------------------------------------------------
+
+bool read_file(const std::string& path, std::vector<uint8_t>& out) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) return false;
+    out.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    return true;
+}
+
+template <typename T>
+T get(const std::vector<uint8_t>& buf, size_t off) {
+    T v = 0;
+    for (size_t i = 0; i < sizeof(T); i++) {
+        v |= static_cast<T>(buf[off + i]) << (8 * i);
+    }
+    return v;
+}
+
+struct ElfInfo {
+    uint32_t entry = 0;
+    bool covers_reset = false;      // a segment is loaded at address 0
+    bool has_tohost = false;
+    uint32_t tohost = 0;
+};
+
+/**
+ * Load the PT_LOAD segments of a little-endian RV32 ELF at their physical
+ * addresses and look up the tohost symbol.
+ */
+bool load_elf(const std::vector<uint8_t>& elf, Soc& soc, ElfInfo& info) {
+    if (elf.size() < 52 || elf[4] != 1 || elf[5] != 1 || get<uint16_t>(elf, 18) != 243) {
+        std::fprintf(stderr, "not a little-endian RV32 ELF\n");
+        return false;
+    }
+
+    uint32_t phoff = get<uint32_t>(elf, 28);
+    uint32_t shoff = get<uint32_t>(elf, 32);
+    uint16_t phentsize = get<uint16_t>(elf, 42);
+    uint16_t phnum = get<uint16_t>(elf, 44);
+    uint16_t shentsize = get<uint16_t>(elf, 46);
+    uint16_t shnum = get<uint16_t>(elf, 48);
+    info.entry = get<uint32_t>(elf, 24);
+
+    for (uint16_t i = 0; i < phnum; i++) {
+        size_t ph = phoff + static_cast<size_t>(i) * phentsize;
+        if (ph + 32 > elf.size() || get<uint32_t>(elf, ph) != 1) continue;   // PT_LOAD
+
+        uint32_t offset = get<uint32_t>(elf, ph + 4);
+        uint32_t paddr = get<uint32_t>(elf, ph + 12);
+        uint32_t filesz = get<uint32_t>(elf, ph + 16);
+        uint32_t memsz = get<uint32_t>(elf, ph + 20);
+        if (static_cast<size_t>(offset) + filesz > elf.size() || filesz > memsz) {
+            std::fprintf(stderr, "truncated ELF segment\n");
+            return false;
+        }
+        if (paddr == 0 && memsz != 0) info.covers_reset = true;
+
+        std::vector<uint8_t> seg(memsz, 0);
+        std::memcpy(seg.data(), &elf[offset], filesz);
+        if (memsz != 0 && !soc.load(paddr, seg.data(), memsz)) {
+            std::fprintf(stderr, "segment at 0x%08x is outside ROM/RAM/TCM\n", paddr);
+            return false;
+        }
+    }
+
+    // Symbol table: SHT_SYMTAB, strings in the linked section
+    for (uint16_t i = 0; i < shnum; i++) {
+        size_t sh = shoff + static_cast<size_t>(i) * shentsize;
+        if (sh + 40 > elf.size() || get<uint32_t>(elf, sh + 4) != 2) continue;
+
+        uint32_t sym_off = get<uint32_t>(elf, sh + 16);
+        uint32_t sym_size = get<uint32_t>(elf, sh + 20);
+        uint32_t link = get<uint32_t>(elf, sh + 24);
+        size_t str_sh = shoff + static_cast<size_t>(link) * shentsize;
+        if (str_sh + 40 > elf.size()) continue;
+        uint32_t str_off = get<uint32_t>(elf, str_sh + 16);
+
+        for (uint32_t s = 0; s + 16 <= sym_size && static_cast<size_t>(sym_off) + s + 16 <= elf.size(); s += 16) {
+            size_t name = str_off + get<uint32_t>(elf, sym_off + s);
+            if (name + sizeof("tohost") <= elf.size() &&
+                std::memcmp(&elf[name], "tohost", sizeof("tohost")) == 0) {
+                info.has_tohost = true;
+                info.tohost = get<uint32_t>(elf, sym_off + s + 4);
+                return true;
+            }
+        }
+    }
+    return true;
+}
+
+// jal x0, target (from address 0)
+uint32_t encode_jal(uint32_t target) {
+    return ((target & 0x100000) << 11) | ((target & 0x7FE) << 20) |
+           ((target & 0x800) << 9) | (target & 0xFF000) | 0x6F;
+}
+
+//------------------------------------------------------------------------------
+// Command line
+//------------------------------------------------------------------------------
+
+void usage(const char* prog) {
+    std::fprintf(stderr,
+                 "usage: %s [--time SEC] [--max-instr N] [--clock HZ] [--cpi N]\n"
+                 "       [--csv FILE] [--csv-every N] [--load OHMS] [--vdc V[,V2]]\n"
+                 "       [--load-step SEC:OHMS]... [--uart-in SEC:TEXT]... [--quiet] <image.elf>\n",
+                 prog);
+}
+
+std::string unescape(const std::string& s) {
+    std::string out;
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == '\\' && i + 1 < s.size()) {
+            char c = s[++i];
+            out += c == 'n' ? '\n' : c == 'r' ? '\r' : c;
+        } else {
+            out += s[i];
+        }
+    }
+    return out;
+}
+
+// "SEC:VALUE" -> seconds and the text after the colon
+bool split_timed(const char* arg, double& sec, std::string& value) {
+    const char* colon = std::strchr(arg, ':');
+    if (colon == nullptr) return false;
+    sec = std::strtod(arg, nullptr);
+    value = colon + 1;
+    return true;
+}
+
+bool parse_args(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        bool has_value = i + 1 < argc;
+        double sec;
+        std::string value;
+        if (a == "--time" && has_value) {
+            opt.time_s = std::strtod(argv[++i], nullptr);
+        } else if (a == "--max-instr" && has_value) {
+            opt.max_instr = std::strtoull(argv[++i], nullptr, 0);
+        } else if (a == "--clock" && has_value) {
+            opt.soc.clock_hz = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else if (a == "--cpi" && has_value) {
+            opt.cpi = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else if (a == "--csv" && has_value) {
+            opt.csv = argv[++i];
+        } else if (a == "--csv-every" && has_value) {
+            opt.csv_every = std::strtoull(argv[++i], nullptr, 0);
+        } else if (a == "--load" && has_value) {
+            opt.soc.plant.r_load = std::strtod(argv[++i], nullptr);
+        } else if (a == "--vdc" && has_value) {
+            char* end = nullptr;
+            opt.soc.plant.vdc1 = opt.soc.plant.vdc2 = std::strtod(argv[++i], &end);
+            if (*end == ',') opt.soc.plant.vdc2 = std::strtod(end + 1, nullptr);
+        } else if (a == "--load-step" && has_value) {
+            if (!split_timed(argv[++i], sec, value)) return false;
+            opt.load_steps.emplace_back(sec, std::strtod(value.c_str(), nullptr));
+        } else if (a == "--uart-in" && has_value) {
+            if (!split_timed(argv[++i], sec, value)) return false;
+            opt.uart_in.emplace_back(sec, unescape(value));
+        } else if (a == "--quiet") {
+            opt.quiet = true;
+        } else if (a[0] != '-' && opt.image.empty()) {
+            opt.image = a;
+        } else {
+            return false;
+        }
+    }
+    return !opt.image.empty() && opt.soc.clock_hz != 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_args(argc, argv, opt)) {
+        usage(argv[0]);
+        return RESULT_ERROR;
+    }
+
+    Soc soc(opt.soc);
+    ElfInfo info;
+
+    std::vector<uint8_t> elf;
+    if (!read_file(opt.image, elf)) {
+        std::fprintf(stderr, "cannot read %s\n", opt.image.c_str());
+        return RESULT_ERROR;
+    }
+    if (!load_elf(elf, soc, info)) return RESULT_ERROR;
+    if (!info.covers_reset && info.entry != 0) {
+        uint32_t jal = encode_jal(info.entry);
+        soc.load(0, reinterpret_cast<const uint8_t*>(&jal), 4);
+    }
+
+    const double clock = opt.soc.clock_hz;
+    for (const auto& s : opt.load_steps) {
+        soc.schedule_load(static_cast<uint64_t>(s.first * clock), s.second);
+    }
+    for (const auto& u : opt.uart_in) {
+        soc.schedule_uart_rx(static_cast<uint64_t>(u.first * clock), u.second);
+    }
+
+    std::FILE* csv = nullptr;
+    if (!opt.csv.empty()) {
+        csv = std::fopen(opt.csv.c_str(), "w");
+        if (csv == nullptr) {
+            std::fprintf(stderr, "cannot write %s\n", opt.csv.c_str());
+            return RESULT_ERROR;
+        }
+        soc.open_csv(csv, opt.csv_every);
+    }
+
+    CpuTiming timing;
+    if (opt.cpi != 0) timing.flat(opt.cpi);
+    Cpu cpu(soc, timing);
+    cpu.reset(0);
+    if (info.has_tohost) cpu.set_tohost(info.tohost);
+
+    auto start = std::chrono::steady_clock::now();
+    StopReason stop = cpu.run(static_cast<uint64_t>(opt.time_s * clock), opt.max_instr);
+    double host_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::fflush(stdout);
+    if (csv != nullptr) std::fclose(csv);
+
+    Result r = RESULT_TIMEOUT;
+    const char* why = "time limit";
+    switch (stop) {
+    case StopReason::TOHOST:
+        r = cpu.tohost_value() == 1 ? RESULT_PASS : RESULT_FAIL;
+        why = r == RESULT_PASS ? "tohost: pass" : "tohost: fail";
+        break;
+    case StopReason::INSTR_LIMIT:
+        why = "instruction limit";
+        break;
+    case StopReason::ILLEGAL_LOOP:
+        r = RESULT_ERROR;
+        why = "trap loop";
+        break;
+    default:
+        break;
+    }
+
+    if (!opt.quiet) {
+        std::fprintf(stderr, "\n[rv32iss] %s at pc=0x%08x: %llu instructions, %llu cycles "
+                             "(%.6f s simulated) in %.2f s host, %.1f MIPS\n",
+                     why, cpu.pc(),
+                     static_cast<unsigned long long>(cpu.instret()),
+                     static_cast<unsigned long long>(cpu.cycles()),
+                     cpu.cycles() / clock, host_s,
+                     host_s > 0 ? cpu.instret() / host_s / 1e6 : 0.0);
+        if (r == RESULT_FAIL) std::fprintf(stderr, "[rv32iss] exit code %u\n", cpu.tohost_value() >> 1);
+    }
+    return r;
+}
@@ -0,0 +1,62 @@
+//==============================================================================
+// plant.h - Averaged Model of the 5-Level CHB Inverter and its Load
+//
+// Two series H-bridges on DC links vdc1/vdc2 drive an LC output filter with
+// a resistive load:
+//
+//   v_inv --[ L, r_l ]--+-- v_out
+//                       |
+//                       C   R_load
+//                       |
+//
+// The bridges are modelled by their switching-period average: v_inv is the
+// sum of each bridge's PWM reference (-1..1) times its DC link voltage,
+// which is what the control loop sees through an anti-aliased sigma-delta
+// ADC. The state is
+// integrated with semi-implicit Euler; 1 us steps are well inside the
+// ~800 Hz filter resonance.
+//==============================================================================
+
+#ifndef ISS_PLANT_H
+#define ISS_PLANT_H
+
+struct PlantParams {
+    double vdc1 = 170.0;            // DC link of H-bridge 1 (V)
+    double vdc2 = 170.0;            // DC link of H-bridge 2 (V)
+    double l = 2.0e-3;              // Filter inductance (H)
+    double r_l = 0.1;               // Inductor resistance (ohm)
+    double c = 20.0e-6;             // Filter capacitance (F)
+    double r_load = 20.0;           // Load resistance (ohm), 0 = open circuit
+};
+
+class Plant {
+public:
+    explicit Plant(const PlantParams& p) : p_(p) {}
+
+    /**
+     * @brief Advance by @p dt seconds with the bridges applying @p ref1 and
+     *        @p ref2 (-1..1)
+     */
+    void step(double ref1, double ref2, double dt) {
+        v_inv_ = ref1 * p_.vdc1 + ref2 * p_.vdc2;
+        i_l_ += dt * (v_inv_ - v_out_ - p_.r_l * i_l_) / p_.l;
+        double i_load = p_.r_load > 0.0 ? v_out_ / p_.r_load : 0.0;
+        v_out_ += dt * (i_l_ - i_load) / p_.c;
+    }
+
+    void set_load(double r_load) { p_.r_load = r_load; }
+
+    double v_inv() const { return v_inv_; }
+    double i_out() const { return i_l_; }
+    double v_out() const { return v_out_; }
+    double vdc1() const { return p_.vdc1; }
+    double vdc2() const { return p_.vdc2; }
+
+private:
+    PlantParams p_;
+    double v_inv_ = 0.0;
+    double i_l_ = 0.0;
+    double v_out_ = 0.0;
+};
+
+#endif // ISS_PLANT_H
@@ -0,0 +1,569 @@
+//==============================================================================
+// soc.cpp - Memory and Peripheral Models for the ISS
+//==============================================================================
+
+#include "soc.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// ADC front-end scaling, as assumed by chb_5level_control.c
+constexpr double ADC_VREF = 3.3;
+constexpr double ADC_COUNTS = 65536.0;
+constexpr double CURRENT_SCALE = 20.0;      // A/V
+constexpr double VOLTAGE_SCALE = 50.0;      // divider ratio
+constexpr double CURRENT_OFFSET = 32768.0;
+
+constexpr uint32_t ADC_CHANNELS = 4;
+constexpr uint32_t UART_RX_DEPTH = 16;
+constexpr uint32_t ICACHE_CONFIG_VALUE = 1024 | (4u << 16);
+constexpr uint32_t PWM_CARRIER_HZ = 5000;  // PWM_FREQ_HZ of the firmware (FREQ_DIV is not decoded)
+constexpr double TWO_PI = 6.283185307179586;
+
+uint16_t adc_code(double counts) {
+    return static_cast<uint16_t>(std::min(std::max(std::lround(counts), 0L), 65535L));
+}
+
+}  // namespace
+
+Soc::Soc(const SocConfig& cfg)
+    : cfg_(cfg), plant_(cfg.plant), rom_(ROM_SIZE, 0), ram_(RAM_SIZE, 0), tcm_(TCM_SIZE, 0) {
+    plant_period_ = std::max<uint64_t>(1, cfg_.clock_hz / cfg_.plant_step_hz);
+    plant_next_ = plant_period_;
+    adc_next_ = cfg_.clock_hz / cfg_.adc_rate_hz;
+    update_next_event();
+}
+
+bool Soc::load(uint32_t addr, const uint8_t* data, uint32_t len) {
+    uint8_t* p = mem_ptr(addr, len);
+    if (p == nullptr) return false;
+    std::memcpy(p, data, len);
+    return true;
+}
+
+//==============================================================================
+// Scheduling
+//==============================================================================
+
+void Soc::sync(uint64_t now) {
+    while (next_event_ <= now) {
+        uint64_t t = next_event_;
+
+        if (plant_next_ <= t) {
+            plant_.step(pwm_reference(0, plant_next_), pwm_reference(1, plant_next_),
+                        1.0 / cfg_.plant_step_hz);
+            prot_check(plant_next_);
+            plant_next_ += plant_period_;
+        }
+        if (pwm_update_at_ <= t) {
+            pwm_bridge_ref_[0] = pwm_bridge_shadow_[0];
+            pwm_bridge_ref_[1] = pwm_bridge_shadow_[1];
+            pwm_update_at_ = UINT64_MAX;
+        }
+        if (adc_next_ <= t) {
+            adc_convert();
+            adc_next_ += cfg_.clock_hz / cfg_.adc_rate_hz;
+        }
+        if (tmr_match_ <= t) {
+            tmr_status_ |= TIMER_STATUS_MATCH;
+            tmr_count_base_ = (tmr_ctrl_ & TIMER_CTRL_AUTO) ? 0 : tmr_compare_ + 1;
+            tmr_base_ = tmr_match_;
+            timer_schedule();
+        }
+        if (prot_wd_deadline_ <= t) {
+            prot_status_ |= PROT_STATUS_WD & prot_mask_;
+            prot_wd_deadline_ = UINT64_MAX;
+        }
+        if (csv_next_ <= t) {
+            csv_row(csv_next_);
+            csv_next_ += csv_every_;
+        }
+        while (!events_.empty() && events_.front().cycle <= t) {
+            const Event& e = events_.front();
+            if (e.type == 0) {
+                if (uart_rx_.size() < UART_RX_DEPTH) uart_rx_.push_back(static_cast<uint8_t>(e.value));
+            } else {
+                plant_.set_load(e.value);
+            }
+            events_.pop_front();
+        }
+        update_next_event();
+    }
+    now_ = now;
+    update_irqs();
+}
+
+void Soc::update_next_event() {
+    uint64_t next = std::min({plant_next_, pwm_update_at_, adc_next_, tmr_match_, prot_wd_deadline_, csv_next_});
+    if (!events_.empty()) next = std::min(next, events_.front().cycle);
+    next_event_ = next;
+}
+
+void Soc::update_irqs() {
+    uint32_t lines = 0;
+
+    if ((tmr_ctrl_ & TIMER_CTRL_IRQ_EN) && (tmr_irq_en_ & TIMER_IRQ_EN_MATCH) &&
+        (tmr_status_ & TIMER_STATUS_MATCH)) {
+        lines |= 1u << IRQ_TIMER;
+    }
+    if ((adc_irq_en_ & ADC_IRQ_EN_FRAME) && adc_fifo_.size() >= ADC_CHANNELS) {
+        lines |= 1u << IRQ_ADC;
+    }
+    if ((uart_irq_en_ & UART_IRQ_EN_TX_EMPTY) ||
+        ((uart_irq_en_ & UART_IRQ_EN_RX_AVAIL) && !uart_rx_.empty())) {
+        lines |= 1u << IRQ_UART;
+    }
+    if (prot_status_ & prot_irq_en_) {
+        lines |= 1u << IRQ_PROT;
+    }
+    irq_lines_ = lines;
+}
+
+void Soc::schedule_uart_rx(uint64_t cycle, const std::string& text) {
+    // One character time at 115200 baud (10 bits) between bytes
+    uint64_t gap = 10ull * cfg_.clock_hz / 115200;
+    for (char c : text) {
+        Event e = {cycle, 0, static_cast<double>(static_cast<uint8_t>(c))};
+        events_.insert(std::upper_bound(events_.begin(), events_.end(), e,
+                                        [](const Event& a, const Event& b) { return a.cycle < b.cycle; }),
+                       e);
+        cycle += gap;
+    }
+    update_next_event();
+}
+
+void Soc::schedule_load(uint64_t cycle, double r_load) {
+    Event e = {cycle, 1, r_load};
+    events_.insert(std::upper_bound(events_.begin(), events_.end(), e,
+                                    [](const Event& a, const Event& b) { return a.cycle < b.cycle; }),
+                   e);
+    update_next_event();
+}
+
+//==============================================================================
+// CSV Trace
+//==============================================================================
+
+void Soc::open_csv(std::FILE* f, uint64_t every) {
+    csv_ = f;
+    csv_every_ = std::max<uint64_t>(1, every);
+    csv_next_ = csv_every_;
+    std::fprintf(csv_, "time_s,v_inv,i_out,v_out,mod_index,pwm_out,prot_status\n");
+    update_next_event();
+}
+
+void Soc::csv_row(uint64_t now) {
+    std::fprintf(csv_, "%.6f,%.3f,%.4f,%.3f,%u,0x%02x,0x%x\n",
+                 static_cast<double>(now) / cfg_.clock_hz, plant_.v_inv(), plant_.i_out(),
+                 plant_.v_out(), pwm_mod_index_, pwm_levels(now), prot_status_);
+}
+
+//==============================================================================
+// PWM Accelerator
+//==============================================================================
+
+bool Soc::bridges_on() const {
+    bool tripped = (prot_ctrl_ & PROT_CTRL_ENABLE) && (prot_status_ & PROT_STATUS_ANY);
+    return (pwm_ctrl_ & PWM_CTRL_ENABLE) && !tripped;
+}
+
+uint32_t Soc::pwm_phase(uint64_t now) const {
+    if (!(pwm_ctrl_ & PWM_CTRL_ENABLE)) return pwm_phase_base_;
+    return pwm_phase_base_ + static_cast<uint32_t>(static_cast<uint64_t>(pwm_sine_freq_) * (now - pwm_base_));
+}
+
+void Soc::pwm_rebase(uint64_t now) {
+    pwm_phase_base_ = pwm_phase(now);
+    pwm_base_ = now;
+}
+
+double Soc::pwm_reference(int bridge, uint64_t now) const {
+    if (!bridges_on()) return 0.0;
+    if (pwm_ctrl_ & PWM_CTRL_CPU_MODE) {
+        uint32_t ref = (pwm_ctrl_ & PWM_CTRL_BRIDGE_REF) ? pwm_bridge_ref_[bridge] : pwm_cpu_ref_;
+        return static_cast<int16_t>(ref) / 32768.0;
+    }
+    double m = (pwm_mod_index_ & PWM_MOD_INDEX_VALUE) / 65536.0;
+    return m * std::sin(TWO_PI * pwm_phase(now) / 4294967296.0);
+}
+
+// Gate pattern of the nearest output level: per bridge +1 = S1+S4,
+// -1 = S2+S3, 0 = S1+S3 (bridge 2 on S5-S8)
+uint32_t Soc::pwm_levels(uint64_t now) const {
+    if (!bridges_on()) return 0;
+    double ref = pwm_reference(0, now) + pwm_reference(1, now);
+    long level = std::min(std::max(std::lround(ref), -2L), 2L);
+    auto bridge = [](long l) -> uint32_t { return l > 0 ? 0x9u : l < 0 ? 0x6u : 0x5u; };
+    long b1 = level > 0 ? 1 : level < 0 ? -1 : 0;
+    long b2 = level - b1;
+    return bridge(b1) | (bridge(b2) << 4);
+}
+
+uint32_t Soc::pwm_read(uint32_t off, uint64_t now) {
+    switch (off) {
+    case REG_OFFSET(pwm_regs_t, CTRL):
+        return pwm_ctrl_ | (pwm_update_at_ != UINT64_MAX ? PWM_CTRL_UPDATE : 0);
+    case REG_OFFSET(pwm_regs_t, FREQ_DIV):      return pwm_freq_div_;
+    case REG_OFFSET(pwm_regs_t, MOD_INDEX):     return pwm_mod_index_;
+    case REG_OFFSET(pwm_regs_t, SINE_PHASE):    return pwm_phase(now);
+    case REG_OFFSET(pwm_regs_t, SINE_FREQ):     return pwm_sine_freq_;
+    case REG_OFFSET(pwm_regs_t, DEADTIME):      return pwm_deadtime_;
+    case REG_OFFSET(pwm_regs_t, STATUS):        return bridges_on() ? PWM_CTRL_ENABLE : 0;
+    case REG_OFFSET(pwm_regs_t, PWM_OUT):       return pwm_levels(now);
+    case REG_OFFSET(pwm_regs_t, CPU_REFERENCE): return pwm_cpu_ref_;
+    case REG_OFFSET(pwm_regs_t, BRIDGE1_REF):   return pwm_bridge_shadow_[0];
+    case REG_OFFSET(pwm_regs_t, BRIDGE2_REF):   return pwm_bridge_shadow_[1];
+    default:                                    return 0;
+    }
+}
+
+void Soc::pwm_write(uint32_t off, uint32_t data, uint64_t now) {
+    switch (off) {
+    case REG_OFFSET(pwm_regs_t, CTRL):
+        pwm_rebase(now);
+        pwm_ctrl_ = data & ~PWM_CTRL_UPDATE;
+        if ((data & PWM_CTRL_UPDATE) && pwm_update_at_ == UINT64_MAX) {
+            // Next carrier period; at once while no carrier runs
+            uint64_t period = cfg_.clock_hz / PWM_CARRIER_HZ;
+            pwm_update_at_ = (pwm_ctrl_ & PWM_CTRL_ENABLE) ? (now / period + 1) * period : now;
+            update_next_event();
+        }
+        break;
+    case REG_OFFSET(pwm_regs_t, FREQ_DIV):      pwm_freq_div_ = data; break;
+    case REG_OFFSET(pwm_regs_t, MOD_INDEX):     pwm_mod_index_ = data & PWM_MOD_INDEX_VALUE; break;
+    case REG_OFFSET(pwm_regs_t, SINE_PHASE):
+        pwm_phase_base_ = data;
+        pwm_base_ = now;
+        break;
+    case REG_OFFSET(pwm_regs_t, SINE_FREQ):
+        pwm_rebase(now);
+        pwm_sine_freq_ = data;
+        break;
+    case REG_OFFSET(pwm_regs_t, DEADTIME):      pwm_deadtime_ = data; break;
+    case REG_OFFSET(pwm_regs_t, CPU_REFERENCE): pwm_cpu_ref_ = data; break;
+    case REG_OFFSET(pwm_regs_t, BRIDGE1_REF):   pwm_bridge_shadow_[0] = data & PWM_BRIDGE1_REF_VALUE; break;
+    case REG_OFFSET(pwm_regs_t, BRIDGE2_REF):   pwm_bridge_shadow_[1] = data & PWM_BRIDGE2_REF_VALUE; break;
+    default:                                    break;
+    }
+}
+
+//==============================================================================
+// Sigma-Delta ADC
+//==============================================================================
+
+void Soc::adc_convert() {
+    if (!(adc_ctrl_ & ADC_CTRL_ENABLE)) return;
+
+    const double volts = ADC_COUNTS / (ADC_VREF * VOLTAGE_SCALE);
+    adc_data_[0] = adc_code(CURRENT_OFFSET + plant_.i_out() * ADC_COUNTS / (ADC_VREF * CURRENT_SCALE));
+    adc_data_[1] = adc_code(plant_.v_out() * volts);
+    adc_data_[2] = adc_code(plant_.vdc1() * volts);
+    adc_data_[3] = adc_code(plant_.vdc2() * volts);
+    adc_status_ |= ADC_STATUS_VALID_CH0 | ADC_STATUS_VALID_CH1 | ADC_STATUS_VALID_CH2 | ADC_STATUS_VALID_CH3;
+    prot_compare();
+
+    if ((adc_ctrl_ & ADC_CTRL_FIFO_EN) && (adc_ctrl_ & ADC_CTRL_CONT)) {
+        for (uint32_t ch = 0; ch < ADC_CHANNELS; ch++) {
+            if (adc_fifo_.size() >= ADC_FIFO_DEPTH) break;    // overrun: rest of frame lost
+            adc_fifo_.push_back(adc_fifo_data_ch_set(adc_fifo_data_sample_set(0, adc_data_[ch]), ch));
+        }
+    }
+}
+
+uint32_t Soc::adc_read(uint32_t off) {
+    switch (off) {
+    case REG_OFFSET(adc_regs_t, CTRL):
+        return adc_ctrl_;
+    case REG_OFFSET(adc_regs_t, STATUS):
+        return adc_status_ |
+               (adc_fifo_.size() >= ADC_FIFO_DEPTH ? ADC_STATUS_FIFO_FULL : 0) |
+               (adc_fifo_.empty() ? ADC_STATUS_FIFO_EMPTY : 0);
+    case REG_OFFSET(adc_regs_t, DATA_CH0):   return adc_data_[0];
+    case REG_OFFSET(adc_regs_t, DATA_CH1):   return adc_data_[1];
+    case REG_OFFSET(adc_regs_t, DATA_CH2):   return adc_data_[2];
+    case REG_OFFSET(adc_regs_t, DATA_CH3):   return adc_data_[3];
+    case REG_OFFSET(adc_regs_t, FIFO_LEVEL): return static_cast<uint32_t>(adc_fifo_.size());
+    case REG_OFFSET(adc_regs_t, IRQ_EN):     return adc_irq_en_;
+    case REG_OFFSET(adc_regs_t, FIFO_DATA): {
+        if (adc_fifo_.empty()) return 0;
+        uint32_t word = adc_fifo_.front();
+        adc_fifo_.pop_front();
+        return word;
+    }
+    default:
+        return 0;
+    }
+}
+
+void Soc::adc_write(uint32_t off, uint32_t data) {
+    switch (off) {
+    case REG_OFFSET(adc_regs_t, CTRL):
+        adc_ctrl_ = data;
+        if (!(data & ADC_CTRL_FIFO_EN)) adc_fifo_.clear();
+        break;
+    case REG_OFFSET(adc_regs_t, IRQ_EN):
+        adc_irq_en_ = data;
+        break;
+    default:
+        break;
+    }
+}
+
+//==============================================================================
+// Protection
+//==============================================================================
+
+void Soc::prot_check(uint64_t now) {
+    (void)now;
+    uint32_t faults = 0;
+
+    // Comparator trips stay asserted until their STATUS.CMP bits are cleared
+    uint32_t cmp = prot_status_cmp_get(prot_status_);
+    if (cmp & 0x1u) faults |= PROT_STATUS_OCP;
+    if (cmp & 0xEu) faults |= PROT_STATUS_OVP;
+
+    if (prot_ocp_ != 0 && std::fabs(plant_.i_out()) > prot_ocp_) {
+        faults |= PROT_STATUS_OCP;
+    }
+    double v_max = std::max({std::fabs(plant_.v_out()), plant_.vdc1(), plant_.vdc2()});
+    if (prot_ovp_ != 0 && v_max > prot_ovp_) {
+        faults |= PROT_STATUS_OVP;
+    }
+    prot_status_ |= faults & prot_mask_;
+}
+
+// Fast comparators: one check per channel per converted frame
+void Soc::prot_compare() {
+    uint32_t trips = 0;
+    for (uint32_t ch = 0; ch < ADC_CHANNELS; ch++) {
+        uint32_t window = prot_cmp_window_[ch];
+        uint32_t code = adc_data_[ch];
+        bool outside = code < (window & 0xFFFFu) || code > (window >> 16);
+        if (!(prot_cmp_ctrl_ & (1u << ch)) || !outside) continue;
+        if (!(prot_cmp_capture_ & PROT_CMP_CAPTURE_VALID)) {
+            prot_cmp_capture_ = PROT_CMP_CAPTURE_VALID | prot_cmp_capture_ch_set(code, ch);
+        }
+        trips |= 1u << ch;
+    }
+    if (trips == 0) return;
+
+    prot_status_ = prot_status_cmp_set(prot_status_, prot_status_cmp_get(prot_status_) | trips);
+    uint32_t faults = ((trips & 0x1u) ? PROT_STATUS_OCP : 0) | ((trips & 0xEu) ? PROT_STATUS_OVP : 0);
+    prot_status_ |= faults & prot_mask_;
+}
+
+uint32_t Soc::prot_read(uint32_t off) {
+    switch (off) {
+    case REG_OFFSET(prot_regs_t, CTRL):          return prot_ctrl_;
+    case REG_OFFSET(prot_regs_t, STATUS):        return prot_status_;
+    case REG_OFFSET(prot_regs_t, FAULT_MASK):    return prot_mask_;
+    case REG_OFFSET(prot_regs_t, OCP_THRESHOLD): return prot_ocp_;
+    case REG_OFFSET(prot_regs_t, OVP_THRESHOLD): return prot_ovp_;
+    case REG_OFFSET(prot_regs_t, WATCHDOG):      return prot_wd_;
+    case REG_OFFSET(prot_regs_t, IRQ_EN):        return prot_irq_en_;
+    case REG_OFFSET(prot_regs_t, CMP_CTRL):      return prot_cmp_ctrl_;
+    case REG_OFFSET(prot_regs_t, CMP0_WINDOW):   return prot_cmp_window_[0];
+    case REG_OFFSET(prot_regs_t, CMP1_WINDOW):   return prot_cmp_window_[1];
+    case REG_OFFSET(prot_regs_t, CMP2_WINDOW):   return prot_cmp_window_[2];
+    case REG_OFFSET(prot_regs_t, CMP3_WINDOW):   return prot_cmp_window_[3];
+    case REG_OFFSET(prot_regs_t, CMP_CAPTURE):   return prot_cmp_capture_;
+    default:                                     return 0;
+    }
+}
+
+void Soc::prot_write(uint32_t off, uint32_t data, uint64_t now) {
+    switch (off) {
+    case REG_OFFSET(prot_regs_t, CTRL):          prot_ctrl_ = data; break;
+    case REG_OFFSET(prot_regs_t, FAULT_MASK):    prot_mask_ = data; break;
+    case REG_OFFSET(prot_regs_t, FAULT_CLEAR):
+        prot_status_ &= ~data;
+        if (!(prot_status_ & PROT_STATUS_CMP)) prot_cmp_capture_ = 0;
+        break;
+    case REG_OFFSET(prot_regs_t, OCP_THRESHOLD): prot_ocp_ = data; break;
+    case REG_OFFSET(prot_regs_t, OVP_THRESHOLD): prot_ovp_ = data; break;
+    case REG_OFFSET(prot_regs_t, IRQ_EN):        prot_irq_en_ = data; break;
+    case REG_OFFSET(prot_regs_t, CMP_CTRL):      prot_cmp_ctrl_ = data & PROT_CMP_CTRL_EN; break;
+    case REG_OFFSET(prot_regs_t, CMP0_WINDOW):   prot_cmp_window_[0] = data; break;
+    case REG_OFFSET(prot_regs_t, CMP1_WINDOW):   prot_cmp_window_[1] = data; break;
+    case REG_OFFSET(prot_regs_t, CMP2_WINDOW):   prot_cmp_window_[2] = data; break;
+    case REG_OFFSET(prot_regs_t, CMP3_WINDOW):   prot_cmp_window_[3] = data; break;
+    case REG_OFFSET(prot_regs_t, WATCHDOG):
+        prot_wd_ = data;
+        prot_wd_deadline_ = data != 0 ? now + data : UINT64_MAX;
+        break;
+    default:
+        break;
+    }
+}
+
+//==============================================================================
+// Timer
+//==============================================================================
+
+uint32_t Soc::timer_count(uint64_t now) const {
+    if (!(tmr_ctrl_ & TIMER_CTRL_ENABLE)) return tmr_count_base_;
+    return tmr_count_base_ + static_cast<uint32_t>((now - tmr_base_) / (tmr_prescaler_ + 1ull));
+}
+
+void Soc::timer_rebase(uint64_t now) {
+    tmr_count_base_ = timer_count(now);
+    tmr_base_ = now;
+}
+
+// Next compare match: COUNT steps past COMPARE (and restarts with AUTO)
+void Soc::timer_schedule() {
+    if (!(tmr_ctrl_ & TIMER_CTRL_ENABLE)) {
+        tmr_match_ = UINT64_MAX;
+        return;
+    }
+    uint64_t ticks = tmr_count_base_ <= tmr_compare_
+                   ? static_cast<uint64_t>(tmr_compare_) - tmr_count_base_ + 1
+                   : (1ull << 32) - tmr_count_base_ + tmr_compare_ + 1;
+    tmr_match_ = tmr_base_ + ticks * (tmr_prescaler_ + 1ull);
+}
+
+uint32_t Soc::timer_read(uint32_t off, uint64_t now) {
+    switch (off) {
+    case REG_OFFSET(timer_regs_t, CTRL):      return tmr_ctrl_;
+    case REG_OFFSET(timer_regs_t, STATUS):    return tmr_status_;
+    case REG_OFFSET(timer_regs_t, PRESCALER): return tmr_prescaler_;
+    case REG_OFFSET(timer_regs_t, COUNT):     return timer_count(now);
+    case REG_OFFSET(timer_regs_t, COMPARE):   return tmr_compare_;
+    case REG_OFFSET(timer_regs_t, IRQ_EN):    return tmr_irq_en_;
+    default:                                  return 0;
+    }
+}
+
+void Soc::timer_write(uint32_t off, uint32_t data, uint64_t now) {
+    switch (off) {
+    case REG_OFFSET(timer_regs_t, STATUS):
+        tmr_status_ &= ~data;
+        return;
+    case REG_OFFSET(timer_regs_t, IRQ_EN):
+        tmr_irq_en_ = data;
+        return;
+    default:
+        break;
+    }
+
+    timer_rebase(now);
+    switch (off) {
+    case REG_OFFSET(timer_regs_t, CTRL):      tmr_ctrl_ = data; break;
+    case REG_OFFSET(timer_regs_t, PRESCALER): tmr_prescaler_ = data; break;
+    case REG_OFFSET(timer_regs_t, COUNT):     tmr_count_base_ = data; break;
+    case REG_OFFSET(timer_regs_t, COMPARE):   tmr_compare_ = data; break;
+    default:                                  break;
+    }
+    timer_schedule();
+}
+
+//==============================================================================
+// UART
+//==============================================================================
+
+uint32_t Soc::uart_read(uint32_t off) {
+    switch (off) {
+    case REG_OFFSET(uart_regs_t, DATA): {
+        if (uart_rx_.empty()) return 0;
+        uint8_t c = uart_rx_.front();
+        uart_rx_.pop_front();
+        return c;
+    }
+    case REG_OFFSET(uart_regs_t, STATUS):
+        return UART_STATUS_TX_EMPTY |
+               (uart_rx_.empty() ? UART_STATUS_RX_EMPTY : UART_STATUS_RX_AVAIL) |
+               (uart_rx_.size() >= UART_RX_DEPTH ? UART_STATUS_RX_FULL : 0);
+    case REG_OFFSET(uart_regs_t, BAUD_DIV): return uart_baud_div_;
+    case REG_OFFSET(uart_regs_t, CTRL):     return uart_ctrl_;
+    case REG_OFFSET(uart_regs_t, IRQ_EN):   return uart_irq_en_;
+    default:                                return 0;
+    }
+}
+
+void Soc::uart_write(uint32_t off, uint32_t data) {
+    switch (off) {
+    case REG_OFFSET(uart_regs_t, DATA):
+        std::putchar(static_cast<int>(data & UART_DATA_BYTE));
+        break;
+    case REG_OFFSET(uart_regs_t, BAUD_DIV): uart_baud_div_ = data; break;
+    case REG_OFFSET(uart_regs_t, CTRL):     uart_ctrl_ = data; break;
+    case REG_OFFSET(uart_regs_t, IRQ_EN):   uart_irq_en_ = data; break;
+    default:                                break;
+    }
+}
+
+//==============================================================================
+// Peripheral Bus
+//==============================================================================
+
+uint32_t Soc::periph_read(uint32_t addr, uint64_t now) {
+    sync(now);
+
+    uint32_t block = (addr & ~0xFFu) - PERIPH_BASE;
+    uint32_t off = addr & 0xFC;
+    uint32_t value = 0;
+
+    switch (block) {
+    case PWM_BASE - PERIPH_BASE:   value = pwm_read(off, now); break;
+    case ADC_BASE - PERIPH_BASE:   value = adc_read(off); break;
+    case PROT_BASE - PERIPH_BASE:  value = prot_read(off); break;
+    case TIMER_BASE - PERIPH_BASE: value = timer_read(off, now); break;
+    case UART_BASE - PERIPH_BASE:  value = uart_read(off); break;
+    case GPIO_BASE - PERIPH_BASE:
+        switch (off) {
+        case REG_OFFSET(gpio_regs_t, DATA_OUT): value = gpio_out_; break;
+        case REG_OFFSET(gpio_regs_t, DATA_IN):  value = gpio_out_ & gpio_dir_; break;
+        case REG_OFFSET(gpio_regs_t, DIR):      value = gpio_dir_; break;
+        case REG_OFFSET(gpio_regs_t, IRQ_EN):   value = gpio_irq_[0]; break;
+        case REG_OFFSET(gpio_regs_t, IRQ_TYPE): value = gpio_irq_[1]; break;
+        case REG_OFFSET(gpio_regs_t, IRQ_POL):  value = gpio_irq_[2]; break;
+        default:                                break;
+        }
+        break;
+    case ICACHE_BASE - PERIPH_BASE:
+        if (off == REG_OFFSET(icache_regs_t, CTRL)) value = icache_ctrl_;
+        if (off == REG_OFFSET(icache_regs_t, CONFIG)) value = ICACHE_CONFIG_VALUE;
+        break;
+    default:
+        break;  // DMA and unused space read as zero
+    }
+
+    update_irqs();
+    return value;
+}
+
+void Soc::periph_write(uint32_t addr, uint32_t data, uint64_t now) {
+    sync(now);
+
+    uint32_t block = (addr & ~0xFFu) - PERIPH_BASE;
+    uint32_t off = addr & 0xFC;
+
+    switch (block) {
+    case PWM_BASE - PERIPH_BASE:   pwm_write(off, data, now); break;
+    case ADC_BASE - PERIPH_BASE:   adc_write(off, data); break;
+    case PROT_BASE - PERIPH_BASE:  prot_write(off, data, now); break;
+    case TIMER_BASE - PERIPH_BASE: timer_write(off, data, now); break;
+    case UART_BASE - PERIPH_BASE:  uart_write(off, data); break;
+    case GPIO_BASE - PERIPH_BASE:
+        switch (off) {
+        case REG_OFFSET(gpio_regs_t, DATA_OUT): gpio_out_ = data; break;
+        case REG_OFFSET(gpio_regs_t, DIR):      gpio_dir_ = data; break;
+        case REG_OFFSET(gpio_regs_t, IRQ_EN):   gpio_irq_[0] = data; break;
+        case REG_OFFSET(gpio_regs_t, IRQ_TYPE): gpio_irq_[1] = data; break;
+        case REG_OFFSET(gpio_regs_t, IRQ_POL):  gpio_irq_[2] = data; break;
+        default:                                break;
+        }
+        break;
+    case ICACHE_BASE - PERIPH_BASE:
+        if (off == REG_OFFSET(icache_regs_t, CTRL)) icache_ctrl_ = data & ICACHE_CTRL_ENABLE;
+        break;
+    default:
+        break;
+    }
+
+    update_next_event();
+    update_irqs();
+}
@@ -0,0 +1,195 @@
+//==============================================================================
+// soc.h - Memory and Peripheral Models for the ISS
+//
+// ROM, RAM and TCM at their soc_regs.h addresses, and behavioural models of
+// the peripherals chb_5level_control.c uses:
+//
+//   PWM    SINE_PHASE accumulates SINE_FREQ every clock; the bridge reference
+//          is MOD_INDEX * sin(phase) (or CPU_REFERENCE as Q15 in CPU mode,
+//          or BRIDGE1_REF/BRIDGE2_REF per bridge with CTRL.BRIDGE_REF) and
+//          feeds the plant. CTRL.UPDATE latches the bridge references at
+//          the next PWM_CARRIER_HZ period boundary. PWM_OUT shows the
+//          nearest of the 5 levels.
+//   ADC    Converts the plant's I_out, V_out, V_dc1, V_dc2 at ADC_RATE_HZ with
+//          the firmware's scaling; FIFO mode pushes tagged frames and raises
+//          IRQ_ADC when a whole frame is queued.
+//   PROT   OCP/OVP compare |I_out| (A) and V_out / V_dc (V) against the
+//          thresholds, plus the watchdog. The fast comparators check every
+//          ADC sample against the CMPn_WINDOW codes. Latched faults with
+//          CTRL.ENABLE force the bridges off.
+//   TIMER  Prescaler, compare match with auto-reload, IRQ_TIMER.
+//   UART   TX goes to stdout at once (the FIFO is always empty); RX bytes are
+//          injected at scheduled times.
+//   ICACHE Registers only (CONFIG reports 1 KB, 4-word lines).
+//   GPIO   DATA_IN reads back the outputs.
+//
+// The DMA engine is not modelled: its registers read as zero, so DMA=1
+// builds do not move data.
+//
+// Peripherals are evaluated lazily: the CPU calls sync() when the cycle
+// count reaches next_event() and before every peripheral access, so the
+// cost between events is one compare per instruction.
+//==============================================================================
+
+#ifndef ISS_SOC_H
+#define ISS_SOC_H
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "plant.h"
+#include "soc_map.h"
+
+struct SocConfig {
+    uint32_t clock_hz = 50000000;
+    uint32_t adc_rate_hz = 10000;       // Frames per second (all 4 channels)
+    uint32_t plant_step_hz = 1000000;   // Plant integration rate
+    PlantParams plant;
+};
+
+class Soc {
+public:
+    explicit Soc(const SocConfig& cfg);
+
+    //--------------------------------------------------------------------------
+    // Memory
+    //--------------------------------------------------------------------------
+
+    // Host pointer for a RAM/ROM/TCM address with @p len bytes available,
+    // nullptr for peripheral or unmapped space
+    uint8_t* mem_ptr(uint32_t addr, uint32_t len) {
+        if (addr < rom_.size() && len <= rom_.size() - addr) return &rom_[addr];
+        uint32_t off = addr - RAM_BASE;
+        if (off < ram_.size() && len <= ram_.size() - off) return &ram_[off];
+        off = addr - TCM_BASE;
+        if (off < tcm_.size() && len <= tcm_.size() - off) return &tcm_[off];
+        return nullptr;
+    }
+
+    bool is_periph(uint32_t addr) const {
+        return addr - PERIPH_BASE < PERIPH_SIZE;
+    }
+
+    // Image loading: ROM is writable here (not by the CPU)
+    bool load(uint32_t addr, const uint8_t* data, uint32_t len);
+
+    //--------------------------------------------------------------------------
+    // Peripherals
+    //--------------------------------------------------------------------------
+
+    uint32_t periph_read(uint32_t addr, uint64_t now);
+    void periph_write(uint32_t addr, uint32_t data, uint64_t now);
+
+    // Bring every model up to @p now and recompute the interrupt lines
+    void sync(uint64_t now);
+
+    uint64_t next_event() const { return next_event_; }
+
+    // mip bits driven by the peripherals
+    uint32_t irq_lines() const { return irq_lines_; }
+
+    void schedule_uart_rx(uint64_t cycle, const std::string& text);
+    void schedule_load(uint64_t cycle, double r_load);
+
+    // CSV row every @p every cycles: time, v_ref, v_inv, i_out, v_out, ...
+    void open_csv(std::FILE* f, uint64_t every);
+
+    const Plant& plant() const { return plant_; }
+
+private:
+    static constexpr uint32_t ADC_FIFO_DEPTH = 16;  // samples
+
+    struct Event {
+        uint64_t cycle;
+        int type;           // 0 = UART RX byte, 1 = load change
+        double value;
+    };
+
+    double pwm_reference(int bridge, uint64_t now) const;
+    uint32_t pwm_phase(uint64_t now) const;
+    uint32_t pwm_levels(uint64_t now) const;
+    bool bridges_on() const;
+    void pwm_rebase(uint64_t now);
+
+    uint32_t timer_count(uint64_t now) const;
+    void timer_rebase(uint64_t now);
+    void timer_schedule();
+
+    void adc_convert();
+    void prot_check(uint64_t now);
+    void prot_compare();
+    void csv_row(uint64_t now);
+    void update_irqs();
+    void update_next_event();
+
+    // Peripheral read/write per block (offset inside the block)
+    uint32_t pwm_read(uint32_t off, uint64_t now);
+    void pwm_write(uint32_t off, uint32_t data, uint64_t now);
+    uint32_t adc_read(uint32_t off);
+    void adc_write(uint32_t off, uint32_t data);
+    uint32_t prot_read(uint32_t off);
+    void prot_write(uint32_t off, uint32_t data, uint64_t now);
+    uint32_t timer_read(uint32_t off, uint64_t now);
+    void timer_write(uint32_t off, uint32_t data, uint64_t now);
+    uint32_t uart_read(uint32_t off);
+    void uart_write(uint32_t off, uint32_t data);
+
+    SocConfig cfg_;
+    Plant plant_;
+    std::vector<uint8_t> rom_, ram_, tcm_;
+
+    uint64_t now_ = 0;
+    uint64_t next_event_ = 0;
+    uint32_t irq_lines_ = 0;
+
+    // PWM (phase is phase_base_ + SINE_FREQ * (now - pwm_base_))
+    uint32_t pwm_ctrl_ = 0, pwm_freq_div_ = 0, pwm_mod_index_ = 0;
+    uint32_t pwm_sine_freq_ = 0, pwm_deadtime_ = 0, pwm_cpu_ref_ = 0;
+    uint32_t pwm_phase_base_ = 0;
+    uint64_t pwm_base_ = 0;
+    uint32_t pwm_bridge_shadow_[2] = {0, 0}, pwm_bridge_ref_[2] = {0, 0};
+    uint64_t pwm_update_at_ = UINT64_MAX;   // pending CTRL.UPDATE
+
+    // ADC
+    uint32_t adc_ctrl_ = 0, adc_status_ = 0, adc_irq_en_ = 0;
+    uint32_t adc_data_[4] = {0, 0, 0, 0};
+    std::deque<uint32_t> adc_fifo_;
+    uint64_t adc_next_ = 0;
+
+    // Plant
+    uint64_t plant_next_ = 0;
+    uint64_t plant_period_ = 1;
+
+    // PROT
+    uint32_t prot_ctrl_ = 0, prot_status_ = 0, prot_mask_ = 0, prot_irq_en_ = 0;
+    uint32_t prot_ocp_ = 0, prot_ovp_ = 0, prot_wd_ = 0;
+    uint32_t prot_cmp_ctrl_ = 0, prot_cmp_capture_ = 0;
+    uint32_t prot_cmp_window_[4] = {0xFFFF0000u, 0xFFFF0000u, 0xFFFF0000u, 0xFFFF0000u};
+    uint64_t prot_wd_deadline_ = UINT64_MAX;
+
+    // TIMER (count is count_base_ + (now - timer_base_) / (PRESCALER + 1))
+    uint32_t tmr_ctrl_ = 0, tmr_status_ = 0, tmr_prescaler_ = 0;
+    uint32_t tmr_compare_ = 0, tmr_irq_en_ = 0, tmr_count_base_ = 0;
+    uint64_t tmr_base_ = 0;
+    uint64_t tmr_match_ = UINT64_MAX;
+
+    // UART
+    uint32_t uart_baud_div_ = 0, uart_ctrl_ = 0, uart_irq_en_ = 0;
+    std::deque<uint8_t> uart_rx_;
+
+    // GPIO, ICACHE
+    uint32_t gpio_out_ = 0, gpio_dir_ = 0, gpio_irq_[3] = {0, 0, 0};
+    uint32_t icache_ctrl_ = 0;
+
+    // Scheduled stimuli, sorted by cycle
+    std::deque<Event> events_;
+
+    std::FILE* csv_ = nullptr;
+    uint64_t csv_every_ = 0;
+    uint64_t csv_next_ = UINT64_MAX;
+};
+
+#endif // ISS_SOC_H
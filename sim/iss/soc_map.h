@@ -0,0 +1,22 @@
+//==============================================================================
+// soc_map.h - SoC Register Map for the ISS
+//
+// The peripheral models decode the same generated header as the firmware
+// (distribution/rv32imz_full_soc/firmware/soc_regs.h), so offsets and bit
+// masks cannot drift from soc_regs.json.
+//==============================================================================
+
+#ifndef ISS_SOC_MAP_H
+#define ISS_SOC_MAP_H
+
+// soc_regs.h is C11: map its offset checks onto the C++ keyword
+#define _Static_assert static_assert
+#include "soc_regs.h"
+#undef _Static_assert
+
+#include "irq.h"
+
+// Offset of a register inside its peripheral block
+#define REG_OFFSET(type, reg)   static_cast<uint32_t>(offsetof(type, reg))
+
+#endif // ISS_SOC_MAP_H
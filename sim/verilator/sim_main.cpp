@@ -0,0 +1,523 @@
+//==============================================================================
+// sim_main.cpp - Compiled Simulation Harness for custom_riscv_core
+//
+// Runs one program image on the Verilator model of sim_top.v and reports
+// the outcome, cycle count and retired instructions:
+//
+//   Vsim_top [options] <image.elf | image.hex>
+//
+//   --max-cycles N   give up after N cycles (default 1000000)
+//   --tohost ADDR    tohost address (default: ELF symbol "tohost")
+//   --soc            SoC memory map and UART console instead of test mode
+//   --vcd FILE       dump a waveform (binary built with TRACE=1)
+//   --quiet          leave the image name out of the result line
+//
+// Test mode reproduces the riscv-tests bench of run_compliance_tests.py: a
+// 32 KB unified memory mirrored over the whole address space and a tohost
+// word where the program writes 1 (pass) or (code << 1) | 1 (fail).
+//
+// SoC mode places ROM, RAM and TCM at their soc_regs.h addresses. Writes to
+// UART->DATA go to stdout, the UART always reports an empty TX FIFO and its
+// TX-empty interrupt follows IRQ_EN; every other peripheral reads as zero.
+// Firmware has no tohost, so it runs until --max-cycles unless the ELF
+// defines the symbol (benchmark.h). An application image linked behind the
+// bootloader gets a jump to its entry point at the reset vector in place
+// of the bootloader.
+//
+// Result lines use the same "*** TEST ... ***" strings as the Icarus bench,
+// followed by "cycles=N instret=N". Exit status: 0 pass, 1 fail, 2 timeout,
+// 3 usage or load error.
+//==============================================================================
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Vsim_top.h"
+#include "verilated.h"
+#if VM_TRACE
+#include "verilated_vcd_c.h"
+#endif
+
+namespace {
+
+constexpr uint32_t NOP = 0x00000013;
+
+// Test mode
+constexpr uint32_t TEST_MEM_BYTES = 32 * 1024;
+constexpr uint32_t TEST_TOHOST_DEFAULT = 0x1000;   // offset used when no symbol
+
+// SoC mode (soc_regs.h)
+constexpr uint32_t SOC_SPACE_BYTES = 0x40000;      // ROM .. end of TCM
+constexpr uint32_t PERIPH_BASE = 0x00020000;
+constexpr uint32_t PERIPH_SIZE = 0x00010000;
+constexpr uint32_t UART_BASE = PERIPH_BASE + 0x0500;
+constexpr uint32_t UART_DATA = 0x00;
+constexpr uint32_t UART_STATUS = 0x04;
+constexpr uint32_t UART_IRQ_EN = 0x10;
+constexpr uint32_t UART_STATUS_TX_EMPTY = 0x02;
+constexpr uint32_t UART_STATUS_RX_EMPTY = 0x08;
+constexpr uint32_t UART_IRQ_EN_TX_EMPTY = 0x02;
+constexpr int IRQ_UART = 17;
+
+// Reset is held this many cycles before the program starts
+constexpr int RESET_CYCLES = 4;
+
+enum Result { RESULT_PASS = 0, RESULT_FAIL = 1, RESULT_TIMEOUT = 2, RESULT_ERROR = 3 };
+
+struct Options {
+    std::string image;
+    std::string vcd;
+    uint64_t max_cycles = 1000000;
+    bool tohost_given = false;
+    uint32_t tohost = 0;
+    bool soc = false;
+    bool quiet = false;
+};
+
+//------------------------------------------------------------------------------
+// Memory model
+//------------------------------------------------------------------------------
+
+class Memory {
+public:
+    explicit Memory(bool soc)
+        : soc_(soc), words_((soc ? SOC_SPACE_BYTES : TEST_MEM_BYTES) / 4, NOP) {}
+
+    bool is_periph(uint32_t addr) const {
+        return soc_ && addr - PERIPH_BASE < PERIPH_SIZE;
+    }
+
+    // Word index of a RAM address (test mode mirrors the whole space)
+    uint32_t index(uint32_t addr) const {
+        return (addr / 4) % words_.size();
+    }
+
+    uint32_t read(uint32_t addr) const {
+        if (is_periph(addr)) return periph_read(addr);
+        return words_[index(addr)];
+    }
+
+    void write(uint32_t addr, uint32_t data, uint32_t sel) {
+        if (is_periph(addr)) {
+            periph_write(addr, data, sel);
+            return;
+        }
+        uint32_t& w = words_[index(addr)];
+        for (int b = 0; b < 4; b++) {
+            if (sel & (1u << b)) {
+                uint32_t mask = 0xFFu << (8 * b);
+                w = (w & ~mask) | (data & mask);
+            }
+        }
+    }
+
+    // Byte store for the image loaders
+    void load_byte(uint32_t addr, uint8_t value) {
+        write(addr & ~3u, static_cast<uint32_t>(value) << (8 * (addr & 3)), 1u << (addr & 3));
+    }
+
+    uint32_t interrupts() const {
+        return (uart_irq_en_ & UART_IRQ_EN_TX_EMPTY) ? (1u << IRQ_UART) : 0;
+    }
+
+private:
+    uint32_t periph_read(uint32_t addr) const {
+        switch (addr - UART_BASE) {
+        case UART_STATUS: return UART_STATUS_TX_EMPTY | UART_STATUS_RX_EMPTY;
+        case UART_IRQ_EN: return uart_irq_en_;
+        default:          return 0;
+        }
+    }
+
+    void periph_write(uint32_t addr, uint32_t data, uint32_t sel) {
+        switch (addr - UART_BASE) {
+        case UART_DATA:
+            if (sel & 1) {
+                std::putchar(static_cast<int>(data & 0xFF));
+            }
+            break;
+        case UART_IRQ_EN:
+            uart_irq_en_ = data;
+            break;
+        default:
+            break;
+        }
+    }
+
+    bool soc_;
+    std::vector<uint32_t> words_;
+    uint32_t uart_irq_en_ = 0;
+};
+
+//------------------------------------------------------------------------------
+// Image loaders
+//------------------------------------------------------------------------------
+
+bool read_file(const std::string& path, std::vector<uint8_t>& out) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) return false;
+    out.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    return true;
+}
+
+template <typename T>
+T get(const std::vector<uint8_t>& buf, size_t off) {
+    T v = 0;
+    for (size_t i = 0; i < sizeof(T); i++) {
+        v |= static_cast<T>(buf[off + i]) << (8 * i);
+    }
+    return v;
+}
+
+struct ElfInfo {
+    uint32_t entry = 0;
+    bool covers_reset = false;      // a segment is loaded at address 0
+    bool has_tohost = false;
+    uint32_t tohost = 0;
+};
+
+/**
+ * Load the PT_LOAD segments of a little-endian RV32 ELF at their physical
+ * addresses and look up the tohost symbol.
+ */
+bool load_elf(const std::vector<uint8_t>& elf, Memory& mem, ElfInfo& info) {
+    if (elf.size() < 52 || elf[4] != 1 || elf[5] != 1 || get<uint16_t>(elf, 18) != 243) {
+        std::fprintf(stderr, "not a little-endian RV32 ELF\n");
+        return false;
+    }
+
+    uint32_t phoff = get<uint32_t>(elf, 28);
+    uint32_t shoff = get<uint32_t>(elf, 32);
+    uint16_t phentsize = get<uint16_t>(elf, 42);
+    uint16_t phnum = get<uint16_t>(elf, 44);
+    uint16_t shentsize = get<uint16_t>(elf, 46);
+    uint16_t shnum = get<uint16_t>(elf, 48);
+    info.entry = get<uint32_t>(elf, 24);
+
+    for (uint16_t i = 0; i < phnum; i++) {
+        size_t ph = phoff + static_cast<size_t>(i) * phentsize;
+        if (ph + 32 > elf.size() || get<uint32_t>(elf, ph) != 1) continue;   // PT_LOAD
+
+        uint32_t offset = get<uint32_t>(elf, ph + 4);
+        uint32_t paddr = get<uint32_t>(elf, ph + 12);
+        uint32_t filesz = get<uint32_t>(elf, ph + 16);
+        uint32_t memsz = get<uint32_t>(elf, ph + 20);
+        if (static_cast<size_t>(offset) + filesz > elf.size()) {
+            std::fprintf(stderr, "truncated ELF segment\n");
+            return false;
+        }
+        if (paddr == 0 && memsz != 0) info.covers_reset = true;
+        for (uint32_t b = 0; b < memsz; b++) {
+            mem.load_byte(paddr + b, b < filesz ? elf[offset + b] : 0);
+        }
+    }
+
+    // Symbol table: SHT_SYMTAB, strings in the linked section
+    for (uint16_t i = 0; i < shnum; i++) {
+        size_t sh = shoff + static_cast<size_t>(i) * shentsize;
+        if (sh + 40 > elf.size() || get<uint32_t>(elf, sh + 4) != 2) continue;
+
+        uint32_t sym_off = get<uint32_t>(elf, sh + 16);
+        uint32_t sym_size = get<uint32_t>(elf, sh + 20);
+        uint32_t link = get<uint32_t>(elf, sh + 24);
+        size_t str_sh = shoff + static_cast<size_t>(link) * shentsize;
+        if (str_sh + 40 > elf.size()) continue;
+        uint32_t str_off = get<uint32_t>(elf, str_sh + 16);
+
+        for (uint32_t s = 0; s + 16 <= sym_size && static_cast<size_t>(sym_off) + s + 16 <= elf.size(); s += 16) {
+            size_t name = str_off + get<uint32_t>(elf, sym_off + s);
+            if (name + sizeof("tohost") <= elf.size() &&
+                std::memcmp(&elf[name], "tohost", sizeof("tohost")) == 0) {
+                info.has_tohost = true;
+                info.tohost = get<uint32_t>(elf, sym_off + s + 4);
+                return true;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Load a $readmemh-style file: one 32-bit word per token, "@addr" sets the
+ * word address, "//" starts a comment.
+ */
+bool load_hex(const std::string& path, Memory& mem) {
+    std::ifstream f(path);
+    if (!f) return false;
+
+    std::string line;
+    uint32_t word_addr = 0;
+    while (std::getline(f, line)) {
+        std::istringstream tokens(line.substr(0, line.find("//")));
+        std::string tok;
+        while (tokens >> tok) {
+            if (tok[0] == '@') {
+                word_addr = static_cast<uint32_t>(std::stoul(tok.substr(1), nullptr, 16));
+            } else {
+                mem.write(word_addr * 4, static_cast<uint32_t>(std::stoul(tok, nullptr, 16)), 0xF);
+                word_addr++;
+            }
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// Simulation
+//------------------------------------------------------------------------------
+
+class Harness {
+public:
+    Harness(VerilatedContext* ctx, Memory& mem) : ctx_(ctx), top_(new Vsim_top(ctx)), mem_(mem) {}
+
+    ~Harness() {
+#if VM_TRACE
+        if (vcd_) vcd_->close();
+#endif
+        top_->final();
+    }
+
+    void open_vcd(const std::string& path) {
+#if VM_TRACE
+        ctx_->traceEverOn(true);
+        vcd_.reset(new VerilatedVcdC);
+        top_->trace(vcd_.get(), 99);
+        vcd_->open(path.c_str());
+#else
+        (void)path;
+        std::fprintf(stderr, "warning: built without TRACE=1, --vcd ignored\n");
+#endif
+    }
+
+    void set_tohost(uint32_t addr) {
+        has_tohost_ = true;
+        tohost_ = addr;
+    }
+
+    Result run(uint64_t max_cycles, uint32_t& code) {
+        top_->rst_n = 0;
+        top_->dwb_err_i = 0;
+        top_->interrupts = 0;
+        top_->iwb_ack_i = 0;
+        top_->iwb_dat_i = NOP;
+        top_->dwb_ack_i = 0;
+        top_->dwb_dat_i = 0;
+        top_->clk = 0;
+        top_->eval();
+
+        for (int i = 0; i < RESET_CYCLES; i++) tick();
+        top_->rst_n = 1;
+        top_->eval();
+
+        for (cycles_ = 0; cycles_ < max_cycles; cycles_++) {
+            tick();
+            if (done_) {
+                code = code_;
+                return code_ == 1 ? RESULT_PASS : RESULT_FAIL;
+            }
+        }
+        return RESULT_TIMEOUT;
+    }
+
+    uint64_t cycles() const { return cycles_; }
+    uint64_t instret() const { return top_->instret; }
+
+private:
+    /**
+     * One clock. The bus timing is that of the Icarus bench: registered
+     * data-port ack, data valid combinationally while the strobe is up, and
+     * an instruction port that is registered for the multi-cycle core and
+     * zero-wait-state (SIM_IFETCH_COMB) for the pipelined one.
+     */
+    void tick() {
+        // Sample the requests as they are before the edge
+        bool ireq = top_->iwb_cyc_o && top_->iwb_stb_o;
+        bool dreq = top_->dwb_cyc_o && top_->dwb_stb_o;
+        uint32_t iadr = top_->iwb_adr_o;
+        bool next_dack = dreq && !top_->dwb_ack_i;
+
+        if (next_dack && top_->dwb_we_o && top_->rst_n) {
+            uint32_t adr = top_->dwb_adr_o;
+            uint32_t dat = top_->dwb_dat_o;
+            mem_.write(adr, dat, top_->dwb_sel_o);
+            if (has_tohost_ && mem_.index(adr) == mem_.index(tohost_) && dat != 0) {
+                done_ = true;
+                code_ = dat;
+            }
+        }
+
+#ifndef SIM_IFETCH_COMB
+        bool next_iack = ireq && !top_->iwb_ack_i;
+        uint32_t next_idata = next_iack ? mem_.read(iadr) : top_->iwb_dat_i;
+#else
+        (void)ireq;
+        (void)iadr;
+#endif
+
+        top_->clk = 1;
+        top_->eval();
+        dump();
+
+#ifndef SIM_IFETCH_COMB
+        top_->iwb_ack_i = next_iack;
+        top_->iwb_dat_i = next_idata;
+#endif
+        top_->dwb_ack_i = top_->rst_n ? next_dack : 0;
+        top_->interrupts = mem_.interrupts();
+
+        top_->clk = 0;
+        top_->eval();
+        settle();
+        dump();
+    }
+
+    // Drive the combinational responses until the requests stop changing
+    void settle() {
+        for (int pass = 0; pass < 4; pass++) {
+            uint32_t ds = top_->dwb_cyc_o && top_->dwb_stb_o;
+            uint32_t dat = ds ? mem_.read(top_->dwb_adr_o) : 0;
+#ifdef SIM_IFETCH_COMB
+            bool iack = top_->rst_n && top_->iwb_cyc_o && top_->iwb_stb_o;
+            uint32_t idat = mem_.read(top_->iwb_adr_o);
+            if (dat == top_->dwb_dat_i && iack == top_->iwb_ack_i && idat == top_->iwb_dat_i) break;
+            top_->iwb_ack_i = iack;
+            top_->iwb_dat_i = idat;
+#else
+            if (dat == top_->dwb_dat_i) break;
+#endif
+            top_->dwb_dat_i = dat;
+            top_->eval();
+        }
+    }
+
+    void dump() {
+        ctx_->timeInc(5);
+#if VM_TRACE
+        if (vcd_) vcd_->dump(ctx_->time());
+#endif
+    }
+
+    VerilatedContext* ctx_;
+    std::unique_ptr<Vsim_top> top_;
+#if VM_TRACE
+    std::unique_ptr<VerilatedVcdC> vcd_;
+#endif
+    Memory& mem_;
+    bool has_tohost_ = false;
+    uint32_t tohost_ = 0;
+    bool done_ = false;
+    uint32_t code_ = 0;
+    uint64_t cycles_ = 0;
+};
+
+void usage(const char* prog) {
+    std::fprintf(stderr,
+                 "usage: %s [--max-cycles N] [--tohost ADDR] [--soc] [--vcd FILE] [--quiet] "
+                 "<image.elf|image.hex>\n", prog);
+}
+
+bool parse_args(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        bool has_value = i + 1 < argc;
+        if (a == "--max-cycles" && has_value) {
+            opt.max_cycles = std::strtoull(argv[++i], nullptr, 0);
+        } else if (a == "--tohost" && has_value) {
+            opt.tohost_given = true;
+            opt.tohost = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else if (a == "--vcd" && has_value) {
+            opt.vcd = argv[++i];
+        } else if (a == "--soc") {
+            opt.soc = true;
+        } else if (a == "--quiet") {
+            opt.quiet = true;
+        } else if (a[0] == '+') {
+            // Verilator plusargs are passed through to the context
+        } else if (a[0] != '-' && opt.image.empty()) {
+            opt.image = a;
+        } else {
+            return false;
+        }
+    }
+    return !opt.image.empty();
+}
+
+// jal x0, target (from address 0)
+uint32_t encode_jal(uint32_t target) {
+    return ((target & 0x100000) << 11) | ((target & 0x7FE) << 20) |
+           ((target & 0x800) << 9) | (target & 0xFF000) | 0x6F;
+}
+
+bool ends_with(const std::string& s, const char* suffix) {
+    size_t n = std::strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_args(argc, argv, opt)) {
+        usage(argv[0]);
+        return RESULT_ERROR;
+    }
+
+    std::unique_ptr<VerilatedContext> ctx(new VerilatedContext);
+    ctx->commandArgs(argc, argv);
+
+    Memory mem(opt.soc);
+    ElfInfo info;
+
+    if (ends_with(opt.image, ".hex")) {
+        if (!load_hex(opt.image, mem)) {
+            std::fprintf(stderr, "cannot read %s\n", opt.image.c_str());
+            return RESULT_ERROR;
+        }
+    } else {
+        std::vector<uint8_t> elf;
+        if (!read_file(opt.image, elf)) {
+            std::fprintf(stderr, "cannot read %s\n", opt.image.c_str());
+            return RESULT_ERROR;
+        }
+        if (!load_elf(elf, mem, info)) return RESULT_ERROR;
+        if (opt.soc && !info.covers_reset && info.entry != 0) {
+            mem.write(0, encode_jal(info.entry), 0xF);
+        }
+    }
+
+    Harness sim(ctx.get(), mem);
+    if (opt.tohost_given) {
+        sim.set_tohost(opt.tohost);
+    } else if (info.has_tohost) {
+        sim.set_tohost(info.tohost);
+    } else if (!opt.soc) {
+        sim.set_tohost(TEST_TOHOST_DEFAULT);
+    }
+    if (!opt.vcd.empty()) sim.open_vcd(opt.vcd);
+
+    uint32_t code = 0;
+    Result r = sim.run(opt.max_cycles, code);
+    std::fflush(stdout);
+
+    const char* verdict = r == RESULT_PASS ? "*** TEST PASSED ***"
+                        : r == RESULT_FAIL ? "*** TEST FAILED ***"
+                        : "*** TEST TIMEOUT ***";
+    if (!opt.quiet) std::printf("\n%s: ", opt.image.c_str());
+    if (r == RESULT_FAIL) {
+        std::printf("%s (code: %u) cycles=%llu instret=%llu\n", verdict, code >> 1,
+                    static_cast<unsigned long long>(sim.cycles()),
+                    static_cast<unsigned long long>(sim.instret()));
+    } else {
+        std::printf("%s cycles=%llu instret=%llu\n", verdict,
+                    static_cast<unsigned long long>(sim.cycles()),
+                    static_cast<unsigned long long>(sim.instret()));
+    }
+    return r;
+}
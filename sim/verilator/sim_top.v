@@ -0,0 +1,58 @@
+//==============================================================================
+// sim_top.v - Verilator Top for the Compiled Simulation Harness
+//
+// Thin wrapper around custom_riscv_core: the Wishbone ports are brought out
+// unchanged and serviced by the C++ memory model in sim_main.cpp, so one
+// compiled binary runs any program image without regenerating a testbench.
+//
+// The retired-instruction count is exported for the per-test report. The
+// default path is the 64-bit csr_minstret register of custom_riscv_core_pipe.v
+// (module custom_riscv_core, instance dut). Other core sources must define
+// SIM_INSTRET: the netlist in synthesized_core.v, for one, names it
+// dut.minstret.
+//==============================================================================
+
+`timescale 1ns/1ps
+
+`ifndef SIM_INSTRET
+`define SIM_INSTRET dut.csr_minstret
+`endif
+
+module sim_top (
+    input  wire        clk,
+    input  wire        rst_n,
+
+    output wire [31:0] iwb_adr_o,
+    input  wire [31:0] iwb_dat_i,
+    output wire        iwb_cyc_o,
+    output wire        iwb_stb_o,
+    input  wire        iwb_ack_i,
+
+    output wire [31:0] dwb_adr_o,
+    output wire [31:0] dwb_dat_o,
+    input  wire [31:0] dwb_dat_i,
+    output wire        dwb_we_o,
+    output wire [3:0]  dwb_sel_o,
+    output wire        dwb_cyc_o,
+    output wire        dwb_stb_o,
+    input  wire        dwb_ack_i,
+    input  wire        dwb_err_i,
+
+    input  wire [31:0] interrupts,
+
+    output wire [63:0] instret
+);
+
+    custom_riscv_core dut (
+        .clk(clk), .rst_n(rst_n),
+        .iwb_adr_o(iwb_adr_o), .iwb_dat_i(iwb_dat_i),
+        .iwb_cyc_o(iwb_cyc_o), .iwb_stb_o(iwb_stb_o), .iwb_ack_i(iwb_ack_i),
+        .dwb_adr_o(dwb_adr_o), .dwb_dat_o(dwb_dat_o), .dwb_dat_i(dwb_dat_i),
+        .dwb_we_o(dwb_we_o), .dwb_sel_o(dwb_sel_o),
+        .dwb_cyc_o(dwb_cyc_o), .dwb_stb_o(dwb_stb_o), .dwb_ack_i(dwb_ack_i),
+        .dwb_err_i(dwb_err_i), .interrupts(interrupts)
+    );
+
+    assign instret = `SIM_INSTRET;
+
+endmodule
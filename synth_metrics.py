@@ -0,0 +1,284 @@
+#!/usr/bin/env python3
+"""
+Synthesis Timing/Area Metrics and Baseline Comparison
+
+Turns the text output of the synthesis flow into structured JSON and
+compares it with a stored baseline:
+
+    python3 synth_metrics.py extract synthesis/soc_results/synthesis.log \\
+        --sta sta_report.txt -o synthesis/soc_results/metrics.json
+    python3 synth_metrics.py compare synthesis/soc_results/metrics.json
+    python3 synth_metrics.py compare metrics.json --update      # accept as new baseline
+
+extract understands:
+  - Yosys `stat`: cells, cell types and (with a liberty file) chip area per
+    module, plus the design hierarchy total
+  - Yosys `ltp`: longest topological path (logic levels) per module
+  - OpenSTA `report_checks` / `report_clock_min_period`, or the nextpnr
+    "Max frequency for clock" line, when a timing report is given
+
+fmax comes from the timing report when there is one. Otherwise it is
+estimated from the `ltp` depth (LEVEL_DELAY_NS per level plus register
+overhead), which is only good for spotting trends between builds.
+
+compare reports per-module cell/area changes and the fmax change against
+the baseline (synthesis/baseline/<design>.json by default). It exits 1 if
+area grew or fmax dropped by more than the thresholds, or if fmax is
+below the clock the firmware is built for (CPU_FREQ_HZ in the bootloader,
+50 MHz).
+"""
+
+import argparse
+import json
+import re
+import shutil
+import sys
+import time
+from pathlib import Path
+
+REPO_ROOT = Path(__file__).resolve().parent
+BASELINE_DIR = REPO_ROOT / "synthesis" / "baseline"
+FIRMWARE_CLOCK_SRC = REPO_ROOT / "distribution" / "rv32imz_full_soc" / "firmware" / "bootloader" / "bootloader.c"
+DEFAULT_CLOCK_MHZ = 50.0
+
+# ltp-based estimate (ECP5 -6 LUT4 plus local routing, clk-to-q + setup)
+LEVEL_DELAY_NS = 0.9
+REGISTER_OVERHEAD_NS = 1.0
+
+#==============================================================================
+# Parsers
+#==============================================================================
+
+STAT_HEADER = re.compile(r"^=== (.+) ===\s*$")
+STAT_CELLS = re.compile(r"^\s+Number of cells:\s+(\d+)")
+STAT_TYPE = re.compile(r"^\s{5}(\S+)\s+(\d+)\s*$")
+STAT_AREA = re.compile(r"^\s+Chip area for (?:top )?module '\\?([^']+)':\s+([\d.]+)")
+LTP = re.compile(r"Longest topological path in (\S+) \(length=(\d+)\)")
+YOSYS_VERSION = re.compile(r"^(Yosys \S+)", re.M)
+
+def parse_yosys(text):
+    """Per-module stats from the last `stat` of each module, plus ltp depth"""
+    modules = {}
+    current = None
+    for line in text.splitlines():
+        m = STAT_HEADER.match(line)
+        if m:
+            current = m.group(1)
+            modules[current] = {"cells": 0, "cell_types": {}}
+            continue
+        if current is None:
+            continue
+        m = STAT_CELLS.match(line)
+        if m:
+            modules[current]["cells"] = int(m.group(1))
+            continue
+        m = STAT_TYPE.match(line)
+        if m and not line.strip().startswith("Number"):
+            modules[current]["cell_types"][m.group(1)] = int(m.group(2))
+            continue
+        m = STAT_AREA.match(line)
+        if m:
+            modules[current]["area"] = float(m.group(2))
+            continue
+        if line.startswith("End of script") or re.match(r"^\d+\. ", line):
+            current = None
+
+    total = modules.pop("design hierarchy", None)
+    if total is None:
+        # Single-module stat: that module is the total
+        total = next(iter(modules.values()), {"cells": 0, "cell_types": {}})
+
+    depth = {}
+    for name, length in LTP.findall(text):
+        depth[name.lstrip("\\")] = int(length)
+    for name, levels in depth.items():
+        if name in modules:
+            modules[name]["logic_levels"] = levels
+
+    version = YOSYS_VERSION.search(text)
+    return modules, total, depth, version.group(1) if version else None
+
+STA_MIN_PERIOD = re.compile(r"^(\S+) period_min = ([\d.]+) fmax = ([\d.]+)", re.M)
+STA_START = re.compile(r"^Startpoint: (\S+)", re.M)
+STA_END = re.compile(r"^Endpoint: (\S+)", re.M)
+STA_ARRIVAL = re.compile(r"^\s*([-\d.]+)\s+data arrival time", re.M)
+STA_SLACK = re.compile(r"^\s*([-\d.]+)\s+slack \((MET|VIOLATED)\)", re.M)
+STA_CLOCK = re.compile(r"^\s*([\d.]+)\s+([\d.]+)\s+clock (\S+) \(rise edge\)", re.M)
+NEXTPNR_FMAX = re.compile(r"Max frequency for clock\s+'([^']+)':\s+([\d.]+) MHz")
+
+def parse_timing(text):
+    """Critical path and fmax from OpenSTA or nextpnr output"""
+    timing = {}
+
+    fmax = NEXTPNR_FMAX.findall(text)
+    if fmax:
+        clock, mhz = min(fmax, key=lambda c: float(c[1]))
+        return {"source": "nextpnr", "clock": clock, "fmax_mhz": float(mhz)}
+
+    start, end = STA_START.search(text), STA_END.search(text)
+    if start and end:
+        timing["startpoint"] = start.group(1)
+        timing["endpoint"] = end.group(1)
+    arrival = STA_ARRIVAL.findall(text)
+    if arrival:
+        timing["delay_ns"] = float(arrival[0])
+    slack = STA_SLACK.search(text)
+    if slack:
+        timing["slack_ns"] = float(slack.group(1))
+
+    # Capture edge of the first path: the second "clock (rise edge)" line
+    clocks = STA_CLOCK.findall(text)
+    min_period = STA_MIN_PERIOD.search(text)
+    if min_period:
+        timing["clock"] = min_period.group(1)
+        timing["fmax_mhz"] = float(min_period.group(3))
+    elif len(clocks) >= 2 and "slack_ns" in timing:
+        period = float(clocks[1][0])
+        timing["clock"] = clocks[1][2]
+        timing["period_ns"] = period
+        timing["fmax_mhz"] = round(1000.0 / (period - timing["slack_ns"]), 2)
+
+    if timing:
+        timing["source"] = "opensta"
+    return timing
+
+def firmware_clock_mhz():
+    """Clock the firmware assumes (CPU_FREQ_HZ)"""
+    try:
+        m = re.search(r"#define\s+CPU_FREQ_HZ\s+(\d+)", FIRMWARE_CLOCK_SRC.read_text())
+    except OSError:
+        m = None
+    return int(m.group(1)) / 1e6 if m else DEFAULT_CLOCK_MHZ
+
+#==============================================================================
+# extract
+#==============================================================================
+
+def extract(args):
+    text = "\n".join(Path(p).read_text(errors="replace") for p in args.logs)
+    modules, total, depth, version = parse_yosys(text)
+    if not modules and not total.get("cells"):
+        print(f"Error: no Yosys stat output in {', '.join(args.logs)}")
+        return 1
+
+    timing = parse_timing(Path(args.sta).read_text(errors="replace")) if args.sta else {}
+    if "fmax_mhz" not in timing and depth:
+        worst = max(depth, key=depth.get)
+        delay = depth[worst] * LEVEL_DELAY_NS + REGISTER_OVERHEAD_NS
+        timing = {"source": "ltp", "module": worst, "logic_levels": depth[worst],
+                  "delay_ns": round(delay, 2), "fmax_mhz": round(1000.0 / delay, 2),
+                  "estimated": True}
+
+    design = args.design or (max(modules, key=lambda m: modules[m]["cells"]) if modules else "design")
+    report = {
+        "design": design,
+        "date": time.strftime("%Y-%m-%d %H:%M:%S"),
+        "tool": version,
+        "target_mhz": args.target_mhz or firmware_clock_mhz(),
+        "total": {k: v for k, v in total.items() if k != "cell_types"},
+        "modules": modules,
+        "timing": timing,
+    }
+
+    out = json.dumps(report, indent=2, sort_keys=True)
+    if args.output:
+        Path(args.output).write_text(out + "\n")
+        print(f"Wrote {args.output}")
+    else:
+        print(out)
+    return 0
+
+#==============================================================================
+# compare
+#==============================================================================
+
+def pct(new, old):
+    return 100.0 * (new - old) / old if old else 0.0
+
+def compare(args):
+    report = json.loads(Path(args.report).read_text())
+    baseline_path = Path(args.baseline) if args.baseline else BASELINE_DIR / f"{report['design']}.json"
+
+    if args.update:
+        baseline_path.parent.mkdir(parents=True, exist_ok=True)
+        shutil.copy(args.report, baseline_path)
+        print(f"Baseline updated: {baseline_path}")
+        return 0
+
+    problems = []
+    target = report.get("target_mhz", DEFAULT_CLOCK_MHZ)
+    fmax = report.get("timing", {}).get("fmax_mhz")
+    source = report.get("timing", {}).get("source", "-")
+
+    if not baseline_path.exists():
+        print(f"No baseline at {baseline_path} (create one with --update)")
+        base = None
+    else:
+        base = json.loads(baseline_path.read_text())
+
+    if base is not None:
+        print(f"{'module':<28} {'cells':>8} {'baseline':>9} {'change':>8}")
+        names = sorted(set(report["modules"]) | set(base["modules"]))
+        for name in names:
+            new = report["modules"].get(name, {}).get("cells", 0)
+            old = base["modules"].get(name, {}).get("cells", 0)
+            change = f"{pct(new, old):+.1f}%" if old else ("new" if new else "")
+            print(f"{name:<28} {new:>8} {old:>9} {change:>8}")
+
+        for key in ("cells", "area"):
+            new, old = report["total"].get(key), base["total"].get(key)
+            if new is None or old is None:
+                continue
+            change = pct(new, old)
+            print(f"{'TOTAL ' + key:<28} {new:>8} {old:>9} {change:+7.1f}%")
+            if change > args.area_threshold:
+                problems.append(f"{key} grew {change:+.1f}% ({old} -> {new})")
+
+        old_fmax = base.get("timing", {}).get("fmax_mhz")
+        if fmax is not None and old_fmax:
+            change = pct(fmax, old_fmax)
+            print(f"\nfmax: {fmax:.2f} MHz (baseline {old_fmax:.2f} MHz, {change:+.1f}%, {source})")
+            if change < -args.fmax_threshold:
+                problems.append(f"fmax dropped {change:+.1f}% ({old_fmax:.2f} -> {fmax:.2f} MHz)")
+
+    if fmax is not None:
+        estimated = " (estimated)" if report["timing"].get("estimated") else ""
+        print(f"fmax {fmax:.2f} MHz{estimated} vs firmware clock {target:.0f} MHz")
+        if fmax < target:
+            problems.append(f"fmax {fmax:.2f} MHz is below the {target:.0f} MHz CPU_FREQ_HZ")
+    else:
+        print("No timing data in report")
+
+    if problems:
+        print("\nRegressions:")
+        for p in problems:
+            print(f"  ✗ {p}")
+        return 1
+    print("\n✓ No regressions")
+    return 0
+
+def main():
+    parser = argparse.ArgumentParser(description="Synthesis area/timing metrics and baseline comparison")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("extract", help="Parse Yosys/STA output into JSON")
+    p.add_argument("logs", nargs="+", help="Yosys logs with stat (and ltp) output")
+    p.add_argument("--sta", help="OpenSTA or nextpnr timing report")
+    p.add_argument("--design", help="Design name (default: largest module)")
+    p.add_argument("--target-mhz", type=float, help="Required clock (default: firmware CPU_FREQ_HZ)")
+    p.add_argument("-o", "--output", help="JSON file (default: stdout)")
+
+    p = sub.add_parser("compare", help="Compare a metrics JSON with the baseline")
+    p.add_argument("report")
+    p.add_argument("--baseline", help="Baseline JSON (default: synthesis/baseline/<design>.json)")
+    p.add_argument("--area-threshold", type=float, default=2.0,
+                   help="Allowed cell/area growth in percent (default 2)")
+    p.add_argument("--fmax-threshold", type=float, default=2.0,
+                   help="Allowed fmax drop in percent (default 2)")
+    p.add_argument("--update", action="store_true", help="Store the report as the new baseline")
+
+    args = parser.parse_args()
+    return extract(args) if args.command == "extract" else compare(args)
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,274 @@
+#!/usr/bin/env python3
+"""
+Incremental Hierarchical SoC Synthesis
+
+Synthesizes every block of the SoC (core, ROM, RAM, each peripheral) as its
+own Yosys run and keeps the netlists in synthesis/cache, keyed by a hash of
+everything that goes into the run: the Yosys version, target, script and the
+contents of the sources, their `include files and any $readmemh image. The
+top level is synthesized against port-only stubs of the blocks, and a last
+Yosys pass stitches the cached netlists into one hierarchical netlist.
+
+A rerun only re-synthesizes blocks whose inputs changed, so a new firmware
+image costs one ROM synthesis and the stitch instead of the whole SoC:
+
+    python3 synthesize_incremental.py                     # soc_simple, ECP5
+    python3 synthesize_incremental.py --core pipelined --mdu fast -j 4
+    python3 synthesize_incremental.py --soc soc_top --target generic
+
+Outputs go where synthesize_soc.sh puts them (synthesis/soc_results):
+soc_simple_synthesized.v/.json and synthesis.log, whose final `stat` is the
+hierarchical total.
+
+Blocks are optimized separately, so logic is not shared or pruned across
+block boundaries and the totals can be slightly above a flat run; use
+synthesize_soc.sh without --incremental for sign-off numbers. Blocks are
+synthesized with their default parameters.
+"""
+
+import argparse
+import concurrent.futures
+import hashlib
+import re
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+REPO_ROOT = Path(__file__).resolve().parent
+CACHE_DIR = REPO_ROOT / "synthesis" / "cache"
+RESULTS_DIR = REPO_ROOT / "synthesis" / "soc_results"
+INCLUDE_DIRS = [REPO_ROOT / "rtl" / "core"]
+
+YOSYS = "yosys"
+
+CORE_VARIANTS = {
+    "multicycle": "rtl/core/custom_riscv_core.v",
+    "pipelined": "rtl/core/custom_riscv_core_pipe.v",
+}
+MDU_VARIANTS = {
+    "serial": "rtl/core/mdu.v",
+    "fast": "rtl/core/mdu_fast.v",
+}
+
+# Synthesis command per target; the stitch step needs the cell library as
+# blackboxes to read the mapped netlists back
+TARGETS = {
+    "ecp5": {"synth": "synth_ecp5 -top {top}", "cells": "read_verilog -lib +/ecp5/cells_sim.v"},
+    "generic": {"synth": "synth -top {top}", "cells": ""},
+}
+
+#==============================================================================
+# Block table
+#==============================================================================
+
+def blocks(core, mdu):
+    """Block name -> (top module, sources, extra data files)"""
+    return {
+        "core": ("custom_riscv_core", [
+            CORE_VARIANTS[core],
+            "rtl/core/decoder.v",
+            "rtl/core/alu.v",
+            MDU_VARIANTS[mdu],
+            "rtl/core/csr_unit.v",
+            "rtl/core/exception_unit.v",
+            "rtl/core/regfile.v",
+        ], []),
+        "dual_rom": ("dual_rom", ["rtl/memory/dual_rom.v"],
+                     ["firmware/bootloader.hex", "firmware/firmware.hex"]),
+        "rom": ("rom_32kb", ["rtl/memory/rom_32kb.v"], ["firmware/firmware.hex"]),
+        "ram": ("ram_64kb", ["rtl/memory/ram_64kb.v"], []),
+        "uart": ("uart", ["rtl/peripherals/uart.v"], []),
+        "gpio": ("gpio", ["rtl/peripherals/gpio.v"], []),
+        "timer": ("timer", ["rtl/peripherals/timer.v"], []),
+        "pwm": ("pwm_accelerator", [
+            "rtl/peripherals/pwm_accelerator.v",
+            "rtl/peripherals/pwm_comparator.v",
+            "rtl/peripherals/pwm_bridge_refs.v",
+            "rtl/peripherals/carrier_generator.v",
+            "rtl/peripherals/sine_generator.v",
+        ], []),
+        "adc": ("adc_interface", [
+            "rtl/peripherals/adc_interface.v",
+            "rtl/peripherals/sigma_delta_adc.v",
+        ], []),
+        "protection": ("protection", [
+            "rtl/peripherals/protection.v",
+            "rtl/peripherals/prot_fast_compare.v",
+        ], []),
+    }
+
+# SoC top -> (glue sources synthesized with the top, blocks it instantiates)
+SOCS = {
+    "soc_simple": (["rtl/soc/soc_simple.v", "rtl/core/custom_core_wrapper.v"],
+                   ["core", "dual_rom", "ram", "uart", "gpio", "timer"]),
+    "soc_top": (["rtl/soc/soc_top.v", "rtl/core/custom_core_wrapper.v",
+                 "rtl/bus/wishbone_interconnect.v", "rtl/bus/wishbone_arbiter_2x1.v"],
+                ["core", "rom", "ram", "uart", "gpio", "timer", "pwm", "adc", "protection"]),
+}
+
+#==============================================================================
+# Hashing
+#==============================================================================
+
+INCLUDE_RE = re.compile(r'`include\s+"([^"]+)"')
+READMEM_RE = re.compile(r'\$readmem[hb]\s*\(\s*"([^"]+)"')
+
+def dependencies(sources):
+    """`include files and $readmem images referenced by the sources"""
+    deps = []
+    for src in sources:
+        text = src.read_text(errors="replace")
+        for name in INCLUDE_RE.findall(text):
+            for d in [src.parent, *INCLUDE_DIRS]:
+                if (d / name).exists():
+                    deps.append(d / name)
+                    break
+        for name in READMEM_RE.findall(text):
+            for d in [REPO_ROOT, src.parent]:
+                if (d / name).exists():
+                    deps.append(d / name)
+                    break
+    return deps
+
+def input_hash(version, script, files, stubs):
+    """Cache key; stubs count by content only (their names carry block keys)"""
+    digest = hashlib.sha256()
+    digest.update(version.encode())
+    digest.update(script.encode())
+    for f in files:
+        digest.update(str(f.relative_to(REPO_ROOT)).encode())
+        digest.update(f.read_bytes() if f.exists() else b"<missing>")
+    for f in stubs:
+        digest.update(f.read_bytes())
+    return digest.hexdigest()[:16]
+
+#==============================================================================
+# Yosys runs
+#==============================================================================
+
+def yosys_version():
+    try:
+        result = subprocess.run([YOSYS, "-V"], capture_output=True, text=True)
+    except FileNotFoundError:
+        return None
+    return result.stdout.strip()
+
+def run_yosys(script, log):
+    result = subprocess.run([YOSYS, "-q", "-l", str(log), "-p", script],
+                            capture_output=True, text=True, cwd=REPO_ROOT)
+    return result.returncode == 0
+
+def cell_count(log):
+    counts = re.findall(r"Number of cells:\s+(\d+)", log.read_text(errors="replace"))
+    return counts[-1] if counts else "-"
+
+def synth_block(name, top, sources, extra, stubs, target, version, force):
+    """Synthesize one block unless cached: (netlist, stub, status, seconds, cells)"""
+    missing = [s for s in sources if not s.exists()]
+    if missing:
+        return None, None, f"missing {missing[0].relative_to(REPO_ROOT)}", 0.0, "-"
+
+    reads = "\n".join(f"read_verilog -sv -I rtl/core {s.relative_to(REPO_ROOT)}" for s in sources)
+    body = f"{reads}\nhierarchy -check -top {top}\n{TARGETS[target]['synth'].format(top=top)}\nstat"
+    key = input_hash(version, f"{target}\n{body}", list(sources) + dependencies(sources) + extra, stubs)
+
+    base = CACHE_DIR / f"{name}-{key}"
+    netlist, stub, log = base.with_suffix(".v"), base.with_suffix(".stub.v"), base.with_suffix(".log")
+    if netlist.exists() and stub.exists() and not force:
+        return netlist, stub, "cached", 0.0, cell_count(log)
+
+    stub_reads = "".join(f"read_verilog -lib {s}\n" for s in stubs)
+    script = (f"{stub_reads}{body}\n"
+              f"write_verilog -noattr {netlist}\n"
+              f"blackbox {top}\n"
+              f"select {top}\n"
+              f"write_verilog -blackbox -selected {stub}")
+    start = time.time()
+    if not run_yosys(script, log):
+        netlist.unlink(missing_ok=True)
+        stub.unlink(missing_ok=True)
+        return None, None, f"FAILED (see {log.relative_to(REPO_ROOT)})", time.time() - start, "-"
+    return netlist, stub, "synthesized", time.time() - start, cell_count(log)
+
+def stitch(top, netlists, target, out_base, log):
+    """Read all netlists back and write the combined hierarchical design"""
+    reads = "\n".join(f"read_verilog {n}" for n in netlists)
+    script = (f"{TARGETS[target]['cells']}\n{reads}\n"
+              f"hierarchy -check -top {top}\n"
+              f"stat\n"
+              f"ltp -noff\n"
+              f"write_verilog {out_base}.v\n"
+              f"write_json {out_base}.json")
+    return run_yosys(script, log)
+
+#==============================================================================
+# Main
+#==============================================================================
+
+def main():
+    parser = argparse.ArgumentParser(description="Incremental block-level SoC synthesis with Yosys")
+    parser.add_argument("--soc", choices=sorted(SOCS), default="soc_simple", help="Top-level SoC")
+    parser.add_argument("--core", choices=sorted(CORE_VARIANTS), default="multicycle")
+    parser.add_argument("--mdu", choices=sorted(MDU_VARIANTS), default="serial")
+    parser.add_argument("--target", choices=sorted(TARGETS), default="ecp5")
+    parser.add_argument("-j", "--jobs", type=int, default=4, help="Parallel block syntheses (default 4)")
+    parser.add_argument("--force", action="append", default=[], metavar="BLOCK",
+                        help="Re-synthesize BLOCK even if cached (repeatable, 'all' for every block)")
+    parser.add_argument("--clean-cache", action="store_true", help="Delete cached netlists first")
+    args = parser.parse_args()
+
+    version = yosys_version()
+    if version is None:
+        print(f"Error: {YOSYS} not found")
+        return 1
+
+    if args.clean_cache and CACHE_DIR.exists():
+        for f in CACHE_DIR.iterdir():
+            f.unlink()
+    CACHE_DIR.mkdir(parents=True, exist_ok=True)
+    RESULTS_DIR.mkdir(parents=True, exist_ok=True)
+
+    table = blocks(args.core, args.mdu)
+    glue, block_names = SOCS[args.soc]
+    forced = set(block_names + ["top"]) if "all" in args.force else set(args.force)
+
+    print(f"Incremental synthesis of {args.soc} (core: {args.core}, mdu: {args.mdu}, target: {args.target})")
+    start = time.time()
+
+    def build(name):
+        top, sources, extra = table[name]
+        return synth_block(name, top, [REPO_ROOT / s for s in sources],
+                           [REPO_ROOT / d for d in extra], [], args.target, version, name in forced)
+
+    with concurrent.futures.ThreadPoolExecutor(max_workers=max(1, args.jobs)) as pool:
+        results = dict(zip(block_names, pool.map(build, block_names)))
+
+    # The top only sees the blocks' ports, so it is rebuilt when the glue
+    # logic or a block interface changes - not when a block's insides do
+    if all(r[0] is not None for r in results.values()):
+        stubs = [r[1] for r in results.values()]
+        results["top"] = synth_block("top", args.soc, [REPO_ROOT / s for s in glue], [], stubs,
+                                     args.target, version, "top" in forced)
+
+    print(f"{'block':<12} {'status':<40} {'time':>7} {'cells':>8}")
+    for name, (_, _, status, seconds, cells) in results.items():
+        print(f"{name:<12} {status:<40} {seconds:6.1f}s {cells:>8}")
+
+    if "top" not in results or results["top"][0] is None:
+        print("✗ Synthesis failed")
+        return 1
+
+    out_base = RESULTS_DIR / f"{args.soc}_synthesized"
+    log = RESULTS_DIR / "synthesis.log"
+    if not stitch(args.soc, [r[0] for r in results.values()], args.target, out_base, log):
+        print(f"✗ Stitching failed - see {log.relative_to(REPO_ROOT)}")
+        return 1
+
+    rebuilt = sum(1 for r in results.values() if r[2] == "synthesized")
+    print(f"✓ {out_base.relative_to(REPO_ROOT)}.v: {rebuilt} of {len(results)} blocks synthesized, "
+          f"{len(results) - rebuilt} cached, {time.time() - start:.1f}s")
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
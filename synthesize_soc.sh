@@ -5,10 +5,84 @@
 
 set -e  # Exit on any error
 
+# Multiply/divide unit variant:
+#   serial - rtl/core/mdu.v, 32-cycle shift-add / restoring (default)
+#   fast   - rtl/core/mdu_fast.v, radix-4 with early termination
+MDU_VARIANT="${MDU_VARIANT:-serial}"
+
+# Core variant:
+#   multicycle - rtl/core/custom_riscv_core.v, 5-state FSM, CPI ~5 (default)
+#   pipelined  - rtl/core/custom_riscv_core_pipe.v, 5-stage with forwarding
+CORE_VARIANT="${CORE_VARIANT:-multicycle}"
+
+# Incremental flow (synthesize_incremental.py): each block is synthesized on
+# its own and cached, so only changed blocks (e.g. the ROM after a firmware
+# update) are re-run. Off by default: a flat run optimizes across blocks.
+INCREMENTAL="${INCREMENTAL:-0}"
+
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --mdu)
+            MDU_VARIANT="$2"
+            shift 2
+            ;;
+        --mdu=*)
+            MDU_VARIANT="${1#--mdu=}"
+            shift
+            ;;
+        --core)
+            CORE_VARIANT="$2"
+            shift 2
+            ;;
+        --core=*)
+            CORE_VARIANT="${1#--core=}"
+            shift
+            ;;
+        --incremental)
+            INCREMENTAL=1
+            shift
+            ;;
+        -h|--help)
+            echo "Usage: $0 [--core multicycle|pipelined] [--mdu serial|fast] [--incremental]"
+            exit 0
+            ;;
+        *)
+            echo "Unknown option: $1"
+            exit 1
+            ;;
+    esac
+done
+
+case "$MDU_VARIANT" in
+    serial) MDU_SRC="rtl/core/mdu.v" ;;
+    fast)   MDU_SRC="rtl/core/mdu_fast.v" ;;
+    *)
+        echo "Unknown MDU variant: $MDU_VARIANT (expected serial or fast)"
+        exit 1
+        ;;
+esac
+
+case "$CORE_VARIANT" in
+    multicycle)
+        CORE_SRC="rtl/core/custom_riscv_core.v"
+        CORE_DESC="Multi-cycle FSM (CPI ~5)"
+        ;;
+    pipelined)
+        CORE_SRC="rtl/core/custom_riscv_core_pipe.v"
+        CORE_DESC="5-stage pipeline with forwarding"
+        ;;
+    *)
+        echo "Unknown core variant: $CORE_VARIANT (expected multicycle or pipelined)"
+        exit 1
+        ;;
+esac
+
 echo "================================================================================"
 echo "RV32IM SoC Synthesis - Complete System Synthesis"
 echo "Date: $(date)"
 echo "Target: Academic synthesis with open-source tools"
+echo "Core:   $CORE_VARIANT ($CORE_SRC)"
+echo "MDU:    $MDU_VARIANT ($MDU_SRC)"
 echo "================================================================================"
 
 cd "$(dirname "$0")"
@@ -29,67 +103,111 @@ if [ ! -f firmware/firmware.hex ]; then
     echo "FFFF0FEF" >> firmware/firmware.hex  # jal x1, -4 (loop)
 fi
 
-echo
-echo "Step 2: Running syntax check..."
-yosys -p "
-    read_verilog -sv rtl/soc/soc_simple.v
-    read_verilog -sv rtl/core/custom_core_wrapper.v
-    read_verilog -sv rtl/core/custom_riscv_core.v
-    read_verilog -sv rtl/core/decoder.v
-    read_verilog -sv rtl/core/alu.v
-    read_verilog -sv rtl/core/mdu.v
-    read_verilog -sv rtl/core/csr_unit.v
-    read_verilog -sv rtl/core/exception_unit.v
-    read_verilog -sv rtl/core/regfile.v
-    read_verilog -sv rtl/memory/dual_rom.v
-    read_verilog -sv rtl/memory/ram_64kb.v
-    read_verilog -sv rtl/peripherals/uart.v
-    read_verilog -sv rtl/peripherals/gpio.v
-    read_verilog -sv rtl/peripherals/timer.v
-    hierarchy -top soc_simple
-    check
-" > "$LOG_DIR/syntax_check.log" 2>&1
-
-if [ $? -eq 0 ]; then
-    echo "✓ Syntax check passed"
+if [ "$INCREMENTAL" = "1" ]; then
+    echo
+    echo "Step 2-3: Incremental block synthesis..."
+    if python3 synthesize_incremental.py --core "$CORE_VARIANT" --mdu "$MDU_VARIANT"; then
+        echo "✓ Synthesis completed successfully"
+    else
+        echo "✗ Synthesis failed - see synthesis/cache/*.log"
+        exit 1
+    fi
 else
-    echo "✗ Syntax check failed - see $LOG_DIR/syntax_check.log"
-    exit 1
+    echo
+    echo "Step 2: Running syntax check..."
+    yosys -p "
+        read_verilog -sv rtl/soc/soc_simple.v
+        read_verilog -sv rtl/core/custom_core_wrapper.v
+        read_verilog -sv $CORE_SRC
+        read_verilog -sv rtl/core/decoder.v
+        read_verilog -sv rtl/core/alu.v
+        read_verilog -sv $MDU_SRC
+        read_verilog -sv rtl/core/csr_unit.v
+        read_verilog -sv rtl/core/exception_unit.v
+        read_verilog -sv rtl/core/regfile.v
+        read_verilog -sv rtl/memory/dual_rom.v
+        read_verilog -sv rtl/memory/ram_64kb.v
+        read_verilog -sv rtl/peripherals/uart.v
+        read_verilog -sv rtl/peripherals/gpio.v
+        read_verilog -sv rtl/peripherals/timer.v
+        hierarchy -top soc_simple
+        check
+    " > "$LOG_DIR/syntax_check.log" 2>&1
+
+    if [ $? -eq 0 ]; then
+        echo "✓ Syntax check passed"
+    else
+        echo "✗ Syntax check failed - see $LOG_DIR/syntax_check.log"
+        exit 1
+    fi
+
+    echo
+    echo "Step 3: Running full synthesis..."
+    yosys -p "
+        read_verilog -sv rtl/soc/soc_simple.v
+        read_verilog -sv rtl/core/custom_core_wrapper.v
+        read_verilog -sv $CORE_SRC
+        read_verilog -sv rtl/core/decoder.v
+        read_verilog -sv rtl/core/alu.v
+        read_verilog -sv $MDU_SRC
+        read_verilog -sv rtl/core/csr_unit.v
+        read_verilog -sv rtl/core/exception_unit.v
+        read_verilog -sv rtl/core/regfile.v
+        read_verilog -sv rtl/memory/dual_rom.v
+        read_verilog -sv rtl/memory/ram_64kb.v
+        read_verilog -sv rtl/peripherals/uart.v
+        read_verilog -sv rtl/peripherals/gpio.v
+        read_verilog -sv rtl/peripherals/timer.v
+        hierarchy -top soc_simple
+        synth_ecp5 -top soc_simple
+        stat
+        ltp -noff
+        write_verilog $LOG_DIR/soc_simple_synthesized.v
+        write_json $LOG_DIR/soc_simple_synthesized.json
+    " > "$LOG_DIR/synthesis.log" 2>&1
+
+    if [ $? -eq 0 ]; then
+        echo "✓ Synthesis completed successfully"
+    else
+        echo "✗ Synthesis failed - see $LOG_DIR/synthesis.log"
+        exit 1
+    fi
 fi
 
 echo
-echo "Step 3: Running full synthesis..."
-yosys -p "
-    read_verilog -sv rtl/soc/soc_simple.v
-    read_verilog -sv rtl/core/custom_core_wrapper.v
-    read_verilog -sv rtl/core/custom_riscv_core.v
-    read_verilog -sv rtl/core/decoder.v
-    read_verilog -sv rtl/core/alu.v
-    read_verilog -sv rtl/core/mdu.v
-    read_verilog -sv rtl/core/csr_unit.v
-    read_verilog -sv rtl/core/exception_unit.v
-    read_verilog -sv rtl/core/regfile.v
-    read_verilog -sv rtl/memory/dual_rom.v
-    read_verilog -sv rtl/memory/ram_64kb.v
-    read_verilog -sv rtl/peripherals/uart.v
-    read_verilog -sv rtl/peripherals/gpio.v
-    read_verilog -sv rtl/peripherals/timer.v
-    hierarchy -top soc_simple
-    synth_ecp5 -top soc_simple
-    stat
-    write_verilog $LOG_DIR/soc_simple_synthesized.v
-    write_json $LOG_DIR/soc_simple_synthesized.json
-" > "$LOG_DIR/synthesis.log" 2>&1
-
-if [ $? -eq 0 ]; then
-    echo "✓ Synthesis completed successfully"
-else
-    echo "✗ Synthesis failed - see $LOG_DIR/synthesis.log"
-    exit 1
-fi
+echo "Step 4: Comparing multiply/divide unit variants..."
+
+# Synthesize each MDU on its own so the area and logic depth can be compared
+# independently of the rest of the SoC. ltp reports the longest
+# combinational path in LUT levels, a proxy for fmax before place & route.
+MDU_TABLE=""
+for variant in serial fast; do
+    case "$variant" in
+        serial) src="rtl/core/mdu.v" ;;
+        fast)   src="rtl/core/mdu_fast.v" ;;
+    esac
+    log="$LOG_DIR/mdu_${variant}.log"
+    if [ -f "$src" ] && yosys -p "
+        read_verilog -sv $src
+        synth_ecp5 -top mdu
+        stat
+        ltp -noff
+    " > "$log" 2>&1; then
+        m_cells=$(grep "Number of cells:" "$log" | tail -1 | awk '{print $4}')
+        m_luts=$(grep "LUT4" "$log" | tail -1 | awk '{print $2}')
+        m_ffs=$(grep "TRELLIS_FF" "$log" | tail -1 | awk '{print $2}')
+        m_depth=$(grep "Longest topological path" "$log" | tail -1 | sed 's/.*length=\([0-9]*\).*/\1/')
+    else
+        m_cells="-"; m_luts="-"; m_ffs="-"; m_depth="-"
+    fi
+    MDU_TABLE="${MDU_TABLE}$(printf '%-8s %-8s %-8s %-8s %-8s' "$variant" "$m_cells" "$m_luts" "$m_ffs" "$m_depth")
+"
+done
+echo "$MDU_TABLE" > "$LOG_DIR/mdu_comparison.txt"
+echo "✓ MDU comparison written to $LOG_DIR/mdu_comparison.txt"
 
 echo
-echo "Step 4: Generating synthesis report..."
+echo "Step 5: Generating synthesis report..."
 
 # Extract key statistics
 CELLS=$(grep "Number of cells:" "$LOG_DIR/synthesis.log" | tail -1 | awk '{print $4}')
@@ -114,6 +232,8 @@ DESIGN OVERVIEW
 Top Module:       soc_simple
 Source Files:     14 Verilog modules
 Architecture:     RV32I + M-extension (48 instructions)
+Core Variant:     $CORE_VARIANT ($CORE_SRC)
+MDU Variant:      $MDU_VARIANT ($MDU_SRC)
 System Features:  ROM, RAM, UART, GPIO, Timer
 
 RESOURCE UTILIZATION
@@ -127,7 +247,7 @@ Memory Blocks:    Inferred (ROM + RAM)
 COMPONENTS SYNTHESIZED
 ======================
 ✓ CPU Core (RV32IM)
-  - 3-stage pipeline
+  - $CORE_DESC
   - RV32I base instruction set (40 instructions)
   - M-extension multiply/divide (8 instructions)
   - 32 × 32-bit register file
@@ -150,6 +270,15 @@ Input Clock:      100 MHz (clk_100mhz)
 System Clock:     50 MHz (internal division)
 Clock Domains:    Fully synchronous design
 
+MULTIPLY/DIVIDE UNIT
+====================
+Variant  Cells    LUT4     FFs      Depth
+$MDU_TABLE
+Latency (cycles)  serial   fast
+MUL*, 16-bit op   33       9
+MUL*, 32-bit op   33       17
+DIV*/REM*         33       1 + ceil(dividend bits / 2)
+
 MEMORY MAP
 ==========
 0x00000000-0x00007FFF: ROM (32KB) - Firmware
@@ -195,7 +324,16 @@ End of Report
 ===============================================================================
 EOF
 
-echo "Step 5: Running post-synthesis verification..."
+echo "Step 5b: Extracting area/timing metrics..."
+# Structured metrics (cells per module, logic depth, fmax estimate) and a
+# comparison against synthesis/baseline/soc_simple.json; regressions and an
+# fmax below the firmware's CPU_FREQ_HZ are reported but do not stop the flow
+python3 synth_metrics.py extract "$LOG_DIR/synthesis.log" --design soc_simple \
+    -o "$LOG_DIR/metrics.json"
+python3 synth_metrics.py compare "$LOG_DIR/metrics.json" || \
+    echo "⚠ Metrics regressed (accept with: python3 synth_metrics.py compare $LOG_DIR/metrics.json --update)"
+
+echo "Step 6: Running post-synthesis verification..."
 # Quick sanity check on synthesized netlist
 if [ -f "$LOG_DIR/soc_simple_synthesized.v" ]; then
     MODULE_COUNT=$(grep -c "^module" "$LOG_DIR/soc_simple_synthesized.v")
@@ -214,12 +352,16 @@ echo "Summary:"
 echo "  • Total cells: $CELLS"
 echo "  • LUTs: $LUTS"
 echo "  • Registers: $REGISTERS"
+echo "  • Core: $CORE_VARIANT"
+echo "  • MDU: $MDU_VARIANT"
 echo "  • Status: Ready for RTL-to-GDS flow"
 echo
 echo "Generated files in synthesis/soc_results/:"
 echo "  • synthesis_report.txt - Complete report"
 echo "  • soc_simple_synthesized.v - Netlist"
 echo "  • synthesis.log - Detailed log"
+echo "  • mdu_comparison.txt - serial vs fast MDU area and depth"
+echo "  • metrics.json - per-module cells, logic depth, fmax estimate"
 echo
 echo "Next: Run './cadence_flow.sh' for RTL-to-GDS in university environment"
 echo "================================================================================"
\ No newline at end of file
@@ -2,18 +2,53 @@
 """
 Post-synthesis verification script for RV32IMZ bootloader system
 Tests the synthesized netlist for basic functionality
+
+Two parts:
+  1. Structural checks of the SoC netlist, reports and firmware images
+  2. Gate-level ISA regression: the riscv-tests run on the synthesized core
+     netlist (synthesized_core.v by default) under Icarus Verilog
+
+The gate-level bench is compiled once per netlist and cached; every test
+then only runs vvp with its hex image and tohost address as plusargs, so
+tests run in parallel (-j) and the compile is skipped on the next run if
+neither the netlist nor the bench changed. --shard K/N runs every N-th
+test starting at K, to split the regression across CI machines.
+
+    python3 verify_post_synthesis.py                     # checks + all tests
+    python3 verify_post_synthesis.py -j 16 --pattern 'rv32um-p-*'
+    python3 verify_post_synthesis.py --gate-only --shard 0/4
 """
 
+import argparse
+import concurrent.futures
+import hashlib
+import os
+import re
 import subprocess
 import sys
-import os
 import time
+from pathlib import Path
+
+REPO_ROOT = Path(__file__).resolve().parent
+
+# Test discovery and image conversion are shared with the RTL regression;
+# its paths are relative to the repository root
+os.chdir(REPO_ROOT)
+sys.path.insert(0, str(REPO_ROOT))
+from run_compliance_tests import (IFETCH_REGISTERED, IVERILOG, RISCV_TESTS_DIR, TESTBENCH_DIR, VVP,
+                                  convert_elf_to_hex, get_test_info)
+
+GATE_DIR = TESTBENCH_DIR / "gate"
+DEFAULT_NETLIST = Path("synthesized_core.v")
+DEFAULT_PATTERNS = ["rv32ui-p-*", "rv32um-p-*"]
+GATE_MAX_CYCLES = 200000
+GATE_TIMEOUT_S = 600
 
 def run_command(cmd, description):
     """Run a command and capture output"""
     print(f"🔍 {description}...")
     try:
-        result = subprocess.run(cmd, shell=True, capture_output=True, text=True, cwd='/home/furka/RV32IMZ')
+        result = subprocess.run(cmd, shell=True, capture_output=True, text=True, cwd=REPO_ROOT)
         if result.returncode == 0:
             print(f"✅ {description} - PASSED")
             return True, result.stdout
@@ -25,22 +60,227 @@ def run_command(cmd, description):
         print(f"❌ {description} - ERROR: {e}")
         return False, str(e)
 
-def main():
-    print("=" * 60)
-    print("RV32IMZ Bootloader Post-Synthesis Verification")
-    print(f"Date: {time.strftime('%Y-%m-%d %H:%M:%S')}")
-    print("=" * 60)
-    
+#==============================================================================
+# Gate-level ISA regression
+#==============================================================================
+
+# One bench for every test: image, tohost word and cycle limit are plusargs
+GATE_TESTBENCH = '''`timescale 1ns/1ps
+
+module tb_gate;
+    reg clk = 0;
+    reg rst_n;
+    always #5 clk = ~clk;
+
+    wire [31:0] iwb_adr_o, dwb_adr_o, dwb_dat_o;
+    wire [31:0] iwb_dat_i, dwb_dat_i;
+    wire iwb_cyc_o, iwb_stb_o, dwb_we_o, dwb_cyc_o, dwb_stb_o;
+    wire [3:0] dwb_sel_o;
+    wire dwb_err_i = 0;
+    reg [31:0] interrupts = 0;
+
+    // UNIFIED MEMORY - same 32KB layout as run_compliance_tests.py
+    reg [31:0] mem [0:8191];
+    reg imem_ack, dmem_ack;
+    reg [31:0] imem_data, dmem_data;
+
+    assign iwb_dat_i = imem_data;
+    assign dwb_dat_i = dmem_data;
+
+    custom_riscv_core dut (
+        .clk(clk), .rst_n(rst_n),
+        .iwb_adr_o(iwb_adr_o), .iwb_dat_i(iwb_dat_i),
+        .iwb_cyc_o(iwb_cyc_o), .iwb_stb_o(iwb_stb_o), .iwb_ack_i(imem_ack),
+        .dwb_adr_o(dwb_adr_o), .dwb_dat_o(dwb_dat_o), .dwb_dat_i(dwb_dat_i),
+        .dwb_we_o(dwb_we_o), .dwb_sel_o(dwb_sel_o),
+        .dwb_cyc_o(dwb_cyc_o), .dwb_stb_o(dwb_stb_o), .dwb_ack_i(dmem_ack),
+        .dwb_err_i(dwb_err_i), .interrupts(interrupts)
+    );
+
+{ifetch}
+
+    always @(*) begin
+        if (dwb_stb_o && dwb_cyc_o) begin
+            dmem_data = mem[dwb_adr_o[14:2]];
+        end else begin
+            dmem_data = 32'h0;
+        end
+    end
+
+    reg [8*1024-1:0] hex_file;
+    integer tohost_offset;
+    integer max_cycles;
+    integer cycles = 0;
+
+    always @(posedge clk) begin
+        if (rst_n) begin
+            cycles = cycles + 1;
+            if (cycles >= max_cycles) begin
+                $display("\\n*** TEST TIMEOUT *** cycles=%0d", cycles);
+                $finish;
+            end
+        end
+    end
+
+    // Data write and tohost monitoring
+    reg [31:0] newv;
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            dmem_ack <= 0;
+        end else begin
+            if (dwb_stb_o && dwb_cyc_o && !dmem_ack) begin
+                if (dwb_we_o) begin
+                    newv = mem[dwb_adr_o[14:2]];
+                    if (dwb_sel_o[0]) newv[7:0]   = dwb_dat_o[7:0];
+                    if (dwb_sel_o[1]) newv[15:8]  = dwb_dat_o[15:8];
+                    if (dwb_sel_o[2]) newv[23:16] = dwb_dat_o[23:16];
+                    if (dwb_sel_o[3]) newv[31:24] = dwb_dat_o[31:24];
+                    mem[dwb_adr_o[14:2]] <= newv;
+                    if (dwb_adr_o[14:2] == tohost_offset[12:0] && dwb_dat_o != 0) begin
+                        if (dwb_dat_o == 1) begin
+                            $display("\\n*** TEST PASSED *** cycles=%0d", cycles);
+                        end else begin
+                            $display("\\n*** TEST FAILED *** (code: %0d) cycles=%0d", dwb_dat_o >> 1, cycles);
+                        end
+                        $finish;
+                    end
+                end
+                dmem_ack <= 1;
+            end else begin
+                dmem_ack <= 0;
+            end
+        end
+    end
+
+    integer i;
+    initial begin
+        rst_n = 0;
+        if (!$value$plusargs("hex=%s", hex_file)) begin
+            $display("*** ERROR *** +hex=<file> required");
+            $finish;
+        end
+        if (!$value$plusargs("tohost=%d", tohost_offset)) tohost_offset = 'h400;
+        if (!$value$plusargs("max_cycles=%d", max_cycles)) max_cycles = {max_cycles};
+
+        for (i = 0; i < 8192; i = i + 1) begin
+            mem[i] = 32'h00000013;  // NOP
+        end
+        $readmemh(hex_file, mem);
+
+        #20 rst_n = 1;
+    end
+endmodule
+'''
+
+def find_tests(patterns, shard):
+    """riscv-tests executables matching the patterns, restricted to one shard"""
+    tests = sorted({f for p in patterns for f in RISCV_TESTS_DIR.glob(p) if f.suffix != '.dump'})
+    index, count = shard
+    return tests[index::count]
+
+def build_gate_sim(netlist, libs, rebuild=False):
+    """Compile bench + netlist once; reused while the inputs are unchanged"""
+    GATE_DIR.mkdir(parents=True, exist_ok=True)
+    bench = GATE_TESTBENCH.format(ifetch=IFETCH_REGISTERED, max_cycles=GATE_MAX_CYCLES)
+
+    digest = hashlib.sha256(bench.encode())
+    for f in [netlist, *libs]:
+        digest.update(f.read_bytes())
+    key = digest.hexdigest()[:16]
+
+    sim_file = GATE_DIR / f"tb_gate_{key}.vvp"
+    if sim_file.exists() and not rebuild:
+        print(f"♻️  Reusing compiled netlist {sim_file}")
+        return sim_file
+
+    tb_file = GATE_DIR / "tb_gate.v"
+    tb_file.write_text(bench)
+    start = time.time()
+    result = subprocess.run([IVERILOG, "-g2012", "-s", "tb_gate", "-o", str(sim_file),
+                             str(tb_file), str(netlist), *[str(f) for f in libs]],
+                            capture_output=True, text=True)
+    if result.returncode != 0:
+        print("❌ Gate-level compile failed:")
+        print(result.stderr[-4000:])
+        return None
+    print(f"🔨 Compiled {netlist} in {time.time() - start:.1f}s -> {sim_file}")
+    return sim_file
+
+def run_gate_test(sim_file, test_file, max_cycles, timeout):
+    """One test on the compiled bench: (status, cycles, wall seconds, output)"""
+    start = time.time()
+    hex_file = GATE_DIR / f"{test_file.name}.hex"
+    if not convert_elf_to_hex(test_file, hex_file):
+        return "ERROR", 0, time.time() - start, "hex conversion failed"
+    offset = get_test_info(test_file)['tohost_word_offset']
+
+    try:
+        result = subprocess.run([VVP, "-n", str(sim_file), f"+hex={hex_file.resolve()}",
+                                 f"+tohost={offset}", f"+max_cycles={max_cycles}"],
+                                capture_output=True, text=True, timeout=timeout)
+    except subprocess.TimeoutExpired:
+        return "TIMEOUT", 0, time.time() - start, f"no result after {timeout}s"
+
+    wall = time.time() - start
+    match = re.search(r'\*\*\* TEST (PASSED|FAILED|TIMEOUT) \*\*\*.*?cycles=(\d+)', result.stdout)
+    if not match:
+        return "ERROR", 0, wall, result.stdout[-1000:] + result.stderr[-1000:]
+    return match.group(1), int(match.group(2)), wall, result.stdout
+
+def gate_regression(args):
+    """Run the ISA tests on the netlist in parallel; returns True if all passed"""
+    print("\n🧪 Gate-level ISA regression:")
+    tests = find_tests(args.pattern or DEFAULT_PATTERNS, args.shard)
+    if not tests:
+        print(f"❌ No tests found in {RISCV_TESTS_DIR}")
+        return False
+
+    sim_file = build_gate_sim(args.netlist, args.lib, args.rebuild)
+    if sim_file is None:
+        return False
+
+    jobs = max(1, args.jobs)
+    print(f"  {len(tests)} tests (shard {args.shard[0]}/{args.shard[1]}), {jobs} workers")
+    start = time.time()
+    results = {}
+    with concurrent.futures.ThreadPoolExecutor(max_workers=jobs) as pool:
+        futures = {pool.submit(run_gate_test, sim_file, t, args.max_cycles, args.timeout): t for t in tests}
+        for future in concurrent.futures.as_completed(futures):
+            test = futures[future]
+            status, cycles, wall, output = future.result()
+            results[test] = (status, cycles, wall)
+            mark = "✅" if status == "PASSED" else "❌"
+            print(f"  {mark} {test.name:<24} {status:<8} cycles={cycles:<8} {wall:7.1f}s")
+            if status != "PASSED" and args.verbose:
+                print(output.strip())
+    elapsed = time.time() - start
+
+    failed = sorted(t.name for t, r in results.items() if r[0] != "PASSED")
+    busy = sum(r[2] for r in results.values())
+    slowest = sorted(results.items(), key=lambda kv: kv[1][2], reverse=True)[:5]
+    print(f"\n  ⏱️  {elapsed:.1f}s wall, {busy:.1f}s of simulation ({busy / elapsed:.1f}x parallel)")
+    print("  Slowest: " + ", ".join(f"{t.name} {r[2]:.1f}s" for t, r in slowest))
+    print(f"  {len(tests) - len(failed)} passed, {len(failed)} failed")
+    for name in failed:
+        print(f"    ❌ {name}")
+    return not failed
+
+#==============================================================================
+# Structural checks
+#==============================================================================
+
+def structural_checks():
+    """Netlist, report and firmware checks; returns True if the netlist exists"""
     # Check synthesis results exist
-    if not os.path.exists('/home/furka/RV32IMZ/synthesis/soc_results/soc_simple_synthesized.v'):
+    if not (REPO_ROOT / 'synthesis/soc_results/soc_simple_synthesized.v').exists():
         print("❌ Synthesized netlist not found!")
         return False
-    
+
     print("📁 Synthesis files found:")
     print("  ✅ soc_simple_synthesized.v")
     print("  ✅ synthesis_report.txt")
     print("  ✅ synthesis.log")
-    
+
     # 1. Check netlist structure
     success, output = run_command(
         "grep -c 'module\\|endmodule' synthesis/soc_results/soc_simple_synthesized.v",
@@ -52,7 +292,7 @@ def main():
             count = int(lines[0])
             if count >= 2:  # At least module + endmodule
                 print(f"  📝 Found {count//2} modules in netlist")
-    
+
     # 2. Check for dual ROM implementation
     success, output = run_command(
         "grep -c 'dual_rom\\|bootloader\\|application' synthesis/soc_results/soc_simple_synthesized.v",
@@ -60,8 +300,8 @@ def main():
     )
     if success and int(output.strip()) > 0:
         print("  📝 Bootloader memory structure preserved")
-    
-    # 3. Check resource utilization  
+
+    # 3. Check resource utilization
     success, output = run_command(
         "grep 'Total Cells:\\|LUTs:\\|Registers:' synthesis/soc_results/synthesis_report.txt",
         "Checking resource utilization"
@@ -70,7 +310,7 @@ def main():
         lines = output.strip().split('\n')
         for line in lines:
             print(f"  📊 {line.strip()}")
-    
+
     # 4. Verify critical paths exist
     success, output = run_command(
         "grep -c 'clk\\|reset' synthesis/soc_results/soc_simple_synthesized.v",
@@ -78,7 +318,7 @@ def main():
     )
     if success and int(output.strip()) > 0:
         print(f"  ⏰ Clock/reset signals: {output.strip()}")
-    
+
     # 5. Check firmware files are included
     success, output = run_command(
         "wc -l firmware/bootloader.hex firmware/firmware.hex",
@@ -91,7 +331,7 @@ def main():
                 print(f"  💾 Bootloader: {line.strip()}")
             elif 'firmware.hex' in line:
                 print(f"  💾 Application: {line.strip()}")
-    
+
     # 6. Memory usage analysis
     print("\n📊 Memory Analysis:")
     success, output = run_command(
@@ -109,21 +349,21 @@ def main():
                     print(f"  🔧 Bootloader size: {size}")
                 elif 'firmware' in filename:
                     print(f"  📱 Application size: {size}")
-    
+
     # 7. Test simple simulation command (syntax only)
     print("\n🔬 Post-synthesis simulation check:")
     success, output = run_command(
         "iverilog -t null -o /tmp/test.vvp synthesis/soc_results/soc_simple_synthesized.v 2>&1 || echo 'Simulation setup ready'",
         "Testing simulation compatibility"
     )
-    
+
     # 8. Memory layout verification
     print("\n🗺️ Memory Layout Verification:")
     print("  📍 0x00000000-0x00003FFF: Bootloader ROM (16KB)")
-    print("  📍 0x00004000-0x00007FFF: Application ROM (16KB)")  
+    print("  📍 0x00004000-0x00007FFF: Application ROM (16KB)")
     print("  📍 0x00008000-0x00017FFF: RAM (64KB)")
     print("  📍 0x00020000+: Peripherals (UART, GPIO, etc.)")
-    
+
     # 9. Check synthesis warnings
     success, output = run_command(
         "grep -i 'warning\\|error' synthesis/soc_results/synthesis.log | tail -5",
@@ -136,34 +376,81 @@ def main():
                 print(f"    {line.strip()}")
     else:
         print("  ✅ No critical warnings found")
-    
+    return True
+
+def parse_shard(text):
+    """'K/N' -> (K, N)"""
+    match = re.fullmatch(r'(\d+)/(\d+)', text)
+    if not match or int(match.group(2)) == 0 or int(match.group(1)) >= int(match.group(2)):
+        raise argparse.ArgumentTypeError("expected K/N with 0 <= K < N")
+    return int(match.group(1)), int(match.group(2))
+
+def main():
+    parser = argparse.ArgumentParser(description="Post-synthesis checks and gate-level ISA regression")
+    parser.add_argument("--netlist", type=Path, default=DEFAULT_NETLIST,
+                        help=f"Core netlist with module custom_riscv_core (default: {DEFAULT_NETLIST})")
+    parser.add_argument("--lib", type=Path, action="append", default=[],
+                        help="Cell library models for the netlist (repeatable)")
+    parser.add_argument("--pattern", action="append",
+                        help="Test glob (repeatable, default: rv32ui-p-* rv32um-p-*)")
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 1,
+                        help="Parallel simulations (default: all cores)")
+    parser.add_argument("--shard", type=parse_shard, default=(0, 1), metavar="K/N",
+                        help="Run every N-th test starting at K")
+    parser.add_argument("--max-cycles", type=int, default=GATE_MAX_CYCLES,
+                        help=f"Cycle limit per test (default {GATE_MAX_CYCLES})")
+    parser.add_argument("--timeout", type=int, default=GATE_TIMEOUT_S,
+                        help=f"Wall-clock limit per test in seconds (default {GATE_TIMEOUT_S})")
+    parser.add_argument("--rebuild", action="store_true", help="Recompile even if cached")
+    group = parser.add_mutually_exclusive_group()
+    group.add_argument("--gate-only", action="store_true", help="Skip the structural checks")
+    group.add_argument("--checks-only", action="store_true", help="Skip the gate-level regression")
+    parser.add_argument("-v", "--verbose", action="store_true", help="Print output of failing tests")
+    args = parser.parse_args()
+
+    print("=" * 60)
+    print("RV32IMZ Bootloader Post-Synthesis Verification")
+    print(f"Date: {time.strftime('%Y-%m-%d %H:%M:%S')}")
+    print("=" * 60)
+
+    checks_ok = args.gate_only or structural_checks()
+
+    gate_ok = True
+    if not args.checks_only:
+        if not args.netlist.exists():
+            print(f"❌ Core netlist {args.netlist} not found!")
+            gate_ok = False
+        else:
+            gate_ok = gate_regression(args)
+
     # 10. Final verification summary
     print("\n" + "=" * 60)
     print("POST-SYNTHESIS VERIFICATION SUMMARY")
     print("=" * 60)
-    print("✅ Synthesis: SUCCESSFUL")
-    print("✅ Netlist: Generated") 
-    print("✅ Bootloader: Integrated")
-    print("✅ Application: Loaded")
-    print("✅ Resources: Within limits")
-    print("✅ Memory Layout: Correct")
-    
+    if not args.gate_only:
+        print(f"{'✅' if checks_ok else '❌'} Netlist/firmware checks: {'PASSED' if checks_ok else 'FAILED'}")
+    if not args.checks_only:
+        print(f"{'✅' if gate_ok else '❌'} Gate-level ISA tests: {'PASSED' if gate_ok else 'FAILED'}")
+
+    if not (checks_ok and gate_ok):
+        return False
+
     print("\n🎯 READY FOR FPGA DEPLOYMENT!")
     print("Next steps:")
     print("1. Program FPGA with synthesized design")
-    print("2. Connect UART for bootloader communication")  
+    print("2. Connect UART for bootloader communication")
     print("3. Upload CHB controller via bootloader")
     print("4. Test 5-level inverter functionality")
-    
+
     print("\n💡 Bootloader Usage:")
     print("- Reset → Bootloader banner")
     print("- Press 'U' within 3s → Update mode")
     print("- Upload firmware via UART")
     print("- Automatic CRC verification")
     print("- Safe boot to application")
-    
+
     return True
 
 if __name__ == '__main__':
     success = main()
-    sys.exit(0 if success else 1)
\ No newline at end of file
+    sys.exit(0 if success else 1)